@@ -0,0 +1,854 @@
+/*-------------------------------------------------------------------------
+ *
+ * columnar_fdw.c
+ *		  foreign-data wrapper for column-oriented, compressed tables
+ *
+ * Columnar tables are meant for scans over a few columns of many rows, as
+ * analytic queries on a datanode do: only the columns a query uses are read,
+ * each column compresses well on its own, and blocks whose min/max cannot
+ * match the scan quals are not read at all.  Rows are only ever appended,
+ * with INSERT.
+ *
+ * Portions Copyright (c) 2016-2017, ADB Development Group
+ *
+ * IDENTIFICATION
+ *		  contrib/columnar_fdw/columnar_fdw.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include <math.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "access/htup_details.h"
+#include "access/reloptions.h"
+#include "access/sysattr.h"
+#include "catalog/pg_foreign_table.h"
+#include "commands/defrem.h"
+#include "commands/explain.h"
+#include "commands/vacuum.h"
+#include "foreign/fdwapi.h"
+#include "foreign/foreign.h"
+#include "miscadmin.h"
+#include "nodes/makefuncs.h"
+#include "optimizer/cost.h"
+#include "optimizer/pathnode.h"
+#include "optimizer/planmain.h"
+#include "optimizer/restrictinfo.h"
+#include "optimizer/var.h"
+#include "storage/lmgr.h"
+#include "utils/memutils.h"
+#include "utils/rel.h"
+#include "utils/sampling.h"
+
+#include "columnar_fdw.h"
+
+PG_MODULE_MAGIC;
+
+/*
+ * Describes the valid options for objects that use this wrapper.
+ */
+struct ColumnarFdwOption
+{
+	const char *optname;
+	Oid			optcontext;		/* Oid of catalog in which option may appear */
+};
+
+static const struct ColumnarFdwOption valid_options[] = {
+	{"filename", ForeignTableRelationId},
+	{"stripe_row_count", ForeignTableRelationId},
+	{"block_row_count", ForeignTableRelationId},
+	{"compression", ForeignTableRelationId},
+
+	/* Sentinel */
+	{NULL, InvalidOid}
+};
+
+/*
+ * FDW-specific information for RelOptInfo.fdw_private.
+ */
+typedef struct ColumnarFdwPlanState
+{
+	ColumnarOptions *options;
+	List	   *columns;		/* attnums (Integer) the scan reads */
+	BlockNumber pages;			/* estimate of the size of those columns */
+	double		ntuples;		/* rows in the table */
+} ColumnarFdwPlanState;
+
+/*
+ * FDW-specific information for ForeignScanState.fdw_state.
+ */
+typedef struct ColumnarFdwExecutionState
+{
+	ColumnarReadState *rstate;
+} ColumnarFdwExecutionState;
+
+/*
+ * SQL functions
+ */
+PG_FUNCTION_INFO_V1(columnar_fdw_handler);
+PG_FUNCTION_INFO_V1(columnar_fdw_validator);
+
+/*
+ * FDW callback routines
+ */
+static void columnarGetForeignRelSize(PlannerInfo *root,
+						  RelOptInfo *baserel,
+						  Oid foreigntableid);
+static void columnarGetForeignPaths(PlannerInfo *root,
+						RelOptInfo *baserel,
+						Oid foreigntableid);
+static ForeignScan *columnarGetForeignPlan(PlannerInfo *root,
+					   RelOptInfo *baserel,
+					   Oid foreigntableid,
+					   ForeignPath *best_path,
+					   List *tlist,
+					   List *scan_clauses,
+					   Plan *outer_plan);
+static void columnarExplainForeignScan(ForeignScanState *node,
+						   ExplainState *es);
+static void columnarBeginForeignScan(ForeignScanState *node, int eflags);
+static TupleTableSlot *columnarIterateForeignScan(ForeignScanState *node);
+static void columnarReScanForeignScan(ForeignScanState *node);
+static void columnarEndForeignScan(ForeignScanState *node);
+static int	columnarIsForeignRelUpdatable(Relation rel);
+static void columnarBeginForeignModify(ModifyTableState *mtstate,
+						   ResultRelInfo *rinfo,
+						   List *fdw_private,
+						   int subplan_index,
+						   int eflags);
+static TupleTableSlot *columnarExecForeignInsert(EState *estate,
+						  ResultRelInfo *rinfo,
+						  TupleTableSlot *slot,
+						  TupleTableSlot *planSlot);
+static void columnarEndForeignModify(EState *estate, ResultRelInfo *rinfo);
+static bool columnarAnalyzeForeignTable(Relation relation,
+							AcquireSampleRowsFunc *func,
+							BlockNumber *totalpages);
+static bool columnarIsForeignScanParallelSafe(PlannerInfo *root,
+								  RelOptInfo *rel,
+								  RangeTblEntry *rte);
+
+/*
+ * Helper functions
+ */
+static bool is_valid_option(const char *option, Oid context);
+static ColumnarOptions *columnarGetOptions(Oid foreigntableid);
+static int	get_row_count_option(DefElem *def);
+static List *get_needed_columns(RelOptInfo *baserel, TupleDesc tupdesc);
+static int columnar_acquire_sample_rows(Relation onerel, int elevel,
+							 HeapTuple *rows, int targrows,
+							 double *totalrows, double *totaldeadrows);
+
+
+/*
+ * Foreign-data wrapper handler function: return a struct with pointers
+ * to my callback routines.
+ */
+Datum
+columnar_fdw_handler(PG_FUNCTION_ARGS)
+{
+	FdwRoutine *fdwroutine = makeNode(FdwRoutine);
+
+	fdwroutine->GetForeignRelSize = columnarGetForeignRelSize;
+	fdwroutine->GetForeignPaths = columnarGetForeignPaths;
+	fdwroutine->GetForeignPlan = columnarGetForeignPlan;
+	fdwroutine->ExplainForeignScan = columnarExplainForeignScan;
+	fdwroutine->BeginForeignScan = columnarBeginForeignScan;
+	fdwroutine->IterateForeignScan = columnarIterateForeignScan;
+	fdwroutine->ReScanForeignScan = columnarReScanForeignScan;
+	fdwroutine->EndForeignScan = columnarEndForeignScan;
+	fdwroutine->IsForeignRelUpdatable = columnarIsForeignRelUpdatable;
+	fdwroutine->BeginForeignModify = columnarBeginForeignModify;
+	fdwroutine->ExecForeignInsert = columnarExecForeignInsert;
+	fdwroutine->EndForeignModify = columnarEndForeignModify;
+	fdwroutine->AnalyzeForeignTable = columnarAnalyzeForeignTable;
+	fdwroutine->IsForeignScanParallelSafe = columnarIsForeignScanParallelSafe;
+
+	PG_RETURN_POINTER(fdwroutine);
+}
+
+/*
+ * Validate the generic options given to a FOREIGN DATA WRAPPER, SERVER,
+ * USER MAPPING or FOREIGN TABLE that uses columnar_fdw.
+ *
+ * Raise an ERROR if the option or its value is considered invalid.
+ */
+Datum
+columnar_fdw_validator(PG_FUNCTION_ARGS)
+{
+	List	   *options_list = untransformRelOptions(PG_GETARG_DATUM(0));
+	Oid			catalog = PG_GETARG_OID(1);
+	char	   *filename = NULL;
+	int			stripe_row_count = DEFAULT_STRIPE_ROW_COUNT;
+	int			block_row_count = DEFAULT_BLOCK_ROW_COUNT;
+	ListCell   *cell;
+
+	/*
+	 * Only superusers are allowed to set options of a columnar_fdw foreign
+	 * table, as with file_fdw: the filename decides which file gets read and
+	 * written.
+	 */
+	if (catalog == ForeignTableRelationId && !superuser())
+		ereport(ERROR,
+				(errcode(ERRCODE_INSUFFICIENT_PRIVILEGE),
+				 errmsg("only superuser can change options of a columnar_fdw foreign table")));
+
+	foreach(cell, options_list)
+	{
+		DefElem    *def = (DefElem *) lfirst(cell);
+
+		if (!is_valid_option(def->defname, catalog))
+		{
+			const struct ColumnarFdwOption *opt;
+			StringInfoData buf;
+
+			/*
+			 * Unknown option specified, complain about it. Provide a hint
+			 * with list of valid options for the object.
+			 */
+			initStringInfo(&buf);
+			for (opt = valid_options; opt->optname; opt++)
+			{
+				if (catalog == opt->optcontext)
+					appendStringInfo(&buf, "%s%s", (buf.len > 0) ? ", " : "",
+									 opt->optname);
+			}
+
+			ereport(ERROR,
+					(errcode(ERRCODE_FDW_INVALID_OPTION_NAME),
+					 errmsg("invalid option \"%s\"", def->defname),
+					 buf.len > 0
+					 ? errhint("Valid options in this context are: %s",
+							   buf.data)
+				  : errhint("There are no valid options in this context.")));
+		}
+
+		if (strcmp(def->defname, "filename") == 0)
+		{
+			if (filename)
+				ereport(ERROR,
+						(errcode(ERRCODE_SYNTAX_ERROR),
+						 errmsg("conflicting or redundant options")));
+			filename = defGetString(def);
+			if (!is_absolute_path(filename))
+				ereport(ERROR,
+						(errcode(ERRCODE_FDW_INVALID_STRING_FORMAT),
+						 errmsg("filename must be an absolute path")));
+		}
+		else if (strcmp(def->defname, "stripe_row_count") == 0)
+			stripe_row_count = get_row_count_option(def);
+		else if (strcmp(def->defname, "block_row_count") == 0)
+		{
+			block_row_count = get_row_count_option(def);
+			if (block_row_count < MIN_BLOCK_ROW_COUNT ||
+				block_row_count > MAX_BLOCK_ROW_COUNT)
+				ereport(ERROR,
+						(errcode(ERRCODE_FDW_INVALID_ATTRIBUTE_VALUE),
+						 errmsg("block_row_count must be between %d and %d",
+								MIN_BLOCK_ROW_COUNT, MAX_BLOCK_ROW_COUNT)));
+		}
+		else if (strcmp(def->defname, "compression") == 0)
+		{
+			char	   *compression = defGetString(def);
+
+			if (strcmp(compression, "none") != 0 &&
+				strcmp(compression, "pglz") != 0)
+				ereport(ERROR,
+						(errcode(ERRCODE_FDW_INVALID_ATTRIBUTE_VALUE),
+						 errmsg("invalid compression \"%s\"", compression),
+						 errhint("Valid compressions are: none, pglz")));
+		}
+	}
+
+	if (stripe_row_count < block_row_count)
+		ereport(ERROR,
+				(errcode(ERRCODE_FDW_INVALID_ATTRIBUTE_VALUE),
+				 errmsg("stripe_row_count must not be less than block_row_count")));
+
+	/*
+	 * Filename option is required for columnar_fdw foreign tables.
+	 */
+	if (catalog == ForeignTableRelationId && filename == NULL)
+		ereport(ERROR,
+				(errcode(ERRCODE_FDW_DYNAMIC_PARAMETER_VALUE_NEEDED),
+				 errmsg("filename is required for columnar_fdw foreign tables")));
+
+	PG_RETURN_VOID();
+}
+
+/*
+ * Check if the provided option is one of the valid options.
+ * context is the Oid of the catalog holding the object the option is for.
+ */
+static bool
+is_valid_option(const char *option, Oid context)
+{
+	const struct ColumnarFdwOption *opt;
+
+	for (opt = valid_options; opt->optname; opt++)
+	{
+		if (context == opt->optcontext && strcmp(opt->optname, option) == 0)
+			return true;
+	}
+	return false;
+}
+
+static int
+get_row_count_option(DefElem *def)
+{
+	int64		value = defGetInt64(def);
+
+	if (value <= 0 || value > PG_INT32_MAX)
+		ereport(ERROR,
+				(errcode(ERRCODE_FDW_INVALID_ATTRIBUTE_VALUE),
+				 errmsg("%s must be a positive integer", def->defname)));
+
+	return (int) value;
+}
+
+/*
+ * Fetch the options for a columnar_fdw foreign table, with defaults filled
+ * in.  Only the table has options, the validator checked them.
+ */
+static ColumnarOptions *
+columnarGetOptions(Oid foreigntableid)
+{
+	ForeignTable *table = GetForeignTable(foreigntableid);
+	ColumnarOptions *options = palloc0(sizeof(ColumnarOptions));
+	ListCell   *lc;
+
+	options->stripe_row_count = DEFAULT_STRIPE_ROW_COUNT;
+	options->block_row_count = DEFAULT_BLOCK_ROW_COUNT;
+	options->compression = COLUMNAR_COMPRESSION_PGLZ;
+
+	foreach(lc, table->options)
+	{
+		DefElem    *def = (DefElem *) lfirst(lc);
+
+		if (strcmp(def->defname, "filename") == 0)
+			options->filename = defGetString(def);
+		else if (strcmp(def->defname, "stripe_row_count") == 0)
+			options->stripe_row_count = get_row_count_option(def);
+		else if (strcmp(def->defname, "block_row_count") == 0)
+			options->block_row_count = get_row_count_option(def);
+		else if (strcmp(def->defname, "compression") == 0 &&
+				 strcmp(defGetString(def), "none") == 0)
+			options->compression = COLUMNAR_COMPRESSION_NONE;
+	}
+
+	/* The validator should have checked that filename was included... */
+	if (options->filename == NULL)
+		elog(ERROR, "filename is required for columnar_fdw foreign tables");
+
+	return options;
+}
+
+/*
+ * columnarGetForeignRelSize
+ *		Obtain relation size estimates for a foreign table
+ */
+static void
+columnarGetForeignRelSize(PlannerInfo *root,
+						  RelOptInfo *baserel,
+						  Oid foreigntableid)
+{
+	ColumnarFdwPlanState *fdw_private;
+	ColumnarFooter *footer;
+	Relation	rel;
+	int			numattrs = 0;
+	double		fraction;
+	int			i;
+
+	fdw_private = (ColumnarFdwPlanState *) palloc(sizeof(ColumnarFdwPlanState));
+	fdw_private->options = columnarGetOptions(foreigntableid);
+
+	rel = heap_open(foreigntableid, AccessShareLock);
+	fdw_private->columns = get_needed_columns(baserel, RelationGetDescr(rel));
+	for (i = 0; i < RelationGetDescr(rel)->natts; i++)
+	{
+		if (!RelationGetDescr(rel)->attrs[i]->attisdropped)
+			numattrs++;
+	}
+	heap_close(rel, AccessShareLock);
+
+	/*
+	 * The footer knows the exact row count.  Only the needed columns are
+	 * read, so scale the size of the data by their share of the columns.
+	 */
+	footer = ColumnarReadFooter(fdw_private->options->filename);
+	fdw_private->ntuples = (double) footer->row_count;
+
+	fraction = numattrs > 0 ?
+		(double) list_length(fdw_private->columns) / numattrs : 1.0;
+	fdw_private->pages = (BlockNumber)
+		ceil((double) footer->data_length * fraction / BLCKSZ);
+	if (fdw_private->pages < 1)
+		fdw_private->pages = 1;
+
+	baserel->fdw_private = (void *) fdw_private;
+	baserel->rows = clamp_row_est(fdw_private->ntuples *
+								  clauselist_selectivity(root,
+													baserel->baserestrictinfo,
+														 0,
+														 JOIN_INNER,
+														 NULL));
+}
+
+/*
+ * columnarGetForeignPaths
+ *		Create possible access paths for a scan on the foreign table
+ *
+ *		Currently we don't support any push-down feature, so there is only one
+ *		possible access path, which simply returns all records in the order in
+ *		the data file.
+ */
+static void
+columnarGetForeignPaths(PlannerInfo *root,
+						RelOptInfo *baserel,
+						Oid foreigntableid)
+{
+	ColumnarFdwPlanState *fdw_private = (ColumnarFdwPlanState *) baserel->fdw_private;
+	Cost		startup_cost;
+	Cost		run_cost = 0;
+	Cost		cpu_per_tuple;
+
+	/*
+	 * Like cost_seqscan() over the pages of the needed columns, with twice
+	 * the CPU cost per tuple to account for decompression.  Skipped blocks
+	 * are not accounted for.
+	 */
+	run_cost += seq_page_cost * fdw_private->pages;
+	startup_cost = baserel->baserestrictcost.startup;
+	cpu_per_tuple = cpu_tuple_cost * 2 + baserel->baserestrictcost.per_tuple;
+	run_cost += cpu_per_tuple * fdw_private->ntuples;
+
+	/*
+	 * The fdw_private list of the path carries the columns to read; it will
+	 * be propagated into the fdw_private list of the Plan node.
+	 */
+	add_path(baserel, (Path *)
+			 create_foreignscan_path(root, baserel,
+									 NULL,		/* default pathtarget */
+									 baserel->rows,
+									 startup_cost,
+									 startup_cost + run_cost,
+									 NIL,		/* no pathkeys */
+									 NULL,		/* no outer rel either */
+									 NULL,		/* no extra plan */
+									 fdw_private->columns));
+}
+
+/*
+ * columnarGetForeignPlan
+ *		Create a ForeignScan plan node for scanning the foreign table
+ */
+static ForeignScan *
+columnarGetForeignPlan(PlannerInfo *root,
+					   RelOptInfo *baserel,
+					   Oid foreigntableid,
+					   ForeignPath *best_path,
+					   List *tlist,
+					   List *scan_clauses,
+					   Plan *outer_plan)
+{
+	Index		scan_relid = baserel->relid;
+
+	/*
+	 * All the scan_clauses go into the plan node's qual list for the
+	 * executor to check; the scan also uses them to skip blocks.
+	 */
+	scan_clauses = extract_actual_clauses(scan_clauses, false);
+
+	/* Create the ForeignScan node */
+	return make_foreignscan(tlist,
+							scan_clauses,
+							scan_relid,
+							NIL,	/* no expressions to evaluate */
+							best_path->fdw_private,
+							NIL,	/* no custom tlist */
+							NIL,	/* no remote quals */
+							outer_plan);
+}
+
+/*
+ * columnarExplainForeignScan
+ *		Produce extra output for EXPLAIN
+ */
+static void
+columnarExplainForeignScan(ForeignScanState *node, ExplainState *es)
+{
+	ColumnarFdwExecutionState *festate = (ColumnarFdwExecutionState *) node->fdw_state;
+	ColumnarOptions *options;
+
+	options = columnarGetOptions(RelationGetRelid(node->ss.ss_currentRelation));
+
+	ExplainPropertyText("Columnar File", options->filename, es);
+
+	/* Suppress file size if we're not showing cost details */
+	if (es->costs)
+	{
+		struct stat stat_buf;
+
+		if (stat(options->filename, &stat_buf) == 0)
+			ExplainPropertyLong("Columnar File Size", (long) stat_buf.st_size,
+								es);
+	}
+
+	if (es->analyze && festate != NULL)
+	{
+		uint64		blocks_read;
+		uint64		blocks_skipped;
+
+		ColumnarReadStats(festate->rstate, &blocks_read, &blocks_skipped);
+		ExplainPropertyLong("Blocks Read", (long) blocks_read, es);
+		ExplainPropertyLong("Blocks Skipped", (long) blocks_skipped, es);
+	}
+}
+
+/*
+ * columnarBeginForeignScan
+ *		Initiate access to the data file
+ */
+static void
+columnarBeginForeignScan(ForeignScanState *node, int eflags)
+{
+	ForeignScan *plan = (ForeignScan *) node->ss.ps.plan;
+	Relation	rel = node->ss.ss_currentRelation;
+	TupleDesc	tupdesc = RelationGetDescr(rel);
+	ColumnarFdwExecutionState *festate;
+	ColumnarOptions *options;
+	bool	   *columns_needed;
+	ListCell   *lc;
+
+	/*
+	 * Do nothing in EXPLAIN (no ANALYZE) case.  node->fdw_state stays NULL.
+	 */
+	if (eflags & EXEC_FLAG_EXPLAIN_ONLY)
+		return;
+
+	options = columnarGetOptions(RelationGetRelid(rel));
+
+	columns_needed = (bool *) palloc0(tupdesc->natts * sizeof(bool));
+	foreach(lc, plan->fdw_private)
+		columns_needed[intVal(lfirst(lc)) - 1] = true;
+
+	festate = (ColumnarFdwExecutionState *) palloc(sizeof(ColumnarFdwExecutionState));
+	festate->rstate = ColumnarBeginRead(options->filename, tupdesc,
+										columns_needed,
+										plan->scan.plan.qual,
+										plan->scan.scanrelid);
+
+	node->fdw_state = (void *) festate;
+}
+
+/*
+ * columnarIterateForeignScan
+ *		Read the next row and store it into the ScanTupleSlot as a virtual
+ *		tuple
+ */
+static TupleTableSlot *
+columnarIterateForeignScan(ForeignScanState *node)
+{
+	ColumnarFdwExecutionState *festate = (ColumnarFdwExecutionState *) node->fdw_state;
+	TupleTableSlot *slot = node->ss.ss_ScanTupleSlot;
+
+	ExecClearTuple(slot);
+	if (ColumnarReadNextRow(festate->rstate,
+							slot->tts_values, slot->tts_isnull))
+		ExecStoreVirtualTuple(slot);
+
+	return slot;
+}
+
+/*
+ * columnarReScanForeignScan
+ *		Rescan table, possibly with new parameters
+ */
+static void
+columnarReScanForeignScan(ForeignScanState *node)
+{
+	ColumnarFdwExecutionState *festate = (ColumnarFdwExecutionState *) node->fdw_state;
+
+	ColumnarRescan(festate->rstate);
+}
+
+/*
+ * columnarEndForeignScan
+ *		Finish scanning foreign table and dispose objects used for this scan
+ */
+static void
+columnarEndForeignScan(ForeignScanState *node)
+{
+	ColumnarFdwExecutionState *festate = (ColumnarFdwExecutionState *) node->fdw_state;
+
+	/* if festate is NULL, we are in EXPLAIN; nothing to do */
+	if (festate)
+		ColumnarEndRead(festate->rstate);
+}
+
+/*
+ * columnarIsForeignRelUpdatable
+ *		Rows can only be appended
+ */
+static int
+columnarIsForeignRelUpdatable(Relation rel)
+{
+	return (1 << CMD_INSERT);
+}
+
+/*
+ * columnarBeginForeignModify
+ *		Start appending to the data file
+ */
+static void
+columnarBeginForeignModify(ModifyTableState *mtstate,
+						   ResultRelInfo *rinfo,
+						   List *fdw_private,
+						   int subplan_index,
+						   int eflags)
+{
+	Relation	rel = rinfo->ri_RelationDesc;
+
+	if (eflags & EXEC_FLAG_EXPLAIN_ONLY)
+		return;
+
+	/*
+	 * Writers append after the stripes the footer lists and replace the
+	 * footer when their transaction commits, so they must take turns until
+	 * then.  Readers are not blocked: they only see the stripes listed when
+	 * they started.
+	 */
+	LockRelationOid(RelationGetRelid(rel), ShareUpdateExclusiveLock);
+
+	rinfo->ri_FdwState = ColumnarBeginWrite(columnarGetOptions(RelationGetRelid(rel)),
+											RelationGetDescr(rel));
+}
+
+/*
+ * columnarExecForeignInsert
+ *		Append one row
+ */
+static TupleTableSlot *
+columnarExecForeignInsert(EState *estate,
+						  ResultRelInfo *rinfo,
+						  TupleTableSlot *slot,
+						  TupleTableSlot *planSlot)
+{
+	slot_getallattrs(slot);
+	ColumnarWriteRow((ColumnarWriteState *) rinfo->ri_FdwState,
+					 slot->tts_values, slot->tts_isnull);
+
+	return slot;
+}
+
+/*
+ * columnarEndForeignModify
+ *		Write out the buffered rows, published when the transaction commits
+ */
+static void
+columnarEndForeignModify(EState *estate, ResultRelInfo *rinfo)
+{
+	/* if ri_FdwState is NULL, we are in EXPLAIN; nothing to do */
+	if (rinfo->ri_FdwState)
+		ColumnarEndWrite((ColumnarWriteState *) rinfo->ri_FdwState);
+}
+
+/*
+ * columnarAnalyzeForeignTable
+ *		Test whether analyzing this foreign table is supported
+ */
+static bool
+columnarAnalyzeForeignTable(Relation relation,
+							AcquireSampleRowsFunc *func,
+							BlockNumber *totalpages)
+{
+	ColumnarOptions *options = columnarGetOptions(RelationGetRelid(relation));
+	ColumnarFooter *footer = ColumnarReadFooter(options->filename);
+
+	/*
+	 * Convert size to pages.  Must return at least 1 so that we can tell
+	 * later on that pg_class.relpages is not default.
+	 */
+	*totalpages = (footer->data_length + (BLCKSZ - 1)) / BLCKSZ;
+	if (*totalpages < 1)
+		*totalpages = 1;
+
+	*func = columnar_acquire_sample_rows;
+
+	return true;
+}
+
+/*
+ * columnarIsForeignScanParallelSafe
+ *		Reading the files works the same in any process, and the footer is
+ *		read when the scan starts.
+ */
+static bool
+columnarIsForeignScanParallelSafe(PlannerInfo *root, RelOptInfo *rel,
+								  RangeTblEntry *rte)
+{
+	return true;
+}
+
+/*
+ * get_needed_columns
+ *		Attribute numbers (as Integer nodes) of the columns the scan must read
+ *
+ * These are the columns needed for joins or final output and those used by
+ * restriction clauses; a whole-row reference needs them all.
+ */
+static List *
+get_needed_columns(RelOptInfo *baserel, TupleDesc tupdesc)
+{
+	Bitmapset  *attrs_used = NULL;
+	List	   *columns = NIL;
+	ListCell   *lc;
+	AttrNumber	attnum;
+
+	pull_varattnos((Node *) baserel->reltarget->exprs, baserel->relid,
+				   &attrs_used);
+	foreach(lc, baserel->baserestrictinfo)
+	{
+		RestrictInfo *rinfo = (RestrictInfo *) lfirst(lc);
+
+		pull_varattnos((Node *) rinfo->clause, baserel->relid,
+					   &attrs_used);
+	}
+
+	if (bms_is_member(0 - FirstLowInvalidHeapAttributeNumber, attrs_used))
+	{
+		for (attnum = 1; attnum <= tupdesc->natts; attnum++)
+		{
+			if (!tupdesc->attrs[attnum - 1]->attisdropped)
+				columns = lappend(columns, makeInteger(attnum));
+		}
+		return columns;
+	}
+
+	while ((attnum = bms_first_member(attrs_used)) >= 0)
+	{
+		/* Adjust for system attributes, which we ignore. */
+		attnum += FirstLowInvalidHeapAttributeNumber;
+		if (attnum <= 0)
+			continue;
+
+		/* Skip dropped attributes (probably shouldn't see any here). */
+		if (tupdesc->attrs[attnum - 1]->attisdropped)
+			continue;
+		columns = lappend(columns, makeInteger(attnum));
+	}
+
+	return columns;
+}
+
+/*
+ * columnar_acquire_sample_rows -- acquire a random sample of rows from the
+ * table
+ *
+ * Selected rows are returned in the caller-allocated array rows[],
+ * which must have at least targrows entries.
+ * The actual number of rows selected is returned as the function result.
+ * We also count the total number of rows in the table and return it into
+ * *totalrows.  Note that *totaldeadrows is always set to 0.
+ */
+static int
+columnar_acquire_sample_rows(Relation onerel, int elevel,
+							 HeapTuple *rows, int targrows,
+							 double *totalrows, double *totaldeadrows)
+{
+	int			numrows = 0;
+	double		rowstoskip = -1;	/* -1 means not set yet */
+	ReservoirStateData rstate;
+	TupleDesc	tupDesc;
+	Datum	   *values;
+	bool	   *nulls;
+	bool	   *columns_needed;
+	ColumnarOptions *options;
+	ColumnarReadState *cstate;
+	int			i;
+
+	Assert(onerel);
+	Assert(targrows > 0);
+
+	tupDesc = RelationGetDescr(onerel);
+	values = (Datum *) palloc(tupDesc->natts * sizeof(Datum));
+	nulls = (bool *) palloc(tupDesc->natts * sizeof(bool));
+	columns_needed = (bool *) palloc(tupDesc->natts * sizeof(bool));
+	for (i = 0; i < tupDesc->natts; i++)
+		columns_needed[i] = true;
+
+	options = columnarGetOptions(RelationGetRelid(onerel));
+	cstate = ColumnarBeginRead(options->filename, tupDesc, columns_needed,
+							   NIL, 0);
+
+	/* Prepare for sampling rows */
+	reservoir_init_selection_state(&rstate, targrows);
+
+	*totalrows = 0;
+	*totaldeadrows = 0;
+	for (;;)
+	{
+		/* Check for user-requested abort or sleep */
+		vacuum_delay_point();
+
+		if (!ColumnarReadNextRow(cstate, values, nulls))
+			break;
+
+		/*
+		 * The first targrows sample rows are simply copied into the
+		 * reservoir.  Then we start replacing tuples in the sample until we
+		 * reach the end of the relation. This algorithm is from Jeff Vitter's
+		 * paper (see more info in commands/analyze.c).
+		 */
+		if (numrows < targrows)
+		{
+			rows[numrows++] = heap_form_tuple(tupDesc, values, nulls);
+		}
+		else
+		{
+			/*
+			 * t in Vitter's paper is the number of records already processed.
+			 * If we need to compute a new S value, we must use the
+			 * not-yet-incremented value of totalrows as t.
+			 */
+			if (rowstoskip < 0)
+				rowstoskip = reservoir_get_next_S(&rstate, *totalrows, targrows);
+
+			if (rowstoskip <= 0)
+			{
+				/*
+				 * Found a suitable tuple, so save it, replacing one old tuple
+				 * at random
+				 */
+				int			k = (int) (targrows * sampler_random_fract(rstate.randstate));
+
+				Assert(k >= 0 && k < targrows);
+				heap_freetuple(rows[k]);
+				rows[k] = heap_form_tuple(tupDesc, values, nulls);
+			}
+
+			rowstoskip -= 1;
+		}
+
+		*totalrows += 1;
+	}
+
+	ColumnarEndRead(cstate);
+
+	pfree(values);
+	pfree(nulls);
+
+	/*
+	 * Emit some interesting relation info
+	 */
+	ereport(elevel,
+			(errmsg("\"%s\": table contains %.0f rows; "
+					"%d rows in sample",
+					RelationGetRelationName(onerel),
+					*totalrows, numrows)));
+
+	return numrows;
+}
@@ -0,0 +1,97 @@
+/*-------------------------------------------------------------------------
+ *
+ * columnar_fdw.h
+ *		  column-oriented, compressed storage for columnar_fdw
+ *
+ * A columnar table lives in two files: the data file, made of stripes
+ * appended one after another, and a small footer file listing the stripes
+ * which make up the table.  A stripe stores its rows column by column, cut
+ * into blocks of a fixed number of rows.  Each stripe starts with a skip
+ * list recording, per column and block, where the block is and the min and
+ * max of its values, so that readers fetch only the columns they need and
+ * skip blocks which cannot match the scan quals.
+ *
+ * Portions Copyright (c) 2016-2017, ADB Development Group
+ *
+ * IDENTIFICATION
+ *		  contrib/columnar_fdw/columnar_fdw.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef COLUMNAR_FDW_H
+#define COLUMNAR_FDW_H
+
+#include "access/tupdesc.h"
+#include "nodes/pg_list.h"
+
+#define COLUMNAR_MAGIC				0x43424441	/* "ADBC" */
+#define COLUMNAR_VERSION			1
+#define COLUMNAR_FOOTER_SUFFIX		".footer"
+
+#define DEFAULT_STRIPE_ROW_COUNT	150000
+#define DEFAULT_BLOCK_ROW_COUNT		10000
+#define MIN_BLOCK_ROW_COUNT			1000
+#define MAX_BLOCK_ROW_COUNT			100000
+
+typedef enum ColumnarCompression
+{
+	COLUMNAR_COMPRESSION_NONE = 0,
+	COLUMNAR_COMPRESSION_PGLZ
+} ColumnarCompression;
+
+/*
+ * Options of a columnar foreign table
+ */
+typedef struct ColumnarOptions
+{
+	char	   *filename;			/* data file, footer is next to it */
+	int			stripe_row_count;	/* rows per stripe */
+	int			block_row_count;	/* rows per block */
+	ColumnarCompression compression;
+} ColumnarOptions;
+
+/*
+ * Location of a stripe in the data file
+ */
+typedef struct StripeMetadata
+{
+	uint64		offset;
+	uint64		length;
+	uint64		row_count;
+} StripeMetadata;
+
+/*
+ * Contents of the footer file
+ */
+typedef struct ColumnarFooter
+{
+	List	   *stripes;			/* list of StripeMetadata */
+	uint64		data_length;		/* end of the last stripe */
+	uint64		row_count;			/* rows in all stripes */
+} ColumnarFooter;
+
+typedef struct ColumnarWriteState ColumnarWriteState;
+typedef struct ColumnarReadState ColumnarReadState;
+
+/* columnar_storage.c */
+extern char *ColumnarFooterPath(const char *filename);
+extern ColumnarFooter *ColumnarReadFooter(const char *filename);
+
+extern ColumnarWriteState *ColumnarBeginWrite(ColumnarOptions *options,
+											  TupleDesc tupdesc);
+extern void ColumnarWriteRow(ColumnarWriteState *state,
+							 Datum *values, bool *nulls);
+extern void ColumnarEndWrite(ColumnarWriteState *state);
+
+extern ColumnarReadState *ColumnarBeginRead(const char *filename,
+											TupleDesc tupdesc,
+											bool *columns_needed,
+											List *quals, Index varno);
+extern bool ColumnarReadNextRow(ColumnarReadState *state,
+								Datum *values, bool *nulls);
+extern void ColumnarRescan(ColumnarReadState *state);
+extern void ColumnarEndRead(ColumnarReadState *state);
+extern void ColumnarReadStats(ColumnarReadState *state,
+							  uint64 *blocks_read, uint64 *blocks_skipped);
+
+#endif   /* COLUMNAR_FDW_H */
@@ -0,0 +1,1528 @@
+/*-------------------------------------------------------------------------
+ *
+ * columnar_storage.c
+ *		  reading and writing the files of columnar_fdw tables
+ *
+ * Rows are collected a block at a time.  A full block is serialized column
+ * by column, each column compressed on its own, and appended to the buffer
+ * of its column; a full stripe then goes to the data file as the skip list
+ * followed by the buffers of all columns.  Once the data is synced, the
+ * new footer is kept with the transaction, and only written when it
+ * commits.  Until then other backends see the footer of before, and an
+ * aborted write leaves only bytes past the end that footer knows about,
+ * which the next writer truncates away.
+ *
+ * Readers load the skip list of one stripe at a time, test each block's
+ * min/max against the scan quals, and decompress the needed columns of the
+ * surviving blocks a whole block at a time.
+ *
+ * Portions Copyright (c) 2016-2017, ADB Development Group
+ *
+ * IDENTIFICATION
+ *		  contrib/columnar_fdw/columnar_storage.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "access/nbtree.h"
+#include "access/sysattr.h"
+#include "access/tupmacs.h"
+#include "access/xact.h"
+#include "catalog/pg_type.h"
+#include "common/pg_lzcompress.h"
+#include "fmgr.h"
+#include "miscadmin.h"
+#include "nodes/makefuncs.h"
+#include "nodes/nodeFuncs.h"
+#include "optimizer/clauses.h"
+#include "optimizer/predtest.h"
+#include "optimizer/var.h"
+#include "storage/fd.h"
+#include "utils/datum.h"
+#include "utils/lsyscache.h"
+#include "utils/memutils.h"
+#include "utils/typcache.h"
+
+#include "columnar_fdw.h"
+
+/* longer values are not kept as block min/max */
+#define MAX_MIN_MAX_SIZE	1024
+
+/*
+ * Skip list entry: one block of one column
+ */
+typedef struct ColumnBlockSkipNode
+{
+	bool		has_nulls;
+	bool		has_values;
+	bool		has_min_max;
+	Datum		min_value;
+	Datum		max_value;
+	uint64		exists_offset;		/* from the start of the stripe data */
+	uint32		exists_length;		/* MAXALIGN'd, values follow */
+	uint32		value_length;		/* as stored */
+	uint32		value_raw_length;	/* before compression */
+	uint8		value_compression;
+} ColumnBlockSkipNode;
+
+/*
+ * Skip list of a stripe
+ */
+typedef struct StripeSkipList
+{
+	uint32		natts;
+	uint32		block_count;
+	uint32	   *block_row_counts;
+	Oid		   *typids;				/* InvalidOid for dropped columns */
+	ColumnBlockSkipNode **blocks;	/* [natts][block_count] */
+} StripeSkipList;
+
+struct ColumnarWriteState
+{
+	ColumnarOptions *options;
+	TupleDesc	tupdesc;
+	ColumnarFooter *footer;
+	MemoryContext context;			/* the state and the footer */
+	int			fd;
+	bool		dirty;				/* any stripe written? */
+
+	MemoryContext stripe_context;	/* column buffers and skip list */
+	MemoryContext block_context;	/* values of the current block */
+	FmgrInfo  **cmp_procs;			/* btree comparators, NULL if none */
+	StringInfoData compress_buffer;
+
+	/* current block */
+	uint32		block_rows;
+	Datum	  **block_values;		/* [natts][block_row_count] */
+	bool	  **block_nulls;
+
+	/* current stripe */
+	uint32		stripe_rows;
+	uint32		stripe_blocks;
+	uint32		max_stripe_blocks;
+	uint32	   *block_row_counts;
+	StringInfo *column_buffers;
+	ColumnBlockSkipNode **skip_nodes;	/* [natts][max_stripe_blocks] */
+};
+
+struct ColumnarReadState
+{
+	char	   *filename;
+	TupleDesc	tupdesc;
+	bool	   *columns_needed;
+	bool	   *columns_in_quals;
+	List	   *quals;
+	Index		varno;
+	ColumnarFooter *footer;
+	int			fd;					/* -1 until a stripe is read */
+
+	/* btree operators building block constraints, per column */
+	Oid		   *ge_operators;
+	Oid		   *le_operators;
+	Oid		   *op_types;
+
+	MemoryContext stripe_context;	/* skip list of the current stripe */
+	MemoryContext block_context;	/* values of the current block */
+
+	ListCell   *next_stripe;
+	StripeSkipList *skip_list;
+	uint64		stripe_data_offset;
+	uint32		next_block;
+
+	/* current block */
+	uint32		block_rows;
+	uint32		next_row;
+	Datum	  **block_values;		/* NULL for columns not read */
+	bool	  **block_nulls;
+
+	uint64		blocks_read;
+	uint64		blocks_skipped;
+};
+
+/*
+ * Footer written by the current transaction, see ColumnarEndWrite
+ */
+typedef struct PendingFooter
+{
+	char	   *filename;
+	ColumnarFooter *footer;
+	SubTransactionId subid;		/* subtransaction which wrote it */
+} PendingFooter;
+
+/* list of PendingFooter in TopTransactionContext, latest last */
+static List *pending_footers = NIL;
+static bool xact_callback_registered = false;
+
+static ColumnarFooter *CopyFooter(ColumnarFooter *footer);
+static PendingFooter *FindPendingFooter(const char *filename);
+static void ColumnarXactCallback(XactEvent event, void *arg);
+static void ColumnarSubXactCallback(SubXactEvent event, SubTransactionId mySubid,
+						SubTransactionId parentSubid, void *arg);
+static void ColumnarWriteFooter(const char *filename, ColumnarFooter *footer);
+static void ColumnarStartStripe(ColumnarWriteState *state);
+static void ColumnarFlushBlock(ColumnarWriteState *state);
+static void ColumnarFlushStripe(ColumnarWriteState *state);
+static void SerializeDatum(StringInfo buf, Datum value, Form_pg_attribute attr);
+static void SerializeSkipList(StringInfo buf, ColumnarWriteState *state);
+static StripeSkipList *DeserializeSkipList(StringInfo buf, const char *filename);
+static bool ColumnarLoadNextStripe(ColumnarReadState *state);
+static bool ColumnarLoadNextBlock(ColumnarReadState *state);
+static void ColumnarLoadColumn(ColumnarReadState *state, int attno, uint32 block);
+static bool ColumnarBlockRefuted(ColumnarReadState *state, uint32 block);
+static void read_at(int fd, uint64 offset, char *buf, uint32 len,
+		const char *filename);
+static void write_all(int fd, const char *buf, Size len, const char *filename);
+static void put_uint8(StringInfo buf, uint8 value);
+static void put_uint32(StringInfo buf, uint32 value);
+static void put_uint64(StringInfo buf, uint64 value);
+static void put_min_max(StringInfo buf, Datum value, int16 typlen, bool typbyval);
+static void get_bytes(StringInfo buf, void *dest, int len, const char *filename);
+static uint8 get_uint8(StringInfo buf, const char *filename);
+static uint32 get_uint32(StringInfo buf, const char *filename);
+static uint64 get_uint64(StringInfo buf, const char *filename);
+static Datum get_min_max(StringInfo buf, int16 typlen, bool typbyval,
+			const char *filename);
+
+/*
+ * ColumnarFooterPath
+ *		Path of the footer file of a data file
+ */
+char *
+ColumnarFooterPath(const char *filename)
+{
+	return psprintf("%s%s", filename, COLUMNAR_FOOTER_SUFFIX);
+}
+
+/*
+ * ColumnarReadFooter
+ *		Read the footer of a data file, no stripes if there is none yet
+ *
+ * The current transaction sees the stripes it wrote itself.
+ */
+ColumnarFooter *
+ColumnarReadFooter(const char *filename)
+{
+	ColumnarFooter *footer;
+	PendingFooter *pending;
+	char	   *path;
+	StringInfoData buf;
+	struct stat stat_buf;
+	uint32		nstripes;
+	uint32		i;
+	int			fd;
+
+	if ((pending = FindPendingFooter(filename)) != NULL)
+		return CopyFooter(pending->footer);
+
+	footer = (ColumnarFooter *) palloc0(sizeof(ColumnarFooter));
+	path = ColumnarFooterPath(filename);
+	fd = OpenTransientFile(path, O_RDONLY | PG_BINARY, 0);
+	if (fd < 0)
+	{
+		if (errno == ENOENT)
+			return footer;
+		ereport(ERROR,
+				(errcode_for_file_access(),
+				 errmsg("could not open file \"%s\": %m", path)));
+	}
+
+	if (fstat(fd, &stat_buf) < 0)
+		ereport(ERROR,
+				(errcode_for_file_access(),
+				 errmsg("could not stat file \"%s\": %m", path)));
+
+	initStringInfo(&buf);
+	enlargeStringInfo(&buf, (int) stat_buf.st_size);
+	read_at(fd, 0, buf.data, (uint32) stat_buf.st_size, path);
+	buf.len = (int) stat_buf.st_size;
+	CloseTransientFile(fd);
+
+	if (get_uint32(&buf, path) != COLUMNAR_MAGIC)
+		ereport(ERROR,
+				(errcode(ERRCODE_DATA_CORRUPTED),
+				 errmsg("\"%s\" is not a columnar footer file", path)));
+	if (get_uint32(&buf, path) != COLUMNAR_VERSION)
+		ereport(ERROR,
+				(errcode(ERRCODE_DATA_CORRUPTED),
+				 errmsg("columnar footer file \"%s\" has an unsupported version",
+						path)));
+
+	nstripes = get_uint32(&buf, path);
+	for (i = 0; i < nstripes; i++)
+	{
+		StripeMetadata *stripe = palloc(sizeof(StripeMetadata));
+
+		stripe->offset = get_uint64(&buf, path);
+		stripe->length = get_uint64(&buf, path);
+		stripe->row_count = get_uint64(&buf, path);
+
+		footer->stripes = lappend(footer->stripes, stripe);
+		footer->data_length = stripe->offset + stripe->length;
+		footer->row_count += stripe->row_count;
+	}
+
+	pfree(buf.data);
+	pfree(path);
+
+	return footer;
+}
+
+/*
+ * CopyFooter
+ *		Copy a footer and its stripes into the current memory context
+ */
+static ColumnarFooter *
+CopyFooter(ColumnarFooter *footer)
+{
+	ColumnarFooter *copy = (ColumnarFooter *) palloc(sizeof(ColumnarFooter));
+	ListCell   *lc;
+
+	*copy = *footer;
+	copy->stripes = NIL;
+	foreach(lc, footer->stripes)
+	{
+		StripeMetadata *stripe = (StripeMetadata *) palloc(sizeof(StripeMetadata));
+
+		*stripe = *(StripeMetadata *) lfirst(lc);
+		copy->stripes = lappend(copy->stripes, stripe);
+	}
+
+	return copy;
+}
+
+/*
+ * FindPendingFooter
+ *		Latest footer the current transaction wrote for a data file, or NULL
+ */
+static PendingFooter *
+FindPendingFooter(const char *filename)
+{
+	PendingFooter *result = NULL;
+	ListCell   *lc;
+
+	foreach(lc, pending_footers)
+	{
+		PendingFooter *pending = (PendingFooter *) lfirst(lc);
+
+		if (strcmp(pending->filename, filename) == 0)
+			result = pending;
+	}
+
+	return result;
+}
+
+/*
+ * ColumnarXactCallback
+ *		Publish the footers of the transaction when it commits
+ *
+ * Footers are written before the commit record, so an error here still
+ * aborts the transaction.  A prepared transaction publishes its rows when
+ * it is prepared, as nothing of the FDW survives until COMMIT PREPARED.
+ */
+static void
+ColumnarXactCallback(XactEvent event, void *arg)
+{
+	List	   *written = NIL;
+	ListCell   *lc;
+	int			i;
+
+	switch (event)
+	{
+		case XACT_EVENT_PRE_COMMIT:
+		case XACT_EVENT_PARALLEL_PRE_COMMIT:
+		case XACT_EVENT_PRE_PREPARE:
+			/* the latest footer of each file, so walk the list backwards */
+			for (i = list_length(pending_footers) - 1; i >= 0; i--)
+			{
+				PendingFooter *pending = (PendingFooter *) list_nth(pending_footers, i);
+				bool		done = false;
+
+				foreach(lc, written)
+				{
+					if (strcmp((char *) lfirst(lc), pending->filename) == 0)
+						done = true;
+				}
+				if (done)
+					continue;
+
+				ColumnarWriteFooter(pending->filename, pending->footer);
+				written = lappend(written, pending->filename);
+			}
+			list_free(written);
+			pending_footers = NIL;
+			break;
+		default:
+			/* the list went away with TopTransactionContext */
+			pending_footers = NIL;
+			break;
+	}
+}
+
+/*
+ * ColumnarSubXactCallback
+ *		Forget the footers of an aborted subtransaction, hand those of a
+ *		committed one to its parent
+ */
+static void
+ColumnarSubXactCallback(SubXactEvent event, SubTransactionId mySubid,
+						SubTransactionId parentSubid, void *arg)
+{
+	ListCell   *lc;
+	ListCell   *prev = NULL;
+	ListCell   *next;
+
+	if (event != SUBXACT_EVENT_ABORT_SUB &&
+		event != SUBXACT_EVENT_COMMIT_SUB)
+		return;
+
+	for (lc = list_head(pending_footers); lc != NULL; lc = next)
+	{
+		PendingFooter *pending = (PendingFooter *) lfirst(lc);
+
+		next = lnext(lc);
+		if (pending->subid != mySubid)
+		{
+			prev = lc;
+			continue;
+		}
+
+		if (event == SUBXACT_EVENT_COMMIT_SUB)
+		{
+			pending->subid = parentSubid;
+			prev = lc;
+		}
+		else
+			pending_footers = list_delete_cell(pending_footers, lc, prev);
+	}
+}
+
+/*
+ * ColumnarWriteFooter
+ *		Replace the footer of a data file, durably
+ */
+static void
+ColumnarWriteFooter(const char *filename, ColumnarFooter *footer)
+{
+	char	   *path = ColumnarFooterPath(filename);
+	char	   *tmppath = psprintf("%s.tmp", path);
+	StringInfoData buf;
+	ListCell   *lc;
+	int			fd;
+
+	initStringInfo(&buf);
+	put_uint32(&buf, COLUMNAR_MAGIC);
+	put_uint32(&buf, COLUMNAR_VERSION);
+	put_uint32(&buf, (uint32) list_length(footer->stripes));
+	foreach(lc, footer->stripes)
+	{
+		StripeMetadata *stripe = (StripeMetadata *) lfirst(lc);
+
+		put_uint64(&buf, stripe->offset);
+		put_uint64(&buf, stripe->length);
+		put_uint64(&buf, stripe->row_count);
+	}
+
+	fd = OpenTransientFile(tmppath, O_RDWR | O_CREAT | O_TRUNC | PG_BINARY,
+						   S_IRUSR | S_IWUSR);
+	if (fd < 0)
+		ereport(ERROR,
+				(errcode_for_file_access(),
+				 errmsg("could not create file \"%s\": %m", tmppath)));
+	write_all(fd, buf.data, buf.len, tmppath);
+	if (pg_fsync(fd) != 0)
+		ereport(ERROR,
+				(errcode_for_file_access(),
+				 errmsg("could not fsync file \"%s\": %m", tmppath)));
+	CloseTransientFile(fd);
+
+	(void) durable_rename(tmppath, path, ERROR);
+
+	pfree(buf.data);
+	pfree(tmppath);
+	pfree(path);
+}
+
+/*
+ * ColumnarBeginWrite
+ *		Start appending rows to the table in options->filename
+ *
+ * The caller makes sure no one else writes the table until the end of the
+ * transaction.
+ */
+ColumnarWriteState *
+ColumnarBeginWrite(ColumnarOptions *options, TupleDesc tupdesc)
+{
+	ColumnarWriteState *state;
+	int			natts = tupdesc->natts;
+	int			i;
+
+	state = (ColumnarWriteState *) palloc0(sizeof(ColumnarWriteState));
+	state->options = options;
+	state->tupdesc = tupdesc;
+	state->context = CurrentMemoryContext;
+	state->footer = ColumnarReadFooter(options->filename);
+
+	state->fd = OpenTransientFile(options->filename,
+								  O_RDWR | O_CREAT | PG_BINARY,
+								  S_IRUSR | S_IWUSR);
+	if (state->fd < 0)
+		ereport(ERROR,
+				(errcode_for_file_access(),
+				 errmsg("could not open file \"%s\": %m", options->filename)));
+
+	/* drop whatever a failed writer left past the known stripes */
+	if (ftruncate(state->fd, (off_t) state->footer->data_length) < 0)
+		ereport(ERROR,
+				(errcode_for_file_access(),
+				 errmsg("could not truncate file \"%s\": %m",
+						options->filename)));
+
+	state->stripe_context = AllocSetContextCreate(CurrentMemoryContext,
+												  "columnar stripe context",
+												  ALLOCSET_DEFAULT_SIZES);
+	state->block_context = AllocSetContextCreate(CurrentMemoryContext,
+												 "columnar block context",
+												 ALLOCSET_DEFAULT_SIZES);
+	initStringInfo(&state->compress_buffer);
+
+	state->cmp_procs = (FmgrInfo **) palloc0(natts * sizeof(FmgrInfo *));
+	state->block_values = (Datum **) palloc(natts * sizeof(Datum *));
+	state->block_nulls = (bool **) palloc(natts * sizeof(bool *));
+	for (i = 0; i < natts; i++)
+	{
+		Form_pg_attribute attr = tupdesc->attrs[i];
+
+		state->block_values[i] = (Datum *)
+			palloc(options->block_row_count * sizeof(Datum));
+		state->block_nulls[i] = (bool *)
+			palloc(options->block_row_count * sizeof(bool));
+
+		if (!attr->attisdropped)
+		{
+			TypeCacheEntry *typentry;
+
+			typentry = lookup_type_cache(attr->atttypid,
+										 TYPECACHE_CMP_PROC_FINFO);
+			if (OidIsValid(typentry->cmp_proc_finfo.fn_oid))
+				state->cmp_procs[i] = &typentry->cmp_proc_finfo;
+		}
+	}
+
+	state->max_stripe_blocks = (options->stripe_row_count +
+								options->block_row_count - 1) /
+		options->block_row_count;
+	ColumnarStartStripe(state);
+
+	return state;
+}
+
+/*
+ * ColumnarWriteRow
+ *		Add a row to the current block, flushing what is full
+ */
+void
+ColumnarWriteRow(ColumnarWriteState *state, Datum *values, bool *nulls)
+{
+	TupleDesc	tupdesc = state->tupdesc;
+	uint32		row = state->block_rows;
+	MemoryContext oldcontext;
+	int			i;
+
+	oldcontext = MemoryContextSwitchTo(state->block_context);
+	for (i = 0; i < tupdesc->natts; i++)
+	{
+		Form_pg_attribute attr = tupdesc->attrs[i];
+
+		if (nulls[i] || attr->attisdropped)
+		{
+			state->block_nulls[i][row] = true;
+			state->block_values[i][row] = (Datum) 0;
+			continue;
+		}
+
+		state->block_nulls[i][row] = false;
+		if (attr->attlen == -1)
+			state->block_values[i][row] =
+				PointerGetDatum(PG_DETOAST_DATUM_COPY(values[i]));
+		else
+			state->block_values[i][row] =
+				datumCopy(values[i], attr->attbyval, attr->attlen);
+	}
+	MemoryContextSwitchTo(oldcontext);
+
+	state->block_rows++;
+	state->stripe_rows++;
+
+	if (state->stripe_rows == state->options->stripe_row_count)
+		ColumnarFlushStripe(state);
+	else if (state->block_rows == state->options->block_row_count)
+		ColumnarFlushBlock(state);
+}
+
+/*
+ * ColumnarEndWrite
+ *		Write out the rows still buffered, to be published in the footer
+ *		when the transaction commits
+ */
+void
+ColumnarEndWrite(ColumnarWriteState *state)
+{
+	ColumnarFlushStripe(state);
+
+	if (state->dirty)
+	{
+		MemoryContext oldcontext;
+		PendingFooter *pending;
+
+		if (pg_fsync(state->fd) != 0)
+			ereport(ERROR,
+					(errcode_for_file_access(),
+					 errmsg("could not fsync file \"%s\": %m",
+							state->options->filename)));
+
+		if (!xact_callback_registered)
+		{
+			RegisterXactCallback(ColumnarXactCallback, NULL);
+			RegisterSubXactCallback(ColumnarSubXactCallback, NULL);
+			xact_callback_registered = true;
+		}
+
+		oldcontext = MemoryContextSwitchTo(TopTransactionContext);
+		pending = (PendingFooter *) palloc(sizeof(PendingFooter));
+		pending->filename = pstrdup(state->options->filename);
+		pending->footer = CopyFooter(state->footer);
+		pending->subid = GetCurrentSubTransactionId();
+		pending_footers = lappend(pending_footers, pending);
+		MemoryContextSwitchTo(oldcontext);
+	}
+
+	CloseTransientFile(state->fd);
+	MemoryContextDelete(state->stripe_context);
+	MemoryContextDelete(state->block_context);
+}
+
+static void
+ColumnarStartStripe(ColumnarWriteState *state)
+{
+	int			natts = state->tupdesc->natts;
+	MemoryContext oldcontext;
+	int			i;
+
+	oldcontext = MemoryContextSwitchTo(state->stripe_context);
+
+	state->stripe_rows = 0;
+	state->stripe_blocks = 0;
+	state->block_row_counts = (uint32 *)
+		palloc(state->max_stripe_blocks * sizeof(uint32));
+	state->column_buffers = (StringInfo *) palloc(natts * sizeof(StringInfo));
+	state->skip_nodes = (ColumnBlockSkipNode **)
+		palloc(natts * sizeof(ColumnBlockSkipNode *));
+	for (i = 0; i < natts; i++)
+	{
+		state->column_buffers[i] = makeStringInfo();
+		state->skip_nodes[i] = (ColumnBlockSkipNode *)
+			palloc0(state->max_stripe_blocks * sizeof(ColumnBlockSkipNode));
+	}
+
+	MemoryContextSwitchTo(oldcontext);
+}
+
+/*
+ * ColumnarFlushBlock
+ *		Serialize and compress the current block into the column buffers
+ */
+static void
+ColumnarFlushBlock(ColumnarWriteState *state)
+{
+	TupleDesc	tupdesc = state->tupdesc;
+	uint32		rows = state->block_rows;
+	uint32		block = state->stripe_blocks;
+	StringInfoData values;
+	MemoryContext oldcontext;
+	int			i;
+
+	if (rows == 0)
+		return;
+
+	Assert(block < state->max_stripe_blocks);
+	oldcontext = MemoryContextSwitchTo(state->block_context);
+	initStringInfo(&values);
+
+	for (i = 0; i < tupdesc->natts; i++)
+	{
+		Form_pg_attribute attr = tupdesc->attrs[i];
+		ColumnBlockSkipNode *node = &state->skip_nodes[i][block];
+		StringInfo	buf = state->column_buffers[i];
+		FmgrInfo   *cmp = state->cmp_procs[i];
+		Datum		min_value = (Datum) 0;
+		Datum		max_value = (Datum) 0;
+		uint32		bitmap_length = (rows + 7) / 8;
+		uint32		row;
+		int32		compressed_length = -1;
+
+		/* existence bitmap, padded so that the values stay aligned */
+		node->exists_offset = buf->len;
+		node->exists_length = MAXALIGN(bitmap_length);
+		enlargeStringInfo(buf, node->exists_length);
+		MemSet(buf->data + buf->len, 0, node->exists_length);
+
+		resetStringInfo(&values);
+		for (row = 0; row < rows; row++)
+		{
+			Datum		value = state->block_values[i][row];
+
+			if (state->block_nulls[i][row])
+			{
+				node->has_nulls = true;
+				continue;
+			}
+
+			buf->data[buf->len + row / 8] |= (1 << (row % 8));
+			SerializeDatum(&values, value, attr);
+
+			if (cmp == NULL)
+				;
+			else if (!node->has_values)
+				min_value = max_value = value;
+			else if (DatumGetInt32(FunctionCall2Coll(cmp, attr->attcollation,
+													 value, min_value)) < 0)
+				min_value = value;
+			else if (DatumGetInt32(FunctionCall2Coll(cmp, attr->attcollation,
+													 value, max_value)) > 0)
+				max_value = value;
+			node->has_values = true;
+		}
+		buf->len += node->exists_length;
+
+		/* values, compressed when it pays */
+		node->value_raw_length = values.len;
+		if (state->options->compression == COLUMNAR_COMPRESSION_PGLZ &&
+			values.len > 0)
+		{
+			resetStringInfo(&state->compress_buffer);
+			enlargeStringInfo(&state->compress_buffer,
+							  PGLZ_MAX_OUTPUT(values.len));
+			compressed_length = pglz_compress(values.data, values.len,
+											  state->compress_buffer.data,
+											  PGLZ_strategy_default);
+		}
+		if (compressed_length >= 0)
+		{
+			node->value_compression = COLUMNAR_COMPRESSION_PGLZ;
+			node->value_length = compressed_length;
+			appendBinaryStringInfo(buf, state->compress_buffer.data,
+								   compressed_length);
+		}
+		else
+		{
+			node->value_compression = COLUMNAR_COMPRESSION_NONE;
+			node->value_length = values.len;
+			appendBinaryStringInfo(buf, values.data, values.len);
+		}
+
+		if (cmp != NULL && node->has_values &&
+			(attr->attlen != -1 ||
+			 (VARSIZE_ANY(DatumGetPointer(min_value)) <= MAX_MIN_MAX_SIZE &&
+			  VARSIZE_ANY(DatumGetPointer(max_value)) <= MAX_MIN_MAX_SIZE)))
+		{
+			MemoryContextSwitchTo(state->stripe_context);
+			node->has_min_max = true;
+			node->min_value = datumCopy(min_value, attr->attbyval, attr->attlen);
+			node->max_value = datumCopy(max_value, attr->attbyval, attr->attlen);
+			MemoryContextSwitchTo(state->block_context);
+		}
+	}
+
+	MemoryContextSwitchTo(oldcontext);
+	MemoryContextReset(state->block_context);
+
+	state->block_row_counts[block] = rows;
+	state->stripe_blocks++;
+	state->block_rows = 0;
+}
+
+/*
+ * ColumnarFlushStripe
+ *		Append the current stripe to the data file
+ */
+static void
+ColumnarFlushStripe(ColumnarWriteState *state)
+{
+	int			natts = state->tupdesc->natts;
+	StripeMetadata *stripe;
+	StringInfoData skip_list;
+	MemoryContext oldcontext;
+	uint64		column_offset = 0;
+	uint32		length;
+	int			i;
+	uint32		block;
+
+	ColumnarFlushBlock(state);
+	if (state->stripe_rows == 0)
+		return;
+
+	/* columns follow each other after the skip list */
+	for (i = 0; i < natts; i++)
+	{
+		for (block = 0; block < state->stripe_blocks; block++)
+			state->skip_nodes[i][block].exists_offset += column_offset;
+		column_offset += state->column_buffers[i]->len;
+	}
+
+	oldcontext = MemoryContextSwitchTo(state->stripe_context);
+	initStringInfo(&skip_list);
+	SerializeSkipList(&skip_list, state);
+	MemoryContextSwitchTo(state->context);
+
+	length = skip_list.len;
+	write_all(state->fd, (char *) &length, sizeof(length),
+			  state->options->filename);
+	write_all(state->fd, skip_list.data, skip_list.len,
+			  state->options->filename);
+	for (i = 0; i < natts; i++)
+		write_all(state->fd, state->column_buffers[i]->data,
+				  state->column_buffers[i]->len, state->options->filename);
+
+	stripe = (StripeMetadata *) palloc(sizeof(StripeMetadata));
+	stripe->offset = state->footer->data_length;
+	stripe->length = sizeof(length) + skip_list.len + column_offset;
+	stripe->row_count = state->stripe_rows;
+	state->footer->stripes = lappend(state->footer->stripes, stripe);
+	state->footer->data_length += stripe->length;
+	state->footer->row_count += stripe->row_count;
+	state->dirty = true;
+	MemoryContextSwitchTo(oldcontext);
+
+	MemoryContextReset(state->stripe_context);
+	ColumnarStartStripe(state);
+}
+
+/*
+ * SerializeDatum
+ *		Append a value the way heap tuples lay out their attributes
+ *
+ * The buffer starts MAXALIGN'd when read back, so offsets aligned from the
+ * start of the buffer are aligned in memory.  Padding is zeroed, which lets
+ * att_align_pointer() tell short varlenas from padding.
+ */
+static void
+SerializeDatum(StringInfo buf, Datum value, Form_pg_attribute attr)
+{
+	Pointer		val = DatumGetPointer(value);
+	int			aligned;
+	Size		data_length;
+
+	if (attr->attlen == -1 && attr->attstorage != 'p' &&
+		VARATT_CAN_MAKE_SHORT(val))
+	{
+		/* convert to short varlena, no alignment needed */
+		data_length = VARATT_CONVERTED_SHORT_SIZE(val);
+		enlargeStringInfo(buf, data_length);
+		SET_VARSIZE_SHORT(buf->data + buf->len, data_length);
+		memcpy(buf->data + buf->len + 1, VARDATA(val), data_length - 1);
+		buf->len += data_length;
+		return;
+	}
+
+	aligned = att_align_nominal(buf->len, attr->attalign);
+	enlargeStringInfo(buf, aligned - buf->len);
+	MemSet(buf->data + buf->len, 0, aligned - buf->len);
+	buf->len = aligned;
+
+	if (attr->attbyval)
+	{
+		enlargeStringInfo(buf, attr->attlen);
+		store_att_byval(buf->data + buf->len, value, attr->attlen);
+		buf->len += attr->attlen;
+		return;
+	}
+
+	if (attr->attlen == -1)
+		data_length = VARSIZE(val);
+	else if (attr->attlen == -2)
+		data_length = strlen(val) + 1;
+	else
+		data_length = attr->attlen;
+	appendBinaryStringInfo(buf, val, data_length);
+}
+
+static void
+SerializeSkipList(StringInfo buf, ColumnarWriteState *state)
+{
+	TupleDesc	tupdesc = state->tupdesc;
+	uint32		block;
+	int			i;
+
+	put_uint32(buf, tupdesc->natts);
+	put_uint32(buf, state->stripe_blocks);
+	for (block = 0; block < state->stripe_blocks; block++)
+		put_uint32(buf, state->block_row_counts[block]);
+
+	for (i = 0; i < tupdesc->natts; i++)
+	{
+		Form_pg_attribute attr = tupdesc->attrs[i];
+
+		put_uint32(buf, attr->attisdropped ? InvalidOid : attr->atttypid);
+		for (block = 0; block < state->stripe_blocks; block++)
+		{
+			ColumnBlockSkipNode *node = &state->skip_nodes[i][block];
+
+			put_uint8(buf, node->has_nulls);
+			put_uint8(buf, node->has_values);
+			put_uint8(buf, node->has_min_max);
+			if (node->has_min_max)
+			{
+				put_min_max(buf, node->min_value, attr->attlen, attr->attbyval);
+				put_min_max(buf, node->max_value, attr->attlen, attr->attbyval);
+			}
+			put_uint64(buf, node->exists_offset);
+			put_uint32(buf, node->exists_length);
+			put_uint32(buf, node->value_length);
+			put_uint32(buf, node->value_raw_length);
+			put_uint8(buf, node->value_compression);
+		}
+	}
+}
+
+static StripeSkipList *
+DeserializeSkipList(StringInfo buf, const char *filename)
+{
+	StripeSkipList *skip_list = palloc(sizeof(StripeSkipList));
+	uint32		block;
+	uint32		i;
+
+	skip_list->natts = get_uint32(buf, filename);
+	skip_list->block_count = get_uint32(buf, filename);
+	if (skip_list->block_count > (uint32) (buf->len / sizeof(uint32)))
+		ereport(ERROR,
+				(errcode(ERRCODE_DATA_CORRUPTED),
+				 errmsg("columnar file \"%s\" is corrupted", filename)));
+
+	skip_list->block_row_counts = (uint32 *)
+		palloc(skip_list->block_count * sizeof(uint32));
+	for (block = 0; block < skip_list->block_count; block++)
+		skip_list->block_row_counts[block] = get_uint32(buf, filename);
+
+	skip_list->typids = (Oid *) palloc(skip_list->natts * sizeof(Oid));
+	skip_list->blocks = (ColumnBlockSkipNode **)
+		palloc(skip_list->natts * sizeof(ColumnBlockSkipNode *));
+	for (i = 0; i < skip_list->natts; i++)
+	{
+		Oid			typid = get_uint32(buf, filename);
+		int16		typlen = 0;
+		bool		typbyval = false;
+
+		if (OidIsValid(typid))
+			get_typlenbyval(typid, &typlen, &typbyval);
+
+		skip_list->typids[i] = typid;
+		skip_list->blocks[i] = (ColumnBlockSkipNode *)
+			palloc0(skip_list->block_count * sizeof(ColumnBlockSkipNode));
+		for (block = 0; block < skip_list->block_count; block++)
+		{
+			ColumnBlockSkipNode *node = &skip_list->blocks[i][block];
+
+			node->has_nulls = get_uint8(buf, filename);
+			node->has_values = get_uint8(buf, filename);
+			node->has_min_max = get_uint8(buf, filename);
+			if (node->has_min_max)
+			{
+				node->min_value = get_min_max(buf, typlen, typbyval, filename);
+				node->max_value = get_min_max(buf, typlen, typbyval, filename);
+			}
+			node->exists_offset = get_uint64(buf, filename);
+			node->exists_length = get_uint32(buf, filename);
+			node->value_length = get_uint32(buf, filename);
+			node->value_raw_length = get_uint32(buf, filename);
+			node->value_compression = get_uint8(buf, filename);
+		}
+	}
+
+	return skip_list;
+}
+
+/*
+ * ColumnarBeginRead
+ *		Start reading the table in "filename"
+ *
+ * Only the columns flagged in columns_needed are read, the others come back
+ * as NULL.  "quals" are the scan quals, whose Vars use "varno"; blocks whose
+ * min/max show no row can pass them are skipped.
+ */
+ColumnarReadState *
+ColumnarBeginRead(const char *filename, TupleDesc tupdesc,
+				  bool *columns_needed, List *quals, Index varno)
+{
+	ColumnarReadState *state;
+	Bitmapset  *qual_attrs = NULL;
+	int			natts = tupdesc->natts;
+	int			attno;
+
+	state = (ColumnarReadState *) palloc0(sizeof(ColumnarReadState));
+	state->filename = pstrdup(filename);
+	state->tupdesc = tupdesc;
+	state->columns_needed = columns_needed;
+	state->columns_in_quals = (bool *) palloc0(natts * sizeof(bool));
+	state->quals = quals;
+	state->varno = varno;
+	state->footer = ColumnarReadFooter(filename);
+	state->fd = -1;
+
+	state->ge_operators = (Oid *) palloc0(natts * sizeof(Oid));
+	state->le_operators = (Oid *) palloc0(natts * sizeof(Oid));
+	state->op_types = (Oid *) palloc0(natts * sizeof(Oid));
+
+	pull_varattnos((Node *) quals, varno, &qual_attrs);
+	while ((attno = bms_first_member(qual_attrs)) >= 0)
+	{
+		Form_pg_attribute attr;
+		TypeCacheEntry *typentry;
+
+		attno += FirstLowInvalidHeapAttributeNumber;
+		if (attno <= 0)
+			continue;
+
+		attr = tupdesc->attrs[attno - 1];
+		if (attr->attisdropped)
+			continue;
+
+		typentry = lookup_type_cache(attr->atttypid, TYPECACHE_BTREE_OPFAMILY);
+		if (!OidIsValid(typentry->btree_opf))
+			continue;
+
+		state->op_types[attno - 1] = typentry->btree_opintype;
+		state->ge_operators[attno - 1] =
+			get_opfamily_member(typentry->btree_opf,
+								typentry->btree_opintype,
+								typentry->btree_opintype,
+								BTGreaterEqualStrategyNumber);
+		state->le_operators[attno - 1] =
+			get_opfamily_member(typentry->btree_opf,
+								typentry->btree_opintype,
+								typentry->btree_opintype,
+								BTLessEqualStrategyNumber);
+		state->columns_in_quals[attno - 1] =
+			OidIsValid(state->ge_operators[attno - 1]) &&
+			OidIsValid(state->le_operators[attno - 1]);
+	}
+
+	state->stripe_context = AllocSetContextCreate(CurrentMemoryContext,
+												  "columnar stripe context",
+												  ALLOCSET_DEFAULT_SIZES);
+	state->block_context = AllocSetContextCreate(CurrentMemoryContext,
+												 "columnar block context",
+												 ALLOCSET_DEFAULT_SIZES);
+	state->block_values = (Datum **) palloc0(natts * sizeof(Datum *));
+	state->block_nulls = (bool **) palloc0(natts * sizeof(bool *));
+
+	ColumnarRescan(state);
+
+	return state;
+}
+
+/*
+ * ColumnarReadNextRow
+ *		Fetch the next row, return false at the end of the table
+ */
+bool
+ColumnarReadNextRow(ColumnarReadState *state, Datum *values, bool *nulls)
+{
+	uint32		row;
+	int			i;
+
+	while (state->next_row >= state->block_rows)
+	{
+		if (!ColumnarLoadNextBlock(state))
+			return false;
+	}
+
+	row = state->next_row++;
+	for (i = 0; i < state->tupdesc->natts; i++)
+	{
+		if (state->block_values[i] == NULL)
+		{
+			values[i] = (Datum) 0;
+			nulls[i] = true;
+		}
+		else
+		{
+			values[i] = state->block_values[i][row];
+			nulls[i] = state->block_nulls[i][row];
+		}
+	}
+
+	return true;
+}
+
+/*
+ * ColumnarRescan
+ *		Restart from the first stripe
+ */
+void
+ColumnarRescan(ColumnarReadState *state)
+{
+	MemoryContextReset(state->stripe_context);
+	MemoryContextReset(state->block_context);
+
+	state->next_stripe = list_head(state->footer->stripes);
+	state->skip_list = NULL;
+	state->next_block = 0;
+	state->block_rows = 0;
+	state->next_row = 0;
+}
+
+void
+ColumnarEndRead(ColumnarReadState *state)
+{
+	if (state->fd >= 0)
+		CloseTransientFile(state->fd);
+	MemoryContextDelete(state->stripe_context);
+	MemoryContextDelete(state->block_context);
+}
+
+void
+ColumnarReadStats(ColumnarReadState *state,
+				  uint64 *blocks_read, uint64 *blocks_skipped)
+{
+	*blocks_read = state->blocks_read;
+	*blocks_skipped = state->blocks_skipped;
+}
+
+static bool
+ColumnarLoadNextStripe(ColumnarReadState *state)
+{
+	StripeMetadata *stripe;
+	StringInfoData buf;
+	uint32		length;
+	MemoryContext oldcontext;
+
+	MemoryContextReset(state->stripe_context);
+	state->skip_list = NULL;
+
+	if (state->next_stripe == NULL)
+		return false;
+	stripe = (StripeMetadata *) lfirst(state->next_stripe);
+	state->next_stripe = lnext(state->next_stripe);
+
+	if (state->fd < 0)
+	{
+		state->fd = OpenTransientFile(state->filename, O_RDONLY | PG_BINARY, 0);
+		if (state->fd < 0)
+			ereport(ERROR,
+					(errcode_for_file_access(),
+					 errmsg("could not open file \"%s\": %m",
+							state->filename)));
+	}
+
+	read_at(state->fd, stripe->offset, (char *) &length, sizeof(length),
+			state->filename);
+	if (sizeof(length) + (uint64) length > stripe->length)
+		ereport(ERROR,
+				(errcode(ERRCODE_DATA_CORRUPTED),
+				 errmsg("columnar file \"%s\" is corrupted", state->filename)));
+
+	oldcontext = MemoryContextSwitchTo(state->stripe_context);
+	initStringInfo(&buf);
+	enlargeStringInfo(&buf, length);
+	read_at(state->fd, stripe->offset + sizeof(length), buf.data, length,
+			state->filename);
+	buf.len = length;
+	state->skip_list = DeserializeSkipList(&buf, state->filename);
+	MemoryContextSwitchTo(oldcontext);
+
+	state->stripe_data_offset = stripe->offset + sizeof(length) + length;
+	state->next_block = 0;
+
+	return true;
+}
+
+static bool
+ColumnarLoadNextBlock(ColumnarReadState *state)
+{
+	uint32		block;
+	int			i;
+
+	for (;;)
+	{
+		/* the rows of the last block are done with */
+		MemoryContextReset(state->block_context);
+		state->block_rows = 0;
+		state->next_row = 0;
+
+		if (state->skip_list == NULL ||
+			state->next_block >= state->skip_list->block_count)
+		{
+			if (!ColumnarLoadNextStripe(state))
+				return false;
+			continue;
+		}
+
+		block = state->next_block++;
+		if (ColumnarBlockRefuted(state, block))
+		{
+			state->blocks_skipped++;
+			continue;
+		}
+
+		state->block_rows = state->skip_list->block_row_counts[block];
+		for (i = 0; i < state->tupdesc->natts; i++)
+			ColumnarLoadColumn(state, i, block);
+		state->blocks_read++;
+
+		return true;
+	}
+}
+
+/*
+ * ColumnarLoadColumn
+ *		Decompress one column of a block into block_values/block_nulls
+ */
+static void
+ColumnarLoadColumn(ColumnarReadState *state, int attno, uint32 block)
+{
+	Form_pg_attribute attr = state->tupdesc->attrs[attno];
+	StripeSkipList *skip_list = state->skip_list;
+	ColumnBlockSkipNode *node;
+	uint32		rows = state->block_rows;
+	MemoryContext oldcontext;
+	char	   *exists;
+	char	   *data;
+	Datum	   *values;
+	bool	   *nulls;
+	uint32		row;
+	long		off = 0;
+
+	state->block_values[attno] = NULL;
+	state->block_nulls[attno] = NULL;
+
+	/* columns added after the stripe was written read as NULL */
+	if (!state->columns_needed[attno] || attr->attisdropped ||
+		attno >= skip_list->natts || !OidIsValid(skip_list->typids[attno]))
+		return;
+
+	if (skip_list->typids[attno] != attr->atttypid)
+		ereport(ERROR,
+				(errcode(ERRCODE_DATATYPE_MISMATCH),
+				 errmsg("column \"%s\" does not match the type stored in columnar file \"%s\"",
+						NameStr(attr->attname), state->filename)));
+
+	node = &skip_list->blocks[attno][block];
+	if (node->exists_length < (rows + 7) / 8 ||
+		node->exists_offset + node->exists_length + node->value_length >
+		state->footer->data_length)
+		ereport(ERROR,
+				(errcode(ERRCODE_DATA_CORRUPTED),
+				 errmsg("columnar file \"%s\" is corrupted", state->filename)));
+
+	oldcontext = MemoryContextSwitchTo(state->block_context);
+
+	exists = palloc(node->exists_length + node->value_length);
+	read_at(state->fd, state->stripe_data_offset + node->exists_offset,
+			exists, node->exists_length + node->value_length,
+			state->filename);
+
+	data = exists + node->exists_length;
+	if (node->value_compression == COLUMNAR_COMPRESSION_PGLZ)
+	{
+		data = palloc(node->value_raw_length);
+		if (pglz_decompress(exists + node->exists_length, node->value_length,
+							data, node->value_raw_length) !=
+			(int32) node->value_raw_length)
+			ereport(ERROR,
+					(errcode(ERRCODE_DATA_CORRUPTED),
+					 errmsg("columnar file \"%s\" is corrupted",
+							state->filename)));
+	}
+
+	values = (Datum *) palloc(rows * sizeof(Datum));
+	nulls = (bool *) palloc(rows * sizeof(bool));
+	for (row = 0; row < rows; row++)
+	{
+		if ((exists[row / 8] & (1 << (row % 8))) == 0)
+		{
+			values[row] = (Datum) 0;
+			nulls[row] = true;
+			continue;
+		}
+
+		off = att_align_pointer(off, attr->attalign, attr->attlen, data + off);
+		if (off >= node->value_raw_length)
+			ereport(ERROR,
+					(errcode(ERRCODE_DATA_CORRUPTED),
+					 errmsg("columnar file \"%s\" is corrupted",
+							state->filename)));
+		values[row] = fetchatt(attr, data + off);
+		nulls[row] = false;
+		off = att_addlength_pointer(off, attr->attlen, data + off);
+	}
+
+	MemoryContextSwitchTo(oldcontext);
+
+	state->block_values[attno] = values;
+	state->block_nulls[attno] = nulls;
+}
+
+/*
+ * ColumnarBlockRefuted
+ *		Can no row of the block pass the scan quals?
+ *
+ * Each column used in the quals contributes what its skip list entry tells
+ * about all rows of the block:
+ *		(col >= min AND col <= max) [OR col IS NULL]
+ * or col IS NULL for a block of nulls only, and we try to refute the quals
+ * with that, like constraint exclusion does with CHECK constraints.
+ */
+static bool
+ColumnarBlockRefuted(ColumnarReadState *state, uint32 block)
+{
+	StripeSkipList *skip_list = state->skip_list;
+	List	   *constraints = NIL;
+	bool		refuted;
+	MemoryContext oldcontext;
+	int			i;
+
+	if (state->quals == NIL)
+		return false;
+
+	oldcontext = MemoryContextSwitchTo(state->block_context);
+
+	for (i = 0; i < state->tupdesc->natts && i < skip_list->natts; i++)
+	{
+		Form_pg_attribute attr = state->tupdesc->attrs[i];
+		ColumnBlockSkipNode *node;
+		Oid			op_type = state->op_types[i];
+		Expr	   *var;
+		Expr	   *min_const;
+		Expr	   *max_const;
+		Expr	   *ge_expr;
+		Expr	   *le_expr;
+		Expr	   *constraint;
+		NullTest   *null_test;
+
+		if (!state->columns_in_quals[i] ||
+			skip_list->typids[i] != attr->atttypid)
+			continue;
+
+		node = &skip_list->blocks[i][block];
+		if (node->has_values && !node->has_min_max)
+			continue;
+
+		var = (Expr *) makeVar(state->varno, i + 1, attr->atttypid,
+							   attr->atttypmod, attr->attcollation, 0);
+
+		null_test = makeNode(NullTest);
+		null_test->arg = var;
+		null_test->nulltesttype = IS_NULL;
+		null_test->argisrow = false;
+		null_test->location = -1;
+
+		if (!node->has_values)
+		{
+			constraints = lappend(constraints, null_test);
+			continue;
+		}
+
+		/* operators of binary-compatible types, e.g. varchar, see a relabel */
+		if (op_type != attr->atttypid)
+			var = (Expr *) makeRelabelType(var, op_type, -1, attr->attcollation,
+										   COERCE_IMPLICIT_CAST);
+
+		min_const = (Expr *) makeConst(op_type, -1, attr->attcollation,
+									   attr->attlen, node->min_value,
+									   false, attr->attbyval);
+		max_const = (Expr *) makeConst(op_type, -1, attr->attcollation,
+									   attr->attlen, node->max_value,
+									   false, attr->attbyval);
+
+		ge_expr = make_opclause(state->ge_operators[i], BOOLOID, false,
+								var, min_const,
+								InvalidOid, attr->attcollation);
+		set_opfuncid((OpExpr *) ge_expr);
+		le_expr = make_opclause(state->le_operators[i], BOOLOID, false,
+								var, max_const,
+								InvalidOid, attr->attcollation);
+		set_opfuncid((OpExpr *) le_expr);
+
+		constraint = make_andclause(list_make2(ge_expr, le_expr));
+		if (node->has_nulls)
+			constraint = make_orclause(list_make2(constraint, null_test));
+		constraints = lappend(constraints, constraint);
+	}
+
+	refuted = constraints != NIL &&
+		predicate_refuted_by(constraints, state->quals);
+
+	MemoryContextSwitchTo(oldcontext);
+
+	return refuted;
+}
+
+static void
+read_at(int fd, uint64 offset, char *buf, uint32 len, const char *filename)
+{
+	int			nread;
+
+	if (lseek(fd, (off_t) offset, SEEK_SET) < 0)
+		ereport(ERROR,
+				(errcode_for_file_access(),
+				 errmsg("could not seek in file \"%s\": %m", filename)));
+
+	while (len > 0)
+	{
+		nread = read(fd, buf, len);
+		if (nread < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			ereport(ERROR,
+					(errcode_for_file_access(),
+					 errmsg("could not read file \"%s\": %m", filename)));
+		}
+		if (nread == 0)
+			ereport(ERROR,
+					(errcode(ERRCODE_DATA_CORRUPTED),
+					 errmsg("unexpected end of columnar file \"%s\"",
+							filename)));
+		buf += nread;
+		len -= nread;
+	}
+}
+
+static void
+write_all(int fd, const char *buf, Size len, const char *filename)
+{
+	int			nwritten;
+
+	while (len > 0)
+	{
+		errno = 0;
+		nwritten = write(fd, buf, len);
+		if (nwritten < 0 && errno == EINTR)
+			continue;
+		if (nwritten <= 0)
+		{
+			/* if write didn't set errno, assume problem is no disk space */
+			if (errno == 0)
+				errno = ENOSPC;
+			ereport(ERROR,
+					(errcode_for_file_access(),
+					 errmsg("could not write to file \"%s\": %m", filename)));
+		}
+		buf += nwritten;
+		len -= nwritten;
+	}
+}
+
+static void
+put_uint8(StringInfo buf, uint8 value)
+{
+	appendBinaryStringInfo(buf, (char *) &value, sizeof(value));
+}
+
+static void
+put_uint32(StringInfo buf, uint32 value)
+{
+	appendBinaryStringInfo(buf, (char *) &value, sizeof(value));
+}
+
+static void
+put_uint64(StringInfo buf, uint64 value)
+{
+	appendBinaryStringInfo(buf, (char *) &value, sizeof(value));
+}
+
+static void
+put_min_max(StringInfo buf, Datum value, int16 typlen, bool typbyval)
+{
+	if (typbyval)
+	{
+		union
+		{
+			Datum		datum;
+			char		data[sizeof(Datum)];
+		}			store;
+
+		put_uint32(buf, typlen);
+		store_att_byval(store.data, value, typlen);
+		appendBinaryStringInfo(buf, store.data, typlen);
+	}
+	else
+	{
+		uint32		length = att_addlength_datum(0, typlen, value);
+
+		put_uint32(buf, length);
+		appendBinaryStringInfo(buf, DatumGetPointer(value), length);
+	}
+}
+
+static void
+get_bytes(StringInfo buf, void *dest, int len, const char *filename)
+{
+	if (len < 0 || buf->cursor + len > buf->len)
+		ereport(ERROR,
+				(errcode(ERRCODE_DATA_CORRUPTED),
+				 errmsg("columnar file \"%s\" is corrupted", filename)));
+	memcpy(dest, buf->data + buf->cursor, len);
+	buf->cursor += len;
+}
+
+static uint8
+get_uint8(StringInfo buf, const char *filename)
+{
+	uint8		value;
+
+	get_bytes(buf, &value, sizeof(value), filename);
+	return value;
+}
+
+static uint32
+get_uint32(StringInfo buf, const char *filename)
+{
+	uint32		value;
+
+	get_bytes(buf, &value, sizeof(value), filename);
+	return value;
+}
+
+static uint64
+get_uint64(StringInfo buf, const char *filename)
+{
+	uint64		value;
+
+	get_bytes(buf, &value, sizeof(value), filename);
+	return value;
+}
+
+static Datum
+get_min_max(StringInfo buf, int16 typlen, bool typbyval, const char *filename)
+{
+	uint32		length = get_uint32(buf, filename);
+
+	if (typbyval)
+	{
+		union
+		{
+			Datum		datum;
+			char		data[sizeof(Datum)];
+		}			store;
+
+		if (length != typlen)
+			ereport(ERROR,
+					(errcode(ERRCODE_DATA_CORRUPTED),
+					 errmsg("columnar file \"%s\" is corrupted", filename)));
+		store.datum = (Datum) 0;
+		get_bytes(buf, store.data, length, filename);
+		return fetch_att(store.data, true, typlen);
+	}
+	else
+	{
+		char	   *value = palloc(length);
+
+		get_bytes(buf, value, length, filename);
+		return PointerGetDatum(value);
+	}
+}
@@ -69,6 +69,10 @@ ProcessAGtmCommand(StringInfo input_message, CommandDest dest)
 			output = ProcessSyncXID(input_message, &buf);
 			break;
 
+		case AGTM_MSG_SET_XACT_NODES:
+			output = ProcessSetXactNodes(input_message, &buf);
+			break;
+
 		case AGTM_MSG_SEQUENCE_INIT:
 			output = ProcessSequenceInit(input_message, &buf);
 			break;
@@ -6,8 +6,80 @@
 #include "commands/sequence.h"
 #include "libpq/libpq.h"
 #include "libpq/pqformat.h"
+#include "storage/lmgr.h"
+#include "storage/lwlock.h"
+#include "storage/shmem.h"
+#include "storage/spin.h"
 #include "utils/builtins.h"
+#include "utils/hsearch.h"
+#include "utils/inval.h"
 #include "utils/resowner.h"
+#include "utils/syscache.h"
+
+/*
+ * Hot sequences
+ *
+ * nextval results are handed out from a shared hash keyed by the relid of
+ * the AGTM sequence.  Each entry holds a run of results reserved at once by
+ * AgtmSequenceReserve, which WAL-logs only the last of them; the entry is
+ * refilled when the run is used up.  Cycled sequences, and sequences beyond
+ * agtm_hot_sequences, go through nextval_oid as before.
+ *
+ * setval drops the reserved results and runs outside the lock; while it
+ * runs the entry is marked, so that nextval goes through nextval_oid and
+ * nothing is reserved from the old value.
+ *
+ * The names a coordinator sends are resolved to relids once per backend,
+ * and resolved again when agtm_sequence changes.
+ */
+
+/* GUC variables */
+int			agtm_hot_sequences = 1024;
+int			agtm_sequence_reserve = 100;
+
+typedef struct AgtmSeqEntry
+{
+	Oid			relid;			/* hash key */
+	slock_t		mutex;			/* protects the fields below */
+	bool		cycled;			/* served by nextval_oid */
+	int			setters;		/* # setval running, served by nextval_oid */
+	int64		next;			/* next result to hand out */
+	int64		step;			/* distance between results */
+	int64		remaining;		/* # results reserved but not handed out */
+} AgtmSeqEntry;
+
+static HTAB *AgtmSeqHash = NULL;
+
+typedef struct AgtmSeqNameKey
+{
+	NameData	database;
+	NameData	schema;
+	NameData	sequence;
+} AgtmSeqNameKey;
+
+typedef struct AgtmSeqNameEntry
+{
+	AgtmSeqNameKey key;			/* hash key */
+	Oid			relid;
+} AgtmSeqNameEntry;
+
+/* currval state of this backend, the sequence.c one is not set */
+typedef struct AgtmSeqCurrEntry
+{
+	Oid			relid;			/* hash key */
+	int64		last;			/* last result returned */
+} AgtmSeqCurrEntry;
+
+static HTAB *AgtmSeqNameHash = NULL;
+static HTAB *AgtmSeqCurrHash = NULL;
+static Oid	AgtmSeqLastUsed = InvalidOid;
+
+static int64 AgtmSeqNextval(Oid relid);
+static bool AgtmSeqNextFromMemory(Oid relid, int64 *result, bool *cycled);
+static void AgtmSeqSetCurrval(Oid relid, int64 value);
+static bool AgtmSeqBeginSetval(Oid relid);
+static void AgtmSeqEndSetval(Oid relid);
+static void AgtmSeqNameInvalidate(Datum arg, int cacheid, uint32 hashvalue);
 
 static void RespondSeqToClient(int64 seq_val, AGTM_ResultType type, StringInfo output);
 
@@ -40,15 +112,13 @@ GetSeqKeyToDatumOid(char *seq_key)
 StringInfo
 ProcessNextSeqCommand(StringInfo message, StringInfo output)
 {
-	Datum seq_val_datum;
 	int64 seq_val;
 	Datum seq_name_to_oid;
 
 	seq_name_to_oid= prase_to_agtm_sequence_name(message);
 	pq_getmsgend(message);
 
-	seq_val_datum = DirectFunctionCall1(nextval_oid, seq_name_to_oid);
-	seq_val = DatumGetInt64(seq_val_datum);
+	seq_val = AgtmSeqNextval(DatumGetObjectId(seq_name_to_oid));
 
 	/* Respond to the client */
 	RespondSeqToClient(seq_val, AGTM_SEQUENCE_GET_NEXT_RESULT, output);
@@ -61,16 +131,27 @@ ProcessCurSeqCommand(StringInfo message, StringInfo output)
 {
 	Datum seq_val_datum;
 	int64 seq_val;
-	Datum seq_name_to_oid;
+	Oid seq_name_to_oid;
+	AgtmSeqCurrEntry *curr;
 
-	seq_name_to_oid= prase_to_agtm_sequence_name(message);
+	seq_name_to_oid = DatumGetObjectId(prase_to_agtm_sequence_name(message));
 	pq_getmsgend(message);
 
 	/*if nextval function never called in this session and before currval function called,
 	 *curral_oid fuction will ereport(error) 
 	 */
-	seq_val_datum = DirectFunctionCall1(currval_oid, seq_name_to_oid);
-	seq_val = DatumGetInt64(seq_val_datum);
+	curr = NULL;
+	if (AgtmSeqCurrHash != NULL)
+		curr = (AgtmSeqCurrEntry *) hash_search(AgtmSeqCurrHash, &seq_name_to_oid,
+												HASH_FIND, NULL);
+	if (curr != NULL)
+		seq_val = curr->last;
+	else
+	{
+		seq_val_datum = DirectFunctionCall1(currval_oid,
+											ObjectIdGetDatum(seq_name_to_oid));
+		seq_val = DatumGetInt64(seq_val_datum);
+	}
 
 	/* Respond to the client */
 	RespondSeqToClient(seq_val, AGTM_MSG_SEQUENCE_GET_CUR_RESULT, output);
@@ -86,6 +167,7 @@ PorcessLastSeqCommand(StringInfo message, StringInfo output)
 	char* dbName = NULL;
 	char* schemaName = NULL;
 	char* sequenceName = NULL;
+	AgtmSeqCurrEntry *curr;
 
 	parse_seqFullName_to_details(message, &dbName, &schemaName, &sequenceName);
 	pq_getmsgend(message);
@@ -93,8 +175,17 @@ PorcessLastSeqCommand(StringInfo message, StringInfo output)
 	/*if nextval function never called in this session and before currval function called,
 	 *curral_oid fuction will ereport(error) 
 	 */
-	seq_val_datum = DirectFunctionCall1(lastval, (Datum)0);
-	seq_val = DatumGetInt64(seq_val_datum);
+	curr = NULL;
+	if (OidIsValid(AgtmSeqLastUsed))
+		curr = (AgtmSeqCurrEntry *) hash_search(AgtmSeqCurrHash, &AgtmSeqLastUsed,
+												HASH_FIND, NULL);
+	if (curr != NULL)
+		seq_val = curr->last;
+	else
+	{
+		seq_val_datum = DirectFunctionCall1(lastval, (Datum)0);
+		seq_val = DatumGetInt64(seq_val_datum);
+	}
 
 	/* Respond to the client */
 	RespondSeqToClient(seq_val, AGTM_SEQUENCE_GET_LAST_RESULT, output);
@@ -120,11 +211,38 @@ ProcessSetSeqCommand(StringInfo message, StringInfo output)
 	iscalled = pq_getmsgbyte(message);
 	pq_getmsgend(message);
 
-	seq_val_datum = DirectFunctionCall3(setval3_oid,
-		seq_name_to_oid, seq_nextval, iscalled);
+	/*
+	 * Results reserved before are not to be handed out any more, and none
+	 * must be reserved from the old value while setval runs.
+	 */
+	if (AgtmSeqBeginSetval(DatumGetObjectId(seq_name_to_oid)))
+	{
+		PG_TRY();
+		{
+			seq_val_datum = DirectFunctionCall3(setval3_oid,
+				seq_name_to_oid, seq_nextval, iscalled);
+		}
+		PG_CATCH();
+		{
+			AgtmSeqEndSetval(DatumGetObjectId(seq_name_to_oid));
+			PG_RE_THROW();
+		}
+		PG_END_TRY();
+		AgtmSeqEndSetval(DatumGetObjectId(seq_name_to_oid));
+	}
+	else
+	{
+		seq_val_datum = DirectFunctionCall3(setval3_oid,
+			seq_name_to_oid, seq_nextval, iscalled);
+		/* hash is full, results could be reserved meanwhile */
+		AgtmSequenceForget(DatumGetObjectId(seq_name_to_oid));
+	}
 
 	seq_val = DatumGetInt64(seq_val_datum);
 
+	if (iscalled)
+		AgtmSeqSetCurrval(DatumGetObjectId(seq_name_to_oid), seq_nextval);
+
 	/* Respond to the client */
 	RespondSeqToClient(seq_val,AGTM_SEQUENCE_SET_VAL_RESULT, output);
 
@@ -135,6 +253,12 @@ StringInfo
 ProcessDiscardCommand(StringInfo message, StringInfo output)
 {
 	ResetSequenceCaches();
+	if (AgtmSeqCurrHash != NULL)
+	{
+		hash_destroy(AgtmSeqCurrHash);
+		AgtmSeqCurrHash = NULL;
+	}
+	AgtmSeqLastUsed = InvalidOid;
 	/* Respond to the client */
 	pq_sendint(output, AGTM_MSG_SEQUENCE_RESET_CACHE_RESULT, 4);
 	return output;
@@ -176,10 +300,41 @@ prase_to_agtm_sequence_name(StringInfo message)
 	StringInfoData	buf;
 	Oid			lineOid;
 	char *	agtmSeqName = NULL;
-	int		oid;
+	Datum	oid;
+	AgtmSeqNameKey key;
+	AgtmSeqNameEntry *entry;
 
-	initStringInfo(&buf);
 	parse_seqFullName_to_details(message, &dbName, &schemaName, &sequenceName);
+
+	if (AgtmSeqNameHash == NULL)
+	{
+		HASHCTL		ctl;
+
+		MemSet(&ctl, 0, sizeof(ctl));
+		ctl.keysize = sizeof(AgtmSeqNameKey);
+		ctl.entrysize = sizeof(AgtmSeqNameEntry);
+		AgtmSeqNameHash = hash_create("AGTM sequence names", 64, &ctl,
+									  HASH_ELEM | HASH_BLOBS);
+		CacheRegisterSyscacheCallback(AGTMSEQUENCEOID,
+									  AgtmSeqNameInvalidate,
+									  (Datum) 0);
+	}
+
+	MemSet(&key, 0, sizeof(key));
+	namestrcpy(&key.database, dbName);
+	namestrcpy(&key.schema, schemaName);
+	namestrcpy(&key.sequence, sequenceName);
+	entry = (AgtmSeqNameEntry *) hash_search(AgtmSeqNameHash, &key,
+											 HASH_FIND, NULL);
+	if (entry != NULL)
+	{
+		pfree(sequenceName);
+		pfree(dbName);
+		pfree(schemaName);
+		return ObjectIdGetDatum(entry->relid);
+	}
+
+	initStringInfo(&buf);
 	isExist = SequenceIsExist(dbName, schemaName, sequenceName);
 	if(!isExist)
 		ereport(ERROR,
@@ -193,6 +348,10 @@ prase_to_agtm_sequence_name(StringInfo message)
 
 	oid = GetSeqKeyToDatumOid(agtmSeqName);
 
+	entry = (AgtmSeqNameEntry *) hash_search(AgtmSeqNameHash, &key,
+											 HASH_ENTER, NULL);
+	entry->relid = DatumGetObjectId(oid);
+
 	pfree(agtmSeqName);
 	pfree(sequenceName);
 	pfree(dbName);
@@ -200,3 +359,247 @@ prase_to_agtm_sequence_name(StringInfo message)
 	return oid ;
 }
 
+
+Size
+AgtmSequenceShmemSize(void)
+{
+	if (agtm_hot_sequences <= 0)
+		return 0;
+
+	return hash_estimate_size(agtm_hot_sequences, sizeof(AgtmSeqEntry));
+}
+
+void
+AgtmSequenceShmemInit(void)
+{
+	HASHCTL		info;
+
+	if (agtm_hot_sequences <= 0)
+		return;
+
+	MemSet(&info, 0, sizeof(info));
+	info.keysize = sizeof(Oid);
+	info.entrysize = sizeof(AgtmSeqEntry);
+	AgtmSeqHash = ShmemInitHash("AGTM Sequence Hash",
+								agtm_hot_sequences,
+								agtm_hot_sequences,
+								&info,
+								HASH_ELEM | HASH_BLOBS);
+}
+
+/*
+ * Drop the results reserved for a sequence, after it was altered, set or
+ * dropped.  The next nextval reserves again from the sequence relation.
+ */
+void
+AgtmSequenceForget(Oid relid)
+{
+	AgtmSeqEntry *entry;
+
+	if (AgtmSeqHash == NULL)
+		return;
+
+	LWLockAcquire(AgtmSequenceLock, LW_EXCLUSIVE);
+	entry = (AgtmSeqEntry *) hash_search(AgtmSeqHash, &relid,
+										 HASH_FIND, NULL);
+	if (entry != NULL && entry->setters > 0)
+		entry->remaining = 0;	/* AgtmSeqEndSetval removes it */
+	else if (entry != NULL)
+		hash_search(AgtmSeqHash, &relid, HASH_REMOVE, NULL);
+	LWLockRelease(AgtmSequenceLock);
+}
+
+/*
+ * Mark the entry of a sequence before setval, dropping its reserved
+ * results.  Returns false if the hash is full and nothing was marked.
+ */
+static bool
+AgtmSeqBeginSetval(Oid relid)
+{
+	AgtmSeqEntry *entry;
+	bool		found;
+
+	if (AgtmSeqHash == NULL)
+		return false;
+
+	LWLockAcquire(AgtmSequenceLock, LW_EXCLUSIVE);
+	entry = (AgtmSeqEntry *) hash_search(AgtmSeqHash, &relid,
+										 HASH_ENTER_NULL, &found);
+	if (entry != NULL)
+	{
+		if (!found)
+		{
+			SpinLockInit(&entry->mutex);
+			entry->cycled = false;
+			entry->setters = 0;
+			entry->next = 0;
+			entry->step = 0;
+		}
+		entry->remaining = 0;
+		entry->setters++;
+	}
+	LWLockRelease(AgtmSequenceLock);
+
+	return entry != NULL;
+}
+
+/*
+ * Unmark the entry after setval; the next nextval reserves again from the
+ * value set
+ */
+static void
+AgtmSeqEndSetval(Oid relid)
+{
+	AgtmSeqEntry *entry;
+
+	LWLockAcquire(AgtmSequenceLock, LW_EXCLUSIVE);
+	entry = (AgtmSeqEntry *) hash_search(AgtmSeqHash, &relid,
+										 HASH_FIND, NULL);
+	if (entry != NULL && --entry->setters == 0)
+		hash_search(AgtmSeqHash, &relid, HASH_REMOVE, NULL);
+	LWLockRelease(AgtmSequenceLock);
+}
+
+static int64
+AgtmSeqNextval(Oid relid)
+{
+	AgtmSeqEntry *entry;
+	int64		result;
+	int64		first;
+	int64		step;
+	int64		nresults;
+	bool		found;
+	bool		cycled = false;
+
+	if (AgtmSeqHash != NULL &&
+		AgtmSeqNextFromMemory(relid, &result, &cycled))
+	{
+		AgtmSeqSetCurrval(relid, result);
+		return result;
+	}
+
+	if (AgtmSeqHash == NULL || cycled)
+	{
+		result = DatumGetInt64(DirectFunctionCall1(nextval_oid,
+												   ObjectIdGetDatum(relid)));
+		AgtmSeqSetCurrval(relid, result);
+		return result;
+	}
+
+	/*
+	 * Refill under the exclusive lock.  Lock the sequence first, so that
+	 * waiting for a concurrent DROP does not hold up the other sequences.
+	 */
+	LockRelationOid(relid, AccessShareLock);
+	LWLockAcquire(AgtmSequenceLock, LW_EXCLUSIVE);
+
+	entry = (AgtmSeqEntry *) hash_search(AgtmSeqHash, &relid,
+										 HASH_ENTER_NULL, &found);
+	if (entry != NULL && !found)
+	{
+		SpinLockInit(&entry->mutex);
+		entry->cycled = false;
+		entry->setters = 0;
+		entry->next = 0;
+		entry->step = 0;
+		entry->remaining = 0;
+	}
+
+	if (entry != NULL && !entry->cycled && entry->setters == 0 &&
+		entry->remaining == 0)
+	{
+		if (AgtmSequenceReserve(relid, agtm_sequence_reserve,
+								&first, &step, &nresults))
+		{
+			entry->next = first;
+			entry->step = step;
+			entry->remaining = nresults;
+		}
+		else
+			entry->cycled = true;
+	}
+
+	if (entry == NULL || entry->cycled || entry->setters > 0)
+	{
+		/* hash is full, sequence cycles, or setval runs */
+		LWLockRelease(AgtmSequenceLock);
+		result = DatumGetInt64(DirectFunctionCall1(nextval_oid,
+												   ObjectIdGetDatum(relid)));
+	}
+	else
+	{
+		result = entry->next;
+		if (--entry->remaining > 0)
+			entry->next += entry->step;
+		LWLockRelease(AgtmSequenceLock);
+	}
+
+	AgtmSeqSetCurrval(relid, result);
+	return result;
+}
+
+/*
+ * Hand out a result already reserved, under the shared lock
+ */
+static bool
+AgtmSeqNextFromMemory(Oid relid, int64 *result, bool *cycled)
+{
+	AgtmSeqEntry *entry;
+	bool		found = false;
+
+	LWLockAcquire(AgtmSequenceLock, LW_SHARED);
+	entry = (AgtmSeqEntry *) hash_search(AgtmSeqHash, &relid,
+										 HASH_FIND, NULL);
+	if (entry != NULL)
+	{
+		SpinLockAcquire(&entry->mutex);
+		*cycled = entry->cycled || entry->setters > 0;
+		if (!*cycled && entry->remaining > 0)
+		{
+			*result = entry->next;
+			if (--entry->remaining > 0)
+				entry->next += entry->step;
+			found = true;
+		}
+		SpinLockRelease(&entry->mutex);
+	}
+	LWLockRelease(AgtmSequenceLock);
+
+	return found;
+}
+
+static void
+AgtmSeqSetCurrval(Oid relid, int64 value)
+{
+	AgtmSeqCurrEntry *curr;
+
+	if (AgtmSeqCurrHash == NULL)
+	{
+		HASHCTL		ctl;
+
+		MemSet(&ctl, 0, sizeof(ctl));
+		ctl.keysize = sizeof(Oid);
+		ctl.entrysize = sizeof(AgtmSeqCurrEntry);
+		AgtmSeqCurrHash = hash_create("AGTM sequence currval", 64, &ctl,
+									  HASH_ELEM | HASH_BLOBS);
+	}
+
+	curr = (AgtmSeqCurrEntry *) hash_search(AgtmSeqCurrHash, &relid,
+											HASH_ENTER, NULL);
+	curr->last = value;
+	AgtmSeqLastUsed = relid;
+}
+
+/*
+ * Syscache callback, a sequence was renamed or dropped
+ */
+static void
+AgtmSeqNameInvalidate(Datum arg, int cacheid, uint32 hashvalue)
+{
+	HASH_SEQ_STATUS status;
+	AgtmSeqNameEntry *entry;
+
+	hash_seq_init(&status, AgtmSeqNameHash);
+	while ((entry = (AgtmSeqNameEntry *) hash_seq_search(&status)) != NULL)
+		hash_search(AgtmSeqNameHash, &entry->key, HASH_REMOVE, NULL);
+}
@@ -7,8 +7,10 @@
 #include "agtm/agtm.h"
 #include "agtm/agtm_msg.h"
 #include "agtm/agtm_protocol.h"
+#include "agtm/agtm_sequence.h"
 #include "agtm/agtm_transaction.h"
 #include "catalog/agtm_sequence.h"
+#include "catalog/namespace.h"
 #include "commands/sequence.h"
 #include "commands/tablecmds.h"
 #include "libpq/libpq.h"
@@ -18,7 +20,9 @@
 #include "nodes/value.h"
 #include "storage/procarray.h"
 #include "storage/lock.h"
+#include "storage/proc.h"
 #include "utils/elog.h"
+#include "utils/hlc.h"
 #include "utils/memutils.h"
 #include "utils/palloc.h"
 #include "utils/snapmgr.h"
@@ -33,9 +37,18 @@ StringInfo ProcessGetGXIDCommand(StringInfo message, StringInfo output)
 {
 	TransactionId	xid;
 	bool			isSubXact;
+	uint64			nodes;
 
 	isSubXact = pq_getmsgbyte(message);
+	pq_copymsgbytes(message, (char *) &nodes, sizeof(nodes));
 	pq_getmsgend(message);
+
+	/*
+	 * Set before the xid shows up in the proc array.  Coordinator and
+	 * datanodes of a transaction may share this backend, so a request only
+	 * ever adds nodes to what is known.
+	 */
+	MyProc->xactNodes |= nodes;
 	if (IsTransactionState())
 	{
 		xid = GetCurrentTransactionId();
@@ -58,7 +71,7 @@ StringInfo ProcessGetTimestamp(StringInfo message, StringInfo output)
 	Timestamp timestamp;
 
 	pq_getmsgend(message);
-	timestamp = GetCurrentTransactionStartTimestamp();
+	timestamp = HlcNow();
 
 	/* Respond to the client */
 	pq_sendint(output, AGTM_GET_TIMESTAMP_RESULT, 4);
@@ -71,6 +84,10 @@ StringInfo ProcessGetSnapshot(StringInfo message, StringInfo output)
 {
 	Snapshot			snapshot;
 	TimestampTz			globalXactStartTimestamp;
+	TimestampTz			clock;
+	TransactionId		globalXmin;
+	uint64				nodes;
+	uint64				xact_nodes;
 	static SnapshotData GlobalAgtmSnapshotData = {
 		NULL,
 		InvalidTransactionId,
@@ -90,15 +107,40 @@ StringInfo ProcessGetSnapshot(StringInfo message, StringInfo output)
 #endif /* ADB */
 		};
 
+	pq_copymsgbytes(message, (char *) &nodes, sizeof(nodes));
+	pq_copymsgbytes(message, (char *) &xact_nodes, sizeof(xact_nodes));
+	pq_copymsgbytes(message, (char *) &clock, sizeof(clock));
 	pq_getmsgend(message);
-	globalXactStartTimestamp = GetCurrentTimestamp();
+
+	/*
+	 * "nodes" asks for the horizon of those nodes, "xact_nodes" are the
+	 * nodes the requesting transaction involves so far.  The latter matters
+	 * for read-only transactions, which never ask for a GXID.
+	 */
+	MyProc->xactNodes |= xact_nodes;
+
+	/*
+	 * The start timestamp of the transaction comes from our hybrid logical
+	 * clock, so it is later than anything the coordinator has seen.
+	 */
+	HlcObserve(clock);
+	globalXactStartTimestamp = HlcNow();
 	snapshot = GetSnapshotData(&GlobalAgtmSnapshotData);
 
+	/*
+	 * A request naming nodes gets the cleanup horizon of those nodes only,
+	 * not held back by transactions which never touched them.
+	 */
+	if (nodes != 0)
+		globalXmin = GetOldestXminForNode(nodes);
+	else
+		globalXmin = RecentGlobalXmin;
+
 	/* Respond to the client */
 	pq_sendint(output, AGTM_SNAPSHOT_GET_RESULT, 4);
 
 	pq_sendbytes(output, (char *)&globalXactStartTimestamp, sizeof (globalXactStartTimestamp));
-	pq_sendbytes(output, (char *)&RecentGlobalXmin, sizeof (TransactionId));
+	pq_sendbytes(output, (char *)&globalXmin, sizeof (TransactionId));
 	pq_sendbytes(output, (char *)&snapshot->xmin, sizeof (TransactionId));
 	pq_sendbytes(output, (char *)&snapshot->xmax, sizeof (TransactionId));
 
@@ -120,6 +162,22 @@ StringInfo ProcessGetSnapshot(StringInfo message, StringInfo output)
 	return output;
 }
 
+StringInfo
+ProcessSetXactNodes(StringInfo message, StringInfo output)
+{
+	uint64			nodes;
+
+	pq_copymsgbytes(message, (char *) &nodes, sizeof(nodes));
+	pq_getmsgend(message);
+
+	MyProc->xactNodes |= nodes;
+
+	/* Respond to the client */
+	pq_sendint(output, AGTM_SET_XACT_NODES_RESULT, 4);
+
+	return output;
+}
+
 StringInfo
 ProcessGetXactStatus(StringInfo message, StringInfo output)
 {
@@ -232,6 +290,7 @@ ProcessSequenceAlter(StringInfo message, StringInfo output)
 	RangeVar * rangeVar = NULL;
 	AlterSeqStmt * seqStmt = NULL;
 	StringInfoData	buf;
+	Oid		relid;
 
 	MemoryContext sequece_Context;
 	MemoryContext oldctx = NULL;
@@ -271,7 +330,14 @@ ProcessSequenceAlter(StringInfo message, StringInfo output)
 	seqStmt->sequence = rangeVar;
 	seqStmt->options = option;
 
+	/*
+	 * Drop the reserved results before the change, and the ones reserved
+	 * from the old values while it was made.
+	 */
+	relid = RangeVarGetRelid(rangeVar, NoLock, false);
+	AgtmSequenceForget(relid);
 	AlterSequence(seqStmt);
+	AgtmSequenceForget(relid);
 
 	(void)MemoryContextSwitchTo(oldctx);
 	MemoryContextDelete(sequece_Context);
@@ -293,6 +359,7 @@ ProcessSequenceDrop(StringInfo message, StringInfo output)
 	RangeVar * rangeVar = NULL;
 	StringInfoData	buf;
 	List	*rangValList = NULL;
+	Oid		relid;
 
 	MemoryContext sequece_Context;
 	MemoryContext oldctx = NULL;
@@ -335,7 +402,9 @@ ProcessSequenceDrop(StringInfo message, StringInfo output)
 	rangValList = lappend(rangValList, makeString(buf.data));
 	drop->objects = lappend(drop->objects, (void*)rangValList);
 
+	relid = RangeVarGetRelid(rangeVar, NoLock, false);
 	RemoveRelations((void *)drop);
+	AgtmSequenceForget(relid);
 
 	(void)MemoryContextSwitchTo(oldctx);
 	MemoryContextDelete(sequece_Context);
@@ -380,6 +449,7 @@ ProcessSequenceDropByDatabase(StringInfo message, StringInfo output)
 			RangeVar * rangeVar = NULL;
 			List	*rangValList = NULL;
 			char    *seq = (char *) lfirst(option);
+			Oid		relid;
 			drop = makeNode(DropStmt);
 			rangeVar = makeNode(RangeVar);
 
@@ -397,7 +467,9 @@ ProcessSequenceDropByDatabase(StringInfo message, StringInfo output)
 			rangValList = lappend(rangValList, makeString(seq));
 			drop->objects = lappend(drop->objects, (void*)rangValList);
 
+			relid = RangeVarGetRelid(rangeVar, NoLock, false);
 			RemoveRelations((void *)drop);
+			AgtmSequenceForget(relid);
 		}
 	}
 
@@ -31,6 +31,14 @@
 #include "utils/index_selfuncs.h"
 #include "utils/memutils.h"
 #include "utils/rel.h"
+#ifdef ADB
+#include "funcapi.h"
+#include "utils/acl.h"
+#include "utils/datum.h"
+#include "utils/fmgroids.h"
+#include "utils/lsyscache.h"
+#include "utils/typcache.h"
+#endif
 
 
 /*
@@ -835,6 +843,307 @@ brin_summarize_new_values(PG_FUNCTION_ARGS)
 	PG_RETURN_INT32((int32) numSummarized);
 }
 
+#ifdef ADB
+/* bounds of one heap column, merged over all page ranges of an index */
+typedef struct BrinColumnBounds
+{
+	AttrNumber	heapattno;		/* column of the table, 0 if not reported */
+	bool		hasvalues;
+	bool		hasnulls;
+	Datum		minval;
+	Datum		maxval;
+	FmgrInfo   *cmp;
+	Oid			collation;
+	Oid			typsend;
+} BrinColumnBounds;
+
+/* state of the heap scan of a page range which is not summarized */
+typedef struct BrinBoundsScanState
+{
+	BrinColumnBounds *bounds;
+	TupleDesc	tupdesc;		/* of the index */
+	MemoryContext cxt;			/* where the bounds live */
+} BrinBoundsScanState;
+
+static void brin_bounds_add(BrinColumnBounds *b, Form_pg_attribute attr,
+				Datum minval, Datum maxval);
+static void brin_bounds_callback(Relation index, HeapTuple htup,
+					 Datum *values, bool *isnull,
+					 bool tupleIsAlive, void *state);
+
+/* widen the bounds of a column to include [minval, maxval] */
+static void
+brin_bounds_add(BrinColumnBounds *b, Form_pg_attribute attr,
+				Datum minval, Datum maxval)
+{
+	if (!b->hasvalues ||
+		DatumGetInt32(FunctionCall2Coll(b->cmp, b->collation,
+										minval, b->minval)) < 0)
+	{
+		if (b->hasvalues && !attr->attbyval)
+			pfree(DatumGetPointer(b->minval));
+		b->minval = datumCopy(minval, attr->attbyval, attr->attlen);
+	}
+	if (!b->hasvalues ||
+		DatumGetInt32(FunctionCall2Coll(b->cmp, b->collation,
+										maxval, b->maxval)) > 0)
+	{
+		if (b->hasvalues && !attr->attbyval)
+			pfree(DatumGetPointer(b->maxval));
+		b->maxval = datumCopy(maxval, attr->attbyval, attr->attlen);
+	}
+	b->hasvalues = true;
+}
+
+/*
+ * Per-heap-tuple callback for IndexBuildHeapRangeScan, like
+ * brinbuildCallback but straight into the bounds.
+ */
+static void
+brin_bounds_callback(Relation index, HeapTuple htup, Datum *values,
+					 bool *isnull, bool tupleIsAlive, void *state)
+{
+	BrinBoundsScanState *scanstate = (BrinBoundsScanState *) state;
+	MemoryContext oldcontext;
+	int			keyno;
+
+	oldcontext = MemoryContextSwitchTo(scanstate->cxt);
+	for (keyno = 0; keyno < scanstate->tupdesc->natts; keyno++)
+	{
+		BrinColumnBounds *b = &scanstate->bounds[keyno];
+
+		if (b->heapattno == 0)
+			continue;
+		if (isnull[keyno])
+			b->hasnulls = true;
+		else
+			brin_bounds_add(b, scanstate->tupdesc->attrs[keyno],
+							values[keyno], values[keyno]);
+	}
+	MemoryContextSwitchTo(oldcontext);
+}
+
+/*
+ * SQL-callable function returning the bounds of the values of the columns
+ * of a table that BRIN minmax indexes summarize, so that a coordinator can
+ * tell which datanodes can have rows matching a qual.
+ *
+ * The bounds hold for all rows, including uncommitted ones.  Page ranges
+ * that are not summarized yet, usually the last one of a table that keeps
+ * growing, are read from the heap like summarization would.
+ * minvalue and maxvalue are in the binary format of the column type, which
+ * does not depend on settings like DateStyle; they are NULL when the column
+ * has no non-null values.
+ */
+Datum
+brin_minmax_bounds(PG_FUNCTION_ARGS)
+{
+	Oid			relid = PG_GETARG_OID(0);
+	ReturnSetInfo *rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
+	TupleDesc	tupdesc;
+	Tuplestorestate *tupstore;
+	MemoryContext per_query_ctx;
+	MemoryContext oldcontext;
+	MemoryContext rangecxt;
+	Relation	heapRel;
+	BlockNumber heapNumBlocks;
+	Bitmapset  *reported = NULL;
+	List	   *indexoids;
+	ListCell   *lc;
+	AclResult	aclresult;
+
+	/* check to see if caller supports us returning a tuplestore */
+	if (rsinfo == NULL || !IsA(rsinfo, ReturnSetInfo))
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("set-valued function called in context that cannot accept a set")));
+	if (!(rsinfo->allowedModes & SFRM_Materialize))
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("materialize mode required, but it is not " \
+						"allowed in this context")));
+
+	if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+		elog(ERROR, "return type must be a row type");
+
+	per_query_ctx = rsinfo->econtext->ecxt_per_query_memory;
+	oldcontext = MemoryContextSwitchTo(per_query_ctx);
+	tupstore = tuplestore_begin_heap(true, false, work_mem);
+	rsinfo->returnMode = SFRM_Materialize;
+	rsinfo->setResult = tupstore;
+	rsinfo->setDesc = tupdesc;
+	MemoryContextSwitchTo(oldcontext);
+
+	heapRel = heap_open(relid, AccessShareLock);
+
+	/* the bounds tell about the values, so they need read access */
+	aclresult = pg_class_aclcheck(relid, GetUserId(), ACL_SELECT);
+	if (aclresult != ACLCHECK_OK)
+		aclcheck_error(aclresult, ACL_KIND_CLASS,
+					   RelationGetRelationName(heapRel));
+
+	rangecxt = AllocSetContextCreate(CurrentMemoryContext,
+									 "brin bounds cxt",
+									 ALLOCSET_DEFAULT_SIZES);
+
+	heapNumBlocks = RelationGetNumberOfBlocks(heapRel);
+	indexoids = RelationGetIndexList(heapRel);
+	foreach(lc, indexoids)
+	{
+		Relation	indexRel;
+		IndexInfo  *indexInfo = NULL;
+		BrinDesc   *bdesc;
+		BrinRevmap *revmap;
+		BrinColumnBounds *bounds;
+		BrinBoundsScanState scanstate;
+		BlockNumber pagesPerRange;
+		BlockNumber heapBlk;
+		Buffer		buf = InvalidBuffer;
+		int			natts;
+		int			keyno;
+
+		indexRel = index_open(lfirst_oid(lc), AccessShareLock);
+		if (indexRel->rd_rel->relam != BRIN_AM_OID ||
+			!IndexIsValid(indexRel->rd_index))
+		{
+			index_close(indexRel, AccessShareLock);
+			continue;
+		}
+
+		/* plain columns with a minmax opclass, not reported yet */
+		natts = RelationGetDescr(indexRel)->natts;
+		bounds = (BrinColumnBounds *) palloc0(natts * sizeof(BrinColumnBounds));
+		for (keyno = 0; keyno < natts; keyno++)
+		{
+			AttrNumber	heapattno = indexRel->rd_index->indkey.values[keyno];
+			Oid			typid = RelationGetDescr(indexRel)->attrs[keyno]->atttypid;
+			TypeCacheEntry *typentry;
+			int16		typlen;
+			bool		typbyval;
+			char		typalign;
+			char		typdelim;
+			Oid			typioparam;
+			Oid			typsend;
+
+			if (heapattno <= 0 || bms_is_member(heapattno, reported) ||
+				index_getprocid(indexRel, keyno + 1, BRIN_PROCNUM_OPCINFO) !=
+				F_BRIN_MINMAX_OPCINFO)
+				continue;
+
+			typentry = lookup_type_cache(typid, TYPECACHE_CMP_PROC_FINFO);
+			get_type_io_data(typid, IOFunc_send, &typlen, &typbyval, &typalign,
+							 &typdelim, &typioparam, &typsend);
+			if (!OidIsValid(typentry->cmp_proc_finfo.fn_oid) ||
+				!OidIsValid(typsend))
+				continue;
+
+			bounds[keyno].heapattno = heapattno;
+			bounds[keyno].cmp = &typentry->cmp_proc_finfo;
+			bounds[keyno].collation = indexRel->rd_indcollation[keyno];
+			bounds[keyno].typsend = typsend;
+		}
+
+		bdesc = brin_build_desc(indexRel);
+		revmap = brinRevmapInitialize(indexRel, &pagesPerRange, NULL);
+
+		scanstate.bounds = bounds;
+		scanstate.tupdesc = bdesc->bd_tupdesc;
+		scanstate.cxt = CurrentMemoryContext;
+
+		for (heapBlk = 0; heapBlk < heapNumBlocks; heapBlk += pagesPerRange)
+		{
+			BrinTuple  *tup;
+			BrinMemTuple *dtup;
+			OffsetNumber off;
+			Size		size;
+
+			CHECK_FOR_INTERRUPTS();
+
+			MemoryContextReset(rangecxt);
+			oldcontext = MemoryContextSwitchTo(rangecxt);
+
+			tup = brinGetTupleForHeapBlock(revmap, heapBlk, &buf, &off, &size,
+										   BUFFER_LOCK_SHARE, NULL);
+			if (tup)
+			{
+				tup = brin_copy_tuple(tup, size);
+				LockBuffer(buf, BUFFER_LOCK_UNLOCK);
+			}
+
+			/* a range not summarized yet is read from the heap instead */
+			if (tup == NULL || (dtup = brin_deform_tuple(bdesc, tup))->bt_placeholder)
+			{
+				MemoryContextSwitchTo(oldcontext);
+				if (indexInfo == NULL)
+					indexInfo = BuildIndexInfo(indexRel);
+				IndexBuildHeapRangeScan(heapRel, indexRel, indexInfo, false, true,
+										heapBlk,
+										Min(pagesPerRange, heapNumBlocks - heapBlk),
+										brin_bounds_callback, (void *) &scanstate);
+				continue;
+			}
+
+			MemoryContextSwitchTo(oldcontext);
+
+			for (keyno = 0; keyno < natts; keyno++)
+			{
+				BrinColumnBounds *b = &bounds[keyno];
+				BrinValues *bval = &dtup->bt_columns[keyno];
+
+				if (b->heapattno == 0)
+					continue;
+				if (bval->bv_hasnulls)
+					b->hasnulls = true;
+				if (bval->bv_allnulls)
+					continue;
+
+				brin_bounds_add(b, bdesc->bd_tupdesc->attrs[keyno],
+								bval->bv_values[0], bval->bv_values[1]);
+			}
+		}
+
+		if (BufferIsValid(buf))
+			ReleaseBuffer(buf);
+		brinRevmapTerminate(revmap);
+
+		for (keyno = 0; keyno < natts; keyno++)
+		{
+			BrinColumnBounds *b = &bounds[keyno];
+			Datum		values[4];
+			bool		nulls[4];
+
+			if (b->heapattno == 0)
+				continue;
+
+			MemSet(nulls, 0, sizeof(nulls));
+			values[0] = Int16GetDatum(b->heapattno);
+			if (b->hasvalues)
+			{
+				values[1] = PointerGetDatum(OidSendFunctionCall(b->typsend, b->minval));
+				values[2] = PointerGetDatum(OidSendFunctionCall(b->typsend, b->maxval));
+			}
+			else
+				nulls[1] = nulls[2] = true;
+			values[3] = BoolGetDatum(b->hasnulls);
+
+			tuplestore_putvalues(tupstore, tupdesc, values, nulls);
+			reported = bms_add_member(reported, b->heapattno);
+		}
+
+		brin_free_desc(bdesc);
+		pfree(bounds);
+		index_close(indexRel, AccessShareLock);
+	}
+
+	MemoryContextDelete(rangecxt);
+	heap_close(heapRel, AccessShareLock);
+
+	tuplestore_donestoring(tupstore);
+
+	return (Datum) 0;
+}
+#endif
+
 /*
  * Build a BrinDesc used to create or scan a BRIN index
  */
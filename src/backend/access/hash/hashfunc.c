@@ -531,6 +531,21 @@ hash_uint32(uint32 k)
 }
 
 #ifdef ADB
+/*
+ * adb_hash_combine() -- mix the hash of one more column into the hash of
+ * the columns before it, for multi-column hash distribution
+ */
+Datum
+adb_hash_combine(PG_FUNCTION_ARGS)
+{
+	uint32		a = (uint32) PG_GETARG_INT32(0);
+	uint32		b = (uint32) PG_GETARG_INT32(1);
+
+	a ^= b + 0x9e3779b9 + (a << 6) + (a >> 2);
+
+	PG_RETURN_INT32((int32) a);
+}
+
 /*
  * compute_hash()
  * Generic hash function for all datatypes
@@ -70,6 +70,9 @@
 #include "utils/lsyscache.h"
 #include "utils/relcache.h"
 #include "utils/snapmgr.h"
+#ifdef ADB
+#include "utils/spccache.h"
+#endif
 #include "utils/syscache.h"
 #include "utils/tqual.h"
 #ifdef ADB
@@ -92,6 +95,9 @@ static HeapScanDesc heap_beginscan_internal(Relation relation,
 						bool is_samplescan,
 						bool temp_snap);
 static BlockNumber heap_parallelscan_nextpage(HeapScanDesc scan);
+#ifdef ADB
+static void heapprefetch(HeapScanDesc scan, BlockNumber page);
+#endif
 static HeapTuple heap_prepare_insert(Relation relation, HeapTuple tup,
 					TransactionId xid, CommandId cid, int options);
 static XLogRecPtr log_heap_update(Relation reln, Buffer oldbuf,
@@ -296,6 +302,32 @@ initscan(HeapScanDesc scan, ScanKey key, bool keep_startblock)
 		scan->rs_startblock = 0;
 	}
 
+#ifdef ADB
+	/*
+	 * Plain scans of user tables prefetch the blocks they read next.  The
+	 * distance is limited as for bitmap heap scans, by the tablespace's
+	 * effective_io_concurrency.  Parallel scans hand blocks out one at a
+	 * time, so there is nothing to read ahead of.
+	 */
+	scan->rs_prefetch_maximum = 0;
+	if (scan->rs_parallel == NULL &&
+		!scan->rs_bitmapscan && !scan->rs_samplescan &&
+		!RelationUsesLocalBuffers(scan->rs_rd) &&
+		!IsCatalogRelation(scan->rs_rd) &&
+		scan->rs_nblocks > 1)
+	{
+		double		maximum;
+
+		if (ComputeIoConcurrency(get_tablespace_io_concurrency(scan->rs_rd->rd_rel->reltablespace),
+								 &maximum))
+			scan->rs_prefetch_maximum = (int) maximum;
+	}
+	scan->rs_prefetch_target = 0;
+	scan->rs_prefetch_pages = 0;
+	scan->rs_prefetch_next = InvalidBlockNumber;
+	scan->rs_prefetch_left = 0;
+#endif
+
 	scan->rs_numblocks = InvalidBlockNumber;
 	scan->rs_inited = false;
 	scan->rs_ctup.t_data = NULL;
@@ -339,6 +371,65 @@ heap_setscanlimits(HeapScanDesc scan, BlockNumber startBlk, BlockNumber numBlks)
 	scan->rs_numblocks = numBlks;
 }
 
+#ifdef ADB
+/*
+ * heapprefetch - subroutine for heapgetpage()
+ *
+ * Issue prefetch requests for the blocks following page, so that their I/O
+ * overlaps with the processing of this one.  As in BitmapHeapNext, requests
+ * go out after the current page was read, and the distance starts small and
+ * grows to rs_prefetch_maximum, so that a scan stopped early by a LIMIT
+ * does not read much it will not use.  Called before rs_cblock is advanced;
+ * a scan which does not move forward one block at a time stops prefetching.
+ */
+static void
+heapprefetch(HeapScanDesc scan, BlockNumber page)
+{
+	if (scan->rs_prefetch_next == InvalidBlockNumber)
+	{
+		/* first page of the scan */
+		if (scan->rs_numblocks != InvalidBlockNumber)
+			scan->rs_prefetch_left = scan->rs_numblocks;
+		else
+			scan->rs_prefetch_left = scan->rs_nblocks;
+		scan->rs_prefetch_next = page;
+	}
+	else if (page != (scan->rs_cblock + 1) % scan->rs_nblocks)
+	{
+		scan->rs_prefetch_maximum = 0;
+		return;
+	}
+
+	if (scan->rs_prefetch_pages > 0)
+		scan->rs_prefetch_pages--;
+	else if (scan->rs_prefetch_left > 0)
+	{
+		/* the page just read was not prefetched, skip over it */
+		Assert(scan->rs_prefetch_next == page);
+		scan->rs_prefetch_next = (page + 1) % scan->rs_nblocks;
+		scan->rs_prefetch_left--;
+	}
+
+	if (scan->rs_prefetch_target >= scan->rs_prefetch_maximum)
+		 /* don't increase any further */ ;
+	else if (scan->rs_prefetch_target >= scan->rs_prefetch_maximum / 2)
+		scan->rs_prefetch_target = scan->rs_prefetch_maximum;
+	else if (scan->rs_prefetch_target > 0)
+		scan->rs_prefetch_target *= 2;
+	else
+		scan->rs_prefetch_target++;
+
+	while (scan->rs_prefetch_pages < scan->rs_prefetch_target &&
+		   scan->rs_prefetch_left > 0)
+	{
+		PrefetchBuffer(scan->rs_rd, MAIN_FORKNUM, scan->rs_prefetch_next);
+		scan->rs_prefetch_next = (scan->rs_prefetch_next + 1) % scan->rs_nblocks;
+		scan->rs_prefetch_left--;
+		scan->rs_prefetch_pages++;
+	}
+}
+#endif
+
 /*
  * heapgetpage - subroutine for heapgettup()
  *
@@ -377,6 +468,10 @@ heapgetpage(HeapScanDesc scan, BlockNumber page)
 	/* read page using selected strategy */
 	scan->rs_cbuf = ReadBufferExtended(scan->rs_rd, MAIN_FORKNUM, page,
 									   RBM_NORMAL, scan->rs_strategy);
+#ifdef ADB
+	if (scan->rs_prefetch_maximum > 0)
+		heapprefetch(scan, page);
+#endif
 	scan->rs_cblock = page;
 
 	if (!scan->rs_pageatatime)
@@ -1621,6 +1716,10 @@ heap_endscan(HeapScanDesc scan)
 Size
 heap_parallelscan_estimate(Snapshot snapshot)
 {
+#ifdef ADB
+	if (snapshot == SnapshotAny)
+		return offsetof(ParallelHeapScanDescData, phs_snapshot_data);
+#endif
 	return add_size(offsetof(ParallelHeapScanDescData, phs_snapshot_data),
 					EstimateSnapshotSpace(snapshot));
 }
@@ -1646,6 +1745,12 @@ heap_parallelscan_initialize(ParallelHeapScanDesc target, Relation relation,
 	SpinLockInit(&target->phs_mutex);
 	target->phs_cblock = InvalidBlockNumber;
 	target->phs_startblock = InvalidBlockNumber;
+#ifdef ADB
+	/* index builds scan with SnapshotAny and check visibility themselves */
+	target->phs_snapshot_any = (snapshot == SnapshotAny);
+	if (target->phs_snapshot_any)
+		return;
+#endif
 	SerializeSnapshot(snapshot, target->phs_snapshot_data);
 }
 
@@ -1661,6 +1766,12 @@ heap_beginscan_parallel(Relation relation, ParallelHeapScanDesc parallel_scan)
 	Snapshot	snapshot;
 
 	Assert(RelationGetRelid(relation) == parallel_scan->phs_relid);
+#ifdef ADB
+	if (parallel_scan->phs_snapshot_any)
+		return heap_beginscan_internal(relation, SnapshotAny, 0, NULL,
+									   parallel_scan, true, true, true,
+									   false, false, false);
+#endif
 	snapshot = RestoreSnapshot(parallel_scan->phs_snapshot_data);
 	RegisterSnapshot(snapshot);
 
@@ -151,6 +151,15 @@ btbuild(Relation heap, Relation index, IndexInfo *indexInfo)
 		elog(ERROR, "index \"%s\" already contains data",
 			 RelationGetRelationName(index));
 
+#ifdef ADB
+	{
+		int			nworkers = _bt_parallel_workers(heap, index, indexInfo);
+
+		if (nworkers > 0)
+			return _bt_parallel_build(heap, index, indexInfo, nworkers);
+	}
+#endif
+
 	buildstate.spool = _bt_spoolinit(heap, index, indexInfo->ii_Unique, false);
 
 	/*
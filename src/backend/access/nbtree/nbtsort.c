@@ -75,6 +75,21 @@
 #include "utils/rel.h"
 #include "utils/sortsupport.h"
 #include "utils/tuplesort.h"
+#ifdef ADB
+#include "access/parallel.h"
+#include "access/relscan.h"
+#include "access/xact.h"
+#include "catalog/catalog.h"
+#include "catalog/index.h"
+#include "lib/binaryheap.h"
+#include "optimizer/clauses.h"
+#include "optimizer/paths.h"
+#include "storage/dsm_impl.h"
+#include "storage/proc.h"
+#include "storage/shm_mq.h"
+#include "storage/spin.h"
+#include "utils/snapmgr.h"
+#endif
 
 
 /*
@@ -831,3 +846,710 @@ _bt_load(BTWriteState *wstate, BTSpool *btspool, BTSpool *btspool2)
 		smgrimmedsync(wstate->index->rd_smgr, MAIN_FORKNUM);
 	}
 }
+
+#ifdef ADB
+/*
+ * Parallel build
+ *
+ * The leader and its workers scan the heap together, each taking the blocks
+ * it gets from a parallel heap scan, and sort what they scanned in their own
+ * spools.  Workers then send their tuples, in order, through a queue to the
+ * leader, which merges them with its own and loads the btree as _bt_load
+ * does.  Uniqueness is checked within each spool by tuplesort, and across
+ * participants by the merge.
+ */
+
+/* shm_toc keys */
+#define PARALLEL_KEY_BTREE_SHARED		UINT64CONST(0xB000000000000001)
+#define PARALLEL_KEY_BTREE_QUEUES		UINT64CONST(0xB000000000000002)
+
+/* size of the queue of each worker */
+#define BT_PARALLEL_QUEUE_SIZE			65536
+
+/*
+ * least sort memory of a participant, in kilobytes.  The default 64MB of
+ * maintenance_work_mem then allows the default two workers, and a smaller
+ * share only makes each participant write more runs.
+ */
+#define BT_PARALLEL_MIN_SORTMEM			16384
+
+/*
+ * State shared by the participants, followed by the parallel heap scan
+ */
+typedef struct BTShared
+{
+	Oid			heaprelid;
+	Oid			indexrelid;
+	bool		isunique;
+	bool		isconcurrent;
+	int			sortmem;		/* kilobytes of each participant */
+
+	/* results of the participants, protected by mutex */
+	slock_t		mutex;
+	double		reltuples;
+	double		indtuples;
+	bool		brokenhotchain;
+} BTShared;
+
+#define ParallelHeapScanFromBTShared(shared) \
+	((ParallelHeapScanDesc) ((char *) (shared) + BUFFERALIGN(sizeof(BTShared))))
+
+/*
+ * Spools of one participant, as BTBuildState in nbtree.c
+ */
+typedef struct BTParticipant
+{
+	BTSpool    *spool;
+	BTSpool    *spool2;			/* dead tuples of a unique index */
+	bool		haveDead;
+	double		indtuples;
+} BTParticipant;
+
+/*
+ * Reads the tuples of a participant in order, merging spool and spool2
+ */
+typedef struct BTSpoolReader
+{
+	BTSpool    *spool;
+	BTSpool    *spool2;
+	IndexTuple	itup;
+	IndexTuple	itup2;
+	bool		should_free;
+	bool		should_free2;
+	int			last;			/* spool the last tuple came from, or 0 */
+	int			keysz;
+	TupleDesc	tupdes;
+	SortSupport sortKeys;
+} BTSpoolReader;
+
+/*
+ * One sorted input of the leader's merge
+ */
+typedef struct BTMergeInput
+{
+	shm_mq_handle *mqh;			/* queue of a worker, NULL for the leader */
+	BTSpoolReader *reader;		/* spools of the leader */
+	IndexTuple	itup;			/* current tuple, NULL at end */
+	bool		live;			/* not from the dead tuple spool */
+} BTMergeInput;
+
+typedef struct BTMergeState
+{
+	BTMergeInput *inputs;
+	int			keysz;
+	TupleDesc	tupdes;
+	SortSupport sortKeys;
+} BTMergeState;
+
+static SortSupport _bt_parallel_sortkeys(Relation index);
+static int _bt_parallel_keycompare(SortSupport sortKeys, int keysz,
+						TupleDesc tupdes, IndexTuple itup,
+						IndexTuple itup2, bool *hasnull);
+static void _bt_parallel_callback(Relation index, HeapTuple htup,
+					  Datum *values, bool *isnull,
+					  bool tupleIsAlive, void *state);
+static void _bt_parallel_scan_and_sort(BTShared *btshared, Relation heap,
+						   Relation index, BTParticipant *participant);
+static void _bt_parallel_reader_init(BTSpoolReader *reader,
+						 BTParticipant *participant);
+static IndexTuple _bt_parallel_read(BTSpoolReader *reader, bool *live);
+static bool _bt_parallel_input_next(BTMergeInput *input);
+static int	_bt_parallel_heap_compare(Datum a, Datum b, void *arg);
+static void _bt_parallel_merge(BTWriteState *wstate, BTMergeInput *inputs,
+				   int ninputs, bool isunique);
+static void _bt_parallel_build_main(dsm_segment *seg, shm_toc *toc);
+
+/*
+ * _bt_parallel_workers - number of workers to build an index with
+ *
+ * As for a parallel sequential scan, one more worker each time the table
+ * triples in size beyond min_parallel_relation_size, or its parallel_workers
+ * option.  The count is limited by max_parallel_maintenance_workers and so
+ * that each participant sorts in at least BT_PARALLEL_MIN_SORTMEM.
+ */
+int
+_bt_parallel_workers(Relation heap, Relation index, IndexInfo *indexInfo)
+{
+	int			nworkers;
+
+	if (max_parallel_maintenance_workers <= 0 ||
+		!IsUnderPostmaster ||
+		IsBootstrapProcessingMode() ||
+		IsInParallelMode() ||
+		IsolationIsSerializable() ||
+		dynamic_shared_memory_type == DSM_IMPL_NONE ||
+		RelationUsesLocalBuffers(heap) ||
+		IsSystemRelation(heap))
+		return 0;
+
+	/* workers evaluate the index expressions and predicate */
+	if (has_parallel_hazard((Node *) indexInfo->ii_Expressions, false) ||
+		has_parallel_hazard((Node *) indexInfo->ii_Predicate, false))
+		return 0;
+
+	nworkers = RelationGetParallelWorkers(heap, -1);
+	if (nworkers < 0)
+	{
+		BlockNumber nblocks = RelationGetNumberOfBlocks(heap);
+		int			threshold = Max(min_parallel_relation_size, 1);
+
+		if (nblocks < (BlockNumber) threshold)
+			return 0;
+
+		nworkers = 1;
+		while (nblocks >= (BlockNumber) threshold * 3)
+		{
+			nworkers++;
+			threshold *= 3;
+			if (threshold > INT_MAX / 3)
+				break;
+		}
+	}
+
+	nworkers = Min(nworkers, max_parallel_maintenance_workers);
+	while (nworkers > 0 &&
+		   maintenance_work_mem / (nworkers + 1) < BT_PARALLEL_MIN_SORTMEM)
+		nworkers--;
+
+	return nworkers;
+}
+
+/*
+ * _bt_parallel_build - build a btree with the leader and nworkers workers
+ *
+ * The leader takes part in the scan, so the build completes even when no
+ * worker could be launched.
+ */
+IndexBuildResult *
+_bt_parallel_build(Relation heap, Relation index, IndexInfo *indexInfo,
+				   int nworkers)
+{
+	IndexBuildResult *result;
+	ParallelContext *pcxt;
+	BTShared   *btshared;
+	BTParticipant leader;
+	BTSpoolReader reader;
+	BTMergeInput *inputs;
+	BTWriteState wstate;
+	Snapshot	snapshot;
+	Size		estshared;
+	char	   *mqspace;
+	int			ninputs;
+	int			i;
+
+	Assert(nworkers > 0);
+
+	EnterParallelMode();
+	pcxt = CreateParallelContext(_bt_parallel_build_main, nworkers);
+
+	/* as IndexBuildHeapScan, see there */
+	if (indexInfo->ii_Concurrent)
+		snapshot = RegisterSnapshot(GetTransactionSnapshot());
+	else
+		snapshot = SnapshotAny;
+
+	estshared = add_size(BUFFERALIGN(sizeof(BTShared)),
+						 heap_parallelscan_estimate(snapshot));
+	shm_toc_estimate_chunk(&pcxt->estimator, estshared);
+	shm_toc_estimate_chunk(&pcxt->estimator,
+						   mul_size(BT_PARALLEL_QUEUE_SIZE, pcxt->nworkers));
+	shm_toc_estimate_keys(&pcxt->estimator, 2);
+
+	InitializeParallelDSM(pcxt);
+
+	btshared = (BTShared *) shm_toc_allocate(pcxt->toc, estshared);
+	btshared->heaprelid = RelationGetRelid(heap);
+	btshared->indexrelid = RelationGetRelid(index);
+	btshared->isunique = indexInfo->ii_Unique;
+	btshared->isconcurrent = indexInfo->ii_Concurrent;
+	btshared->sortmem = maintenance_work_mem / (nworkers + 1);
+	SpinLockInit(&btshared->mutex);
+	btshared->reltuples = 0;
+	btshared->indtuples = 0;
+	btshared->brokenhotchain = false;
+	heap_parallelscan_initialize(ParallelHeapScanFromBTShared(btshared),
+								 heap, snapshot);
+	shm_toc_insert(pcxt->toc, PARALLEL_KEY_BTREE_SHARED, btshared);
+
+	/* the leader receives from every worker */
+	mqspace = shm_toc_allocate(pcxt->toc,
+							   mul_size(BT_PARALLEL_QUEUE_SIZE, pcxt->nworkers));
+	inputs = (BTMergeInput *) palloc0(sizeof(BTMergeInput) * (pcxt->nworkers + 1));
+	for (i = 0; i < pcxt->nworkers; i++)
+	{
+		shm_mq	   *mq;
+
+		mq = shm_mq_create(mqspace + i * BT_PARALLEL_QUEUE_SIZE,
+						   (Size) BT_PARALLEL_QUEUE_SIZE);
+		shm_mq_set_receiver(mq, MyProc);
+		inputs[i + 1].mqh = shm_mq_attach(mq, pcxt->seg, NULL);
+	}
+	shm_toc_insert(pcxt->toc, PARALLEL_KEY_BTREE_QUEUES, mqspace);
+
+	LaunchParallelWorkers(pcxt);
+	for (i = 0; i < pcxt->nworkers_launched; i++)
+		shm_mq_set_handle(inputs[i + 1].mqh, pcxt->worker[i].bgwhandle);
+
+	/* do our share of the scan, then merge everything */
+	_bt_parallel_scan_and_sort(btshared, heap, index, &leader);
+	_bt_parallel_reader_init(&reader, &leader);
+	inputs[0].reader = &reader;
+	ninputs = pcxt->nworkers_launched + 1;
+
+	wstate.heap = heap;
+	wstate.index = index;
+	wstate.btws_use_wal = XLogIsNeeded() && RelationNeedsWAL(index);
+	wstate.btws_pages_alloced = BTREE_METAPAGE + 1;
+	wstate.btws_pages_written = 0;
+	wstate.btws_zeropage = NULL;
+
+	_bt_parallel_merge(&wstate, inputs, ninputs, indexInfo->ii_Unique);
+
+	/* reports errors of the workers, if any */
+	WaitForParallelWorkersToFinish(pcxt);
+
+	result = (IndexBuildResult *) palloc(sizeof(IndexBuildResult));
+	result->heap_tuples = btshared->reltuples;
+	result->index_tuples = btshared->indtuples;
+	if (btshared->brokenhotchain)
+		indexInfo->ii_BrokenHotChain = true;
+
+	_bt_spooldestroy(leader.spool);
+	if (leader.spool2)
+		_bt_spooldestroy(leader.spool2);
+	DestroyParallelContext(pcxt);
+	if (IsMVCCSnapshot(snapshot))
+		UnregisterSnapshot(snapshot);
+	ExitParallelMode();
+
+	return result;
+}
+
+/*
+ * Entry point of a worker
+ */
+static void
+_bt_parallel_build_main(dsm_segment *seg, shm_toc *toc)
+{
+	BTShared   *btshared;
+	BTParticipant participant;
+	BTSpoolReader reader;
+	Relation	heap;
+	Relation	index;
+	LOCKMODE	heapLockmode;
+	LOCKMODE	indexLockmode;
+	shm_mq	   *mq;
+	shm_mq_handle *mqh;
+	IndexTuple	itup;
+	bool		live;
+
+	btshared = shm_toc_lookup(toc, PARALLEL_KEY_BTREE_SHARED);
+
+	/* as the leader, see index_build callers */
+	if (!btshared->isconcurrent)
+	{
+		heapLockmode = ShareLock;
+		indexLockmode = AccessExclusiveLock;
+	}
+	else
+	{
+		heapLockmode = ShareUpdateExclusiveLock;
+		indexLockmode = RowExclusiveLock;
+	}
+	heap = heap_open(btshared->heaprelid, heapLockmode);
+	index = index_open(btshared->indexrelid, indexLockmode);
+
+	mq = (shm_mq *) ((char *) shm_toc_lookup(toc, PARALLEL_KEY_BTREE_QUEUES) +
+					 ParallelWorkerNumber * BT_PARALLEL_QUEUE_SIZE);
+	shm_mq_set_sender(mq, MyProc);
+	mqh = shm_mq_attach(mq, seg, NULL);
+
+	_bt_parallel_scan_and_sort(btshared, heap, index, &participant);
+
+	/* send a flag byte, whether the tuple is live, then the tuple */
+	_bt_parallel_reader_init(&reader, &participant);
+	while ((itup = _bt_parallel_read(&reader, &live)) != NULL)
+	{
+		shm_mq_iovec iov[2];
+		char		flag = live ? 1 : 0;
+
+		iov[0].data = &flag;
+		iov[0].len = 1;
+		iov[1].data = (const char *) itup;
+		iov[1].len = IndexTupleSize(itup);
+		if (shm_mq_sendv(mqh, iov, 2, false) == SHM_MQ_DETACHED)
+			break;				/* the leader failed, it reports why */
+	}
+	shm_mq_detach(mq);
+
+	_bt_spooldestroy(participant.spool);
+	if (participant.spool2)
+		_bt_spooldestroy(participant.spool2);
+	index_close(index, indexLockmode);
+	heap_close(heap, heapLockmode);
+}
+
+/*
+ * Scan the blocks the parallel scan gives us and sort their tuples
+ */
+static void
+_bt_parallel_scan_and_sort(BTShared *btshared, Relation heap, Relation index,
+						   BTParticipant *participant)
+{
+	IndexInfo  *indexInfo;
+	HeapScanDesc scan;
+	double		reltuples;
+
+	indexInfo = BuildIndexInfo(index);
+	indexInfo->ii_Concurrent = btshared->isconcurrent;
+
+	participant->spool = (BTSpool *) palloc0(sizeof(BTSpool));
+	participant->spool->heap = heap;
+	participant->spool->index = index;
+	participant->spool->isunique = btshared->isunique;
+	participant->spool->sortstate =
+		tuplesort_begin_index_btree(heap, index, btshared->isunique,
+									btshared->sortmem, false);
+	participant->spool2 = NULL;
+	if (btshared->isunique)
+	{
+		/* as _bt_spoolinit, dead tuples are expected to be few */
+		participant->spool2 = (BTSpool *) palloc0(sizeof(BTSpool));
+		participant->spool2->heap = heap;
+		participant->spool2->index = index;
+		participant->spool2->isunique = false;
+		participant->spool2->sortstate =
+			tuplesort_begin_index_btree(heap, index, false, work_mem, false);
+	}
+	participant->haveDead = false;
+	participant->indtuples = 0;
+
+	scan = heap_beginscan_parallel(heap, ParallelHeapScanFromBTShared(btshared));
+	reltuples = IndexBuildHeapScanParallel(heap, index, indexInfo, scan,
+										   _bt_parallel_callback,
+										   (void *) participant);
+
+	if (participant->spool2 && !participant->haveDead)
+	{
+		_bt_spooldestroy(participant->spool2);
+		participant->spool2 = NULL;
+	}
+
+	tuplesort_performsort(participant->spool->sortstate);
+	if (participant->spool2)
+		tuplesort_performsort(participant->spool2->sortstate);
+
+	SpinLockAcquire(&btshared->mutex);
+	btshared->reltuples += reltuples;
+	btshared->indtuples += participant->indtuples;
+	if (indexInfo->ii_BrokenHotChain)
+		btshared->brokenhotchain = true;
+	SpinLockRelease(&btshared->mutex);
+}
+
+/*
+ * Per-tuple callback from IndexBuildHeapScanParallel, as btbuildCallback
+ */
+static void
+_bt_parallel_callback(Relation index, HeapTuple htup, Datum *values,
+					  bool *isnull, bool tupleIsAlive, void *state)
+{
+	BTParticipant *participant = (BTParticipant *) state;
+
+	if (tupleIsAlive || participant->spool2 == NULL)
+		_bt_spool(participant->spool, &htup->t_self, values, isnull);
+	else
+	{
+		participant->haveDead = true;
+		_bt_spool(participant->spool2, &htup->t_self, values, isnull);
+	}
+
+	participant->indtuples += 1;
+}
+
+/*
+ * Prepare SortSupport data for each column, as _bt_load
+ */
+static SortSupport
+_bt_parallel_sortkeys(Relation index)
+{
+	int			keysz = RelationGetNumberOfAttributes(index);
+	ScanKey		indexScanKey = _bt_mkscankey_nodata(index);
+	SortSupport sortKeys;
+	int			i;
+
+	sortKeys = (SortSupport) palloc0(keysz * sizeof(SortSupportData));
+	for (i = 0; i < keysz; i++)
+	{
+		SortSupport sortKey = sortKeys + i;
+		ScanKey		scanKey = indexScanKey + i;
+		int16		strategy;
+
+		sortKey->ssup_cxt = CurrentMemoryContext;
+		sortKey->ssup_collation = scanKey->sk_collation;
+		sortKey->ssup_nulls_first =
+			(scanKey->sk_flags & SK_BT_NULLS_FIRST) != 0;
+		sortKey->ssup_attno = scanKey->sk_attno;
+		/* Abbreviation is not supported here */
+		sortKey->abbreviate = false;
+
+		AssertState(sortKey->ssup_attno != 0);
+
+		strategy = (scanKey->sk_flags & SK_BT_DESC) != 0 ?
+			BTGreaterStrategyNumber : BTLessStrategyNumber;
+
+		PrepareSortSupportFromIndexRel(index, strategy, sortKey);
+	}
+	_bt_freeskey(indexScanKey);
+
+	return sortKeys;
+}
+
+/*
+ * Compare the keys of two index tuples, noting in *hasnull whether any of
+ * them is null
+ */
+static int
+_bt_parallel_keycompare(SortSupport sortKeys, int keysz, TupleDesc tupdes,
+						IndexTuple itup, IndexTuple itup2, bool *hasnull)
+{
+	int			i;
+
+	if (hasnull)
+		*hasnull = false;
+	for (i = 1; i <= keysz; i++)
+	{
+		Datum		attrDatum1,
+					attrDatum2;
+		bool		isNull1,
+					isNull2;
+		int32		compare;
+
+		attrDatum1 = index_getattr(itup, i, tupdes, &isNull1);
+		attrDatum2 = index_getattr(itup2, i, tupdes, &isNull2);
+		if (hasnull && (isNull1 || isNull2))
+			*hasnull = true;
+
+		compare = ApplySortComparator(attrDatum1, isNull1,
+									  attrDatum2, isNull2,
+									  sortKeys + i - 1);
+		if (compare != 0)
+			return compare;
+	}
+
+	return 0;
+}
+
+static void
+_bt_parallel_reader_init(BTSpoolReader *reader, BTParticipant *participant)
+{
+	reader->spool = participant->spool;
+	reader->spool2 = participant->spool2;
+	reader->itup = tuplesort_getindextuple(reader->spool->sortstate,
+										   true, &reader->should_free);
+	reader->itup2 = NULL;
+	reader->should_free2 = false;
+	if (reader->spool2)
+		reader->itup2 = tuplesort_getindextuple(reader->spool2->sortstate,
+												true, &reader->should_free2);
+	reader->last = 0;
+	reader->keysz = RelationGetNumberOfAttributes(reader->spool->index);
+	reader->tupdes = RelationGetDescr(reader->spool->index);
+	reader->sortKeys = reader->spool2 ? _bt_parallel_sortkeys(reader->spool->index) : NULL;
+}
+
+/*
+ * Next tuple of a participant, NULL at end.  It is valid until the next
+ * call.
+ */
+static IndexTuple
+_bt_parallel_read(BTSpoolReader *reader, bool *live)
+{
+	/* advance the spool the previous tuple came from */
+	if (reader->last == 1)
+	{
+		if (reader->should_free)
+			pfree(reader->itup);
+		reader->itup = tuplesort_getindextuple(reader->spool->sortstate,
+											   true, &reader->should_free);
+	}
+	else if (reader->last == 2)
+	{
+		if (reader->should_free2)
+			pfree(reader->itup2);
+		reader->itup2 = tuplesort_getindextuple(reader->spool2->sortstate,
+												true, &reader->should_free2);
+	}
+
+	/* on equal keys the live tuple goes first, as in _bt_load */
+	if (reader->itup2 == NULL)
+		reader->last = reader->itup ? 1 : 0;
+	else if (reader->itup == NULL)
+		reader->last = 2;
+	else if (_bt_parallel_keycompare(reader->sortKeys, reader->keysz,
+									 reader->tupdes, reader->itup,
+									 reader->itup2, NULL) <= 0)
+		reader->last = 1;
+	else
+		reader->last = 2;
+
+	*live = (reader->last == 1);
+	if (reader->last == 1)
+		return reader->itup;
+	if (reader->last == 2)
+		return reader->itup2;
+	return NULL;
+}
+
+/*
+ * Move an input of the merge to its next tuple, false at end
+ */
+static bool
+_bt_parallel_input_next(BTMergeInput *input)
+{
+	shm_mq_result res;
+	Size		nbytes;
+	void	   *data;
+
+	if (input->mqh == NULL)
+	{
+		input->itup = _bt_parallel_read(input->reader, &input->live);
+		return input->itup != NULL;
+	}
+
+	if (input->itup)
+		pfree(input->itup);
+	input->itup = NULL;
+
+	/* a worker which failed detaches, the leader reports its error later */
+	res = shm_mq_receive(input->mqh, &nbytes, &data, false);
+	if (res == SHM_MQ_DETACHED)
+		return false;
+	Assert(res == SHM_MQ_SUCCESS && nbytes > 1);
+
+	/* copied for alignment, and to outlive the next receive */
+	input->live = ((char *) data)[0] != 0;
+	input->itup = (IndexTuple) palloc(nbytes - 1);
+	memcpy(input->itup, (char *) data + 1, nbytes - 1);
+
+	return true;
+}
+
+/*
+ * binaryheap comparator, the smallest tuple first
+ */
+static int
+_bt_parallel_heap_compare(Datum a, Datum b, void *arg)
+{
+	BTMergeState *state = (BTMergeState *) arg;
+	BTMergeInput *input1 = &state->inputs[DatumGetInt32(a)];
+	BTMergeInput *input2 = &state->inputs[DatumGetInt32(b)];
+	int			compare;
+
+	compare = _bt_parallel_keycompare(state->sortKeys, state->keysz,
+									  state->tupdes, input1->itup,
+									  input2->itup, NULL);
+	if (compare == 0)
+		compare = ItemPointerCompare(&input1->itup->t_tid,
+									 &input2->itup->t_tid);
+
+	return -compare;
+}
+
+/*
+ * Merge the sorted inputs into the leaf pages of the index
+ */
+static void
+_bt_parallel_merge(BTWriteState *wstate, BTMergeInput *inputs, int ninputs,
+				   bool isunique)
+{
+	BTMergeState state;
+	BTPageState *pstate = NULL;
+	binaryheap *heap;
+	IndexTuple	lastlive = NULL;
+	int			i;
+
+	state.inputs = inputs;
+	state.keysz = RelationGetNumberOfAttributes(wstate->index);
+	state.tupdes = RelationGetDescr(wstate->index);
+	state.sortKeys = _bt_parallel_sortkeys(wstate->index);
+
+	heap = binaryheap_allocate(ninputs, _bt_parallel_heap_compare, &state);
+	for (i = 0; i < ninputs; i++)
+	{
+		if (_bt_parallel_input_next(&inputs[i]))
+			binaryheap_add_unordered(heap, Int32GetDatum(i));
+	}
+	binaryheap_build(heap);
+
+	while (!binaryheap_empty(heap))
+	{
+		BTMergeInput *input;
+
+		CHECK_FOR_INTERRUPTS();
+
+		i = DatumGetInt32(binaryheap_first(heap));
+		input = &inputs[i];
+
+		/*
+		 * Tuples with equal keys are adjacent, with dead ones in between
+		 * maybe.  Those of one participant were checked by its tuplesort.
+		 */
+		if (isunique && input->live)
+		{
+			bool		hasnull;
+
+			if (lastlive != NULL &&
+				_bt_parallel_keycompare(state.sortKeys, state.keysz,
+										state.tupdes, lastlive,
+										input->itup, &hasnull) == 0 &&
+				!hasnull)
+			{
+				Datum		values[INDEX_MAX_KEYS];
+				bool		isnull[INDEX_MAX_KEYS];
+				char	   *key_desc;
+
+				index_deform_tuple(input->itup, state.tupdes, values, isnull);
+				key_desc = BuildIndexValueDescription(wstate->index, values, isnull);
+
+				ereport(ERROR,
+						(errcode(ERRCODE_UNIQUE_VIOLATION),
+						 errmsg("could not create unique index \"%s\"",
+								RelationGetRelationName(wstate->index)),
+						 key_desc ? errdetail("Key %s is duplicated.", key_desc) :
+						 errdetail("Duplicate keys exist."),
+						 errtableconstraint(wstate->heap,
+								   RelationGetRelationName(wstate->index))));
+			}
+			if (lastlive)
+				pfree(lastlive);
+			lastlive = CopyIndexTuple(input->itup);
+		}
+
+		/* When we see first tuple, create first index page */
+		if (pstate == NULL)
+			pstate = _bt_pagestate(wstate, 0);
+		_bt_buildadd(wstate, pstate, input->itup);
+
+		if (_bt_parallel_input_next(input))
+			binaryheap_replace_first(heap, Int32GetDatum(i));
+		else
+			(void) binaryheap_remove_first(heap);
+	}
+
+	binaryheap_free(heap);
+	if (lastlive)
+		pfree(lastlive);
+	pfree(state.sortKeys);
+
+	/* Close down final pages and write the metapage */
+	_bt_uppershutdown(wstate, pstate);
+
+	/* see _bt_load */
+	if (RelationNeedsWAL(wstate->index))
+	{
+		RelationOpenSmgr(wstate->index);
+		smgrimmedsync(wstate->index->rd_smgr, MAIN_FORKNUM);
+	}
+}
+#endif   /* ADB */
@@ -478,6 +478,10 @@ MarkAsPreparing(TransactionId xid, const char *gid,
 	proc->databaseId = databaseid;
 	proc->roleId = owner;
 	proc->isBackgroundWorker = false;
+#ifdef AGTM
+	/* keep pinning only the nodes the prepared transaction involves */
+	proc->xactNodes = MyProc->xactNodes;
+#endif
 	proc->lwWaiting = false;
 	proc->lwWaitMode = 0;
 	proc->waitLock = NULL;
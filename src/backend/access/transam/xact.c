@@ -56,6 +56,7 @@
 #include "utils/catcache.h"
 #include "utils/combocid.h"
 #include "utils/guc.h"
+#include "utils/hlc.h"
 #include "utils/inval.h"
 #include "utils/memutils.h"
 #include "utils/relmapper.h"
@@ -73,6 +74,7 @@
 #include "lib/stringinfo.h"
 #include "intercomm/inter-comm.h"
 #include "pgxc/execRemote.h"
+#include "pgxc/noderange.h"
 #include "pgxc/pause.h"
 #include "pgxc/pgxc.h"
 #include "pgxc/xc_maintenance_mode.h"
@@ -933,6 +935,9 @@ SetCurrentTransactionStartTimestamp(TimestampTz timestamp)
 	 * Datanode or NoMaster-Coordinator get timestamp from Master-Co
 	 * ordinator.
 	 */
+	/* in any case keep the local clock past it */
+	HlcObserve(timestamp);
+
 	if ((IsCoordMaster() && !FirstSnapshotSet) || !IsCoordMaster())
 	{
 		globalXactStartTimestamp = timestamp;
@@ -2129,6 +2134,7 @@ StartTransaction(void)
 	s->agtm_begin = false;
 	s->xact_phase = XACT_PHASE_ONE;
 	s->interXactState = NULL;
+	agtm_ResetXactNodes();
 #endif
 
 	/*
@@ -2231,8 +2237,17 @@ StartTransaction(void)
 	xactStopTimestamp = 0;
 #ifdef ADB
 	/*
-	 * For ADB, transaction start timestamp has to follow the AGTM timeline
+	 * For ADB, transaction start timestamp has to follow the AGTM timeline.
+	 * Until a timestamp arrives with the first snapshot or from the
+	 * coordinator, start from the hybrid logical clock, which is already
+	 * past every timestamp this node has seen.  A session connected from a
+	 * coordinator got its timestamp before the transaction started.
 	 */
+	if (!IsConnFromCoord())
+	{
+		globalXactStartTimestamp = HlcNow();
+		globalDeltaTimestmap = globalXactStartTimestamp - xactStartTimestamp;
+	}
 	pgstat_report_xact_timestamp(globalXactStartTimestamp);
 #else
 	pgstat_report_xact_timestamp(xactStartTimestamp);
@@ -2368,6 +2383,7 @@ CommitTransaction(void)
 	Assert(s->parent == NULL);
 
 #if defined(ADB)
+	NodeRangePreCommit();
 	StartCommitRemoteXact(s);
 #endif
 
@@ -2677,6 +2693,10 @@ PrepareTransaction(void)
 
 	CallXactCallbacks(XACT_EVENT_PRE_PREPARE);
 
+#ifdef ADB
+	NodeRangePreCommit();
+#endif
+
 	/*
 	 * The remaining actions cannot call any user-defined code, so it's safe
 	 * to start shutting down within-transaction services.  But note that most
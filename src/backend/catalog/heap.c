@@ -83,12 +83,14 @@
 #include "commands/dbcommands.h"
 #include "intercomm/inter-node.h"
 #include "nodes/makefuncs.h"
+#include "optimizer/planner.h"
 #include "optimizer/reduceinfo.h"
 #include "parser/parse_func.h"
 #include "pgxc/locator.h"
 #include "pgxc/nodemgr.h"
 #include "pgxc/pgxc.h"
 #include "pgxc/pgxcnode.h"
+#include "utils/typcache.h"
 
 extern bool distribute_by_replication_default;
 #endif
@@ -1328,6 +1330,214 @@ GetUserDefinedDistribution(Oid relid,
 	pfree(funcargs);
 }
 
+/*
+ * Get the columns of a hash distribution on several columns, in the order
+ * they are hashed in.
+ */
+static void
+GetMultiHashDistribution(Oid relid,
+						 DistributeBy *distributeby,
+						 TupleDesc descriptor,
+						 int *numatts,
+						 int16 **attnums)
+{
+	int16	   *local_attnums;
+	int			nargs = 0;
+	ListCell   *lc;
+
+	Assert(distributeby->disttype == DISTTYPE_HASH);
+	Assert(list_length(distributeby->funcargs) > 1);
+
+	local_attnums = (int16 *) palloc0(sizeof(int16) * list_length(distributeby->funcargs));
+	foreach (lc, distributeby->funcargs)
+	{
+		ColumnRef  *cref = (ColumnRef *) lfirst(lc);
+		char	   *colname = strVal(linitial(cref->fields));
+		AttrNumber	local_attnum = get_attnum(relid, colname);
+		int			i;
+
+		if (local_attnum <= 0 && local_attnum >= -(int) lengthof(SysAtt))
+			ereport(ERROR,
+					(errcode(ERRCODE_INVALID_TABLE_DEFINITION),
+					 errmsg("Invalid distribution column specified: %s", colname)));
+
+		if (!IsTypeDistributable(descriptor->attrs[local_attnum - 1]->atttypid))
+			ereport(ERROR,
+					(errcode(ERRCODE_WRONG_OBJECT_TYPE),
+					 errmsg("Column %s is not a hash distributable data type",
+							colname)));
+
+		for (i = 0; i < nargs; i++)
+		{
+			if (local_attnums[i] == local_attnum)
+				ereport(ERROR,
+						(errcode(ERRCODE_DUPLICATE_COLUMN),
+						 errmsg("column \"%s\" appears twice in distribution key",
+								colname)));
+		}
+		local_attnums[nargs++] = local_attnum;
+	}
+
+	if (numatts)
+		*numatts = nargs;
+	if (attnums)
+		*attnums = local_attnums;
+	else
+		pfree(local_attnums);
+}
+
+/*
+ * Transform a bound or listed value of a range or list distribution
+ * into a Const of the type of the distribution column.
+ */
+static Const *
+GetDistributionValue(ParseState *pstate, Node *node, Form_pg_attribute attr)
+{
+	Node   *expr;
+	Node   *coerced;
+	Const  *value;
+
+	expr = transformExpr(pstate, node, EXPR_KIND_OTHER);
+	coerced = coerce_to_target_type(pstate,
+									expr, exprType(expr),
+									attr->atttypid, attr->atttypmod,
+									COERCION_ASSIGNMENT,
+									COERCE_IMPLICIT_CAST,
+									-1);
+	if (coerced == NULL)
+		ereport(ERROR,
+				(errcode(ERRCODE_DATATYPE_MISMATCH),
+				 errmsg("distribution value of type %s cannot be cast to type %s of column \"%s\"",
+						format_type_be(exprType(expr)),
+						format_type_be(attr->atttypid),
+						NameStr(attr->attname)),
+				 parser_errposition(pstate, exprLocation(node))));
+
+	coerced = (Node *) expression_planner((Expr *) coerced);
+	if (!IsA(coerced, Const))
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_TABLE_DEFINITION),
+				 errmsg("distribution value must be a constant"),
+				 parser_errposition(pstate, exprLocation(node))));
+
+	value = (Const *) coerced;
+	if (value->constisnull)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_TABLE_DEFINITION),
+				 errmsg("distribution value cannot be null"),
+				 errhint("Null values are stored on the first node."),
+				 parser_errposition(pstate, exprLocation(node))));
+
+	/* compare with the collation of the column */
+	value->constcollid = attr->attcollation;
+	value->location = -1;
+
+	return value;
+}
+
+/*
+ * Get the Const bounds of a range distribution, or the Lists of Const values
+ * of each node of a list distribution.
+ */
+static List *
+GetRangeOrListDistribution(DistributeBy *distributeby, Form_pg_attribute attr)
+{
+	ParseState	   *pstate = make_parsestate(NULL);
+	TypeCacheEntry *typentry;
+	List		   *result = NIL;
+	ListCell	   *lc;
+
+	Assert(distributeby->disttype == DISTTYPE_RANGE ||
+		   distributeby->disttype == DISTTYPE_LIST);
+
+	if (distributeby->disttype == DISTTYPE_RANGE)
+	{
+		Const *prev = NULL;
+
+		typentry = lookup_type_cache(attr->atttypid, TYPECACHE_CMP_PROC_FINFO);
+		if (!OidIsValid(typentry->cmp_proc_finfo.fn_oid))
+			ereport(ERROR,
+					(errcode(ERRCODE_WRONG_OBJECT_TYPE),
+					 errmsg("Column \"%s\" is not range distributable data type",
+							NameStr(attr->attname))));
+
+		foreach (lc, distributeby->funcargs)
+		{
+			Const *bound = GetDistributionValue(pstate, lfirst(lc), attr);
+
+			if (prev != NULL &&
+				DatumGetInt32(FunctionCall2Coll(&typentry->cmp_proc_finfo,
+												attr->attcollation,
+												prev->constvalue,
+												bound->constvalue)) >= 0)
+				ereport(ERROR,
+						(errcode(ERRCODE_INVALID_TABLE_DEFINITION),
+						 errmsg("bounds of range distribution must be strictly increasing"),
+						 parser_errposition(pstate, exprLocation(lfirst(lc)))));
+
+			result = lappend(result, bound);
+			prev = bound;
+		}
+	} else
+	{
+		List	   *all_values = NIL;
+
+		typentry = lookup_type_cache(attr->atttypid, TYPECACHE_EQ_OPR_FINFO);
+		if (!OidIsValid(typentry->eq_opr_finfo.fn_oid))
+			ereport(ERROR,
+					(errcode(ERRCODE_WRONG_OBJECT_TYPE),
+					 errmsg("Column \"%s\" is not list distributable data type",
+							NameStr(attr->attname))));
+
+		/* each node has one value or an ARRAY[] of values */
+		foreach (lc, distributeby->funcargs)
+		{
+			Node	   *arg = lfirst(lc);
+			List	   *elems;
+			List	   *values = NIL;
+			ListCell   *lc2, *lc3;
+
+			if (IsA(arg, A_ArrayExpr))
+				elems = ((A_ArrayExpr *) arg)->elements;
+			else
+				elems = list_make1(arg);
+
+			if (elems == NIL)
+				ereport(ERROR,
+						(errcode(ERRCODE_INVALID_TABLE_DEFINITION),
+						 errmsg("values of a node of list distribution cannot be empty"),
+						 parser_errposition(pstate, exprLocation(arg))));
+
+			foreach (lc2, elems)
+			{
+				Const *value = GetDistributionValue(pstate, lfirst(lc2), attr);
+
+				foreach (lc3, all_values)
+				{
+					Const *other = lfirst(lc3);
+
+					if (DatumGetBool(FunctionCall2Coll(&typentry->eq_opr_finfo,
+													   attr->attcollation,
+													   other->constvalue,
+													   value->constvalue)))
+						ereport(ERROR,
+								(errcode(ERRCODE_INVALID_TABLE_DEFINITION),
+								 errmsg("value of list distribution is listed more than once"),
+								 parser_errposition(pstate, exprLocation(lfirst(lc2)))));
+				}
+				all_values = lappend(all_values, value);
+				values = lappend(values, value);
+			}
+			result = lappend(result, values);
+		}
+		list_free(all_values);
+	}
+
+	free_parsestate(pstate);
+
+	return result;
+}
+
 /* --------------------------------
 *	   AddRelationDistribution
 *
@@ -1351,9 +1561,7 @@ AddRelationDistribution(Oid relid,
 	Oid				funcid = InvalidOid;
 	int				numatts = 0;
 	int16		   *attnums = NULL;
-
-	/* Obtain details of nodes and classify them */
-	nodeoids = GetRelationDistributionNodes(subcluster, &numnodes);
+	List		   *values = NIL;
 
 	/* Obtain details of distribution information */
 	GetRelationDistributionItems(relid,
@@ -1365,11 +1573,42 @@ AddRelationDistribution(Oid relid,
 								 &attnum,
 								 &funcid,
 								 &numatts,
-								 &attnums);
+								 &attnums,
+								 &values);
+
+	/*
+	 * Obtain details of nodes and classify them.  Range and list tables map
+	 * their values to nodes in the order given by TO NODE.
+	 */
+	if (IsLocatorDistributedByRangeOrList(locatortype) &&
+		subcluster && subcluster->clustertype == SUBCLUSTER_NODE)
+		nodeoids = BuildRelationDistributionNodes(subcluster->members, &numnodes);
+	else
+		nodeoids = GetRelationDistributionNodes(subcluster, &numnodes);
+
+	if (locatortype == LOCATOR_TYPE_RANGE &&
+		numnodes != list_length(values) + 1)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_TABLE_DEFINITION),
+				 errmsg("range distribution with %d bounds needs %d nodes, but %d are given",
+						list_length(values), list_length(values) + 1, numnodes)));
+	if (locatortype == LOCATOR_TYPE_LIST &&
+		numnodes != list_length(values))
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_TABLE_DEFINITION),
+				 errmsg("list distribution with %d value lists needs %d nodes, but %d are given",
+						list_length(values), list_length(values), numnodes)));
 
 	/* Now OK to insert data in catalog */
 	PgxcClassCreate(relid, locatortype, attnum, hashalgorithm,
-					hashbuckets, numnodes, nodeoids, funcid, numatts, attnums);
+					hashbuckets, numnodes, nodeoids, funcid, numatts, attnums,
+					values);
+
+	if (subcluster && subcluster->clustertype == SUBCLUSTER_COLOCATE)
+	{
+		CommandCounterIncrement();
+		PgxcClassColocate(relid, GetColocationRelid(subcluster));
+	}
 
 	/* Make dependency entries */
 	myself.classId = PgxcClassRelationId;
@@ -1419,7 +1658,8 @@ AddPgxcRelationDependFunction(Oid relid,
 								&attnum,
 								&funcid,
 								&numatts,
-								&attnums);
+								&attnums,
+								NULL);
 
 	/*
 	 * Dependency on function while distribute
@@ -1444,7 +1684,8 @@ GetRelationDistributionItems(Oid relid,
 							AttrNumber *attnum,
 							Oid *funcid,
 							int *numatts,
-							int16 **attnums)
+							int16 **attnums,
+							List **values)
 {
 	int local_hashalgorithm = 0;
 	int local_hashbuckets = 0;
@@ -1507,6 +1748,14 @@ GetRelationDistributionItems(Oid relid,
 							 errmsg("Column %s is not a hash distributable data type",
 							 distributeby->colname)));
 				}
+
+				/* the other columns of a multi-column key */
+				if (list_length(distributeby->funcargs) > 1)
+					GetMultiHashDistribution(relid,
+											 distributeby,
+											 descriptor,
+											 numatts,
+											 attnums);
 				local_locatortype = LOCATOR_TYPE_HASH;
 				break;
 
@@ -1557,6 +1806,29 @@ GetRelationDistributionItems(Oid relid,
 				}
 				break;
 
+			case DISTTYPE_RANGE:
+			case DISTTYPE_LIST:
+				/*
+				 * Validate user specified range or list column.
+				 * System columns cannot be used.
+				 */
+				local_attnum = get_attnum(relid, distributeby->colname);
+				if (local_attnum <= 0 && local_attnum >= -(int) lengthof(SysAtt))
+				{
+					ereport(ERROR,
+							(errcode(ERRCODE_INVALID_TABLE_DEFINITION),
+							 errmsg("Invalid distribution column specified")));
+				}
+
+				if (distributeby->disttype == DISTTYPE_RANGE)
+					local_locatortype = LOCATOR_TYPE_RANGE;
+				else
+					local_locatortype = LOCATOR_TYPE_LIST;
+				if (values)
+					*values = GetRangeOrListDistribution(distributeby,
+														 descriptor->attrs[local_attnum - 1]);
+				break;
+
 			default:
 				ereport(ERROR,
 						(errcode(ERRCODE_INVALID_TABLE_DEFINITION),
@@ -1660,6 +1932,14 @@ GetRelationDistributionNodes(PGXCSubCluster *subcluster, int *numnodes)
 
 	Assert(numnodes);
 	*numnodes = 0;
+
+	/* Nodes of another table, kept in its order */
+	if (subcluster && subcluster->clustertype == SUBCLUSTER_COLOCATE)
+	{
+		*numnodes = get_pgxc_classnodes(GetColocationRelid(subcluster), &nodes);
+		return nodes;
+	}
+
 	if (!subcluster)
 	{
 		nodes = GetAllDnIDA(false, numnodes);
@@ -1702,6 +1982,21 @@ GetRelationDistributionNodes(PGXCSubCluster *subcluster, int *numnodes)
 	return SortRelationDistributionNodes(nodes, *numnodes);
 }
 
+/*
+* GetColocationRelid
+* Look up the table of a COLOCATE WITH clause.  It is locked so that its
+* distribution does not change before commit.
+*/
+Oid
+GetColocationRelid(PGXCSubCluster *subcluster)
+{
+	Assert(subcluster->clustertype == SUBCLUSTER_COLOCATE);
+
+	return RangeVarGetRelid(makeRangeVarFromNameList(subcluster->members),
+							AccessShareLock,
+							false);
+}
+
 /*
 * SortRelationDistributionNodes
 * Sort elements in a node array.
@@ -106,6 +106,16 @@ static void UpdateIndexRelation(Oid indexoid, Oid heapoid,
 					bool isexclusion,
 					bool immediate,
 					bool isvalid);
+static double IndexBuildHeapScanInternal(Relation heapRelation,
+						   Relation indexRelation,
+						   IndexInfo *indexInfo,
+						   bool allow_sync,
+						   bool anyvisible,
+						   BlockNumber start_blockno,
+						   BlockNumber numblocks,
+						   HeapScanDesc scan,
+						   IndexBuildCallback callback,
+						   void *callback_state);
 static void index_update_stats(Relation rel,
 				   bool hasindex, bool isprimary,
 				   double reltuples);
@@ -2185,10 +2195,59 @@ IndexBuildHeapRangeScan(Relation heapRelation,
 						BlockNumber numblocks,
 						IndexBuildCallback callback,
 						void *callback_state)
+{
+	return IndexBuildHeapScanInternal(heapRelation, indexRelation,
+									  indexInfo, allow_sync,
+									  anyvisible,
+									  start_blockno, numblocks,
+									  NULL,
+									  callback, callback_state);
+}
+
+#ifdef ADB
+/*
+ * As IndexBuildHeapScan, for one participant of a parallel index build.
+ * The caller began "scan" with heap_beginscan_parallel(); each participant
+ * indexes the blocks it gets from the shared scan.  The scan is ended here.
+ */
+double
+IndexBuildHeapScanParallel(Relation heapRelation,
+						   Relation indexRelation,
+						   IndexInfo *indexInfo,
+						   HeapScanDesc scan,
+						   IndexBuildCallback callback,
+						   void *callback_state)
+{
+	Assert(scan != NULL && scan->rs_parallel != NULL);
+
+	return IndexBuildHeapScanInternal(heapRelation, indexRelation,
+									  indexInfo, true,
+									  false,
+									  0, InvalidBlockNumber,
+									  scan,
+									  callback, callback_state);
+}
+#endif
+
+/*
+ * Workhorse of the above.  A NULL "scan" means to begin a scan of the given
+ * block range.
+ */
+static double
+IndexBuildHeapScanInternal(Relation heapRelation,
+						   Relation indexRelation,
+						   IndexInfo *indexInfo,
+						   bool allow_sync,
+						   bool anyvisible,
+						   BlockNumber start_blockno,
+						   BlockNumber numblocks,
+						   HeapScanDesc scan,
+						   IndexBuildCallback callback,
+						   void *callback_state)
 {
 	bool		is_system_catalog;
 	bool		checking_uniqueness;
-	HeapScanDesc scan;
+	bool		registered_snapshot = false;
 	HeapTuple	heapTuple;
 	Datum		values[INDEX_MAX_KEYS];
 	bool		isnull[INDEX_MAX_KEYS];
@@ -2241,11 +2300,21 @@ IndexBuildHeapRangeScan(Relation heapRelation,
 	 * SnapshotAny because we must retrieve all tuples and do our own time
 	 * qual checks (because we have to index RECENTLY_DEAD tuples). In a
 	 * concurrent build, or during bootstrap, we take a regular MVCC snapshot
-	 * and index whatever's live according to that.
+	 * and index whatever's live according to that.  A parallel scan comes
+	 * with the snapshot the leader chose the same way.
 	 */
-	if (IsBootstrapProcessingMode() || indexInfo->ii_Concurrent)
+	if (scan != NULL)
+	{
+		snapshot = scan->rs_snapshot;
+		if (snapshot == SnapshotAny)
+			OldestXmin = GetOldestXmin(heapRelation, true);
+		else
+			OldestXmin = InvalidTransactionId;		/* not used */
+	}
+	else if (IsBootstrapProcessingMode() || indexInfo->ii_Concurrent)
 	{
 		snapshot = RegisterSnapshot(GetTransactionSnapshot());
+		registered_snapshot = true;
 		OldestXmin = InvalidTransactionId;		/* not used */
 
 		/* "any visible" mode is not compatible with this */
@@ -2258,21 +2327,24 @@ IndexBuildHeapRangeScan(Relation heapRelation,
 		OldestXmin = GetOldestXmin(heapRelation, true);
 	}
 
-	scan = heap_beginscan_strat(heapRelation,	/* relation */
-								snapshot,		/* snapshot */
-								0,		/* number of keys */
-								NULL,	/* scan key */
-								true,	/* buffer access strategy OK */
-								allow_sync);	/* syncscan OK? */
-
-	/* set our scan endpoints */
-	if (!allow_sync)
-		heap_setscanlimits(scan, start_blockno, numblocks);
-	else
+	if (scan == NULL)
 	{
-		/* syncscan can only be requested on whole relation */
-		Assert(start_blockno == 0);
-		Assert(numblocks == InvalidBlockNumber);
+		scan = heap_beginscan_strat(heapRelation,	/* relation */
+									snapshot,		/* snapshot */
+									0,		/* number of keys */
+									NULL,	/* scan key */
+									true,	/* buffer access strategy OK */
+									allow_sync);	/* syncscan OK? */
+
+		/* set our scan endpoints */
+		if (!allow_sync)
+			heap_setscanlimits(scan, start_blockno, numblocks);
+		else
+		{
+			/* syncscan can only be requested on whole relation */
+			Assert(start_blockno == 0);
+			Assert(numblocks == InvalidBlockNumber);
+		}
 	}
 
 	reltuples = 0;
@@ -2595,7 +2667,7 @@ IndexBuildHeapRangeScan(Relation heapRelation,
 	heap_endscan(scan);
 
 	/* we can now forget our snapshot, if set */
-	if (IsBootstrapProcessingMode() || indexInfo->ii_Concurrent)
+	if (registered_snapshot)
 		UnregisterSnapshot(snapshot);
 
 	ExecDropSingleTupleTableSlot(slot);
@@ -11,20 +11,33 @@
  */
 #include "postgres.h"
 
+#include "access/genam.h"
 #include "access/heapam.h"
 #include "access/htup_details.h"
 #include "catalog/dependency.h"
 #include "catalog/indexing.h"
 #include "catalog/namespace.h"
+#include "catalog/pg_depend.h"
+#include "catalog/pg_inherits_fn.h"
 #include "catalog/pg_proc.h"
 #include "catalog/pg_type.h"
 #include "catalog/pgxc_class.h"
 #include "utils/builtins.h"
+#include "utils/fmgroids.h"
+#include "utils/inval.h"
+#include "utils/lsyscache.h"
 #include "utils/rel.h"
 #include "utils/syscache.h"
 #include "pgxc/locator.h"
+#include "pgxc/noderange.h"
 #include "utils/array.h"
 
+static List *PgxcClassGetKeys(HeapTuple tup);
+static bool PgxcClassSameDistribution(Oid pcrelid, HeapTuple tup,
+						  Oid refrelid, HeapTuple reftup,
+						  bool report);
+static void PgxcClassColocateDepend(Oid pcrelid, Oid colocation, bool add);
+static bool PgxcClassStillColocated(Relation rel, Oid pcrelid, HeapTuple tup);
 
 /*
  * PgxcClassCreate
@@ -40,7 +53,8 @@ PgxcClassCreate(Oid pcrelid,
 				Oid *nodes,
 				Oid pcfuncid,
 				int numatts,
-				int16 *pcfuncattnums)
+				int16 *pcfuncattnums,
+				List *pcvalues)
 {
 	Relation	pgxcclassrel;
 	HeapTuple	htup;
@@ -70,7 +84,8 @@ PgxcClassCreate(Oid pcrelid,
 	values[Anum_pgxc_class_pcrelid - 1]   = ObjectIdGetDatum(pcrelid);
 	values[Anum_pgxc_class_pclocatortype - 1] = CharGetDatum(pclocatortype);
 
-	if (pclocatortype == LOCATOR_TYPE_HASH || pclocatortype == LOCATOR_TYPE_MODULO)
+	if (pclocatortype == LOCATOR_TYPE_HASH || pclocatortype == LOCATOR_TYPE_MODULO ||
+		IsLocatorDistributedByRangeOrList(pclocatortype))
 	{
 		values[Anum_pgxc_class_pcattnum - 1] = UInt16GetDatum(pcattnum);
 		values[Anum_pgxc_class_pchashalgorithm - 1] = UInt16GetDatum(pchashalgorithm);
@@ -80,6 +95,9 @@ PgxcClassCreate(Oid pcrelid,
 	/* Node information */
 	values[Anum_pgxc_class_nodes - 1] = PointerGetDatum(nodes_array);
 
+	/* Joins a colocation group with PgxcClassColocate */
+	values[Anum_pgxc_class_pccolocation - 1] = ObjectIdGetDatum(InvalidOid);
+
 	if (pclocatortype == LOCATOR_TYPE_USER_DEFINED)
 	{
 		Assert(OidIsValid(pcfuncid));
@@ -89,12 +107,29 @@ PgxcClassCreate(Oid pcrelid,
 		attrs_array = buildint2vector(pcfuncattnums, numatts);
 		values[Anum_pgxc_class_pcfuncid - 1] = ObjectIdGetDatum(pcfuncid);
 		values[Anum_pgxc_class_pcfuncattnums - 1] = PointerGetDatum(attrs_array);
+	} else if (pclocatortype == LOCATOR_TYPE_HASH && numatts > 1)
+	{
+		/* hash on several columns */
+		Assert(pcfuncattnums);
+
+		attrs_array = buildint2vector(pcfuncattnums, numatts);
+		values[Anum_pgxc_class_pcfuncid - 1] = ObjectIdGetDatum(InvalidOid);
+		values[Anum_pgxc_class_pcfuncattnums - 1] = PointerGetDatum(attrs_array);
 	} else
 	{
 		values[Anum_pgxc_class_pcfuncid -1] = ObjectIdGetDatum(InvalidOid);
 		nulls[Anum_pgxc_class_pcfuncattnums - 1] = true;
 	}
 
+	if (IsLocatorDistributedByRangeOrList(pclocatortype))
+	{
+		Assert(pcvalues != NIL);
+		values[Anum_pgxc_class_pcvalues - 1] = CStringGetTextDatum(nodeToString(pcvalues));
+	} else
+	{
+		nulls[Anum_pgxc_class_pcvalues - 1] = true;
+	}
+
 	/* Open the relation for insertion */
 	pgxcclassrel = heap_open(PgxcClassRelationId, RowExclusiveLock);
 
@@ -125,12 +160,14 @@ PgxcClassAlter(Oid pcrelid,
 			   PgxcClassAlterType type,
 			   Oid pcfuncid,
 			   int numatts,
-			   int16 *pcfuncattnums)
+			   int16 *pcfuncattnums,
+			   List *pcvalues)
 {
 	Relation	rel;
 	HeapTuple	oldtup, newtup;
 	oidvector  *nodes_array;
 	int2vector	*attrs_array = NULL;
+	Oid			colocation;
 
 	Datum		new_record[Natts_pgxc_class];
 	bool		new_record_nulls[Natts_pgxc_class];
@@ -163,6 +200,7 @@ PgxcClassAlter(Oid pcrelid,
 			new_record_repl[Anum_pgxc_class_pchashbuckets - 1] = true;
 			new_record_repl[Anum_pgxc_class_pcfuncid - 1] = true;
 			new_record_repl[Anum_pgxc_class_pcfuncattnums - 1] = true;
+			new_record_repl[Anum_pgxc_class_pcvalues - 1] = true;
 			break;
 		case PGXC_CLASS_ALTER_NODES:
 			new_record_repl[Anum_pgxc_class_nodes - 1] = true;
@@ -177,6 +215,7 @@ PgxcClassAlter(Oid pcrelid,
 			new_record_repl[Anum_pgxc_class_nodes - 1] = true;
 			new_record_repl[Anum_pgxc_class_pcfuncid - 1] = true;
 			new_record_repl[Anum_pgxc_class_pcfuncattnums - 1] = true;
+			new_record_repl[Anum_pgxc_class_pcvalues - 1] = true;
 	}
 
 	/* Set up new fields */
@@ -225,7 +264,8 @@ PgxcClassAlter(Oid pcrelid,
 
 	if (new_record_repl[Anum_pgxc_class_pcfuncattnums - 1])
 	{
-		if (IsLocatorDistributedByUserDefined(pclocatortype))
+		if (IsLocatorDistributedByUserDefined(pclocatortype) ||
+			(pclocatortype == LOCATOR_TYPE_HASH && numatts > 1))
 		{
 			Assert(numatts > 0 && pcfuncattnums);
 			attrs_array = buildint2vector(pcfuncattnums, numatts);
@@ -236,14 +276,332 @@ PgxcClassAlter(Oid pcrelid,
 		}
 	}
 
+	if (new_record_repl[Anum_pgxc_class_pcvalues - 1])
+	{
+		if (IsLocatorDistributedByRangeOrList(pclocatortype))
+		{
+			Assert(pcvalues != NIL);
+			new_record[Anum_pgxc_class_pcvalues - 1] = CStringGetTextDatum(nodeToString(pcvalues));
+		} else
+		{
+			new_record_nulls[Anum_pgxc_class_pcvalues - 1] = true;
+		}
+	}
+
 	/* Update relation */
 	newtup = heap_modify_tuple(oldtup, RelationGetDescr(rel),
 							   new_record,
 							   new_record_nulls, new_record_repl);
+
+	/*
+	 * A member of a colocation group stays in it as long as it is still
+	 * distributed the way of the others, otherwise it leaves the group and
+	 * the others keep the guarantee.  PgxcClassColocate joins it again.
+	 */
+	colocation = ((Form_pgxc_class) GETSTRUCT(oldtup))->pccolocation;
+	if (OidIsValid(colocation) &&
+		!PgxcClassStillColocated(rel, pcrelid, newtup))
+	{
+		MemSet(new_record_repl, false, sizeof(new_record_repl));
+		new_record_repl[Anum_pgxc_class_pccolocation - 1] = true;
+		new_record[Anum_pgxc_class_pccolocation - 1] = ObjectIdGetDatum(InvalidOid);
+		newtup = heap_modify_tuple(newtup, RelationGetDescr(rel),
+								   new_record,
+								   new_record_nulls, new_record_repl);
+		PgxcClassColocateDepend(pcrelid, colocation, false);
+	}
+
 	simple_heap_update(rel, &oldtup->t_self, newtup);
 	CatalogUpdateIndexes(rel, newtup);
 
 	heap_close(rel, RowExclusiveLock);
+
+	/* rows are going to move between nodes */
+	NodeRangeForget(pcrelid, InvalidTransactionId);
+}
+
+/*
+ * Get the distribution key columns of a pgxc_class tuple, in the order they
+ * are hashed or given to the distribution function.
+ */
+static List *
+PgxcClassGetKeys(HeapTuple tup)
+{
+	Form_pgxc_class classForm = (Form_pgxc_class) GETSTRUCT(tup);
+	List	   *keys = NIL;
+	Datum		datum;
+	bool		isnull;
+
+	datum = SysCacheGetAttr(PGXCCLASSRELID, tup,
+							Anum_pgxc_class_pcfuncattnums, &isnull);
+	if (isnull)
+		keys = list_make1_int(classForm->pcattnum);
+	else
+	{
+		int2vector *attnums = (int2vector *) DatumGetPointer(datum);
+		int			i;
+
+		for (i = 0; i < attnums->dim1; i++)
+			keys = lappend_int(keys, attnums->values[i]);
+	}
+
+	return keys;
+}
+
+/*
+ * Check that two tables are distributed the same way: same locator type,
+ * key column types, function, range bounds or list values, and the same
+ * nodes in the same order.  Rows with equal keys are then always stored on
+ * the same node.  Raise an error if they are not and report is true.
+ */
+static bool
+PgxcClassSameDistribution(Oid pcrelid, HeapTuple tup,
+						  Oid refrelid, HeapTuple reftup,
+						  bool report)
+{
+	Form_pgxc_class classForm = (Form_pgxc_class) GETSTRUCT(tup);
+	Form_pgxc_class refForm = (Form_pgxc_class) GETSTRUCT(reftup);
+	Datum		datum, refdatum;
+	bool		isnull, refisnull;
+	List	   *keys, *refkeys;
+	ListCell   *lc1, *lc2;
+
+	keys = PgxcClassGetKeys(tup);
+	refkeys = PgxcClassGetKeys(reftup);
+
+	datum = SysCacheGetAttr(PGXCCLASSRELID, tup,
+							Anum_pgxc_class_pcvalues, &isnull);
+	refdatum = SysCacheGetAttr(PGXCCLASSRELID, reftup,
+							   Anum_pgxc_class_pcvalues, &refisnull);
+
+	if (classForm->pclocatortype != refForm->pclocatortype ||
+		classForm->pcfuncid != refForm->pcfuncid ||
+		list_length(keys) != list_length(refkeys) ||
+		isnull != refisnull ||
+		(!isnull && strcmp(TextDatumGetCString(datum),
+						   TextDatumGetCString(refdatum)) != 0))
+	{
+		if (!report)
+			return false;
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_TABLE_DEFINITION),
+				 errmsg("cannot colocate table \"%s\" with table \"%s\"",
+						get_rel_name(pcrelid), get_rel_name(refrelid)),
+				 errdetail("The tables are not distributed the same way.")));
+	}
+
+	forboth(lc1, keys, lc2, refkeys)
+	{
+		if (get_atttype(pcrelid, lfirst_int(lc1)) == get_atttype(refrelid, lfirst_int(lc2)))
+			continue;
+		if (!report)
+			return false;
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_TABLE_DEFINITION),
+				 errmsg("cannot colocate table \"%s\" with table \"%s\"",
+						get_rel_name(pcrelid), get_rel_name(refrelid)),
+				 errdetail("Distribution column \"%s\" is of type %s but column \"%s\" is of type %s.",
+						   get_attname(pcrelid, lfirst_int(lc1)),
+						   format_type_be(get_atttype(pcrelid, lfirst_int(lc1))),
+						   get_attname(refrelid, lfirst_int(lc2)),
+						   format_type_be(get_atttype(refrelid, lfirst_int(lc2))))));
+	}
+
+	if (classForm->nodeoids.dim1 != refForm->nodeoids.dim1 ||
+		memcmp(classForm->nodeoids.values, refForm->nodeoids.values,
+			   classForm->nodeoids.dim1 * sizeof(Oid)) != 0)
+	{
+		if (!report)
+			return false;
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_TABLE_DEFINITION),
+				 errmsg("cannot colocate table \"%s\" with table \"%s\"",
+						get_rel_name(pcrelid), get_rel_name(refrelid)),
+				 errdetail("The tables are not stored on the same nodes.")));
+	}
+
+	list_free(keys);
+	list_free(refkeys);
+
+	return true;
+}
+
+/*
+ * Add or remove the dependency of a member of a colocation group on the
+ * table that names the group, so that the table is not dropped while the
+ * group is in use.  An inheritance link between the two tables is a
+ * dependency of the same shape, it is left alone.
+ */
+static void
+PgxcClassColocateDepend(Oid pcrelid, Oid colocation, bool add)
+{
+	Relation	depRel;
+	ScanKeyData key[2];
+	SysScanDesc scan;
+	HeapTuple	tup;
+	bool		found = false;
+
+	if (pcrelid == colocation)
+		return;
+
+	depRel = heap_open(DependRelationId, RowExclusiveLock);
+
+	ScanKeyInit(&key[0],
+				Anum_pg_depend_classid,
+				BTEqualStrategyNumber, F_OIDEQ,
+				ObjectIdGetDatum(RelationRelationId));
+	ScanKeyInit(&key[1],
+				Anum_pg_depend_objid,
+				BTEqualStrategyNumber, F_OIDEQ,
+				ObjectIdGetDatum(pcrelid));
+
+	scan = systable_beginscan(depRel, DependDependerIndexId, true,
+							  NULL, 2, key);
+
+	while (HeapTupleIsValid(tup = systable_getnext(scan)))
+	{
+		Form_pg_depend depform = (Form_pg_depend) GETSTRUCT(tup);
+
+		if (depform->objsubid == 0 &&
+			depform->refclassid == RelationRelationId &&
+			depform->refobjid == colocation &&
+			depform->refobjsubid == 0 &&
+			depform->deptype == DEPENDENCY_NORMAL)
+		{
+			found = true;
+			if (!add && !list_member_oid(find_inheritance_children(colocation, NoLock),
+										   pcrelid))
+				simple_heap_delete(depRel, &tup->t_self);
+		}
+	}
+
+	systable_endscan(scan);
+	heap_close(depRel, RowExclusiveLock);
+
+	if (add && !found)
+	{
+		ObjectAddress myself, referenced;
+
+		ObjectAddressSet(myself, RelationRelationId, pcrelid);
+		ObjectAddressSet(referenced, RelationRelationId, colocation);
+		recordDependencyOn(&myself, &referenced, DEPENDENCY_NORMAL);
+	}
+}
+
+/*
+ * Is the distribution of a member of a colocation group, given by tup,
+ * still the one of the group?  It is compared to any other member.
+ */
+static bool
+PgxcClassStillColocated(Relation rel, Oid pcrelid, HeapTuple tup)
+{
+	Form_pgxc_class classForm = (Form_pgxc_class) GETSTRUCT(tup);
+	HeapScanDesc scan;
+	HeapTuple	othertup;
+	bool		result = true;
+
+	scan = heap_beginscan_catalog(rel, 0, NULL);
+	while (HeapTupleIsValid(othertup = heap_getnext(scan, ForwardScanDirection)))
+	{
+		Form_pgxc_class otherForm = (Form_pgxc_class) GETSTRUCT(othertup);
+
+		if (otherForm->pcrelid == pcrelid ||
+			otherForm->pccolocation != classForm->pccolocation)
+			continue;
+
+		result = PgxcClassSameDistribution(pcrelid, tup,
+										   otherForm->pcrelid, othertup,
+										   false);
+		break;
+	}
+	heap_endscan(scan);
+
+	return result;
+}
+
+/*
+ * PgxcClassColocate
+ *		Put a table in the colocation group of another table
+ *
+ * Both tables must already be distributed the same way, see
+ * PgxcClassSameDistribution.  The group is named after its first table,
+ * every other member depends on that table.
+ */
+void
+PgxcClassColocate(Oid pcrelid, Oid refrelid)
+{
+	Relation	rel;
+	HeapTuple	tup, reftup, newtup;
+	Form_pgxc_class classForm, refForm;
+	Oid			colocation;
+	Datum		new_record[Natts_pgxc_class];
+	bool		new_record_nulls[Natts_pgxc_class];
+	bool		new_record_repl[Natts_pgxc_class];
+
+	Assert(OidIsValid(pcrelid) && OidIsValid(refrelid));
+
+	if (pcrelid == refrelid)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_TABLE_DEFINITION),
+				 errmsg("cannot colocate table \"%s\" with itself",
+						get_rel_name(pcrelid))));
+
+	tup = SearchSysCacheCopy1(PGXCCLASSRELID, ObjectIdGetDatum(pcrelid));
+	if (!HeapTupleIsValid(tup)) /* should not happen */
+		elog(ERROR, "cache lookup failed for pgxc_class %u", pcrelid);
+	reftup = SearchSysCacheCopy1(PGXCCLASSRELID, ObjectIdGetDatum(refrelid));
+	if (!HeapTupleIsValid(reftup))
+		ereport(ERROR,
+				(errcode(ERRCODE_WRONG_OBJECT_TYPE),
+				 errmsg("table \"%s\" is not distributed",
+						get_rel_name(refrelid))));
+	classForm = (Form_pgxc_class) GETSTRUCT(tup);
+	refForm = (Form_pgxc_class) GETSTRUCT(reftup);
+
+	if (!IsLocatorDistributedByValue(refForm->pclocatortype) &&
+		!IsLocatorDistributedByUserDefined(refForm->pclocatortype))
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_TABLE_DEFINITION),
+				 errmsg("cannot colocate with table \"%s\"", get_rel_name(refrelid)),
+				 errdetail("Only tables distributed by value can be colocated.")));
+
+	(void) PgxcClassSameDistribution(pcrelid, tup, refrelid, reftup, true);
+
+	MemSet(new_record, 0, sizeof(new_record));
+	MemSet(new_record_nulls, false, sizeof(new_record_nulls));
+	MemSet(new_record_repl, false, sizeof(new_record_repl));
+	new_record_repl[Anum_pgxc_class_pccolocation - 1] = true;
+
+	rel = heap_open(PgxcClassRelationId, RowExclusiveLock);
+
+	/* the first table of a group names it */
+	colocation = refForm->pccolocation;
+	if (!OidIsValid(colocation))
+	{
+		colocation = refrelid;
+		new_record[Anum_pgxc_class_pccolocation - 1] = ObjectIdGetDatum(colocation);
+		newtup = heap_modify_tuple(reftup, RelationGetDescr(rel),
+								   new_record, new_record_nulls, new_record_repl);
+		simple_heap_update(rel, &reftup->t_self, newtup);
+		CatalogUpdateIndexes(rel, newtup);
+		CacheInvalidateRelcacheByRelid(refrelid);
+	}
+
+	/* leaving another group */
+	if (OidIsValid(classForm->pccolocation) &&
+		classForm->pccolocation != colocation)
+		PgxcClassColocateDepend(pcrelid, classForm->pccolocation, false);
+
+	new_record[Anum_pgxc_class_pccolocation - 1] = ObjectIdGetDatum(colocation);
+	newtup = heap_modify_tuple(tup, RelationGetDescr(rel),
+							   new_record, new_record_nulls, new_record_repl);
+	simple_heap_update(rel, &tup->t_self, newtup);
+	CatalogUpdateIndexes(rel, newtup);
+	CacheInvalidateRelcacheByRelid(pcrelid);
+
+	heap_close(rel, RowExclusiveLock);
+
+	PgxcClassColocateDepend(pcrelid, colocation, true);
 }
 
 /*
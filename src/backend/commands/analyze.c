@@ -60,6 +60,7 @@
 #include "catalog/pg_operator.h"
 #include "nodes/makefuncs.h"
 #include "pgxc/execRemote.h"
+#include "pgxc/noderange.h"
 #include "pgxc/pgxc.h"
 #include "utils/snapmgr.h"
 #endif
@@ -854,6 +855,12 @@ do_analyze_rel(Relation onerel, int options, VacuumParams *params,
 		 */
 		analyze_rel_coordinator(onerel, inh, attr_cnt, vacattrstats);
 
+		/*
+		 * Fetch the value ranges of BRIN indexed columns on each data node.
+		 */
+		if (!inh)
+			NodeRangeCollect(onerel);
+
 		/*
 		 * Skip acquiring local stats. Coordinator does not store data of
 		 * distributed tables.
@@ -49,6 +49,7 @@
 #include "utils/snapmgr.h"
 
 #ifdef ADB
+#include "catalog/index.h"
 #include "catalog/pg_trigger.h"
 #include "catalog/pgxc_node.h"
 #include "intercomm/inter-comm.h"
@@ -56,7 +57,9 @@
 #include "pgxc/pgxc.h"
 #include "pgxc/execRemote.h"
 #include "pgxc/locator.h"
+#include "pgxc/noderange.h"
 #include "pgxc/remotecopy.h"
+#include "pgxc/resultcache.h"
 #include "nodes/nodes.h"
 #include "pgxc/poolmgr.h"
 #endif
@@ -127,6 +130,9 @@ typedef struct CopyStateData
 	bool		binary;			/* binary format? */
 	bool		oids;			/* include OIDs? */
 	bool		freeze;			/* freeze rows on loading? */
+#ifdef ADB
+	bool		bulk_load;		/* build indexes after loading? */
+#endif
 	bool		csv_mode;		/* Comma Separated Value format? */
 	bool		header_line;	/* CSV header line? */
 	char	   *null_print;		/* NULL marker string (server encoding!) */
@@ -351,6 +357,7 @@ static bool CopyGetInt16(CopyState cstate, int16 *val);
 
 #ifdef ADB
 static RemoteCopyOptions *GetRemoteCopyOptions(CopyState cstate);
+static bool CopyCanDeferIndexes(CopyState cstate, ResultRelInfo *resultRelInfo);
 static void append_defvals(Datum *values, CopyState cstate);
 #endif
 
@@ -1114,6 +1121,16 @@ ProcessCopyOptions(CopyState cstate,
 						 errmsg("conflicting or redundant options")));
 			cstate->freeze = defGetBoolean(defel);
 		}
+#ifdef ADB
+		else if (strcmp(defel->defname, "bulk_load") == 0)
+		{
+			if (cstate->bulk_load)
+				ereport(ERROR,
+						(errcode(ERRCODE_SYNTAX_ERROR),
+						 errmsg("conflicting or redundant options")));
+			cstate->bulk_load = defGetBoolean(defel);
+		}
+#endif
 		else if (strcmp(defel->defname, "delimiter") == 0)
 		{
 			if (cstate->delim)
@@ -1368,6 +1385,14 @@ ProcessCopyOptions(CopyState cstate,
 				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
 				 errmsg("COPY force null only available using COPY FROM")));
 
+#ifdef ADB
+	/* Check bulk_load */
+	if (cstate->bulk_load && !is_from)
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("COPY bulk load only available using COPY FROM")));
+#endif
+
 	/* Don't allow the delimiter to appear in the null string. */
 	if (strchr(cstate->null_print, cstate->delim[0]) != NULL)
 		ereport(ERROR,
@@ -2382,6 +2407,9 @@ CopyFrom(CopyState cstate)
 	uint64		processed = 0;
 	bool		useHeapMultiInsert;
 	int			nBufferedTuples = 0;
+#ifdef ADB
+	bool		defer_indexes = false;
+#endif
 
 #define MAX_BUFFERED_TUPLES 1000
 	HeapTuple  *bufferedTuples = NULL;	/* initialize to silence warning */
@@ -2489,6 +2517,25 @@ CopyFrom(CopyState cstate)
 		hi_options |= HEAP_INSERT_FROZEN;
 	}
 
+#ifdef ADB
+	/*
+	 * BULK_LOAD has the same requirement as skipping WAL: nobody else can
+	 * see the relfilenode we load into, so its indexes can be left behind
+	 * and rebuilt in one sorted pass at the end.  On a coordinator which
+	 * only forwards rows to the datanodes, the datanodes do this.
+	 */
+	if (cstate->bulk_load &&
+		!(IS_PGXC_COORDINATOR && rcstate && rcstate->rel_loc))
+	{
+		if (cstate->rel->rd_createSubid == InvalidSubTransactionId &&
+			cstate->rel->rd_newRelfilenodeSubid == InvalidSubTransactionId)
+			ereport(ERROR,
+					(errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+					 errmsg("cannot perform BULK_LOAD because the table was not created or truncated in the current transaction")));
+		defer_indexes = true;
+	}
+#endif
+
 	/*
 	 * We need a ResultRelInfo so we can use the regular executor's
 	 * index-entry-making machinery.  (There used to be a huge amount of code
@@ -2502,6 +2549,22 @@ CopyFrom(CopyState cstate)
 
 	ExecOpenIndices(resultRelInfo, false);
 
+#ifdef ADB
+	/*
+	 * Close the indexes of a bulk load, so that nothing below maintains
+	 * them row by row.
+	 */
+	if (defer_indexes)
+	{
+		defer_indexes = CopyCanDeferIndexes(cstate, resultRelInfo);
+		if (defer_indexes)
+		{
+			ExecCloseIndices(resultRelInfo);
+			resultRelInfo->ri_NumIndices = 0;
+		}
+	}
+#endif
+
 	estate->es_result_relations = resultRelInfo;
 	estate->es_num_result_relations = 1;
 	estate->es_result_relation_info = resultRelInfo;
@@ -2550,6 +2613,8 @@ CopyFrom(CopyState cstate)
 	/* Send COPY command to datanode */
 	if (IS_PGXC_COORDINATOR && rcstate && rcstate->rel_loc)
 	{
+		ResultCacheNoteWrite(RelationGetRelid(cstate->rel));
+
 		/* Send COPY command to datanode */
 		StartRemoteCopy(rcstate);
 
@@ -2632,7 +2697,8 @@ CopyFrom(CopyState cstate)
 			AttrNumber				attnum;
 			bool					need_free;
 
-			if (IsRelationDistributedByValue(rel_loc_info))
+			if (IsRelationDistributedByValue(rel_loc_info) &&
+				!IsRelationDistributedByMultiHash(rel_loc_info))
 			{
 				nelems = 1;
 				need_free = false;
@@ -2641,12 +2707,12 @@ CopyFrom(CopyState cstate)
 				dist_col_is_nulls = &nulls[attnum - 1];
 				dist_col_types = &attr[attnum - 1]->atttypid;
 			} else
-			if (IsRelationDistributedByUserDefined(rel_loc_info))
+			if (IsRelationDistributedByUserDefined(rel_loc_info) ||
+				IsRelationDistributedByMultiHash(rel_loc_info))
 			{
 				ListCell   *lc = NULL;
 				int			idx = 0;
 
-				Assert(OidIsValid(rel_loc_info->funcid));
 				Assert(rel_loc_info->funcAttrNums);
 				nelems = list_length(rel_loc_info->funcAttrNums);
 				dist_col_values = (Datum *) palloc0(sizeof(Datum) * nelems);
@@ -2810,6 +2876,8 @@ CopyFrom(CopyState cstate)
 	{
 		//bool replicated = (rcstate->rel_loc->locatorType == LOCATOR_TYPE_REPLICATED);
 		EndRemoteCopy(rcstate);
+
+		NodeRangeNoteWrite(RelationGetRelid(cstate->rel));
 	}
 #endif
 
@@ -2820,6 +2888,16 @@ CopyFrom(CopyState cstate)
 	if (cstate->copy_dest == COPY_OLD_FE)
 		pq_endmsgread();
 
+#ifdef ADB
+	/*
+	 * Build the indexes of a bulk load, checking unique constraints on the
+	 * way, before any AFTER trigger gets to use them.
+	 */
+	if (defer_indexes)
+		reindex_relation(RelationGetRelid(cstate->rel),
+						 REINDEX_REL_CHECK_CONSTRAINTS, 0);
+#endif
+
 	/* Execute AFTER STATEMENT insertion triggers */
 	ExecASInsertTriggers(estate, resultRelInfo);
 
@@ -5003,6 +5081,39 @@ CreateCopyDestReceiver(void)
 	return (DestReceiver *) self;
 }
 #ifdef ADB
+/*
+ * CopyCanDeferIndexes
+ *
+ * Can a bulk load leave the indexes of the target table alone until all
+ * rows are in?  Not if something may look at the table while loading,
+ * the same cases which rule out heap_multi_insert, nor if an index needs
+ * its checks per row, as deferred unique and exclusion constraints do.
+ */
+static bool
+CopyCanDeferIndexes(CopyState cstate, ResultRelInfo *resultRelInfo)
+{
+	int			i;
+
+	if (resultRelInfo->ri_NumIndices == 0)
+		return false;
+
+	if ((resultRelInfo->ri_TrigDesc != NULL &&
+		 (resultRelInfo->ri_TrigDesc->trig_insert_before_row ||
+		  resultRelInfo->ri_TrigDesc->trig_insert_instead_row)) ||
+		cstate->volatile_defexprs)
+		return false;
+
+	for (i = 0; i < resultRelInfo->ri_NumIndices; i++)
+	{
+		Form_pg_index index = resultRelInfo->ri_IndexRelationDescs[i]->rd_index;
+
+		if (!index->indimmediate || index->indisexclusion)
+			return false;
+	}
+
+	return true;
+}
+
 static RemoteCopyOptions *
 GetRemoteCopyOptions(CopyState cstate)
 {
@@ -5025,6 +5136,7 @@ GetRemoteCopyOptions(CopyState cstate)
 		res->rco_force_quote = list_copy(cstate->force_quote);
 	if (cstate->force_notnull)
 		res->rco_force_notnull = list_copy(cstate->force_notnull);
+	res->rco_bulk_load = cstate->bulk_load;
 
 	return res;
 }
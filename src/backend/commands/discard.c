@@ -21,6 +21,9 @@
 #include "commands/sequence.h"
 #include "utils/guc.h"
 #include "utils/portal.h"
+#ifdef ADB
+#include "libpq/libpq-node.h"
+#endif
 
 static void DiscardAll(bool isTopLevel);
 
@@ -75,4 +78,7 @@ DiscardAll(bool isTopLevel)
 	ResetPlanCache();
 	ResetTempTableNamespace();
 	ResetSequenceCaches();
+#ifdef ADB
+	PQNRequestCloseAllConnect();
+#endif
 }
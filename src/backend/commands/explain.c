@@ -43,6 +43,7 @@
 #include "intercomm/inter-node.h"
 #include "optimizer/pgxcplan.h"
 #include "pgxc/pgxcnode.h"
+#include "pgxc/resultcache.h"
 #endif
 
 /* Hook for plugins to get control in ExplainOneQuery() */
@@ -1608,6 +1609,14 @@ ExplainNode(PlanState *planstate, List *ancestors,
 				show_instrumentation_count("Rows Removed by Filter", 1,
 										   planstate, es);
 			break;
+#ifdef ADB
+		case T_WindowAgg:
+			show_upper_qual(plan->qual, "Filter", planstate, ancestors, es);
+			if (plan->qual)
+				show_instrumentation_count("Rows Removed by Filter", 1,
+										   planstate, es);
+			break;
+#endif /* ADB */
 		case T_Sort:
 			show_sort_keys((SortState *) planstate, ancestors, es);
 			show_sort_info((SortState *) planstate, es);
@@ -1662,7 +1671,18 @@ ExplainNode(PlanState *planstate, List *ancestors,
 												context,
 												list_length(es->rtable) > 1,
 												false);
-				ExplainPropertyText("Reduce", expr, es);
+				ExplainPropertyText(reducePlan->adaptive_follow ? "Adaptive Reduce" : "Reduce",
+									expr, es);
+				if(reducePlan->adaptive_reduce)
+				{
+					pfree(expr);
+					expr = deparse_expression((Node*)reducePlan->adaptive_reduce,
+											  context,
+											  list_length(es->rtable) > 1,
+											  false);
+					ExplainPropertyText("Adaptive Reduce", expr, es);
+					ExplainPropertyInteger("Adaptive Rows", reducePlan->adaptive_rows, es);
+				}
 				if(OidIsValid(reducePlan->special_node))
 				{
 					char *label = psprintf("%u Reduce", reducePlan->special_node);
@@ -3761,6 +3781,13 @@ ExplainRemoteQuery(RemoteQuery *plan, PlanState *planstate, List *ancestors, Exp
 	/* Remote query statement */
 	if (es->verbose)
 		ExplainPropertyText("Remote query", plan->sql_statement, es);
+
+	/* whether the rows came from the result cache, see resultcache.c */
+	if (es->analyze && IsA(planstate, RemoteQueryState) &&
+		((RemoteQueryState *) planstate)->result_cache)
+		ExplainPropertyText("Result Cache",
+							ResultCacheIsHit(((RemoteQueryState *) planstate)->result_cache) ?
+							"hit" : "miss", es);
 }
 #endif /*ADB*/
 
@@ -1045,6 +1045,166 @@ nextval_internal(Oid relid)
 	return result;
 }
 
+#ifdef AGTM
+/*
+ * AgtmSequenceReserve
+ *
+ * Reserve up to count nextval results of a sequence at once, for the
+ * in-memory sequences of agtm_sequence.c.  As for a nextval on AGTM, each
+ * result stands for cache_value numbers the coordinator caches.  The last
+ * number reserved becomes the sequence's last_value and is WAL-logged, so
+ * results handed out from memory are not handed out again after a crash.
+ *
+ * Cycled sequences are not reserved, false is returned and nothing changed.
+ * Otherwise *first is the first result, *step the distance between results
+ * and *nresults how many there are, at least one.
+ *
+ * The record is flushed before returning: the results are handed out to
+ * other sessions, whose transactions may never write WAL of their own.
+ */
+bool
+AgtmSequenceReserve(Oid relid, int64 count,
+					int64 *first, int64 *step, int64 *nresults)
+{
+	SeqTable	elm;
+	Relation	seqrel;
+	Buffer		buf;
+	HeapTupleData seqtuple;
+	Form_pg_sequence seq;
+	int64		incby,
+				maxv,
+				minv,
+				cache,
+				start;
+	uint64		uincby,
+				span,
+				n,
+				off;
+	XLogRecPtr	recptr = InvalidXLogRecPtr;
+
+	Assert(count > 0);
+
+	/* open and AccessShareLock sequence */
+	init_sequence(relid, &elm, &seqrel);
+
+	if (pg_class_aclcheck(elm->relid, GetUserId(),
+						  ACL_USAGE | ACL_UPDATE) != ACLCHECK_OK)
+		ereport(ERROR,
+				(errcode(ERRCODE_INSUFFICIENT_PRIVILEGE),
+				 errmsg("permission denied for sequence %s",
+						RelationGetRelationName(seqrel))));
+
+	PreventCommandIfReadOnly("nextval()");
+
+	/* lock page' buffer and read tuple */
+	seq = read_seq_tuple(elm, seqrel, &buf, &seqtuple);
+
+	if (seq->is_cycled)
+	{
+		UnlockReleaseBuffer(buf);
+		relation_close(seqrel, NoLock);
+		return false;
+	}
+
+	incby = seq->increment_by;
+	maxv = seq->max_value;
+	minv = seq->min_value;
+	cache = seq->cache_value;
+	uincby = incby > 0 ? (uint64) incby : (uint64) 0 - (uint64) incby;
+
+	/* first number not handed out yet, see nextval_internal */
+	start = seq->last_value;
+	if (seq->is_called)
+	{
+		if (incby > 0 &&
+			((maxv >= 0 && start > maxv - incby) ||
+			 (maxv < 0 && start + incby > maxv)))
+		{
+			char		bufm[100];
+
+			snprintf(bufm, sizeof(bufm), INT64_FORMAT, maxv);
+			ereport(ERROR,
+					(errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+					 errmsg("nextval: reached maximum value of sequence \"%s\" (%s)",
+							RelationGetRelationName(seqrel), bufm)));
+		}
+		if (incby < 0 &&
+			((minv < 0 && start < minv - incby) ||
+			 (minv >= 0 && start + incby < minv)))
+		{
+			char		bufm[100];
+
+			snprintf(bufm, sizeof(bufm), INT64_FORMAT, minv);
+			ereport(ERROR,
+					(errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+					 errmsg("nextval: reached minimum value of sequence \"%s\" (%s)",
+							RelationGetRelationName(seqrel), bufm)));
+		}
+		start += incby;
+	}
+
+	/* increments left from start to the limit */
+	if (incby > 0)
+		span = ((uint64) maxv - (uint64) start) / uincby;
+	else
+		span = ((uint64) start - (uint64) minv) / uincby;
+
+	/* results whose first number is within the limit */
+	n = Min(span / (uint64) cache + 1, (uint64) count);
+	if (n > 1 && (uint64) cache > (uint64) PG_INT64_MAX / uincby)
+		n = 1;					/* distance would overflow */
+	off = (n - 1) * (uint64) cache;
+	off += Min((uint64) cache - 1, span - off);
+
+	/* check the comment above nextval_internal()'s equivalent call. */
+	if (RelationNeedsWAL(seqrel))
+		GetTopTransactionId();
+
+	START_CRIT_SECTION();
+
+	if (incby > 0)
+		seq->last_value = (int64) ((uint64) start + off * uincby);
+	else
+		seq->last_value = (int64) ((uint64) start - off * uincby);
+	seq->is_called = true;
+	seq->log_cnt = 0;
+
+	MarkBufferDirty(buf);
+
+	/* XLOG stuff */
+	if (RelationNeedsWAL(seqrel))
+	{
+		xl_seq_rec	xlrec;
+		Page		page = BufferGetPage(buf);
+
+		XLogBeginInsert();
+		XLogRegisterBuffer(0, buf, REGBUF_WILL_INIT);
+
+		xlrec.node = seqrel->rd_node;
+		XLogRegisterData((char *) &xlrec, sizeof(xl_seq_rec));
+		XLogRegisterData((char *) seqtuple.t_data, seqtuple.t_len);
+
+		recptr = XLogInsert(RM_SEQ_ID, XLOG_SEQ_LOG);
+
+		PageSetLSN(page, recptr);
+	}
+
+	END_CRIT_SECTION();
+
+	UnlockReleaseBuffer(buf);
+	relation_close(seqrel, NoLock);
+
+	if (!XLogRecPtrIsInvalid(recptr))
+		XLogFlush(recptr);
+
+	*first = start;
+	*step = n > 1 ? cache * incby : incby;
+	*nresults = (int64) n;
+
+	return true;
+}
+#endif   /* AGTM */
+
 Datum
 currval_oid(PG_FUNCTION_ARGS)
 {
@@ -6630,6 +6630,35 @@ ATAddCheckConstraint(List **wqueue, AlteredTableInfo *tab, Relation rel,
 				 same_dist_col = true;
 		 }
 
+		 /* every column of a multi-column hash key, in the same order */
+		 if (same_dist_col &&
+			 (IsRelationDistributedByMultiHash(rloc) ||
+			  IsRelationDistributedByMultiHash(pkrloc)))
+		 {
+			 ListCell *lc1,
+					  *lc2;
+
+			 if (list_length(rloc->funcAttrNums) != list_length(pkrloc->funcAttrNums))
+				 same_dist_col = false;
+			 else
+			 {
+				 forboth(lc1, rloc->funcAttrNums, lc2, pkrloc->funcAttrNums)
+				 {
+					 for (i = 0; i < constraintNKeys; i++)
+					 {
+						 if (constraintKey[i] == lfirst_int(lc1) &&
+							 foreignKey[i] == lfirst_int(lc2))
+							 break;
+					 }
+					 if (i >= constraintNKeys)
+					 {
+						 same_dist_col = false;
+						 break;
+					 }
+				 }
+			 }
+		 }
+
 		 if (!same_dist_col)
 			 ereport(ERROR,
 				 (errcode(ERRCODE_INVALID_FOREIGN_KEY),
@@ -6638,6 +6667,15 @@ ATAddCheckConstraint(List **wqueue, AlteredTableInfo *tab, Relation rel,
 				 errhint("because cannot make sure foreign key table has the "
 					 "same partition with the primary key table")));
 
+		 if (IsRelationDistributedByRangeOrList(rloc) &&
+			 (!equal(rloc->nodeids, pkrloc->nodeids) ||
+			  !equal(rloc->distValues, pkrloc->distValues)))
+			 ereport(ERROR,
+				 (errcode(ERRCODE_INVALID_FOREIGN_KEY),
+				 errmsg("Cannot create foreign key \"%s\" which cannot be "
+					 "referenced in the primary key table", constraintName),
+				 errhint("because of different values of nodes")));
+
 		 if (foreignUpdateType == FKCONSTR_ACTION_SETNULL ||
 			 foreignUpdateType == FKCONSTR_ACTION_SETDEFAULT ||
 			 foreignDeleteType == FKCONSTR_ACTION_SETNULL ||
@@ -11877,7 +11915,8 @@ AtExecDistributeBy(Relation rel, DistributeBy *options)
 								 &attnum,
 								 &funcid,
 								 &numatts,
-								 &attnums
+								 &attnums,
+								 NULL
 								 );
 
 
@@ -11909,7 +11948,8 @@ AtExecDistributeBy(Relation rel, DistributeBy *options)
 				   PGXC_CLASS_ALTER_DISTRIBUTION,
 				   funcid,
 				   numatts,
-				   attnums
+				   attnums,
+				   NULL
 				   );
 
 	/* Make the additional catalog changes visible */
@@ -11919,6 +11959,7 @@ AtExecDistributeBy(Relation rel, DistributeBy *options)
 
 /*
  * ALTER TABLE <name> TO [ NODE nodelist | GROUP groupname ]
+ * ALTER TABLE <name> COLOCATE WITH table
  */
 static void
 AtExecSubCluster(Relation rel, PGXCSubCluster *options)
@@ -11949,11 +11990,19 @@ AtExecSubCluster(Relation rel, PGXCSubCluster *options)
 				   PGXC_CLASS_ALTER_NODES,
 				   0,
 				   0,
+				   NULL,
 				   NULL
 				   );
 
 	/* Make the additional catalog changes visible */
 	CommandCounterIncrement();
+
+	/* Join the colocation group, the distribution has to match by now */
+	if (options->clustertype == SUBCLUSTER_COLOCATE)
+	{
+		PgxcClassColocate(RelationGetRelid(rel), GetColocationRelid(options));
+		CommandCounterIncrement();
+	}
 }
 
 
@@ -11999,6 +12048,7 @@ AtExecAddNode(Relation rel, List *options)
 				   PGXC_CLASS_ALTER_NODES,
 				   0,
 				   0,
+				   NULL,
 				   NULL
 				   );
 
@@ -12046,6 +12096,7 @@ AtExecDeleteNode(Relation rel, List *options)
 				   PGXC_CLASS_ALTER_NODES,
 				   0,
 				   0,
+				   NULL,
 				   NULL
 				   );
 
@@ -12080,6 +12131,54 @@ ATCheckCmd(Relation rel, AlterTableCmd *cmd)
 				break;
 			}
 
+		case AT_DistributeBy:
+			{
+				DistributeBy *distributeby = (DistributeBy *) cmd->def;
+
+				/* Rows would have to be moved by value */
+				if (distributeby->disttype == DISTTYPE_RANGE ||
+					distributeby->disttype == DISTTYPE_LIST)
+					ereport(ERROR,
+							(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+							 errmsg("Cannot alter a table to range or list distribution")));
+				break;
+			}
+
+		case AT_SubCluster:
+		case AT_AddNodeList:
+		case AT_DeleteNodeList:
+			{
+				RelationLocInfo *locinfo = RelationGetLocInfo(rel);
+
+				/*
+				 * COLOCATE WITH a table on the same nodes in the same order
+				 * moves no row, PgxcClassColocate checks the values.
+				 */
+				if (cmd->subtype == AT_SubCluster &&
+					((PGXCSubCluster *) cmd->def)->clustertype == SUBCLUSTER_COLOCATE &&
+					locinfo && IsRelationDistributedByRangeOrList(locinfo))
+				{
+					Oid		refrelid = GetColocationRelid((PGXCSubCluster *) cmd->def);
+					RelationLocInfo *refinfo = GetRelationLocInfo(refrelid);
+
+					if (refinfo && equal(refinfo->nodeids, locinfo->nodeids))
+					{
+						FreeRelationLocInfo(refinfo);
+						break;
+					}
+					if (refinfo)
+						FreeRelationLocInfo(refinfo);
+				}
+
+				/* Each node of those tables stores its own values */
+				if (locinfo && IsRelationDistributedByRangeOrList(locinfo))
+					ereport(ERROR,
+							(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+							 errmsg("Cannot alter nodes of a table distributed by range or list"),
+							 errhint("Redistribute the table by another type first.")));
+				break;
+			}
+
 		default:
 			break;
 	}
@@ -12143,9 +12242,13 @@ BuildRedistribCommands(Oid relid, List *subCmds)
 											 (AttrNumber *)&(newLocInfo->partAttrNum),
 											 &funcid,
 											 &numatts,
-											 &attnums
+											 &attnums,
+											 NULL
 											 );
 
+				/* range and list are refused by ATCheckCmd */
+				newLocInfo->distValues = NIL;
+
 				newLocInfo->funcid = funcid;
 				if (newLocInfo->funcAttrNums)
 				{
@@ -6316,45 +6316,57 @@ pgxc_get_trigger_tuple(HeapTupleHeader tuphead)
 
 /*
  * pgxc_check_distcol_update:
- * Compare the distribution column value in tup1 and tup2, and error out if it
- * is different. This is called to make sure triggers have not updated the
- * distribution column.
+ * Compare the distribution column values in tup1 and tup2, and error out if
+ * any is different. This is called to make sure triggers have not updated the
+ * distribution columns.
  */
 static void
 pgxc_check_distcol_update(HeapTuple tup1, HeapTuple tup2,
 						  TupleDesc tupdesc, RelationLocInfo *rel_locinfo)
 {
-	Datum	old_distval;
-	Datum	new_distval;
-	bool	old_isnull;
-	bool	new_isnull;
-	Form_pg_attribute partAtt = tupdesc->attrs[rel_locinfo->partAttrNum - 1];
+	List	   *attnums;
+	ListCell   *lc;
 
-	old_distval = heap_getattr(tup1, rel_locinfo->partAttrNum, tupdesc, &old_isnull);
-	new_distval = heap_getattr(tup2, rel_locinfo->partAttrNum, tupdesc, &new_isnull);
+	if (IsRelationDistributedByMultiHash(rel_locinfo))
+		attnums = rel_locinfo->funcAttrNums;
+	else
+		attnums = list_make1_int(rel_locinfo->partAttrNum);
 
-	/*
-	 * On coordinator, the varlena types returned from datanodes should be
-	 * already detoasted, but still to be safe, make sure they are detoasted.
-	 * datumIsEqual() may or may not give correct results with toasted values.
-	 */
-	if (!partAtt->attbyval && partAtt->attlen == -1)
+	foreach (lc, attnums)
 	{
-		old_distval = PointerGetDatum(PG_DETOAST_DATUM(old_distval));
-		new_distval = PointerGetDatum(PG_DETOAST_DATUM(new_distval));
-	}
+		AttrNumber	attnum = (AttrNumber) lfirst_int(lc);
+		Datum	old_distval;
+		Datum	new_distval;
+		bool	old_isnull;
+		bool	new_isnull;
+		Form_pg_attribute partAtt = tupdesc->attrs[attnum - 1];
 
-	/*
-	 * If only one of them is NULL, that means it has been updated.
-	 * Compare the values if both of them are not-NULL.
-	 */
-	if (old_isnull != new_isnull ||
-		(!old_isnull && !new_isnull &&
-		 !datumIsEqual(old_distval, new_distval, partAtt->attbyval, partAtt->attlen)))
-		ereport(ERROR,
-				(errcode(ERRCODE_INVALID_COLUMN_REFERENCE),
-				 errmsg("Partition column cannot be updated"),
-				 errdetail("Trigger function updated the partition column")));
+		old_distval = heap_getattr(tup1, attnum, tupdesc, &old_isnull);
+		new_distval = heap_getattr(tup2, attnum, tupdesc, &new_isnull);
+
+		/*
+		 * On coordinator, the varlena types returned from datanodes should be
+		 * already detoasted, but still to be safe, make sure they are detoasted.
+		 * datumIsEqual() may or may not give correct results with toasted values.
+		 */
+		if (!partAtt->attbyval && partAtt->attlen == -1)
+		{
+			old_distval = PointerGetDatum(PG_DETOAST_DATUM(old_distval));
+			new_distval = PointerGetDatum(PG_DETOAST_DATUM(new_distval));
+		}
+
+		/*
+		 * If only one of them is NULL, that means it has been updated.
+		 * Compare the values if both of them are not-NULL.
+		 */
+		if (old_isnull != new_isnull ||
+			(!old_isnull && !new_isnull &&
+			 !datumIsEqual(old_distval, new_distval, partAtt->attbyval, partAtt->attlen)))
+			ereport(ERROR,
+					(errcode(ERRCODE_INVALID_COLUMN_REFERENCE),
+					 errmsg("Partition column cannot be updated"),
+					 errdetail("Trigger function updated the partition column")));
+	}
 }
 #endif
 
@@ -52,11 +52,15 @@
 
 #ifdef ADB
 #include "access/visibilitymap.h"
+#include "catalog/pgxc_class.h"
 #include "executor/executor.h"
 #include "nodes/makefuncs.h"
 #include "pgxc/execRemote.h"
+#include "pgxc/locator.h"
 #include "pgxc/pgxc.h"
+#include "utils/builtins.h"
 #include "utils/lsyscache.h"
+#include "utils/timestamp.h"
 #endif /* ADB */
 
 /*
@@ -1755,6 +1759,158 @@ get_remote_relstat(char *nspname, char *relname, bool replicated,
 	}
 }
 
+/* hash key to match datanode rows with coordinator relations */
+typedef struct RemoteAnalyzeName
+{
+	NameData	nspname;
+	NameData	relname;
+} RemoteAnalyzeName;
+
+typedef struct RemoteAnalyzeNameEnt
+{
+	RemoteAnalyzeName name;		/* hash key */
+	Oid			relid;
+	bool		replicated;
+} RemoteAnalyzeNameEnt;
+
+/*
+ * Get the analyze activity of the given distributed tables from all the
+ * data nodes with one query.  Returns a hash of RemoteAnalyzeInfo keyed by
+ * relid, allocated in the current memory context; tables no data node
+ * reported about are left out.  Requires an active snapshot.
+ */
+HTAB *
+get_remote_analyze_info(List *relids)
+{
+	HASHCTL			ctl;
+	HTAB		   *names;
+	HTAB		   *result;
+	ListCell	   *lc;
+	RemoteAnalyzeName key;
+	EState		   *estate;
+	MemoryContext	oldcontext;
+	RemoteQuery	   *step;
+	RemoteQueryState *node;
+	TupleTableSlot *slot;
+
+	MemSet(&ctl, 0, sizeof(ctl));
+	ctl.keysize = sizeof(Oid);
+	ctl.entrysize = sizeof(RemoteAnalyzeInfo);
+	ctl.hcxt = CurrentMemoryContext;
+	result = hash_create("Remote analyze info", 64, &ctl,
+						 HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
+
+	MemSet(&ctl, 0, sizeof(ctl));
+	ctl.keysize = sizeof(RemoteAnalyzeName);
+	ctl.entrysize = sizeof(RemoteAnalyzeNameEnt);
+	ctl.hcxt = CurrentMemoryContext;
+	names = hash_create("Remote analyze names", 64, &ctl,
+						HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
+
+	foreach (lc, relids)
+	{
+		Oid			relid = lfirst_oid(lc);
+		HeapTuple	tuple;
+		char	   *nspname;
+		char	   *relname;
+		RemoteAnalyzeNameEnt *ent;
+
+		tuple = SearchSysCache1(PGXCCLASSRELID, ObjectIdGetDatum(relid));
+		if (!HeapTupleIsValid(tuple))
+			continue;
+		relname = get_rel_name(relid);
+		nspname = relname ? get_namespace_name(get_rel_namespace(relid)) : NULL;
+		if (nspname == NULL)
+		{
+			ReleaseSysCache(tuple);
+			continue;
+		}
+
+		MemSet(&key, 0, sizeof(key));
+		namestrcpy(&key.nspname, nspname);
+		namestrcpy(&key.relname, relname);
+		ent = (RemoteAnalyzeNameEnt *) hash_search(names, &key, HASH_ENTER, NULL);
+		ent->relid = relid;
+		ent->replicated = IsLocatorReplicated(((Form_pgxc_class) GETSTRUCT(tuple))->pclocatortype);
+		ReleaseSysCache(tuple);
+	}
+
+	if (hash_get_num_entries(names) == 0)
+	{
+		hash_destroy(names);
+		return result;
+	}
+
+	step = makeNode(RemoteQuery);
+	step->combine_type = COMBINE_TYPE_NONE;
+	step->exec_nodes = NULL;
+	step->sql_statement = "SELECT schemaname, relname, n_mod_since_analyze, "
+						  "greatest(last_analyze, last_autoanalyze) "
+						  "FROM pg_catalog.pg_stat_user_tables";
+	step->force_autocommit = true;
+	step->exec_type = EXEC_ON_DATANODES;
+	step->scan.plan.targetlist = list_make4(
+		makeTargetEntry((Expr *) makeVar(1, 1, NAMEOID, -1, InvalidOid, 0), 1, NULL, false),
+		makeTargetEntry((Expr *) makeVar(1, 2, NAMEOID, -1, InvalidOid, 0), 2, NULL, false),
+		makeTargetEntry((Expr *) makeVar(1, 3, INT8OID, -1, InvalidOid, 0), 3, NULL, false),
+		makeTargetEntry((Expr *) makeVar(1, 4, TIMESTAMPTZOID, -1, InvalidOid, 0), 4, NULL, false));
+
+	estate = CreateExecutorState();
+	oldcontext = MemoryContextSwitchTo(estate->es_query_cxt);
+	estate->es_snapshot = GetActiveSnapshot();
+	node = ExecInitRemoteQuery(step, estate, 0);
+	MemoryContextSwitchTo(oldcontext);
+
+	for (slot = ExecRemoteQuery(node);
+		 slot != NULL && !TupIsNull(slot);
+		 slot = ExecRemoteQuery(node))
+	{
+		RemoteAnalyzeNameEnt *ent;
+		RemoteAnalyzeInfo *info;
+		Datum		value;
+		bool		isnull;
+		bool		found;
+		float8		changes;
+
+		MemSet(&key, 0, sizeof(key));
+		value = slot_getattr(slot, 1, &isnull);
+		if (isnull)
+			continue;
+		namestrcpy(&key.nspname, NameStr(*DatumGetName(value)));
+		value = slot_getattr(slot, 2, &isnull);
+		if (isnull)
+			continue;
+		namestrcpy(&key.relname, NameStr(*DatumGetName(value)));
+
+		ent = (RemoteAnalyzeNameEnt *) hash_search(names, &key, HASH_FIND, NULL);
+		if (ent == NULL)
+			continue;
+
+		info = (RemoteAnalyzeInfo *) hash_search(result, &ent->relid, HASH_ENTER, &found);
+		if (!found)
+		{
+			info->changes = 0;
+			info->last_analyze = 0;
+		}
+
+		value = slot_getattr(slot, 3, &isnull);
+		changes = isnull ? 0 : (float8) DatumGetInt64(value);
+		/* every node of a replicated table sees every change */
+		if (ent->replicated)
+			info->changes = Max(info->changes, changes);
+		else
+			info->changes += changes;
+
+		value = slot_getattr(slot, 4, &isnull);
+		if (!isnull && DatumGetTimestampTz(value) > info->last_analyze)
+			info->last_analyze = DatumGetTimestampTz(value);
+	}
+	ExecEndRemoteQuery(node);
+	FreeExecutorState(estate);
+
+	hash_destroy(names);
+	return result;
+}
 
 /*
  * Coordinator does not contain any data, so we never need to vacuum relations.
@@ -118,7 +118,7 @@ bool clusterRecvTupleEx(ClusterRecvState *state, const char *msg, int len, struc
 	switch(*msg)
 	{
 	case CLUSTER_MSG_TUPLE_DATA:
-		restore_slot_message(msg+1, len-1, state->base_slot);
+		restore_slot_message_ex(msg+1, len-1, state->base_slot, state->tuple_cxt);
 		return true;
 	case CLUSTER_MSG_TUPLE_DESC:
 		compare_slot_head_message(msg+1, len-1, state->base_slot->tts_tupleDescriptor);
@@ -164,7 +164,7 @@ bool clusterRecvTupleEx(ClusterRecvState *state, const char *msg, int len, struc
 	case CLUSTER_MSG_CONVERT_TUPLE:
 		if(state->convert)
 		{
-			restore_slot_message(msg+1, len-1, state->convert_slot);
+			restore_slot_message_ex(msg+1, len-1, state->convert_slot, state->tuple_cxt);
 			do_type_convert_slot_in(state->convert, state->convert_slot, state->base_slot, state->slot_need_copy_datum);
 			return true;
 		}else
@@ -324,6 +324,9 @@ ClusterRecvState *createClusterRecvState(PlanState *ps, bool need_copy)
 	state = palloc0(sizeof(*state));
 	state->base_slot = slot;
 	state->ps = ps;
+	state->tuple_cxt = GenerationContextCreate(CurrentMemoryContext,
+											   "ClusterRecvState tuples",
+											   ALLOCSET_DEFAULT_INITSIZE);
 
 	state->convert = create_type_convert(slot->tts_tupleDescriptor, false, true);
 	if(state->convert != NULL)
@@ -340,6 +343,14 @@ void freeClusterRecvState(ClusterRecvState *state)
 {
 	if(state)
 	{
+		if(state->tuple_cxt)
+		{
+			/* slots are cleared by ExecEndPlan only after us */
+			ExecClearTuple(state->base_slot);
+			if(state->convert_slot)
+				ExecClearTuple(state->convert_slot);
+			MemoryContextDelete(state->tuple_cxt);
+		}
 		if(state->convert_slot)
 		{
 			if(state->convert_slot_is_single)
@@ -595,12 +606,18 @@ void serialize_slot_message(StringInfo buf, TupleTableSlot *slot, char msg_type)
 }
 
 TupleTableSlot* restore_slot_message(const char *msg, int len, TupleTableSlot *slot)
+{
+	return restore_slot_message_ex(msg, len, slot, slot->tts_mcxt);
+}
+
+TupleTableSlot* restore_slot_message_ex(const char *msg, int len, TupleTableSlot *slot,
+										MemoryContext tuple_cxt)
 {
 	MinimalTuple tup;
 	uint32 t_len = *(uint32*)msg;
 	if(t_len > len)
 		ereport(ERROR, (errmsg("invalid tuple message length")));
-	tup = MemoryContextAlloc(slot->tts_mcxt, t_len);
+	tup = MemoryContextAlloc(tuple_cxt ? tuple_cxt : slot->tts_mcxt, t_len);
 	memcpy(tup, msg, t_len);
 	return ExecStoreMinimalTuple(tup, slot, true);
 }
@@ -11,6 +11,7 @@
 #include "lib/stringinfo.h"
 #include "libpq/libpq.h"
 #include "libpq/libpq-node.h"
+#include "libpq/md5.h"
 #include "libpq/pqformat.h"
 #include "miscadmin.h"
 #include "nodes/makefuncs.h"
@@ -21,7 +22,9 @@
 #include "storage/mem_toc.h"
 #include "tcop/dest.h"
 #include "utils/combocid.h"
+#include "utils/hsearch.h"
 #include "utils/lsyscache.h"
+#include "utils/memutils.h"
 #include "utils/ps_status.h"
 #include "utils/rel.h"
 #include "utils/snapmgr.h"
@@ -45,6 +48,24 @@
 #define REMOTE_KEY_ES_INSTRUMENT			0xFFFFFF09
 #define REMOTE_KEY_HAS_REDUCE				0xFFFFFF0A
 #define REMOTE_KEY_REDUCE_GROUP				0xFFFFFF0B
+#define REMOTE_KEY_PLAN_DIGEST				0xFFFFFF0C
+#define REMOTE_KEY_PLAN						0xFFFFFF0D
+
+/*
+ * A serialized plan (range table and PlannedStmt) of at least
+ * CLUSTER_PLAN_DIGEST_MIN bytes is sent by its MD5 digest.  Each remote
+ * backend keeps the last CLUSTER_PLAN_CACHE_ENTRIES such plans, together
+ * no more than cluster_plan_cache_size kilobytes, and the coordinator remembers
+ * which digests it sent to which remote backend, so a plan executed again
+ * crosses the network once per backend instead of once per execution.
+ * What the coordinator remembers is only a hint: a remote backend which
+ * does not hold the plan (evicted, or another session sent it plans in
+ * between) asks for it once it has replied to the plan message.
+ */
+#define CLUSTER_PLAN_DIGEST_MIN				8192
+#define CLUSTER_PLAN_CACHE_ENTRIES			16
+#define CLUSTER_PLAN_CACHE_BYTES			((Size) cluster_plan_cache_size * 1024)
+#define CLUSTER_PLAN_DIGEST_LEN				33	/* MD5 in hex, and '\0' */
 
 typedef struct ClusterPlanContext
 {
@@ -52,8 +73,31 @@ typedef struct ClusterPlanContext
 	bool have_temp;					/* have temporary object */
 	bool have_reduce;				/* does this cluster plan have reduce node? */
 	bool start_self_reduce;			/* does this cluster plan need start self-reduce? */
+	StringInfo plan;				/* REMOTE_KEY_PLAN message, NULL when inlined */
+	char plan_digest[CLUSTER_PLAN_DIGEST_LEN];
 }ClusterPlanContext;
 
+/* plan a remote backend keeps, see CLUSTER_PLAN_DIGEST_MIN */
+typedef struct ClusterPlanCacheEntry
+{
+	char			digest[CLUSTER_PLAN_DIGEST_LEN];
+	StringInfoData	plan;
+}ClusterPlanCacheEntry;
+
+/* digests the coordinator sent to a remote backend */
+typedef struct ClusterPlanHolderKey
+{
+	Oid		nodeoid;
+	int		pid;
+}ClusterPlanHolderKey;
+
+typedef struct ClusterPlanHolder
+{
+	ClusterPlanHolderKey	key;
+	int						next;	/* slot to overwrite next */
+	char					digests[CLUSTER_PLAN_CACHE_ENTRIES][CLUSTER_PLAN_DIGEST_LEN];
+}ClusterPlanHolder;
+
 typedef struct ClusterErrorHookContext
 {
 	ErrorContextCallback	callback;
@@ -62,9 +106,20 @@ typedef struct ClusterErrorHookContext
 }ClusterErrorHookContext;
 
 extern bool enable_cluster_plan;
+extern int cluster_plan_cache_size;
+
+/* remote side, most recently used first */
+static List *cluster_plan_cache = NIL;
+static Size cluster_plan_cache_bytes = 0;
+/* coordinator side */
+static HTAB *cluster_plan_holders = NULL;
 
 static void restore_cluster_plan_info(StringInfo buf);
-static QueryDesc *create_cluster_query_desc(StringInfo buf, DestReceiver *r);
+static StringInfo restore_cluster_plan(StringInfo info);
+static StringInfo store_cluster_plan(const char *digest, const char *data, int len);
+static void send_copy_both_response(void);
+static void recv_copy_data_message(StringInfo msg, const char *what);
+static QueryDesc *create_cluster_query_desc(StringInfo info, StringInfo plan, DestReceiver *r);
 
 static void SerializePlanInfo(StringInfo msg, PlannedStmt *stmt, ParamListInfo param, ClusterPlanContext *context);
 static bool SerializePlanHook(StringInfo buf, Node *node, void *context);
@@ -76,6 +131,9 @@ static void wait_rdc_group_message(void);
 static bool get_rdc_listen_port_hook(void *context, struct pg_conn *conn, PQNHookFuncType type, ...);
 static void StartRemoteReduceGroup(List *conns, RdcMask *rdc_masks, int rdc_cnt);
 static void StartRemotePlan(StringInfo msg, List *rnodes, ClusterPlanContext *context);
+static ClusterPlanHolder *get_cluster_plan_holder(Oid nodeoid, PGconn *conn);
+static bool cluster_plan_held(ClusterPlanHolder *holder, const char *digest);
+static bool get_cluster_plan_status_hook(void *context, struct pg_conn *conn, PQNHookFuncType type, ...);
 static bool InstrumentEndLoop_walker(PlanState *ps, void *);
 
 static void ExecClusterErrorHookMaster(void *arg);
@@ -87,6 +145,7 @@ void exec_cluster_plan(const void *splan, int length)
 {
 	QueryDesc *query_desc;
 	DestReceiver *receiver;
+	StringInfo plan;
 	StringInfoData buf;
 	StringInfoData msg;
 	ClusterErrorHookContext error_context_hook;
@@ -101,8 +160,9 @@ void exec_cluster_plan(const void *splan, int length)
 	enable_cluster_plan = true;
 
 	restore_cluster_plan_info(&buf);
+	plan = restore_cluster_plan(&buf);
 	receiver = CreateDestReceiver(DestClusterOut);
-	query_desc = create_cluster_query_desc(&buf, receiver);
+	query_desc = create_cluster_query_desc(&buf, plan, receiver);
 	if(mem_toc_lookup(&buf, REMOTE_KEY_ES_INSTRUMENT, NULL) != NULL)
 		need_instrument = true;
 	else
@@ -113,14 +173,11 @@ void exec_cluster_plan(const void *splan, int length)
 	else
 		has_reduce = false;
 
-	/* Send a message
-	 * 'H' for copy out, 'W' for copy both */
-	initStringInfo(&msg);
-	pq_sendbyte(&msg, 0);
-	pq_sendint(&msg, 0, 2);
-	pq_putmessage('W', msg.data, msg.len);
-	pq_flush();
+	/* a plan sent by digest already answered */
+	if (plan == &buf)
+		send_copy_both_response();
 
+	initStringInfo(&msg);
 	if (has_reduce)
 	{
 		int rdc_listen_port;
@@ -208,7 +265,120 @@ static void restore_cluster_plan_info(StringInfo buf)
 	/* ADBQ: need active snapshot? */
 }
 
-static QueryDesc *create_cluster_query_desc(StringInfo info, DestReceiver *r)
+/*
+ * Return the message holding the range table and PlannedStmt: the plan
+ * message itself, or, when the plan was sent by digest, the cached plan.
+ * In the latter case the copy both response is sent here, followed by a
+ * CLUSTER_MSG_PLAN_STATUS message telling whether we need the plan.
+ */
+static StringInfo restore_cluster_plan(StringInfo info)
+{
+	ClusterPlanCacheEntry *entry;
+	StringInfo		plan;
+	StringInfoData	msg;
+	ListCell	   *lc;
+	const char	   *digest;
+	char		   *data;
+	int				len;
+	bool			need;
+
+	digest = mem_toc_lookup(info, REMOTE_KEY_PLAN_DIGEST, NULL);
+	if (digest == NULL)
+		return info;
+
+	plan = NULL;
+	data = mem_toc_lookup(info, REMOTE_KEY_PLAN, &len);
+	if (data != NULL)
+	{
+		plan = store_cluster_plan(digest, data, len);
+	}else
+	{
+		foreach (lc, cluster_plan_cache)
+		{
+			entry = lfirst(lc);
+			if (strcmp(entry->digest, digest) == 0)
+			{
+				cluster_plan_cache = lcons(entry, list_delete_cell(cluster_plan_cache, lc, NULL));
+				plan = &entry->plan;
+				break;
+			}
+		}
+	}
+
+	need = (plan == NULL);
+	send_copy_both_response();
+	initStringInfo(&msg);
+	appendStringInfoChar(&msg, CLUSTER_MSG_PLAN_STATUS);
+	appendBinaryStringInfo(&msg, (char *) &need, sizeof(need));
+	pq_putmessage('d', msg.data, msg.len);
+	pq_flush();
+	pfree(msg.data);
+
+	if (need)
+	{
+		recv_copy_data_message(&msg, "cluster plan");
+		data = mem_toc_lookup(&msg, REMOTE_KEY_PLAN, &len);
+		if (data == NULL)
+			ereport(ERROR, (errcode(ERRCODE_PROTOCOL_VIOLATION)
+				, errmsg("Can not find cluster plan")));
+		plan = store_cluster_plan(digest, data, len);
+		pfree(msg.data);
+	}
+
+	return plan;
+}
+
+/*
+ * Keep a plan sent by digest, evicting the least recently used ones.
+ * The coordinator does not send plans over CLUSTER_PLAN_CACHE_BYTES
+ * by digest, but its setting may be larger than ours: such a plan is
+ * kept alone.
+ */
+static StringInfo store_cluster_plan(const char *digest, const char *data, int len)
+{
+	ClusterPlanCacheEntry *entry;
+	MemoryContext	oldcontext;
+
+	while (cluster_plan_cache != NIL &&
+		   (list_length(cluster_plan_cache) >= CLUSTER_PLAN_CACHE_ENTRIES ||
+			cluster_plan_cache_bytes + len > CLUSTER_PLAN_CACHE_BYTES))
+	{
+		entry = llast(cluster_plan_cache);
+		cluster_plan_cache = list_delete_ptr(cluster_plan_cache, entry);
+		cluster_plan_cache_bytes -= entry->plan.len;
+		pfree(entry->plan.data);
+		pfree(entry);
+	}
+
+	oldcontext = MemoryContextSwitchTo(TopMemoryContext);
+	entry = palloc(sizeof(*entry));
+	strlcpy(entry->digest, digest, sizeof(entry->digest));
+	entry->plan.data = palloc(len);
+	memcpy(entry->plan.data, data, len);
+	entry->plan.len = entry->plan.maxlen = len;
+	entry->plan.cursor = 0;
+	cluster_plan_cache = lcons(entry, cluster_plan_cache);
+	cluster_plan_cache_bytes += len;
+	MemoryContextSwitchTo(oldcontext);
+
+	return &entry->plan;
+}
+
+/* Send a message
+ * 'H' for copy out, 'W' for copy both */
+static void send_copy_both_response(void)
+{
+	StringInfoData msg;
+
+	initStringInfo(&msg);
+	pq_sendbyte(&msg, 0);
+	pq_sendint(&msg, 0, 2);
+	pq_putmessage('W', msg.data, msg.len);
+	pq_flush();
+	pfree(msg.data);
+}
+
+static QueryDesc *create_cluster_query_desc(StringInfo info, StringInfo plan, DestReceiver *r)
 {
 	ListCell *lc;
 	List *rte_list;
@@ -219,7 +389,7 @@ static QueryDesc *create_cluster_query_desc(StringInfo info, DestReceiver *r)
 	int es_instrument;
 	int i,n;
 
-	buf.data = mem_toc_lookup(info, REMOTE_KEY_RTE_LIST, &buf.len);
+	buf.data = mem_toc_lookup(plan, REMOTE_KEY_RTE_LIST, &buf.len);
 	if(buf.data == NULL)
 		ereport(ERROR, (errcode(ERRCODE_PROTOCOL_VIOLATION)
 			, errmsg("can not find range table list")));
@@ -238,7 +408,7 @@ static QueryDesc *create_cluster_query_desc(StringInfo info, DestReceiver *r)
 			base_rels[i] = NULL;
 	}
 
-	buf.data = mem_toc_lookup(info, REMOTE_KEY_PLAN_STMT, &buf.len);
+	buf.data = mem_toc_lookup(plan, REMOTE_KEY_PLAN_STMT, &buf.len);
 	if(buf.data == NULL)
 		ereport(ERROR, (errcode(ERRCODE_PROTOCOL_VIOLATION)
 			, errmsg("Can not find PlannedStmt")));
@@ -367,6 +537,11 @@ PlanState* ExecStartClusterPlan(Plan *plan, EState *estate, int eflags, List *rn
 
 	StartRemotePlan(&msg, rnodes, &context);
 	pfree(msg.data);
+	if (context.plan)
+	{
+		pfree(context.plan->data);
+		pfree(context.plan);
+	}
 
 	return ExecInitNode(plan, estate, eflags);
 }
@@ -377,6 +552,7 @@ static void SerializePlanInfo(StringInfo msg, PlannedStmt *stmt,
 	ListCell *lc;
 	List *rte_list;
 	PlannedStmt *new_stmt;
+	StringInfoData plan;
 	Size size;
 
 	new_stmt = palloc(sizeof(*new_stmt));
@@ -407,13 +583,36 @@ static void SerializePlanInfo(StringInfo msg, PlannedStmt *stmt,
 			rte_list = lappend(rte_list, rte);
 		}
 	}
-	begin_mem_toc_insert(msg, REMOTE_KEY_RTE_LIST);
-	saveNodeAndHook(msg, (Node*)rte_list, SerializePlanHook, context);
-	end_mem_toc_insert(msg, REMOTE_KEY_RTE_LIST);
-
-	begin_mem_toc_insert(msg, REMOTE_KEY_PLAN_STMT);
-	saveNodeAndHook(msg, (Node*)new_stmt, SerializePlanHook, context);
-	end_mem_toc_insert(msg, REMOTE_KEY_PLAN_STMT);
+	initStringInfo(&plan);
+	begin_mem_toc_insert(&plan, REMOTE_KEY_RTE_LIST);
+	saveNodeAndHook(&plan, (Node*)rte_list, SerializePlanHook, context);
+	end_mem_toc_insert(&plan, REMOTE_KEY_RTE_LIST);
+
+	begin_mem_toc_insert(&plan, REMOTE_KEY_PLAN_STMT);
+	saveNodeAndHook(&plan, (Node*)new_stmt, SerializePlanHook, context);
+	end_mem_toc_insert(&plan, REMOTE_KEY_PLAN_STMT);
+
+	/* large plans go by digest, see CLUSTER_PLAN_DIGEST_MIN */
+	if (context &&
+		plan.len >= CLUSTER_PLAN_DIGEST_MIN &&
+		(Size) plan.len <= CLUSTER_PLAN_CACHE_BYTES &&
+		pg_md5_hash(plan.data, plan.len, context->plan_digest))
+	{
+		begin_mem_toc_insert(msg, REMOTE_KEY_PLAN_DIGEST);
+		appendBinaryStringInfo(msg, context->plan_digest, CLUSTER_PLAN_DIGEST_LEN);
+		end_mem_toc_insert(msg, REMOTE_KEY_PLAN_DIGEST);
+
+		context->plan = makeStringInfo();
+		begin_mem_toc_insert(context->plan, REMOTE_KEY_PLAN);
+		appendBinaryStringInfo(context->plan, plan.data, plan.len);
+		end_mem_toc_insert(context->plan, REMOTE_KEY_PLAN);
+	}else
+	{
+		appendBinaryStringInfo(msg, plan.data, plan.len);
+		if (context)
+			context->plan = NULL;
+	}
+	pfree(plan.data);
 
 	begin_mem_toc_insert(msg, REMOTE_KEY_PARAM);
 	SaveParamList(msg, param);
@@ -622,26 +821,12 @@ static void *LoadPlanHook(StringInfo buf, NodeTag tag, void *context)
 
 static void SerializeRelationOid(StringInfo buf, Oid relid)
 {
-	Relation rel;
-	rel = relation_open(relid, NoLock);
-	save_namespace(buf, RelationGetNamespace(rel));
-	save_node_string(buf, RelationGetRelationName(rel));
-	relation_close(rel, NoLock);
+	save_oid_class(buf, relid);
 }
 
 static Oid RestoreRelationOid(StringInfo buf, bool missok)
 {
-	Oid oid = load_namespace_extend(buf, missok);
-	char *rel_name = load_node_string(buf, true);
-	if(OidIsValid(oid) && rel_name[0])
-		oid = get_relname_relid(rel_name, oid);
-	else
-		oid = InvalidOid;
-	if(!OidIsValid(oid) && !missok)
-		ereport(ERROR,
-				(errcode(ERRCODE_UNDEFINED_OBJECT),
-				errmsg("relation \"%s\" not exists", rel_name)));
-	return oid;
+	return load_oid_class_extend(buf, missok);
 }
 
 static void send_rdc_listend_port(int port)
@@ -654,14 +839,12 @@ static void send_rdc_listend_port(int port)
 	pfree(buf.data);
 }
 
-static void wait_rdc_group_message(void)
+/*
+ * Read a copy data message the coordinator sent, "what" names it in errors
+ */
+static void recv_copy_data_message(StringInfo msg, const char *what)
 {
-	int				i;
 	int				type;
-	int				rdc_cnt;
-	RdcMask		   *rdc_masks;
-	StringInfoData	buf;
-	StringInfoData	msg;
 
 	pq_startmsgread();
 	type = pq_getbyte();
@@ -670,24 +853,35 @@ static void wait_rdc_group_message(void)
 		if (type != EOF)
 			ereport(ERROR,
 				(errcode(ERRCODE_CONNECTION_FAILURE),
-				 errmsg("fail to receive reduce group message"),
+				 errmsg("fail to receive %s message", what),
 				 errdetail("unexpected message type '%c' on client connection", type)));
 
 		ereport(ERROR,
 				(errcode(ERRCODE_CONNECTION_FAILURE),
-				 errmsg("fail to receive reduce group message"),
+				 errmsg("fail to receive %s message", what),
 				 errdetail("unexpected EOF on client connection")));
 	}
 
-	initStringInfo(&msg);
-	if (pq_getmessage(&msg, 0))
+	initStringInfo(msg);
+	if (pq_getmessage(msg, 0))
 	{
-		pfree(msg.data);
+		pfree(msg->data);
 		ereport(ERROR,
 				(errcode(ERRCODE_CONNECTION_FAILURE),
-				 errmsg("fail to receive reduce group message"),
+				 errmsg("fail to receive %s message", what),
 				 errdetail("unexpected EOF on client connection")));
 	}
+}
+
+static void wait_rdc_group_message(void)
+{
+	int				i;
+	int				rdc_cnt;
+	RdcMask		   *rdc_masks;
+	StringInfoData	buf;
+	StringInfoData	msg;
+
+	recv_copy_data_message(&msg, "reduce group");
 
 	buf.data = mem_toc_lookup(&msg, REMOTE_KEY_REDUCE_GROUP, &(buf.len));
 	if (buf.data == NULL)
@@ -814,6 +1008,9 @@ static void StartRemotePlan(StringInfo msg, List *rnodes, ClusterPlanContext *co
 	RdcMask		   *rdc_masks = NULL;
 	ErrorContextCallback error_context_hook;
 	InterXactState	state;
+	ClusterPlanHolder **holders = NULL;
+	bool			need_plan;
+	int				i;
 
 	Assert(rnodes);
 	/* try to start transaction */
@@ -845,7 +1042,10 @@ static void StartRemotePlan(StringInfo msg, List *rnodes, ClusterPlanContext *co
 	list_conn = GetPGconnFromHandleList(state->cur_handle->handles);
 	/*foreach(lc, list_conn)*/
 	Assert(list_length(list_conn) == list_length(rnodes));
+	if (context->plan)
+		holders = palloc(sizeof(ClusterPlanHolder *) * list_length(list_conn));
 	save_len = msg->len;
+	i = 0;
 	forboth(lc, list_conn, lc2, rnodes)
 	{
 		/* send node oid to remote */
@@ -854,6 +1054,15 @@ static void StartRemotePlan(StringInfo msg, List *rnodes, ClusterPlanContext *co
 		appendBinaryStringInfo(msg, (char*)&(lfirst_oid(lc2)), sizeof(lfirst_oid(lc2)));
 		end_mem_toc_insert(msg, REMOTE_KEY_NODE_OID);
 
+		/* send the plan itself unless the remote backend should hold it */
+		if (context->plan)
+		{
+			holders[i] = get_cluster_plan_holder(lfirst_oid(lc2), lfirst(lc));
+			if (!cluster_plan_held(holders[i], context->plan_digest))
+				appendBinaryStringInfo(msg, context->plan->data, context->plan->len);
+			i++;
+		}
+
 		/* send reduce group map and reduce ID to remote */
 		if (context->have_reduce)
 		{
@@ -911,6 +1120,38 @@ static void StartRemotePlan(StringInfo msg, List *rnodes, ClusterPlanContext *co
 			PQclear(res);
 			res = NULL;
 		}
+
+		/* send the plan to the remote backends which do not hold it */
+		if (context->plan)
+		{
+			i = 0;
+			foreach(lc, list_conn)
+			{
+				conn = lfirst(lc);
+				PQNOneExecFinish(conn, get_cluster_plan_status_hook, &need_plan, true);
+				if (need_plan &&
+					(PQputCopyData(conn, context->plan->data, context->plan->len) <= 0 ||
+					 PQflush(conn)))
+				{
+					const char *node_name = PQNConnectName(conn);
+					ereport(ERROR,
+							(errcode(ERRCODE_CONNECTION_FAILURE),
+							 errmsg("%s", PQerrorMessage(conn)),
+							 node_name ? errnode(node_name) : 0));
+				}
+
+				/* remember it is there now */
+				if (!cluster_plan_held(holders[i], context->plan_digest))
+				{
+					strlcpy(holders[i]->digests[holders[i]->next],
+							context->plan_digest,
+							CLUSTER_PLAN_DIGEST_LEN);
+					holders[i]->next = (holders[i]->next + 1) % CLUSTER_PLAN_CACHE_ENTRIES;
+				}
+				i++;
+			}
+			pfree(holders);
+		}
 	}PG_CATCH();
 	{
 		if(res)
@@ -946,6 +1187,106 @@ static void StartRemotePlan(StringInfo msg, List *rnodes, ClusterPlanContext *co
 	error_context_stack = error_context_hook.previous;
 }
 
+/*
+ * Find what we know a remote backend holds, keyed by its node and pid;
+ * a backend which exited and whose pid got reused only costs a round trip.
+ */
+static ClusterPlanHolder *get_cluster_plan_holder(Oid nodeoid, PGconn *conn)
+{
+	ClusterPlanHolderKey	key;
+	ClusterPlanHolder	   *holder;
+	bool					found;
+
+	if (cluster_plan_holders == NULL)
+	{
+		HASHCTL		ctl;
+
+		MemSet(&ctl, 0, sizeof(ctl));
+		ctl.keysize = sizeof(ClusterPlanHolderKey);
+		ctl.entrysize = sizeof(ClusterPlanHolder);
+		ctl.hcxt = TopMemoryContext;
+		cluster_plan_holders = hash_create("cluster plan holders",
+										   64,
+										   &ctl,
+										   HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
+	}
+
+	MemSet(&key, 0, sizeof(key));
+	key.nodeoid = nodeoid;
+	key.pid = PQbackendPID(conn);
+	holder = hash_search(cluster_plan_holders, &key, HASH_ENTER, &found);
+	if (!found)
+	{
+		holder->next = 0;
+		MemSet(holder->digests, 0, sizeof(holder->digests));
+	}
+
+	return holder;
+}
+
+static bool cluster_plan_held(ClusterPlanHolder *holder, const char *digest)
+{
+	int		i;
+
+	for (i = 0; i < CLUSTER_PLAN_CACHE_ENTRIES; i++)
+	{
+		if (strcmp(holder->digests[i], digest) == 0)
+			return true;
+	}
+	return false;
+}
+
+static bool
+get_cluster_plan_status_hook(void *context, struct pg_conn *conn, PQNHookFuncType type, ...)
+{
+	va_list			args;
+	const char	   *buf;
+	const char	   *node_name;
+	PGresult	   *res;
+	int				len;
+
+	AssertArg(context);
+	switch (type)
+	{
+		case PQNHFT_ERROR:
+			ereport(ERROR, (errmsg("%m")));
+		case PQNHFT_COPY_OUT_DATA:
+			va_start(args, type);
+			buf = va_arg(args, const char*);
+			len = va_arg(args, int);
+			va_end(args);
+
+			if (buf[0] != CLUSTER_MSG_PLAN_STATUS ||
+				len != sizeof(bool) + 1)
+			{
+				node_name = PQNConnectName(conn);
+				ereport(ERROR,
+						(errcode(ERRCODE_PROTOCOL_VIOLATION),
+						 errmsg("fail to get cluster plan status"),
+						 errdetail("unexpected cluster message type %d", buf[0]),
+						 node_name ? errnode(node_name) : 0));
+			}
+			memcpy(context, buf + 1, sizeof(bool));
+			return true;
+		case PQNHFT_RESULT:
+			va_start(args, type);
+			res = va_arg(args, PGresult*);
+			va_end(args);
+			if (res && PQresultStatus(res) == PGRES_FATAL_ERROR)
+				PQNReportResultError(res, conn, ERROR, true);
+			node_name = PQNConnectName(conn);
+			ereport(ERROR,
+					(errcode(ERRCODE_INTERNAL_ERROR),
+					 errmsg("fail to get cluster plan status"),
+					 node_name ? errnode(node_name) : 0));
+			break;
+		default:
+			ereport(ERROR, (errmsg("unexpected PQNHookFuncType %d", type)));
+			break;
+	}
+	return false;
+}
+
 static bool InstrumentEndLoop_walker(PlanState *ps, void *context)
 {
 	if(ps == NULL)
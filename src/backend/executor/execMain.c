@@ -65,7 +65,9 @@
 #include "executor/nodeClusterReduce.h"
 #include "executor/nodeReduceScan.h"
 #include "nodes/nodeFuncs.h"
+#include "pgxc/noderange.h"
 #include "pgxc/pgxc.h"
+#include "pgxc/resultcache.h"
 #endif
 
 
@@ -180,6 +182,12 @@ standard_ExecutorStart(QueryDesc *queryDesc, int eflags)
 		!(eflags & EXEC_FLAG_EXPLAIN_ONLY))
 		ExecCheckXactReadOnly(queryDesc->plannedstmt);
 
+#ifdef ADB
+	/* drop cached results of replicated tables this plan writes */
+	if (!(eflags & EXEC_FLAG_EXPLAIN_ONLY))
+		ResultCacheNoteWrites(queryDesc->plannedstmt);
+#endif /* ADB */
+
 	/*
 	 * Build EState, switch into per-query memory context for startup.
 	 */
@@ -243,6 +251,12 @@ standard_ExecutorStart(QueryDesc *queryDesc, int eflags)
 	estate->es_top_eflags = eflags;
 	estate->es_instrument = queryDesc->instrument_options;
 
+#ifdef ADB
+	/* the value ranges the plan relies on must hold for our snapshot */
+	if (!(eflags & EXEC_FLAG_EXPLAIN_ONLY))
+		NodeRangeCheckPlan(queryDesc->plannedstmt, estate->es_snapshot);
+#endif /* ADB */
+
 	/*
 	 * Initialize the plan state tree
 	 */
@@ -481,6 +495,12 @@ standard_ExecutorEnd(QueryDesc *queryDesc)
 
 	ExecEndPlan(queryDesc->planstate, estate);
 
+#ifdef ADB
+	/* rows written by this plan may lie outside the known node ranges */
+	if (!(estate->es_top_eflags & EXEC_FLAG_EXPLAIN_ONLY))
+		NodeRangeNoteWrites(queryDesc->plannedstmt);
+#endif /* ADB */
+
 	/* do away with our snapshots */
 	UnregisterSnapshot(estate->es_snapshot);
 	UnregisterSnapshot(estate->es_crosscheck_snapshot);
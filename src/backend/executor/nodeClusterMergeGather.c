@@ -183,6 +183,12 @@ void ExecEndClusterMergeGather(ClusterMergeGatherState *node)
 		PQNListExecFinish(list, NULL, PQNEFHNormal, NULL, true);
 		list_free(list);
 	}
+	/* tuples of remote slots live in recv_state */
+	for(i=0;i<node->nremote;++i)
+	{
+		if(node->slots[i])
+			ExecClearTuple(node->slots[i]);
+	}
 	freeClusterRecvState(node->recv_state);
 }
 
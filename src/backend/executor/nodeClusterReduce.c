@@ -13,6 +13,7 @@
 #include "pgxc/pgxc.h"
 #include "reduce/adb_reduce.h"
 #include "utils/hsearch.h"
+#include "utils/memutils.h"
 
 extern bool enable_cluster_plan;
 
@@ -34,6 +35,7 @@ static TupleTableSlot *GetMergeSlotFromRemote(ClusterReduceState *node, ReduceEn
 static TupleTableSlot *ExecClusterMergeReduce(ClusterReduceState *node);
 static void WaitForServerFIN(RdcPort *port);
 static void DisConnectSelfReduce(ClusterReduceState *node);
+static void SwitchToAdaptiveReduce(ClusterReduceState *node, bool notify);
 static bool DriveClusterReduceState(ClusterReduceState *node);
 static bool DriveCteScanState(CteScanState *node);
 static bool DriveClusterReduceWalker(PlanState *node);
@@ -172,6 +174,14 @@ ExecInitClusterReduce(ClusterReduce *node, EState *estate, int eflags)
 	crstate->ended = false;
 	crstate->tuplestorestate = NULL;
 
+	/*
+	 * Tuples received from remote live until the next one is stored in
+	 * the same slot, keep them apart from the query context.
+	 */
+	crstate->tuple_cxt = GenerationContextCreate(CurrentMemoryContext,
+												 "ClusterReduce tuples",
+												 ALLOCSET_DEFAULT_INITSIZE);
+
 	ExecInitResultTupleSlot(estate, &crstate->ps);
 	ExecAssignExprContext(estate, &crstate->ps);
 	ExecAssignResultTypeFromTL(&crstate->ps);
@@ -235,6 +245,8 @@ ExecInitClusterReduce(ClusterReduce *node, EState *estate, int eflags)
 	{
 		crstate->reduceState = ExecInitExpr(node->reduce, &crstate->ps);
 	}
+	if (node->adaptive_reduce)
+		crstate->adaptiveState = ExecInitExpr(node->adaptive_reduce, &crstate->ps);
 
 	estate->es_reduce_plan_inited = true;
 
@@ -260,6 +272,7 @@ GetSlotFromOuter(ClusterReduceState *node)
 	PlanState	   *outerNode;
 	bool			outerValid;
 	List		   *destOids = NIL;
+	ClusterReduce  *plan = (ClusterReduce *) node->ps.plan;
 
 	Assert(node && node->port);
 	port = node->port;
@@ -271,6 +284,15 @@ GetSlotFromOuter(ClusterReduceState *node)
 		outerslot = ExecProcNode(outerNode);
 		if (!TupIsNull(outerslot))
 		{
+			/* inner side of the join did not switch, keep the row here */
+			if (plan->adaptive_follow && !node->adaptive_switched)
+				return outerslot;
+
+			if (node->adaptiveState != NULL &&
+				!node->adaptive_switched &&
+				++(node->adaptive_seen) > plan->adaptive_rows)
+				SwitchToAdaptiveReduce(node, true);
+
 			econtext = node->ps.ps_ExprContext;
 			econtext->ecxt_outertuple = outerslot;
 			for(;;)
@@ -342,6 +364,7 @@ ExecClusterReduce(ClusterReduceState *node)
 	ReduceEntry		entry;
 	bool			found;
 	Oid				eof_oid;
+	Oid				adapt_oid;
 	EState		   *estate;
 	Tuplestorestate*tuplestorestate;
 	ScanDirection	dir;
@@ -434,6 +457,7 @@ ExecClusterReduce(ClusterReduceState *node)
 				{
 					ExecClearTuple(slot);
 					eof_oid = InvalidOid;
+					adapt_oid = InvalidOid;
 					if (node->eof_underlying)
 						rdc_set_block(port);
 					else
@@ -441,13 +465,19 @@ ExecClusterReduce(ClusterReduceState *node)
 
 					if(node->convert)
 					{
-						GetSlotFromRemote(port, node->convert_slot, NULL, &eof_oid, &node->closed_remote);
+						GetSlotFromRemote(port, node->convert_slot, node->tuple_cxt, NULL, &eof_oid, &adapt_oid, &node->closed_remote);
 						outerslot = do_type_convert_slot_in(node->convert, node->convert_slot, slot, false);
 					}else
 					{
-						outerslot = GetSlotFromRemote(port, slot, NULL, &eof_oid, &node->closed_remote);
+						outerslot = GetSlotFromRemote(port, slot, node->tuple_cxt, NULL, &eof_oid, &adapt_oid, &node->closed_remote);
 					}
 
+					/* some node switched, follow it */
+					if (OidIsValid(adapt_oid) &&
+						node->adaptiveState != NULL &&
+						!node->adaptive_switched)
+						SwitchToAdaptiveReduce(node, false);
+
 					if (OidIsValid(eof_oid))
 					{
 						found = false;
@@ -573,11 +603,11 @@ GetMergeSlotFromRemote(ClusterReduceState *node, ReduceEntry entry)
 
 		if(node->convert)
 		{
-			GetSlotFromRemote(port, node->convert_slot, &slot_oid, &eof_oid, &(node->closed_remote));
+			GetSlotFromRemote(port, node->convert_slot, node->tuple_cxt, &slot_oid, &eof_oid, NULL, &(node->closed_remote));
 			outerslot = do_type_convert_slot_in(node->convert, node->convert_slot, cur_slot, false);
 		}else
 		{
-			outerslot = GetSlotFromRemote(port, cur_slot, &slot_oid, &eof_oid, &(node->closed_remote));
+			outerslot = GetSlotFromRemote(port, cur_slot, node->tuple_cxt, &slot_oid, &eof_oid, NULL, &(node->closed_remote));
 		}
 
 		if (OidIsValid(eof_oid))
@@ -814,6 +844,17 @@ void ExecEndClusterReduce(ClusterReduceState *node)
 		free_type_convert(node->convert);
 	}
 
+	/*
+	 * The result slot is cleared by ExecEndPlan only after us, free its
+	 * tuple while the context holding it still exists.
+	 */
+	if (node->tuple_cxt)
+	{
+		ExecClearTuple(node->ps.ps_ResultTupleSlot);
+		MemoryContextDelete(node->tuple_cxt);
+		node->tuple_cxt = NULL;
+	}
+
 	ExecEndNode(outerPlanState(node));
 }
 
@@ -868,6 +909,50 @@ ExecClusterReduceRestrPos(ClusterReduceState *node)
 	tuplestore_copy_read_pointer(node->tuplestorestate, 1, 0);
 }
 
+/*
+ * Reduce the rest of rows by adaptive_reduce, rows already sent to every
+ * node do no harm: the outer side of the join follows us and reduces its
+ * rows by the same hash, see ExecClusterReduceFollow.
+ */
+static void
+SwitchToAdaptiveReduce(ClusterReduceState *node, bool notify)
+{
+	Assert(node->adaptiveState && !node->adaptive_switched);
+
+	elog(DEBUG1,
+		 "[PLAN %d] switch to adaptive reduce after " INT64_FORMAT " rows%s",
+		 PlanNodeID(node->ps.plan), node->adaptive_seen,
+		 notify ? "" : " as other node did");
+
+	node->reduceState = node->adaptiveState;
+	node->adaptive_switched = true;
+
+	/* tell other nodes before any row reduced the new way */
+	if (notify)
+		SendAdaptToRemote(node->port, PlanStateGetTargetNodes(node));
+}
+
+/* ----------------------------------------------------------------
+ *		ExecClusterReduceFollow
+ *
+ *		Called once the inner side of a join, "leader", is read to the
+ *		end.  Every node then knows whether any of them switched to the
+ *		adaptive reduce, in which case the outer side must reduce all of
+ *		its rows, otherwise it keeps them where they are.
+ * ----------------------------------------------------------------
+ */
+void
+ExecClusterReduceFollow(ClusterReduceState *node, ClusterReduceState *leader)
+{
+	if (!((ClusterReduce *) node->ps.plan)->adaptive_follow ||
+		leader->adaptiveState == NULL ||
+		node->started)
+		return;
+
+	Assert(leader->eof_underlying && leader->eof_network);
+	node->adaptive_switched = leader->adaptive_switched;
+}
+
 void
 ExecReScanClusterReduce(ClusterReduceState *node)
 {
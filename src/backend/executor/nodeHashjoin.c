@@ -21,6 +21,9 @@
 #include "executor/nodeHash.h"
 #include "executor/nodeHashjoin.h"
 #include "miscadmin.h"
+#ifdef ADB
+#include "executor/nodeClusterReduce.h"
+#endif
 #include "utils/memutils.h"
 
 
@@ -184,6 +187,17 @@ ExecHashJoin(HashJoinState *node)
 				hashNode->hashtable = hashtable;
 				(void) MultiExecProcNode((PlanState *) hashNode);
 
+#ifdef ADB
+				/*
+				 * The inner side is read to the end now, the outer side
+				 * reduces its rows the same way on every node.
+				 */
+				if (IsA(outerNode, ClusterReduceState) &&
+					IsA(outerPlanState(hashNode), ClusterReduceState))
+					ExecClusterReduceFollow((ClusterReduceState *) outerNode,
+											(ClusterReduceState *) outerPlanState(hashNode));
+#endif
+
 				/*
 				 * If the inner relation is completely empty, and we're not
 				 * doing a left outer join, we can quit without scanning the
@@ -177,6 +177,9 @@ static void eval_windowfunction(WindowAggState *winstate,
 
 static void begin_partition(WindowAggState *winstate);
 static void spool_tuples(WindowAggState *winstate, int64 pos);
+#ifdef ADB
+static void skip_partition(WindowAggState *winstate);
+#endif /* ADB */
 static void release_partition(WindowAggState *winstate);
 
 static bool row_is_in_frame(WindowAggState *winstate, int64 pos,
@@ -1227,6 +1230,68 @@ spool_tuples(WindowAggState *winstate, int64 pos)
 	MemoryContextSwitchTo(oldcontext);
 }
 
+#ifdef ADB
+/*
+ * Skip the rest of the current partition: read tuples from the outer node
+ * up to the first one of the next partition without storing them, and
+ * make the next call move on to that partition.
+ */
+static void
+skip_partition(WindowAggState *winstate)
+{
+	WindowAgg  *node = (WindowAgg *) winstate->ss.ps.plan;
+	PlanState  *outerPlan;
+	TupleTableSlot *outerslot;
+	MemoryContext oldcontext;
+	int64		skipped;
+
+	/* rows already in the tuplestore after the current one */
+	skipped = winstate->spooled_rows - winstate->currentpos;
+	winstate->currentpos = winstate->spooled_rows - 1;
+
+	if (winstate->partition_spooled)
+	{
+		InstrCountFiltered1(winstate, skipped);
+		return;
+	}
+
+	outerPlan = outerPlanState(winstate);
+
+	/* Must be in query context to call outerplan */
+	oldcontext = MemoryContextSwitchTo(winstate->ss.ps.ps_ExprContext->ecxt_per_query_memory);
+
+	for (;;)
+	{
+		outerslot = ExecProcNode(outerPlan);
+		if (TupIsNull(outerslot))
+		{
+			/* reached the end of the last partition */
+			winstate->more_partitions = false;
+			break;
+		}
+
+		if (node->partNumCols > 0 &&
+			!execTuplesMatch(winstate->first_part_slot,
+							 outerslot,
+							 node->partNumCols, node->partColIdx,
+							 winstate->partEqfunctions,
+							 winstate->tmpcontext->ecxt_per_tuple_memory))
+		{
+			/* end of partition; copy the tuple for the next cycle */
+			ExecCopySlot(winstate->first_part_slot, outerslot);
+			winstate->more_partitions = true;
+			break;
+		}
+
+		++skipped;
+	}
+	winstate->partition_spooled = true;
+
+	MemoryContextSwitchTo(oldcontext);
+	InstrCountFiltered1(winstate, skipped);
+}
+#endif /* ADB */
+
 /*
  * release_partition
  * clear information kept within a partition, including
@@ -1776,6 +1841,14 @@ restart:
 	 * evaluated with respect to that row.
 	 */
 	econtext->ecxt_outertuple = winstate->ss.ss_ScanTupleSlot;
+#ifdef ADB
+	if (winstate->ss.ps.qual &&
+		!ExecQual(winstate->ss.ps.qual, econtext, false))
+	{
+		skip_partition(winstate);
+		goto restart;
+	}
+#endif /* ADB */
 	result = ExecProject(winstate->ss.ps.ps_ProjInfo, &isDone);
 
 	if (isDone == ExprEndResult)
@@ -1862,12 +1935,22 @@ ExecInitWindowAgg(WindowAgg *node, EState *estate, int eflags)
 		ExecInitExpr((Expr *) node->plan.targetlist,
 					 (PlanState *) winstate);
 
+#ifdef ADB
+	/*
+	 * Only a top-k pre-filter of a cluster plan has quals.  Once they fail
+	 * they fail for the rest of the partition, see create_window_topk_path.
+	 */
+	winstate->ss.ps.qual = (List *)
+		ExecInitExpr((Expr *) node->plan.qual,
+					 (PlanState *) winstate);
+#else
 	/*
 	 * WindowAgg nodes never have quals, since they can only occur at the
 	 * logical top level of a query (ie, after any WHERE or HAVING filters)
 	 */
 	Assert(node->plan.qual == NIL);
 	winstate->ss.ps.qual = NIL;
+#endif /* ADB */
 
 	/*
 	 * initialize child nodes
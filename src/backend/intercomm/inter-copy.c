@@ -37,12 +37,27 @@ typedef struct RemoteCopyContext
 	TupleTableSlot	   *slot;
 } RemoteCopyContext;
 
+/*
+ * COPY TO STDOUT/FILE forwards the datanode CopyData as is, coalescing
+ * it up to this size before writing to the destination.
+ */
+#define COPY_OUT_CHUNK_SIZE		(64 * 1024)
+
+typedef struct CopyOutForwardContext
+{
+	RemoteCopyState	   *node;
+	StringInfoData		chunk;
+} CopyOutForwardContext;
+
 static NodeHandle*LookupNodeHandle(List *handle_list, Oid node_id);
 static void HandleCopyOutRow(RemoteCopyState *node, char *buf, int len);
 static int HandleStartRemoteCopy(NodeHandle *handle, CommandId cmid, Snapshot snap, const char *copy_query);
 static bool HandleRecvCopyResult(NodeHandle *handle);
 static void FetchRemoteCopyRow(RemoteCopyState *node, StringInfo row);
 static bool FetchCopyRowHook(void *context, struct pg_conn *conn, PQNHookFuncType type, ...);
+static uint64 ForwardRemoteCopyOut(RemoteCopyState *node);
+static bool ForwardCopyOutHook(void *context, struct pg_conn *conn, PQNHookFuncType type, ...);
+static void HandleCopyOutResult(struct pg_conn *conn, PGresult *res);
 
 /*
  * StartRemoteCopy
@@ -140,17 +155,33 @@ EndRemoteCopy(RemoteCopyState *node)
 						 errdetail("%s", HandleGetError(prhandle, false))));
 		}
 
+		/*
+		 * End COPY on all the other nodes before waiting for any of them,
+		 * so that whatever they do at the end of COPY (e.g. build the
+		 * indexes of a bulk load) runs in parallel.
+		 */
 		foreach (lc_handle, node->copy_handles)
 		{
 			handle = (NodeHandle *) lfirst(lc_handle);
 			/* Primary handle has been copy end already, see above */
 			if (prhandle && handle == prhandle)
 				continue;
-			if (PQputCopyEnd(handle->node_conn, NULL) <= 0 ||
-				!HandleFinishCommand(handle, NULL))
+			if (PQputCopyEnd(handle->node_conn, NULL) <= 0)
 				ereport(ERROR,
 						(errmsg("Fail to end COPY %s", node->is_from ? "FROM" : "TO"),
-						 errnode(NameStr(prhandle->node_name)),
+						 errnode(NameStr(handle->node_name)),
+						 errdetail("%s", HandleGetError(handle, false))));
+		}
+
+		foreach (lc_handle, node->copy_handles)
+		{
+			handle = (NodeHandle *) lfirst(lc_handle);
+			if (prhandle && handle == prhandle)
+				continue;
+			if (!HandleFinishCommand(handle, NULL))
+				ereport(ERROR,
+						(errmsg("Fail to end COPY %s", node->is_from ? "FROM" : "TO"),
+						 errnode(NameStr(handle->node_name)),
 						 errdetail("%s", HandleGetError(handle, false))));
 		}
 	} PG_CATCH();
@@ -254,6 +285,14 @@ DoRemoteCopyTo(RemoteCopyState *node)
 
 	Assert(node);
 
+	/*
+	 * Rows sent to the client or a file need no conversion, so do not
+	 * fetch them one by one.
+	 */
+	if (node->remoteCopyType == REMOTE_COPY_STDOUT ||
+		node->remoteCopyType == REMOTE_COPY_FILE)
+		return ForwardRemoteCopyOut(node);
+
 	node->processed = 0;
 	for (;;)
 	{
@@ -267,6 +306,83 @@ DoRemoteCopyTo(RemoteCopyState *node)
 	return node->processed;
 }
 
+/*
+ * ForwardRemoteCopyOut
+ *
+ * Read CopyData from all involved handles in one multiplexed loop and
+ * forward it as is to the destination, in chunks of COPY_OUT_CHUNK_SIZE.
+ *
+ * return the count of copy row
+ */
+static uint64
+ForwardRemoteCopyOut(RemoteCopyState *node)
+{
+	CopyOutForwardContext context;
+
+	Assert(node);
+	context.node = node;
+	initStringInfo(&context.chunk);
+	enlargeStringInfo(&context.chunk, COPY_OUT_CHUNK_SIZE);
+
+	node->processed = 0;
+	PQNListExecFinish(node->copy_handles, HandleGetPGconn,
+					  ForwardCopyOutHook, &context, true);
+
+	if (context.chunk.len > 0)
+		HandleCopyOutRow(node, context.chunk.data, context.chunk.len);
+	pfree(context.chunk.data);
+
+	return node->processed;
+}
+
+static bool
+ForwardCopyOutHook(void *context, struct pg_conn *conn, PQNHookFuncType type, ...)
+{
+	va_list args;
+
+	switch(type)
+	{
+		case PQNHFT_ERROR:
+			return PQNEFHNormal(NULL, conn, type);
+		case PQNHFT_COPY_OUT_DATA:
+			{
+				CopyOutForwardContext *forward = (CopyOutForwardContext *) context;
+				const char	   *buf;
+				int				len;
+
+				va_start(args, type);
+				buf = va_arg(args, const char*);
+				len = va_arg(args, int);
+				va_end(args);
+
+				/* each CopyData message of datanode is one row */
+				appendBinaryStringInfo(&forward->chunk, buf, len);
+				forward->node->processed++;
+				if (forward->chunk.len >= COPY_OUT_CHUNK_SIZE)
+				{
+					HandleCopyOutRow(forward->node,
+									 forward->chunk.data,
+									 forward->chunk.len);
+					resetStringInfo(&forward->chunk);
+				}
+			}
+			break;
+		case PQNHFT_COPY_IN_ONLY:
+			PQputCopyEnd(conn, NULL);
+			break;
+		case PQNHFT_RESULT:
+			va_start(args, type);
+			HandleCopyOutResult(conn, va_arg(args, PGresult*));
+			va_end(args);
+			break;
+		default:
+			break;
+	}
+
+	/* keep going until all handles finish */
+	return false;
+}
+
 /*
  * HandleCopyOutRow
  *
@@ -444,22 +560,9 @@ FetchCopyRowHook(void *context, struct pg_conn *conn, PQNHookFuncType type, ...)
 			PQputCopyEnd(conn, NULL);
 			break;
 		case PQNHFT_RESULT:
-			{
-				PGresult	   *res;
-				ExecStatusType	status;
-
-				va_start(args, type);
-				res = va_arg(args, PGresult*);
-				if(res)
-				{
-					status = PQresultStatus(res);
-					if(status == PGRES_FATAL_ERROR)
-						PQNReportResultError(res, conn, ERROR, true);
-					else if(status == PGRES_COPY_IN)
-						PQputCopyEnd(conn, NULL);
-				}
-				va_end(args);
-			}
+			va_start(args, type);
+			HandleCopyOutResult(conn, va_arg(args, PGresult*));
+			va_end(args);
 			break;
 		default:
 			break;
@@ -468,6 +571,21 @@ FetchCopyRowHook(void *context, struct pg_conn *conn, PQNHookFuncType type, ...)
 	return false;
 }
 
+static void
+HandleCopyOutResult(struct pg_conn *conn, PGresult *res)
+{
+	ExecStatusType	status;
+
+	if(res)
+	{
+		status = PQresultStatus(res);
+		if(status == PGRES_FATAL_ERROR)
+			PQNReportResultError(res, conn, ERROR, true);
+		else if(status == PGRES_COPY_IN)
+			PQputCopyEnd(conn, NULL);
+	}
+}
+
 /*
  * LookupNodeHandle
  *
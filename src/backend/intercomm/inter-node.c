@@ -98,8 +98,14 @@ InitNodeExecutor(bool force)
 	if (handle_init)
 		return ;
 
-	/* Update node table in the shared memory */
-	PgxcNodeListAndCount();
+	/*
+	 * Update node table in the shared memory, a forced reinitialization
+	 * always rereads the catalog.
+	 */
+	if (force)
+		PgxcNodeListAndCount();
+	else
+		PgxcNodeListAndCountIfInvalid();
 
 	all_node_def = PgxcNodeGetAllDefinition(&numCN, &numDN);
 	numALL = numCN + numDN;
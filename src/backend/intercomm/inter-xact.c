@@ -52,6 +52,7 @@ static InterXactStateData TopInterXactStateData = {
 };
 
 static void ResetInterXactState(InterXactState state);
+static void InterXactReportNodes(NodeMixHandle *mix_handle);
 static void InterXactTwoPhase(const char *gid, Oid *nodes, int nnodes, TwoPhaseState tp_state, bool missing_ok);
 static void InterXactTwoPhaseInternal(List *handle_list, char *command, const char *command_tag, bool ignore_error);
 
@@ -206,6 +207,8 @@ MakeInterXactState(MemoryContext context, const List *node_list)
 		 * generate a new "all_handle"
 		 */
 		state->all_handle = ConcatMixHandle(state->all_handle, cur_handle);
+
+		InterXactReportNodes(cur_handle);
 	}
 
 	(void) MemoryContextSwitchTo(old_context);
@@ -277,11 +280,38 @@ MakeInterXactState2(InterXactState state, const List *node_list)
 	 */
 	state->all_handle = ConcatMixHandle(state->all_handle, cur_handle);
 
+	InterXactReportNodes(cur_handle);
+
 	(void) MemoryContextSwitchTo(old_context);
 
 	return state;
 }
 
+/*
+ * InterXactReportNodes
+ *
+ * let AGTM know the nodes of "mix_handle" take part in the current
+ * transaction, before any of them starts it
+ */
+static void
+InterXactReportNodes(NodeMixHandle *mix_handle)
+{
+	NodeHandle	   *handle;
+	ListCell	   *lc_handle;
+	uint64			nodes = 0;
+
+	if (!IsCoordMaster() || !mix_handle)
+		return ;
+
+	foreach (lc_handle, mix_handle->handles)
+	{
+		handle = (NodeHandle *) lfirst(lc_handle);
+		nodes |= agtm_NodeBit(NameStr(handle->node_name));
+	}
+
+	agtm_AddXactNodes(nodes);
+}
+
 /*
  * ExecInterXactUtility
  *
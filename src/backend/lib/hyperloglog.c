@@ -178,6 +178,26 @@ addHyperLogLog(hyperLogLogState *cState, uint32 hash)
 	cState->hashesArr[index] = Max(count, cState->hashesArr[index]);
 }
 
+#ifdef ADB
+/*
+ * Merges the registers of another estimator into cState.
+ *
+ * Both states must have been initialized with the same register width.  The
+ * result estimates the cardinality of the union of both input sets.
+ */
+void
+mergeHyperLogLog(hyperLogLogState *cState, const hyperLogLogState *oState)
+{
+	Size		i;
+
+	if (cState->registerWidth != oState->registerWidth)
+		elog(ERROR, "cannot merge HyperLogLog states of different bit width");
+
+	for (i = 0; i < cState->nRegisters; i++)
+		cState->hashesArr[i] = Max(cState->hashesArr[i], oState->hashesArr[i]);
+}
+#endif /* ADB */
+
 /*
  * Estimates cardinality, based on elements added so far
  */
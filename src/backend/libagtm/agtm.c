@@ -1,5 +1,6 @@
 #include "postgres.h"
 
+#include "access/hash.h"
 #include "access/htup_details.h"
 #include "access/subtrans.h"
 #include "access/transam.h"
@@ -19,8 +20,10 @@
 #include "pgxc/nodemgr.h"
 #include "pgxc/pgxc.h"
 #include "pgxc/pgxcnode.h"
+#include "postmaster/autovacuum.h"
 #include "storage/procarray.h"
 #include "utils/builtins.h"
+#include "utils/hlc.h"
 #include "utils/lsyscache.h"
 #include "utils/snapmgr.h"
 
@@ -36,17 +39,34 @@ static PGresult_data *saved_curBlock = NULL;
 static int saved_curOffset = 0;
 static int saved_spaceLeft = 0;
 
+/* nodes involved in the current transaction, and those AGTM knows about */
+static uint64 xact_nodes = 0;
+static uint64 agtm_xact_nodes = 0;
+
 TransactionId
 agtm_GetGlobalTransactionId(bool isSubXact)
 {
 	PGresult 		*res;
 	StringInfoData	buf;
 	GlobalTransactionId gxid;
+	uint64			nodes;
 
 	if(!IsUnderAGTM())
 		return InvalidGlobalTransactionId;
 
-	agtm_send_message(AGTM_MSG_GET_GXID, "%c", isSubXact);
+	/*
+	 * Tell AGTM which nodes the new transaction involves, so that it holds
+	 * back only their cleanup horizons.  A datanode transaction involves
+	 * just that datanode.
+	 */
+	if (IsCoordMaster())
+		nodes = agtm_xact_nodes = xact_nodes;
+	else if (IS_PGXC_DATANODE)
+		nodes = agtm_NodeBit(PGXCNodeName);
+	else
+		nodes = AGTM_ALL_NODES;
+
+	agtm_send_message(AGTM_MSG_GET_GXID, "%c %p%d", isSubXact, &nodes, (int)sizeof(nodes));
 	res = agtm_get_result(AGTM_MSG_GET_GXID);
 	Assert(res);
 	agtm_use_result_type(res, &buf, AGTM_GET_GXID_RESULT);
@@ -290,29 +310,16 @@ agtm_RenameSeuqneceByDataBase(const char * oldDatabase,
 				oldDatabase , newDatabase)));
 }
 
+/*
+ * The hybrid logical clock of this node is already past every timestamp
+ * AGTM handed to it, and AGTM learns it with each snapshot request, so a
+ * timestamp consistent with the rest of the cluster does not need a round
+ * trip to AGTM.
+ */
 Timestamp
 agtm_GetTimestamptz(void)
 {
-	PGresult		*res;
-	StringInfoData	buf;
-	Timestamp		timestamp;
-
-	if(!IsUnderAGTM())
-		ereport(ERROR,
-			(errmsg("agtm_GetTimestamptz function must under AGTM")));
-
-	agtm_send_message(AGTM_MSG_GET_TIMESTAMP, " ");
-	res = agtm_get_result(AGTM_MSG_GET_TIMESTAMP);
-	Assert(res);
-	agtm_use_result_type(res, &buf, AGTM_GET_TIMESTAMP_RESULT);
-	pq_copymsgbytes(&buf, (char*)&timestamp, sizeof(timestamp));
-
-	ereport(DEBUG1,
-		(errmsg("get timestamp: %ld from agtm", timestamp)));
-
-	agtm_use_result_end(&buf);
-	agtm_clear_result(res);
-	return timestamp;
+	return HlcNow();
 }
 
 Snapshot
@@ -323,6 +330,9 @@ agtm_GetGlobalSnapShot(Snapshot snapshot)
 	StringInfoData	buf;
 	uint32 xcnt;
 	TimestampTz	globalXactStartTimestamp;
+	TimestampTz	clock;
+	uint64		nodes = 0;
+	uint64		report_nodes = 0;
 
 	AssertArg(snapshot && snapshot->xip && snapshot->subxip);
 
@@ -330,7 +340,26 @@ agtm_GetGlobalSnapShot(Snapshot snapshot)
 		ereport(ERROR,
 			(errmsg("agtm_GetGlobalSnapShot function must under AGTM")));
 
-	agtm_send_message(AGTM_MSG_SNAPSHOT_GET, " ");
+	/*
+	 * Autovacuum on a datanode asks for the cleanup horizon of its own node
+	 * instead of the cluster-wide one, if node_cleanup_horizon allows.
+	 */
+	if (node_cleanup_horizon && IS_PGXC_DATANODE && IsAnyAutoVacuumProcess())
+		nodes = agtm_NodeBit(PGXCNodeName);
+
+	/*
+	 * The nodes of the current transaction go along, a read-only one never
+	 * asks for a GXID and may not have begun at AGTM.
+	 */
+	if (IsCoordMaster())
+		report_nodes = agtm_xact_nodes = xact_nodes;
+
+	/* send our clock along, AGTM keeps its own past it */
+	clock = HlcNow();
+	agtm_send_message(AGTM_MSG_SNAPSHOT_GET, "%p%d%p%d%p%d",
+					  &nodes, (int)sizeof(nodes),
+					  &report_nodes, (int)sizeof(report_nodes),
+					  &clock, (int)sizeof(clock));
 	res = agtm_get_result(AGTM_MSG_SNAPSHOT_GET);
 	Assert(res);
 	agtm_use_result_type(res, &buf, AGTM_SNAPSHOT_GET_RESULT);
@@ -362,11 +391,86 @@ agtm_GetGlobalSnapShot(Snapshot snapshot)
 	agtm_use_result_end(&buf);
 	agtm_clear_result(res);
 
+	if (nodes != 0)
+		ProcArrayAdvanceNodeXmin(RecentGlobalXmin);
+
 	if (GetCurrentCommandId(false) > snapshot->curcid)
 		snapshot->curcid = GetCurrentCommandId(false);
 	return snapshot;
 }
 
+/*
+ * agtm_NodeBit
+ *
+ * bit of the node in the masks sent to AGTM
+ */
+uint64
+agtm_NodeBit(const char *node_name)
+{
+	AssertArg(node_name);
+
+	return UINT64CONST(1) <<
+		(hash_any((const unsigned char *) node_name, strlen(node_name)) % 64);
+}
+
+/*
+ * agtm_AddXactNodes
+ *
+ * Remember that the current transaction involves "nodes".  Callers do this
+ * before starting the transaction on them.  A set that grows after the
+ * transaction began at AGTM is sent right away, before that it goes along
+ * with the next GXID or snapshot request.  AGTM only ever adds to the set
+ * it knows, see ProcessSetXactNodes.
+ */
+void
+agtm_AddXactNodes(uint64 nodes)
+{
+	PGresult		*res;
+	StringInfoData	buf;
+
+	xact_nodes |= nodes;
+	if (xact_nodes == agtm_xact_nodes || !TopXactBeginAGTM())
+		return ;
+
+	agtm_xact_nodes = xact_nodes;
+	agtm_send_message(AGTM_MSG_SET_XACT_NODES, "%p%d", &xact_nodes, (int)sizeof(xact_nodes));
+	res = agtm_get_result(AGTM_MSG_SET_XACT_NODES);
+	Assert(res);
+	agtm_use_result_type(res, &buf, AGTM_SET_XACT_NODES_RESULT);
+	agtm_use_result_end(&buf);
+	agtm_clear_result(res);
+}
+
+void
+agtm_ResetXactNodes(void)
+{
+	xact_nodes = agtm_xact_nodes = 0;
+}
+
+/*
+ * adb_xact_nodes
+ *
+ * mask of nodes of the current transaction sent to AGTM so far
+ */
+Datum
+adb_xact_nodes(PG_FUNCTION_ARGS)
+{
+	PG_RETURN_INT64((int64) agtm_xact_nodes);
+}
+
+/*
+ * adb_node_bit
+ *
+ * bit of the node in that mask
+ */
+Datum
+adb_node_bit(PG_FUNCTION_ARGS)
+{
+	Name		node_name = PG_GETARG_NAME(0);
+
+	PG_RETURN_INT64((int64) agtm_NodeBit(NameStr(*node_name)));
+}
+
 XidStatus
 agtm_TransactionIdGetStatus(TransactionId xid, XLogRecPtr *lsn)
 {
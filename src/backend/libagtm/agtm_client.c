@@ -20,6 +20,7 @@
 /* Configuration variables */
 extern char				*AGtmHost;
 extern int 				AGtmPort;
+int						agtm_idle_release_timeout = 0;
 
 #define AGTM_PORT		"agtm_port"
 #define InvalidAGtmPort	0
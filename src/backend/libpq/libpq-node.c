@@ -28,6 +28,10 @@ typedef struct OidPGconn
 }OidPGconn;
 
 static HTAB *htab_oid_pgconn = NULL;
+/* pooler generation when htab_oid_pgconn got created */
+static uint32 pgconn_pool_generation = 0;
+/* DISCARD ALL or RESET ALL ran, kept PGconns must not outlive it */
+static bool pgconn_close_requested = false;
 
 static void init_htab_oid_pgconn(void);
 static List* apply_for_node_use_oid(List *oid_list);
@@ -73,6 +77,7 @@ static void init_htab_oid_pgconn(void)
 		size <<= 1;	/* size = size*2 */
 	htab_oid_pgconn = hash_create("hash oid to PGconn", size, &hctl
 				, HASH_ELEM | HASH_CONTEXT | HASH_FUNCTION);
+	pgconn_pool_generation = PoolManagerGetGeneration();
 /*	pg_atexit*/
 }
 
@@ -595,6 +600,9 @@ void PQNReleaseAllConnect(void)
 {
 	HASH_SEQ_STATUS seq_status;
 	OidPGconn *op;
+	bool force_close = pgconn_close_requested;
+
+	pgconn_close_requested = false;
 	if(htab_oid_pgconn == NULL || hash_get_num_entries(htab_oid_pgconn) == 0)
 		return;
 
@@ -607,7 +615,50 @@ void PQNReleaseAllConnect(void)
 	}
 	hash_destroy(htab_oid_pgconn);
 	htab_oid_pgconn = NULL;
-	PoolManagerReleaseConnections(false);
+	PoolManagerReleaseConnections(force_close);
+}
+
+/*
+ * The session state was reset, so the remote sessions kept by a
+ * persistent session may carry settings the session no longer has.
+ * Make the next transaction boundary close them instead of keeping them
+ * or giving them back to the pooler.
+ */
+void PQNRequestCloseAllConnect(void)
+{
+	if(PersistentConnections && htab_oid_pgconn != NULL)
+		pgconn_close_requested = true;
+}
+
+/*
+ * Can the session keep its PGconns for the next transaction instead of
+ * giving them back to the pooler? Only if all of them are idle out of
+ * a transaction, the pooler was not reloaded or cleaned since we got
+ * them, and the session state was not reset since.
+ */
+bool PQNCanKeepAllConnect(void)
+{
+	HASH_SEQ_STATUS seq_status;
+	OidPGconn *op;
+	if(htab_oid_pgconn == NULL || hash_get_num_entries(htab_oid_pgconn) == 0)
+		return true;
+
+	if(pgconn_close_requested
+		|| pgconn_pool_generation != PoolManagerGetGeneration())
+		return false;
+
+	hash_seq_init(&seq_status, htab_oid_pgconn);
+	while((op = hash_seq_search(&seq_status)) != NULL)
+	{
+		if(op->conn == NULL
+			|| PQstatus(op->conn) != CONNECTION_OK
+			|| PQtransactionStatus(op->conn) != PQTRANS_IDLE)
+		{
+			hash_seq_term(&seq_status);
+			return false;
+		}
+	}
+	return true;
 }
 
 void PQNReportResultError(struct pg_result *result, struct pg_conn *conn, int elevel, bool free_result)
@@ -104,6 +104,10 @@ _copyPlannedStmt(const PlannedStmt *from)
 	COPY_NODE_FIELD(relationOids);
 	COPY_NODE_FIELD(invalItems);
 	COPY_SCALAR_FIELD(nParamExec);
+#ifdef ADB
+	COPY_NODE_FIELD(nodeRangeRelids);
+	COPY_NODE_FIELD(nodeRangeStamps);
+#endif /* ADB */
 
 	return newnode;
 }
@@ -4656,6 +4660,7 @@ _copyExecNodes(const ExecNodes *from)
 	COPY_NODE_FIELD(en_dist_vars);
 	COPY_NODE_FIELD(nodeList);
 	COPY_NODE_FIELD(nodeids);
+	COPY_SCALAR_FIELD(en_colocation);
 
 	return newnode;
 }
@@ -4723,6 +4728,9 @@ _copyClusterReduce(const ClusterReduce *from)
 	COPY_NODE_FIELD(special_reduce);
 	COPY_NODE_FIELD(reduce_oids);
 	COPY_SCALAR_FIELD(special_node);
+	COPY_NODE_FIELD(adaptive_reduce);
+	COPY_SCALAR_FIELD(adaptive_rows);
+	COPY_SCALAR_FIELD(adaptive_follow);
 
 	COPY_SCALAR_FIELD(numCols);
 	COPY_POINTER_FIELD(sortColIdx, from->numCols * sizeof(AttrNumber));
@@ -22,12 +22,14 @@
 #include "nodes/nodeFuncs.h"
 #include "utils/lsyscache.h"
 #ifdef ADB
+#include "access/hash.h"
 #include "executor/executor.h"
 #include "nodes/execnodes.h"
 #include "parser/parser.h"
 #include "parser/parse_coerce.h"
 #include "parser/parse_oper.h"
 #include "utils/builtins.h"
+#include "utils/fmgroids.h"
 #include "utils/typcache.h"
 #endif /* ADB */
 
@@ -684,6 +686,45 @@ int32 execHashValue(Datum datum, Oid typid, Oid collid)
 	return DatumGetInt32(result);
 }
 
+/*
+ * adb_hash_combine(...adb_hash_combine(hash(expr1), hash(expr2))..., hash(exprN)),
+ * the hash of a multi-column distribution key
+ */
+Expr *makeHashExprList(List *exprs)
+{
+	ListCell *lc;
+	Expr *result;
+	AssertArg(exprs != NIL);
+
+	result = makeHashExpr(linitial(exprs));
+	for_each_cell(lc, lnext(list_head(exprs)))
+	{
+		result = (Expr*)makeFuncExpr(F_ADB_HASH_COMBINE,
+									 INT4OID,
+									 list_make2(result, makeHashExpr(lfirst(lc))),
+									 InvalidOid, InvalidOid,
+									 COERCE_EXPLICIT_CALL);
+	}
+	return result;
+}
+
+/* same as makeHashExprList, values must not be null */
+int32 execHashValues(int nelems, const Datum *datums, const Oid *typids)
+{
+	int32 result;
+	int i;
+	AssertArg(nelems > 0);
+
+	result = execHashValue(datums[0], typids[0], InvalidOid);
+	for(i=1;i<nelems;++i)
+	{
+		result = DatumGetInt32(DirectFunctionCall2(adb_hash_combine,
+												   Int32GetDatum(result),
+												   Int32GetDatum(execHashValue(datums[i], typids[i], InvalidOid))));
+	}
+	return result;
+}
+
 /* (expr % right) */
 Expr *makeModuloExpr(Expr *expr, int right)
 {
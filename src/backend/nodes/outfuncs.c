@@ -275,6 +275,10 @@ _outPlannedStmt(StringInfo str, const PlannedStmt *node)
 	WRITE_NODE_FIELD(relationOids);
 	WRITE_NODE_FIELD(invalItems);
 	WRITE_INT_FIELD(nParamExec);
+#ifdef ADB
+	WRITE_NODE_FIELD(nodeRangeRelids);
+	WRITE_NODE_FIELD(nodeRangeStamps);
+#endif /* ADB */
 }
 
 /*
@@ -587,6 +591,7 @@ _outExecNodes(StringInfo str, const ExecNodes *node)
 	WRITE_NODE_FIELD(en_dist_vars);
 	WRITE_NODE_FIELD(nodeList);
 	WRITE_NODE_FIELD(nodeids);
+	WRITE_OID_FIELD(en_colocation);
 }
 
 static void
@@ -601,6 +606,9 @@ _outClusterReduce(StringInfo str, const ClusterReduce *node)
 	WRITE_NODE_FIELD(special_reduce);
 	WRITE_NODE_FIELD(reduce_oids);
 	WRITE_OID_FIELD(special_node);
+	WRITE_NODE_FIELD(adaptive_reduce);
+	WRITE_INT_FIELD(adaptive_rows);
+	WRITE_BOOL_FIELD(adaptive_follow);
 
 	WRITE_INT_FIELD(numCols);
 	appendStringInfoString(str, " :sortColIdx");
@@ -2033,6 +2041,9 @@ _outWindowAggPath(StringInfo str, const WindowAggPath *node)
 	WRITE_NODE_FIELD(subpath);
 	WRITE_NODE_FIELD(winclause);
 	WRITE_NODE_FIELD(winpathkeys);
+#ifdef ADB
+	WRITE_NODE_FIELD(qual);
+#endif /* ADB */
 }
 
 static void
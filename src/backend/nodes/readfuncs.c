@@ -1419,6 +1419,10 @@ _readPlannedStmt(void)
 	READ_NODE_FIELD(relationOids);
 	READ_NODE_FIELD(invalItems);
 	READ_INT_FIELD(nParamExec);
+#ifdef ADB
+	READ_NODE_FIELD(nodeRangeRelids);
+	READ_NODE_FIELD(nodeRangeStamps);
+#endif /* ADB */
 
 	READ_DONE();
 }
@@ -2296,6 +2300,9 @@ _readClusterReduce(void)
 	READ_NODE_FIELD(special_reduce);
 	READ_NODE_FIELD(reduce_oids);
 	READ_OID_FIELD(special_node);
+	READ_NODE_FIELD(adaptive_reduce);
+	READ_INT_FIELD(adaptive_rows);
+	READ_BOOL_FIELD(adaptive_follow);
 
 	READ_INT_FIELD(numCols);
 	READ_ATTRNUMBER_ARRAY(sortColIdx, local_node->numCols);
@@ -5,6 +5,7 @@
 #include "postgres.h"
 #include "libpq/pqformat.h"
 
+#include "access/hash.h"
 #include "access/htup_details.h"
 #include "access/transam.h"
 #include "access/tuptypeconvert.h"
@@ -25,7 +26,10 @@
 #include "parser/parse_func.h"
 #include "parser/parse_type.h"
 #include "utils/builtins.h"
+#include "utils/hsearch.h"
+#include "utils/inval.h"
 #include "utils/lsyscache.h"
+#include "utils/memutils.h"
 #include "utils/syscache.h"
 #include "nodes/extensible.h"
 #include "nodes/replnodes.h"
@@ -37,6 +41,56 @@
 
 #define IS_OID_BUILTIN(oid_) (oid_ < FirstBootstrapObjectId)
 
+/*
+ * Types, functions, operators and relations which are not builtin are
+ * saved by name, and loading one by name costs a handful of syscache
+ * lookups (namespace, argument and result types, the object itself).
+ * The names are preceded by their length, so that a backend which has
+ * loaded the same bytes before finds the OID in load_oid_cache and skips
+ * them.  The cache is emptied whenever pg_type, pg_proc, pg_operator,
+ * pg_class or pg_namespace change, which covers creating, dropping and
+ * renaming any of the objects it maps or their schemas; collations are
+ * rare and always looked up.
+ */
+#define LOAD_OID_KIND_TYPE		't'
+#define LOAD_OID_KIND_PROC		'p'
+#define LOAD_OID_KIND_OPERATOR	'o'
+#define LOAD_OID_KIND_CLASS		'r'
+
+#define LOAD_OID_CACHE_MAX		8192
+
+typedef struct LoadOidKey
+{
+	uint32	hash;		/* hash_any() of the names */
+	int32	len;
+	char	kind;		/* LOAD_OID_KIND_XXX */
+}LoadOidKey;
+
+/* where the names of a reference being loaded start */
+typedef struct LoadOidRef
+{
+	int		start;
+	uint32	generation;	/* load_oid_cache_generation when started */
+}LoadOidRef;
+
+typedef struct LoadOidEntry
+{
+	LoadOidKey	key;
+	Oid			oid;
+	char	   *names;
+}LoadOidEntry;
+
+static HTAB *load_oid_cache = NULL;
+static MemoryContext load_oid_cache_context = NULL;
+static bool load_oid_cache_valid = false;
+static uint32 load_oid_cache_generation = 0;
+
+static int begin_save_oid_names(StringInfo buf);
+static void end_save_oid_names(StringInfo buf, int offset);
+static bool load_oid_cached(StringInfo buf, char kind, LoadOidRef *ref, Oid *oid);
+static void remember_load_oid(StringInfo buf, char kind, LoadOidRef *ref, Oid oid);
+static void invalidate_load_oid_cache(Datum arg, int cacheid, uint32 hashvalue);
+
 /* not support Node */
 #define NO_NODE_PlannerInfo
 #define NO_NODE_RelOptInfo
@@ -157,6 +211,23 @@ void save_node_string(StringInfo buf, const char *str)
 	appendBinaryStringInfo(buf, str, len+1);
 }
 
+/* reserve the length of names, see load_oid_cache */
+static int begin_save_oid_names(StringInfo buf)
+{
+	int offset = buf->len;
+	int32 len = 0;
+
+	appendBinaryStringInfo(buf, (char*)&len, sizeof(len));
+	return offset;
+}
+
+static void end_save_oid_names(StringInfo buf, int offset)
+{
+	int32 len = buf->len - offset - sizeof(len);
+
+	memcpy(buf->data + offset, &len, sizeof(len));
+}
+
 void save_node_bitmapset(StringInfo buf, const Bitmapset *node)
 {
 	if(node == NULL)
@@ -202,6 +273,7 @@ void save_oid_type(StringInfo buf, Oid typid)
 {
 	Type type;
 	Form_pg_type typ;
+	int offset;
 
 	if(!OidIsValid(typid))
 	{
@@ -210,6 +282,15 @@ void save_oid_type(StringInfo buf, Oid typid)
 	}
 	SAVE_IS_NOT_NULL();
 
+	if(IS_OID_BUILTIN(typid))
+	{
+		SAVE_BOOL(true);
+		pq_sendbytes(buf, (char*)&typid, sizeof(typid));
+		return;
+	}
+	SAVE_BOOL(false);
+	offset = begin_save_oid_names(buf);
+
 	/* get pg_type cache */
 	type = typeidType(typid);
 	Assert(HeapTupleIsValid(type));
@@ -219,6 +300,7 @@ void save_oid_type(StringInfo buf, Oid typid)
 	save_namespace(buf, typ->typnamespace);
 	save_node_string(buf, NameStr(typ->typname));
 	ReleaseSysCache(type);
+	end_save_oid_names(buf, offset);
 }
 
 void save_oid_collation(StringInfo buf, Oid collation)
@@ -255,6 +337,7 @@ void save_oid_proc(StringInfo buf, Oid proc)
 	Form_pg_proc procform;
 	oidvector  *oidArray;
 	int i,count;
+	int offset;
 
 	if(IS_OID_BUILTIN(proc))
 	{
@@ -263,6 +346,7 @@ void save_oid_proc(StringInfo buf, Oid proc)
 	}else
 	{
 		SAVE_BOOL(false);
+		offset = begin_save_oid_names(buf);
 		proctup = SearchSysCache1(PROCOID, ObjectIdGetDatum(proc));
 		if (!HeapTupleIsValid(proctup))
 			ereport(ERROR, (errmsg("cache lookup failed for function %u", proc)));
@@ -281,6 +365,7 @@ void save_oid_proc(StringInfo buf, Oid proc)
 		for(i=0;i<count;++i)
 			save_oid_type(buf, oidArray->values[i]);
 		ReleaseSysCache(proctup);
+		end_save_oid_names(buf, offset);
 	}
 }
 
@@ -288,12 +373,15 @@ void save_oid_operator(StringInfo buf, Oid op)
 {
 	HeapTuple opertup;
 	Form_pg_operator operform;
+	int offset;
 	if(IS_OID_BUILTIN(op))
 	{
 		SAVE_BOOL(true);
 		pq_sendbytes(buf, (char*)&op, sizeof(op));
 	}else
 	{
+		SAVE_BOOL(false);
+		offset = begin_save_oid_names(buf);
 		opertup = SearchSysCache1(OPEROID, ObjectIdGetDatum(op));
 		if (!HeapTupleIsValid(opertup))
 			elog(ERROR, "cache lookup failed for operator %u", op);
@@ -309,6 +397,7 @@ void save_oid_operator(StringInfo buf, Oid op)
 		save_oid_type(buf, operform->oprright);
 
 		ReleaseSysCache(opertup);
+		end_save_oid_names(buf, offset);
 	}
 }
 
@@ -316,12 +405,15 @@ void save_oid_class(StringInfo buf, Oid oid_rel)
 {
 	HeapTuple classtup;
 	Form_pg_class classform;
+	int offset;
 	if(IS_OID_BUILTIN(oid_rel))
 	{
 		SAVE_BOOL(true);
 		pq_sendbytes(buf, (char*)&oid_rel, sizeof(oid_rel));
 	}else
 	{
+		SAVE_BOOL(false);
+		offset = begin_save_oid_names(buf);
 		classtup = SearchSysCache1(RELOID, ObjectIdGetDatum(oid_rel));
 		if (!HeapTupleIsValid(classtup))
 			elog(ERROR, "could not open relation with OID %u", oid_rel);
@@ -329,6 +421,7 @@ void save_oid_class(StringInfo buf, Oid oid_rel)
 		save_namespace(buf, classform->relnamespace);
 		save_node_string(buf, NameStr(classform->relname));
 		ReleaseSysCache(classtup);
+		end_save_oid_names(buf, offset);
 	}
 }
 
@@ -633,10 +726,19 @@ Oid load_oid_type(StringInfo buf)
 	const char *str_type;
 	HeapTuple tup;
 	Oid typid,namespaceId;
+	LoadOidRef ref;
 
 	if(LOAD_IS_NULL())
 		return InvalidOid;
 
+	if(LOAD_BOOL())
+	{
+		pq_copymsgbytes(buf, (char*)&typid, sizeof(typid));
+		return typid;
+	}
+	if(load_oid_cached(buf, LOAD_OID_KIND_TYPE, &ref, &typid))
+		return typid;
+
 	namespaceId = load_namespace(buf);
 	if(!OidIsValid(namespaceId))
 		ereport(ERROR, (errmsg("Load an invalid namespace id")));
@@ -651,6 +753,7 @@ Oid load_oid_type(StringInfo buf)
 
 	typid = HeapTupleGetOid(tup);
 	ReleaseSysCache(tup);
+	remember_load_oid(buf, LOAD_OID_KIND_TYPE, &ref, typid);
 	return typid;
 }
 
@@ -704,6 +807,10 @@ Oid load_oid_proc(StringInfo buf)
 		const char *proc_name;
 		Oid *args;
 		HeapTuple tup;
+		LoadOidRef ref;
+
+		if(load_oid_cached(buf, LOAD_OID_KIND_PROC, &ref, &oid))
+			return oid;
 
 		nsp = load_namespace(buf);
 		proc_name = load_node_string(buf, false);
@@ -752,6 +859,7 @@ Oid load_oid_proc(StringInfo buf)
 		if(args)
 			pfree(args);
 		pfree(vector);
+		remember_load_oid(buf, LOAD_OID_KIND_PROC, &ref, oid);
 	}
 	return oid;
 }
@@ -772,6 +880,10 @@ Oid load_oid_operator(StringInfo buf)
 		Oid rettype;
 		Oid left;
 		Oid right;
+		LoadOidRef ref;
+
+		if(load_oid_cached(buf, LOAD_OID_KIND_OPERATOR, &ref, &oid))
+			return oid;
 
 		rettype = load_oid_type(buf);
 		nsp = load_namespace(buf);
@@ -803,30 +915,155 @@ Oid load_oid_operator(StringInfo buf)
 				,errhint("it result type %s", format_type_be(form_oper->oprresult))));
 		}
 		ReleaseSysCache(tup);
+		remember_load_oid(buf, LOAD_OID_KIND_OPERATOR, &ref, oid);
 	}
 
 	return oid;
 }
 
 Oid load_oid_class(StringInfo buf)
+{
+	return load_oid_class_extend(buf, false);
+}
+
+Oid load_oid_class_extend(struct StringInfoData *buf, bool missok)
 {
 	const char *relname;
 	Oid nsp;
 	Oid oid;
+	LoadOidRef ref;
 	if(LOAD_BOOL())
 	{
 		pq_copymsgbytes(buf, (char*)&oid, sizeof(oid));
 	}else
 	{
-		nsp = load_namespace(buf);
+		if(load_oid_cached(buf, LOAD_OID_KIND_CLASS, &ref, &oid))
+			return oid;
+
+		nsp = load_namespace_extend(buf, missok);
 		relname = load_node_string(buf, false);
-		oid = get_relname_relid(relname, nsp);
+		if(OidIsValid(nsp))
+			oid = get_relname_relid(relname, nsp);
+		else
+			oid = InvalidOid;
 		if (!OidIsValid(oid))
-			elog(ERROR, "relation \"%s\" not exists in schema %u", relname, nsp);
+		{
+			if(missok)
+				return InvalidOid;
+			ereport(ERROR,
+					(errcode(ERRCODE_UNDEFINED_OBJECT),
+					 errmsg("relation \"%s\" not exists", relname)));
+		}
+		remember_load_oid(buf, LOAD_OID_KIND_CLASS, &ref, oid);
 	}
 	return oid;
 }
 
+/*
+ * Read the length of the names of a reference.  If this backend has loaded
+ * the same names before, skip them and return the OID they loaded as.
+ */
+static bool load_oid_cached(StringInfo buf, char kind, LoadOidRef *ref, Oid *oid)
+{
+	LoadOidKey key;
+	LoadOidEntry *entry;
+	int32 len;
+
+	pq_copymsgbytes(buf, (char*)&len, sizeof(len));
+	if(len <= 0 || len > buf->len - buf->cursor)
+		ereport(ERROR,
+				(errcode(ERRCODE_PROTOCOL_VIOLATION),
+				 errmsg("invalid object reference in message")));
+	ref->start = buf->cursor;
+	ref->generation = load_oid_cache_generation;
+
+	if(load_oid_cache == NULL || !load_oid_cache_valid)
+		return false;
+
+	MemSet(&key, 0, sizeof(key));
+	key.hash = DatumGetUInt32(hash_any((unsigned char*)buf->data + ref->start, len));
+	key.len = len;
+	key.kind = kind;
+	entry = hash_search(load_oid_cache, &key, HASH_FIND, NULL);
+	if(entry == NULL ||
+	   memcmp(entry->names, buf->data + ref->start, len) != 0)
+		return false;
+
+	buf->cursor += len;
+	*oid = entry->oid;
+	return true;
+}
+
+/*
+ * Remember the OID the names from ref->start to the cursor loaded as,
+ * unless the catalogs changed while they were looked up
+ */
+static void remember_load_oid(StringInfo buf, char kind, LoadOidRef *ref, Oid oid)
+{
+	LoadOidKey key;
+	LoadOidEntry *entry;
+	int32 len = buf->cursor - ref->start;
+	bool found;
+
+	Assert(OidIsValid(oid) && len > 0);
+	if(ref->generation != load_oid_cache_generation)
+		return;
+
+	if(load_oid_cache_context == NULL)
+	{
+		load_oid_cache_context = AllocSetContextCreate(TopMemoryContext,
+													   "load oid cache",
+													   ALLOCSET_DEFAULT_SIZES);
+		CacheRegisterSyscacheCallback(TYPEOID, invalidate_load_oid_cache, (Datum) 0);
+		CacheRegisterSyscacheCallback(PROCOID, invalidate_load_oid_cache, (Datum) 0);
+		CacheRegisterSyscacheCallback(OPEROID, invalidate_load_oid_cache, (Datum) 0);
+		CacheRegisterSyscacheCallback(RELOID, invalidate_load_oid_cache, (Datum) 0);
+		CacheRegisterSyscacheCallback(NAMESPACEOID, invalidate_load_oid_cache, (Datum) 0);
+	}
+
+	if(load_oid_cache == NULL ||
+	   !load_oid_cache_valid ||
+	   hash_get_num_entries(load_oid_cache) >= LOAD_OID_CACHE_MAX)
+	{
+		HASHCTL ctl;
+
+		MemoryContextReset(load_oid_cache_context);
+		MemSet(&ctl, 0, sizeof(ctl));
+		ctl.keysize = sizeof(LoadOidKey);
+		ctl.entrysize = sizeof(LoadOidEntry);
+		ctl.hcxt = load_oid_cache_context;
+		load_oid_cache = hash_create("load oid cache",
+									 256,
+									 &ctl,
+									 HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
+		load_oid_cache_valid = true;
+	}
+
+	MemSet(&key, 0, sizeof(key));
+	key.hash = DatumGetUInt32(hash_any((unsigned char*)buf->data + ref->start, len));
+	key.len = len;
+	key.kind = kind;
+	entry = hash_search(load_oid_cache, &key, HASH_ENTER, &found);
+	if(!found)
+	{
+		entry->names = MemoryContextAlloc(load_oid_cache_context, len);
+	}else if(memcmp(entry->names, buf->data + ref->start, len) == 0)
+	{
+		entry->oid = oid;
+		return;
+	}
+	/* a hash collision replaces the older names, same length */
+	memcpy(entry->names, buf->data + ref->start, len);
+	entry->oid = oid;
+}
+
+static void invalidate_load_oid_cache(Datum arg, int cacheid, uint32 hashvalue)
+{
+	/* emptied by the next remember_load_oid(), nobody holds an entry now */
+	load_oid_cache_valid = false;
+	load_oid_cache_generation++;
+}
+
 static ParamExternData* load_ParamExternData(StringInfo buf, ParamExternData *node)
 {
 	AssertArg(node);
@@ -45,10 +45,14 @@
 #include "rewrite/rewriteManip.h"
 #include "utils/lsyscache.h"
 #ifdef ADB
+#include "access/stratnum.h"
+#include "catalog/pg_opfamily.h"
+#include "catalog/pg_type.h"
 #include "catalog/pgxc_node.h"
 #include "optimizer/planmain.h"
 #include "optimizer/reduceinfo.h"
 #include "pgxc/pgxcnode.h"
+#include "utils/fmgroids.h"
 #endif /* ADB */
 
 /* results of subquery_is_pushdown_safe */
@@ -136,6 +140,8 @@ static void recurse_push_qual(Node *setOp, Query *topquery,
 static void remove_unused_subquery_outputs(Query *subquery, RelOptInfo *rel);
 #ifdef ADB
 static bool set_path_reduce_info_worker(Path *path, List *reduce_info_list);
+static WindowTopK *find_window_topk(Query *subquery, Index rti, List *restrictinfo);
+static bool ranking_window_walker(Node *node, Index *winref);
 #endif /* ADB */
 
 /*
@@ -2242,10 +2248,17 @@ set_subquery_pathlist(PlannerInfo *root, RelOptInfo *rel,
 	/* plan_params should not be in use in current query level */
 	Assert(root->plan_params == NIL);
 
+#ifdef ADB
+	root->subquery_topk = find_window_topk(subquery, rti, rel->baserestrictinfo);
+#endif /* ADB */
+
 	/* Generate a subroot and Paths for the subquery */
 	rel->subroot = subquery_planner(root->glob, subquery,
 									root,
 									false, tuple_fraction);
+#ifdef ADB
+	root->subquery_topk = NULL;
+#endif /* ADB */
 
 	/* Isolate the params needed by this specific subplan */
 	rel->subplan_params = root->plan_params;
@@ -3489,6 +3502,121 @@ static bool set_path_reduce_info_worker(Path *path, List *reduce_info_list)
 	}
 	return false;
 }
+
+/*
+ * find_window_topk
+ *		Look for a restriction like "rn <= 10" of the upper query, where rn
+ *		is a ranking window function of the subquery.
+ *
+ * Ranking functions of a row only depend on the rows ordered before it in
+ * its window partition, so the subquery may drop the other rows of each
+ * partition early, see create_cluster_window_path.  That is safe only if
+ * all window functions of the subquery are ranking ones of the same window
+ * and nothing but the upper query looks at the rows.
+ */
+static WindowTopK *find_window_topk(Query *subquery, Index rti, List *restrictinfo)
+{
+	WindowTopK *topk = NULL;
+	ListCell   *lc;
+	Index		winref = 0;
+
+	if (!subquery->hasWindowFuncs ||
+		expression_returns_set((Node *) subquery->targetList) ||
+		subquery->setOperations ||
+		subquery->distinctClause ||
+		subquery->limitCount ||
+		subquery->limitOffset ||
+		subquery->rowMarks ||
+		contain_volatile_functions((Node *) subquery->targetList) ||
+		ranking_window_walker((Node *) subquery->targetList, &winref))
+		return NULL;
+
+	foreach(lc, restrictinfo)
+	{
+		RestrictInfo *rinfo = lfirst(lc);
+		OpExpr	   *opexpr = (OpExpr *) rinfo->clause;
+		Var		   *var;
+		Const	   *con;
+		TargetEntry *tle;
+		int64		count;
+		int			strategy;
+
+		if (rinfo->pseudoconstant ||
+			!IsA(opexpr, OpExpr) ||
+			list_length(opexpr->args) != 2)
+			continue;
+
+		var = linitial(opexpr->args);
+		con = lsecond(opexpr->args);
+		if (!IsA(var, Var) ||
+			var->varno != rti ||
+			var->varlevelsup != 0 ||
+			!IsA(con, Const) ||
+			con->constisnull)
+			continue;
+
+		tle = get_tle_by_resno(subquery->targetList, var->varattno);
+		if (tle == NULL ||
+			tle->resjunk ||
+			!IsA(tle->expr, WindowFunc))
+			continue;
+
+		switch (con->consttype)
+		{
+			case INT8OID:
+				count = DatumGetInt64(con->constvalue);
+				break;
+			case INT4OID:
+				count = DatumGetInt32(con->constvalue);
+				break;
+			case INT2OID:
+				count = DatumGetInt16(con->constvalue);
+				break;
+			default:
+				continue;
+		}
+
+		strategy = get_op_opfamily_strategy(opexpr->opno, INTEGER_BTREE_FAM_OID);
+		if (strategy == BTLessStrategyNumber)
+			--count;
+		else if (strategy != BTLessEqualStrategyNumber &&
+				 strategy != BTEqualStrategyNumber)
+			continue;
+
+		if (count < 1 ||
+			(topk != NULL && topk->count <= count))
+			continue;
+
+		if (topk == NULL)
+			topk = palloc(sizeof(WindowTopK));
+		topk->wfunc = copyObject(tle->expr);
+		topk->count = count;
+	}
+
+	return topk;
+}
+
+/* return true if not all window functions are ranking ones of one window */
+static bool ranking_window_walker(Node *node, Index *winref)
+{
+	if (node == NULL)
+		return false;
+
+	if (IsA(node, WindowFunc))
+	{
+		WindowFunc *wfunc = (WindowFunc *) node;
+
+		if (wfunc->winfnoid != F_WINDOW_ROW_NUMBER &&
+			wfunc->winfnoid != F_WINDOW_RANK &&
+			wfunc->winfnoid != F_WINDOW_DENSE_RANK)
+			return true;
+		if (*winref == 0)
+			*winref = wfunc->winref;
+		return *winref != wfunc->winref;
+	}
+
+	return expression_tree_walker(node, ranking_window_walker, winref);
+}
 #endif /* ADB */
 
 /*****************************************************************************
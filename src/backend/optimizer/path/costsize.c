@@ -144,6 +144,8 @@ bool		enable_remotegroup = true;
 bool		enable_remotesort = true;
 bool		enable_remotelimit = true;
 bool		enable_hashscan = true;
+bool		enable_semijoin_reduction = true;
+int			adaptive_join_rows = 0;
 #endif
 
 typedef struct
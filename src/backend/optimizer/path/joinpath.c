@@ -114,6 +114,9 @@ static List *create_inner_reduce_info_for_join(List *outer_reduce_list, RelOptIn
 											   JoinType jointype, JoinPathExtraData *extra);
 static List *reduce_paths_for_join(PlannerInfo *root, RelOptInfo *rel, List *pathlist, List *reduce_list);
 static List *coord_paths_for_join(PlannerInfo *root, RelOptInfo *rel);
+static Path *get_semi_unique_inner_path(ClusterJoinContext *jcontext);
+static List *semi_unique_paths_for_join(ClusterJoinContext *jcontext, List *outer_reduce_list,
+										List *reduce_list);
 static bool get_cluster_join_exprs(RelOptInfo *outerrel, RelOptInfo *innerrel,
 								   List **outer_exprs, List **inner_exprs,
 								   List *restrictlist);
@@ -2410,6 +2413,8 @@ static void add_cluster_paths_to_joinrel(PlannerInfo *root,
 											   innerrel,
 											   innerrel->cluster_pathlist == NIL ? innerrel->pathlist:innerrel->cluster_pathlist,
 											   need_reduce_list);
+		inner_pathlist = list_concat(inner_pathlist,
+									 semi_unique_paths_for_join(&jcontext, all_outer_reduce, need_reduce_list));
 		tried_join = add_cluster_paths_to_joinrel_internal(&jcontext,
 														   outerrel->cluster_pathlist == NIL ? outerrel->pathlist:outerrel->cluster_pathlist,
 														   inner_pathlist,
@@ -2473,6 +2478,9 @@ static void add_cluster_paths_to_joinrel(PlannerInfo *root,
 																  &path);
 				if(path && list_member_ptr(reduce_inner_pathlist, path) == false)
 					reduce_inner_pathlist = lappend(reduce_inner_pathlist, path);
+				/* hash the distinct join keys only */
+				if((path = get_semi_unique_inner_path(&jcontext)) != NULL)
+					reduce_inner_pathlist = lappend(reduce_inner_pathlist, path);
 re_reduce_join_:
 				ReducePathListByExpr((Expr*)outer_exprs,
 									 root,
@@ -3145,6 +3153,76 @@ static List *coord_paths_for_join(PlannerInfo *root, RelOptInfo *rel)
 	return result;
 }
 
+/*
+ * A semi join only needs the distinct join keys of its inner side, so the
+ * inner rows can be unique-ified on each node before they are reduced.
+ * Return that path, or NULL if it does not help
+ */
+static Path *get_semi_unique_inner_path(ClusterJoinContext *jcontext)
+{
+	SpecialJoinInfo *sjinfo = jcontext->extra->sjinfo;
+	RelOptInfo *innerrel = jcontext->innerrel;
+	Path *subpath = innerrel->cheapest_cluster_total_path;
+	UniquePath *upath;
+
+	if (!enable_semijoin_reduction ||
+		(jcontext->jointype != JOIN_SEMI && jcontext->jointype != JOIN_UNIQUE_INNER) ||
+		sjinfo == NULL ||
+		sjinfo->jointype != JOIN_SEMI ||
+		!bms_equal(innerrel->relids, sjinfo->syn_righthand) ||
+		subpath == NULL ||
+		PATH_REQ_OUTER(subpath) ||
+		IsReduceInfoListReplicated(get_reduce_info_list(subpath)) ||
+		IsReduceInfoListCoordinator(get_reduce_info_list(subpath)))
+		return NULL;
+
+	upath = create_cluster_unique_path(jcontext->root, innerrel, subpath, sjinfo);
+	if (upath == NULL ||
+		upath->umethod == UNIQUE_PATH_NOOP)
+		return NULL;
+
+	return (Path*)upath;
+}
+
+/*
+ * Reduce the distinct inner join keys of a semi join using reduce_list,
+ * and also broadcast them to the nodes of outer_reduce_list, which is
+ * cheaper when the inner side is selective
+ */
+static List *semi_unique_paths_for_join(ClusterJoinContext *jcontext, List *outer_reduce_list,
+										List *reduce_list)
+{
+	ListCell *lc;
+	ReduceInfo *rinfo;
+	List *exec_list;
+	List *result = NIL;
+	Path *upath = get_semi_unique_inner_path(jcontext);
+
+	if (upath == NULL)
+		return NIL;
+
+	foreach(lc, reduce_list)
+		ReducePathUsingReduceInfo(jcontext->root, jcontext->innerrel, upath,
+								  ReducePathSave2List, (void*)&result, lfirst(lc));
+
+	foreach(lc, outer_reduce_list)
+	{
+		rinfo = lfirst(lc);
+		if (IsReduceInfoCoordinator(rinfo))
+			return result;
+	}
+	exec_list = ReduceInfoListGetExecuteOidList(outer_reduce_list);
+	rinfo = MakeReplicateReduceInfo(exec_list);
+	list_free(exec_list);
+	if (ReduceInfoListMember(reduce_list, rinfo))
+		FreeReduceInfo(rinfo);
+	else
+		ReducePathUsingReduceInfo(jcontext->root, jcontext->innerrel, upath,
+								  ReducePathSave2List, (void*)&result, rinfo);
+
+	return result;
+}
+
 static bool get_cluster_join_exprs(RelOptInfo *outerrel, RelOptInfo *innerrel,
 								   List **outer_exprs, List **inner_exprs,
 								   List *restrictlist)
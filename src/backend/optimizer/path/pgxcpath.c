@@ -154,7 +154,8 @@ create_plainrel_rqpath(PlannerInfo *root, RelOptInfo *rel, RangeTblEntry *rte,
 	if (IsExecNodesDistributedByValue(exec_nodes))
 	{
 		Var	*dist_var = pgxc_get_dist_var(rel->relid, rte, rel->reltarget->exprs);
-		exec_nodes->en_dist_vars = list_make1(dist_var);
+		if (dist_var)
+			exec_nodes->en_dist_vars = list_make1(dist_var);
 	}
 
 #ifdef ADB
@@ -45,6 +45,7 @@
 #ifdef ADB
 #include "catalog/pgxc_node.h"
 #include "nodes/pg_list.h"
+#include "pgxc/locator.h"
 #include "pgxc/pgxcnode.h"
 #include "pgxc/pgxc.h"
 #include "optimizer/pathnode.h"
@@ -295,6 +296,8 @@ static ClusterGatherType get_gather_type(List *reduce_info_list);
 static Plan* create_filter_if_replicate(Plan *subplan, List *reduce_list);
 static bool replace_reduce_replicate_nodes(Path *path, List *nodes);
 static Plan *create_cluster_reduce_plan(PlannerInfo *root, ClusterReducePath *path, int flags);
+static Plan *create_adaptive_join_reduce(HashPath *best_path, Plan *outer_plan,
+							Plan *inner_plan, List *hashclauses);
 static Plan *create_reducescan_plan(PlannerInfo *root, ReduceScanPath *path, int flags);
 static bool find_cluster_reduce_expr(Path *path, List **pplist);
 static void set_scan_execute_oids(Scan *scan, Path *path, PlannerInfo *root);
@@ -2186,6 +2189,9 @@ create_windowagg_plan(PlannerInfo *root, WindowAggPath *best_path)
 						  wc->startOffset,
 						  wc->endOffset,
 						  subplan);
+#ifdef ADB
+	plan->plan.qual = best_path->qual;
+#endif /* ADB */
 
 	copy_generic_path_info(&plan->plan, (Path *) best_path);
 
@@ -4167,6 +4173,14 @@ create_hashjoin_plan(PlannerInfo *root,
 		}
 	}
 
+#ifdef ADB
+	if (best_path->jpath.path.reduce_is_valid)
+		outer_plan = create_adaptive_join_reduce(best_path,
+												 outer_plan,
+												 inner_plan,
+												 hashclauses);
+#endif /* ADB */
+
 	/*
 	 * Build the hash node and hash join node.
 	 */
@@ -6801,6 +6815,94 @@ static Plan *create_cluster_reduce_plan(PlannerInfo *root, ClusterReducePath *pa
 	return (Plan*) plan;
 }
 
+/*
+ * The inner side of left and anti joins is broadcast to the nodes of the
+ * outer side, which melts the network when it is much larger than planned.
+ * Let the broadcast switch to a hash reduce on the join keys after
+ * adaptive_join_rows rows, and put a ClusterReduce over the outer side which
+ * keeps its rows local unless the inner side switched, then reduces them by
+ * the same hash.  Returns the new outer plan, or outer_plan if the join
+ * can't switch.
+ */
+static Plan *create_adaptive_join_reduce(HashPath *best_path, Plan *outer_plan,
+										 Plan *inner_plan, List *hashclauses)
+{
+	Path *outer_path = best_path->jpath.outerjoinpath;
+	Path *inner_path = best_path->jpath.innerjoinpath;
+	ClusterReduce *inner_reduce;
+	ClusterReduce *outer_reduce;
+	ReduceInfo *rinfo;
+	List *outer_keys = NIL;
+	List *inner_keys = NIL;
+	ListCell *lc;
+
+	if (adaptive_join_rows <= 0 ||
+		(best_path->jpath.jointype != JOIN_LEFT &&
+		 best_path->jpath.jointype != JOIN_ANTI) ||
+		best_path->jpath.path.parallel_workers > 0 ||
+		!IsA(inner_path, ClusterReducePath) ||
+		!IsA(inner_plan, ClusterReduce) ||
+		IsA(outer_path, ClusterReducePath) ||
+		outer_path->reduce_info_list == NIL)
+		return outer_plan;
+
+	/* inner side must be broadcast to the nodes running the join */
+	inner_reduce = (ClusterReduce *) inner_plan;
+	if (list_length(inner_path->reduce_info_list) != 1 ||
+		inner_reduce->numCols > 0 ||
+		inner_reduce->adaptive_reduce != NULL)
+		return outer_plan;
+	rinfo = linitial(inner_path->reduce_info_list);
+	if (!IsReduceInfoReplicated(rinfo) ||
+		IsReduceInfoFinalReplicated(rinfo) ||
+		!IsReduceInfoListExecuteSubset(outer_path->reduce_info_list,
+									   rinfo->storage_nodes))
+		return outer_plan;
+
+	/* every outer row must be on one node only */
+	foreach(lc, outer_path->reduce_info_list)
+	{
+		ReduceInfo *outer_info = lfirst(lc);
+		if (!IsReduceInfoByValue(outer_info) && !IsReduceInfoRound(outer_info))
+			return outer_plan;
+	}
+
+	/* hash keys, outer variable is on the left of hashclauses */
+	foreach(lc, hashclauses)
+	{
+		OpExpr *clause = lfirst(lc);
+		Expr *outer_key = linitial(clause->args);
+		Expr *inner_key = lsecond(clause->args);
+		Oid typid = exprType((Node*)outer_key);
+
+		if (typid != exprType((Node*)inner_key) ||
+			!IsTypeDistributable(typid) ||
+			!IsA(strip_implicit_coercions((Node*)outer_key), Var) ||
+			!IsA(strip_implicit_coercions((Node*)inner_key), Var))
+			continue;
+		outer_keys = lappend(outer_keys, outer_key);
+		inner_keys = lappend(inner_keys, inner_key);
+	}
+	if (outer_keys == NIL)
+		return outer_plan;
+
+	outer_reduce = makeNode(ClusterReduce);
+	outerPlan(outer_reduce) = outer_plan;
+	outer_reduce->plan.targetlist = outer_plan->targetlist;
+	copy_plan_costsize(&outer_reduce->plan, outer_plan);
+	outer_reduce->reduce_oids = list_copy(rinfo->storage_nodes);
+	outer_reduce->adaptive_follow = true;
+
+	rinfo = MakeMultiHashReduceInfo(outer_reduce->reduce_oids, NIL, outer_keys);
+	outer_reduce->reduce = CreateExprUsingReduceInfo(rinfo);
+
+	rinfo = MakeMultiHashReduceInfo(outer_reduce->reduce_oids, NIL, inner_keys);
+	inner_reduce->adaptive_reduce = CreateExprUsingReduceInfo(rinfo);
+	inner_reduce->adaptive_rows = adaptive_join_rows;
+
+	return (Plan *) outer_reduce;
+}
+
 static Plan *create_reducescan_plan(PlannerInfo *root, ReduceScanPath *path, int flags)
 {
 	ListCell   *lc;
@@ -2096,8 +2096,10 @@ pgxc_set_en_expr(Oid tableoid, Index resultRelationIndex)
 	 *
 	 * XXX Need further testing for replicated and round-robin tables
 	 */
-	if (rel_loc_info->locatorType == LOCATOR_TYPE_HASH ||
-		rel_loc_info->locatorType == LOCATOR_TYPE_MODULO)
+	if ((rel_loc_info->locatorType == LOCATOR_TYPE_HASH &&
+		 !IsRelationDistributedByMultiHash(rel_loc_info)) ||
+		rel_loc_info->locatorType == LOCATOR_TYPE_MODULO ||
+		IsRelationDistributedByRangeOrList(rel_loc_info))
 	{
 		tp = SearchSysCache(ATTNUM,
 							ObjectIdGetDatum(tableoid),
@@ -2122,7 +2124,8 @@ pgxc_set_en_expr(Oid tableoid, Index resultRelationIndex)
 
 		result = list_make1(var);
 	} else
-	if (rel_loc_info->locatorType == LOCATOR_TYPE_USER_DEFINED)
+	if (rel_loc_info->locatorType == LOCATOR_TYPE_USER_DEFINED ||
+		IsRelationDistributedByMultiHash(rel_loc_info))
 	{
 		ListCell *lc;
 		AttrNumber attnum;
@@ -2983,7 +2986,8 @@ validate_part_col_updatable(const Query *query)
 	 *
 	 * But we allow the statement like UPDATE table set dist_col = dist_col
 	 */
-	if (IsRelationDistributedByUserDefined(rel_loc_info))
+	if (IsRelationDistributedByUserDefined(rel_loc_info) ||
+		IsRelationDistributedByMultiHash(rel_loc_info))
 	{
 		ListCell *l;
 
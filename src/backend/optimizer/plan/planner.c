@@ -55,12 +55,17 @@
 #include "utils/lsyscache.h"
 #include "utils/syscache.h"
 #ifdef ADB
+#include "access/stratnum.h"
+#include "catalog/pg_aggregate.h"
 #include "catalog/pg_namespace.h"
+#include "catalog/pg_opfamily.h"
 #include "catalog/pgxc_node.h"
+#include "pgxc/noderange.h"
 #include "pgxc/pgxc.h"
 #include "pgxc/pgxcnode.h"
 #include "optimizer/pgxcplan.h"
 #include "optimizer/reduceinfo.h"
+#include "parser/parse_oper.h"
 #include "utils/fmgroids.h"
 #endif
 
@@ -223,6 +228,9 @@ static bool is_remote_relation(PlannerInfo *root, Index relid);
 static Bitmapset *find_cte_planid(PlannerInfo *root, Bitmapset *bms);
 static int create_cluster_distinct_path(PlannerInfo *root, Path *subpath, void *context);
 static int create_cluster_grouping_path(PlannerInfo *root, Path *subpath, void *context);
+static PathTarget *make_distinct_agg_input_target(PlannerInfo *root, PathTarget *grouping_target);
+static Path *create_distinct_agg_input_path(PlannerInfo *root, RelOptInfo *input_rel,
+											Path *path, PathTarget *dedup_target);
 static bool replace_replicate_reduce(Path *path, List *reduce_replicate);
 static void create_cluster_window_path(PlannerInfo *root,
 									   RelOptInfo *window_rel,
@@ -232,7 +240,20 @@ static void create_cluster_window_path(PlannerInfo *root,
 									   List *tlist,
 									   WindowFuncLists *wflists,
 									   List *activeWindows);
+static void create_cluster_window_reduce_path(PlannerInfo *root,
+											  RelOptInfo *window_rel,
+											  Path *path,
+											  PathTarget *output_target,
+											  List *tlist,
+											  WindowFuncLists *wflists,
+											  List *partition_list,
+											  List *coord_list,
+											  List *storage,
+											  List *exclude,
+											  CreateWindowAggPathContext *base_context);
 static int create_cluster_window_internal(PlannerInfo *root, Path *path, void *context);
+static Path *create_window_topk_path(PlannerInfo *root, RelOptInfo *window_rel, Path *path,
+									 WindowClause *wc, List *tlist);
 static PathTarget* update_window_target(PathTarget *input_target,
 										WindowFuncLists *wflists,
 										WindowClause *wc);
@@ -257,6 +278,14 @@ PlannedStmt *
 planner(Query *parse, int cursorOptions, ParamListInfo boundParams)
 {
 	PlannedStmt *result;
+#ifdef ADB
+	NodeRangePlanState node_range_save;
+
+	/* collect the tables datanodes are left out of by value ranges */
+	NodeRangeBeginPlan(&node_range_save);
+	PG_TRY();
+	{
+#endif
 
 	if (planner_hook)
 		result = (*planner_hook) (parse, cursorOptions, boundParams);
@@ -271,6 +300,17 @@ planner(Query *parse, int cursorOptions, ParamListInfo boundParams)
 		else
 #endif
 		result = standard_planner(parse, cursorOptions, boundParams);
+
+#ifdef ADB
+	}
+	PG_CATCH();
+	{
+		NodeRangeEndPlan(NULL, &node_range_save);
+		PG_RE_THROW();
+	}
+	PG_END_TRY();
+	NodeRangeEndPlan(result, &node_range_save);
+#endif
 	return result;
 }
 
@@ -4445,6 +4485,7 @@ create_grouping_paths(PlannerInfo *root,
 		CreateGrupingPathsContext gcontext;
 		Path *cheapest_cluster_path = input_rel->cheapest_cluster_total_path;
 
+		PathTarget *dedup_target = NULL;
 		bool no_partial = (agg_costs->hasNonPartial || agg_costs->hasNonSerial);
 		bool tried_cluster_agg = false;
 		bool have_cluster_subpath = false;
@@ -4577,6 +4618,20 @@ create_grouping_paths(PlannerInfo *root,
 			pathlist = GetCheapestReducePathList(input_rel, input_rel->cluster_pathlist, NULL, &path);
 			if(!list_member_ptr(pathlist, path))
 				pathlist = lappend(pathlist, path);
+			if(no_partial)
+				dedup_target = make_distinct_agg_input_target(root, target);
+			if(dedup_target)
+			{
+				/* remove duplicate rows on each node before reduce them */
+				List *dedup_list = NIL;
+				foreach(lc, pathlist)
+				{
+					path = create_distinct_agg_input_path(root, input_rel, lfirst(lc), dedup_target);
+					if(path)
+						dedup_list = lappend(dedup_list, path);
+				}
+				pathlist = list_concat(pathlist, dedup_list);
+			}
 			foreach(lc, pathlist)
 			{
 				/* reduce to coordinator, by hash and modulo do once */
@@ -4932,6 +4987,7 @@ static void create_cluster_window_path(PlannerInfo *root,
 	List	   *partition_list = NIL;
 	List	   *storage;
 	List	   *exclude;
+	Path	   *topk_path;
 
 	CreateWindowAggPathContext context;
 
@@ -4983,6 +5039,47 @@ static void create_cluster_window_path(PlannerInfo *root,
 											  &storage,
 											  &exclude);
 
+	create_cluster_window_reduce_path(root, window_rel, path, output_target, tlist, wflists,
+									  partition_list, list_copy(coord_list), storage, exclude,
+									  &context);
+
+	/*
+	 * Also try to drop rows the upper query does not need before reduce
+	 * them, and let the costs decide
+	 */
+	if(partition_list)
+		topk_path = create_window_topk_path(root, window_rel, path, linitial(partition_list), tlist);
+	else if(list_length(coord_list) == 1)
+		topk_path = create_window_topk_path(root, window_rel, path, linitial(coord_list), tlist);
+	else
+		topk_path = path;
+
+	if(topk_path != path)
+		create_cluster_window_reduce_path(root, window_rel, topk_path, output_target, tlist, wflists,
+										  partition_list, list_copy(coord_list), storage, exclude,
+										  &context);
+}
+
+/*
+ * Compute the windows of partition_list on the nodes after reduce path by
+ * their PARTITION BY keys, and the windows of coord_list on the coordinator
+ */
+static void create_cluster_window_reduce_path(PlannerInfo *root,
+											  RelOptInfo *window_rel,
+											  Path *path,
+											  PathTarget *output_target,
+											  List *tlist,
+											  WindowFuncLists *wflists,
+											  List *partition_list,
+											  List *coord_list,
+											  List *storage,
+											  List *exclude,
+											  CreateWindowAggPathContext *base_context)
+{
+	WindowClause *wc;
+	ListCell   *lc;
+	CreateWindowAggPathContext context = *base_context;
+
 	if(partition_list)
 	{
 		ListCell *lc2;
@@ -5131,6 +5228,69 @@ static PathTarget* update_window_target(PathTarget *input_target,
 	return window_target;
 }
 
+/*
+ * When the upper query only keeps rows ranked in the first count of their
+ * window partition, see find_window_topk, each node can drop the other
+ * rows of its own part of a partition first: a row ranked in the first
+ * count of the whole partition is ranked there on its own node, too.
+ */
+static Path *create_window_topk_path(PlannerInfo *root, RelOptInfo *window_rel, Path *path,
+									 WindowClause *wc, List *tlist)
+{
+	WindowTopK *topk;
+	WindowAggPath *topk_path;
+	List *window_pathkeys;
+	List *exec_list;
+	Expr *qual;
+	Oid opno;
+	double rows;
+
+	if (root->parent_root == NULL ||
+		(topk = root->parent_root->subquery_topk) == NULL ||
+		topk->wfunc->winref != wc->winref ||
+		PATH_REQ_OUTER(path))
+		return path;
+
+	opno = get_opfamily_member(INTEGER_BTREE_FAM_OID, INT8OID, INT8OID,
+							   BTLessEqualStrategyNumber);
+	if (!OidIsValid(opno))
+		return path;
+	qual = make_opclause(opno, BOOLOID, false,
+						 (Expr*)copyObject(topk->wfunc),
+						 (Expr*)makeConst(INT8OID, -1, InvalidOid, sizeof(int64),
+										  Int64GetDatum(topk->count), false,
+										  FLOAT8PASSBYVAL),
+						 InvalidOid, InvalidOid);
+
+	window_pathkeys = make_pathkeys_for_window(root, wc, tlist);
+	if(!pathkeys_contained_in(window_pathkeys, path->pathkeys))
+		path = (Path*)create_sort_path(root, window_rel, path, window_pathkeys, -1.0);
+
+	topk_path = create_windowagg_path(root,
+									  window_rel,
+									  path,
+									  path->pathtarget,
+									  list_make1(topk->wfunc),
+									  wc,
+									  window_pathkeys);
+	topk_path->qual = list_make1(qual);
+
+	/* at most count rows of each partition on each node */
+	rows = (double) topk->count;
+	if (wc->partitionClause)
+		rows *= estimate_num_groups(root,
+									get_sortgrouplist_exprs(wc->partitionClause, tlist),
+									path->rows,
+									NULL);
+	exec_list = ReduceInfoListGetExecuteOidList(get_reduce_info_list(path));
+	rows *= Max(list_length(exec_list), 1);
+	list_free(exec_list);
+	if (rows < topk_path->path.rows)
+		topk_path->path.rows = clamp_row_est(rows);
+
+	return (Path*)topk_path;
+}
+
 static int create_cluster_window_internal(PlannerInfo *root, Path *path, void *context)
 {
 	CreateWindowAggPathContext *wcontext = (CreateWindowAggPathContext*)context;
@@ -6724,7 +6884,8 @@ static Path* reduce_to_relation_insert(PlannerInfo *root, Index rel_id, Path *pa
 		path = create_cluster_reduce_path(root, path, list_make1(reduce_info), path->parent, NIL);
 	}else if(loc_info->locatorType == LOCATOR_TYPE_HASH ||
 			 loc_info->locatorType == LOCATOR_TYPE_MODULO ||
-			 loc_info->locatorType == LOCATOR_TYPE_USER_DEFINED)
+			 loc_info->locatorType == LOCATOR_TYPE_USER_DEFINED ||
+			 IsRelationDistributedByRangeOrList(loc_info))
 	{
 		Expr *expr;
 		if (IsReduceInfoListReplicated(reduce_list))
@@ -6732,7 +6893,19 @@ static Path* reduce_to_relation_insert(PlannerInfo *root, Index rel_id, Path *pa
 			path = replicate_to_one_node(root, path->parent, path, storage_nodes);
 		}
 		reduce_info = NULL;
-		if(loc_info->locatorType == LOCATOR_TYPE_HASH)
+		if(IsRelationDistributedByMultiHash(loc_info))
+		{
+			ListCell *lc;
+			List *params = NIL;
+			foreach(lc, loc_info->funcAttrNums)
+			{
+				expr = list_nth(path->pathtarget->exprs, lfirst_int(lc)-1);
+				params = lappend(params, expr);
+			}
+			reduce_info = MakeMultiHashReduceInfo(storage_nodes,
+												  NIL,
+												  params);
+		}else if(loc_info->locatorType == LOCATOR_TYPE_HASH)
 		{
 			expr = list_nth(path->pathtarget->exprs, loc_info->partAttrNum - 1);
 			reduce_info = MakeHashReduceInfo(storage_nodes,
@@ -6744,6 +6917,20 @@ static Path* reduce_to_relation_insert(PlannerInfo *root, Index rel_id, Path *pa
 			reduce_info = MakeModuloReduceInfo(storage_nodes,
 											   NIL,
 											   expr);
+		}else if(loc_info->locatorType == LOCATOR_TYPE_RANGE)
+		{
+			expr = list_nth(path->pathtarget->exprs, loc_info->partAttrNum - 1);
+			reduce_info = MakeRangeReduceInfo(storage_nodes,
+											  NIL,
+											  expr,
+											  loc_info->distValues);
+		}else if(loc_info->locatorType == LOCATOR_TYPE_LIST)
+		{
+			expr = list_nth(path->pathtarget->exprs, loc_info->partAttrNum - 1);
+			reduce_info = MakeListReduceInfo(storage_nodes,
+											 NIL,
+											 expr,
+											 loc_info->distValues);
 		}else if(loc_info->locatorType == LOCATOR_TYPE_USER_DEFINED)
 		{
 			ListCell *lc;
@@ -6896,6 +7083,142 @@ static int create_cluster_distinct_path(PlannerInfo *root, Path *subpath, void *
 	return 0;
 }
 
+/*
+ * When every aggregate of the query ignores duplicated input, such as
+ * count(DISTINCT x) or max(x), input rows equal in the grouping columns and
+ * in all the aggregate arguments can be removed before aggregation without
+ * changing the result.  Build the target of those rows, laid out like
+ * make_partial_grouping_target, or return NULL if some aggregate counts
+ * duplicates.
+ */
+static PathTarget *make_distinct_agg_input_target(PlannerInfo *root, PathTarget *grouping_target)
+{
+	Query *parse = root->parse;
+	PathTarget *dedup_target;
+	List *non_group_cols;
+	List *non_group_exprs;
+	ListCell *lc;
+	ListCell *lc2;
+	int i;
+
+	if (!parse->hasAggs ||
+		contain_volatile_functions((Node*)grouping_target->exprs) ||
+		contain_volatile_functions(parse->havingQual))
+		return NULL;
+
+	dedup_target = create_empty_pathtarget();
+	non_group_cols = NIL;
+
+	i = 0;
+	foreach(lc, grouping_target->exprs)
+	{
+		Expr *expr = lfirst(lc);
+		Index sgref = get_pathtarget_sortgroupref(grouping_target, i);
+
+		if (sgref && parse->groupClause &&
+			get_sortgroupref_clause_noerr(sgref, parse->groupClause) != NULL)
+			add_column_to_pathtarget(dedup_target, expr, sgref);
+		else
+			non_group_cols = lappend(non_group_cols, expr);
+		i++;
+	}
+	if (parse->havingQual)
+		non_group_cols = lappend(non_group_cols, parse->havingQual);
+
+	non_group_exprs = pull_var_clause((Node *) non_group_cols,
+									  PVC_INCLUDE_AGGREGATES |
+									  PVC_RECURSE_WINDOWFUNCS |
+									  PVC_INCLUDE_PLACEHOLDERS);
+	list_free(non_group_cols);
+
+	foreach(lc, non_group_exprs)
+	{
+		Aggref *aggref = lfirst(lc);
+		HeapTuple tuple;
+		Oid aggsortop;
+
+		if (!IsA(aggref, Aggref))
+		{
+			add_new_column_to_pathtarget(dedup_target, (Expr*)aggref);
+			continue;
+		}
+
+		/* min and max like aggregates have a sort operator */
+		if (aggref->aggdistinct == NIL)
+		{
+			tuple = SearchSysCache1(AGGFNOID, ObjectIdGetDatum(aggref->aggfnoid));
+			if (!HeapTupleIsValid(tuple))
+				elog(ERROR, "cache lookup failed for aggregate %u", aggref->aggfnoid);
+			aggsortop = ((Form_pg_aggregate) GETSTRUCT(tuple))->aggsortop;
+			ReleaseSysCache(tuple);
+			if (!OidIsValid(aggsortop))
+			{
+				list_free(non_group_exprs);
+				return NULL;
+			}
+		}
+
+		foreach(lc2, aggref->args)
+			add_new_column_to_pathtarget(dedup_target, ((TargetEntry*)lfirst(lc2))->expr);
+		if (aggref->aggfilter)
+			add_new_column_to_pathtarget(dedup_target, aggref->aggfilter);
+	}
+	list_free(non_group_exprs);
+
+	return set_pathtarget_cost_width(root, dedup_target);
+}
+
+/*
+ * Sort and unique the rows of path on each node, see
+ * make_distinct_agg_input_target, so only distinct rows are reduced.
+ * Returns NULL if some column can not be sorted.
+ */
+static Path *create_distinct_agg_input_path(PlannerInfo *root, RelOptInfo *input_rel,
+											Path *path, PathTarget *dedup_target)
+{
+	List *reduce_list;
+	List *pathkeys = NIL;
+	ListCell *lc;
+	double numGroups;
+	Oid sortop;
+	Oid eqop;
+
+	foreach(lc, dedup_target->exprs)
+	{
+		Expr *expr = lfirst(lc);
+
+		get_sort_group_operators(exprType((Node*)expr),
+								 false, false, false,
+								 &sortop, &eqop, NULL, NULL);
+		if (!OidIsValid(sortop) || !OidIsValid(eqop))
+			return NULL;
+		pathkeys = list_concat_unique_ptr(pathkeys,
+										  build_expression_pathkey(root,
+																   expr,
+																   NULL,
+																   sortop,
+																   input_rel->relids,
+																   true));
+	}
+	if (pathkeys == NIL)
+		return NULL;
+
+	reduce_list = get_reduce_info_list(path);
+	path = (Path*)create_projection_path(root, input_rel, path, dedup_target);
+	if (!pathkeys_contained_in(pathkeys, path->pathkeys))
+		path = (Path*)create_sort_path(root, input_rel, path, pathkeys, -1.0);
+	numGroups = estimate_num_groups(root, dedup_target->exprs, path->rows, NULL);
+	path = (Path*)create_upper_unique_path(root,
+										   input_rel,
+										   path,
+										   list_length(pathkeys),
+										   numGroups);
+	path->reduce_info_list = CopyReduceInfoList(reduce_list);
+	path->reduce_is_valid = true;
+
+	return path;
+}
+
 static int create_cluster_grouping_path(PlannerInfo *root, Path *subpath, void *context)
 {
 	Path *path;
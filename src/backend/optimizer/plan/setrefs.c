@@ -691,6 +691,11 @@ set_plan_refs(PlannerInfo *root, Plan *plan, int rtoffset)
 													   subplan_itlist,
 													   OUTER_VAR,
 													   rtoffset);
+				reduce->adaptive_reduce = (Expr*)fix_upper_expr(root,
+																(Node*)(reduce->adaptive_reduce),
+																subplan_itlist,
+																OUTER_VAR,
+																rtoffset);
 				pfree(subplan_itlist);
 			}
 			break;
@@ -531,7 +531,8 @@ pgxc_FQS_get_relation_nodes(RangeTblEntry *rte, Index varno, Query *query)
 	if (IsExecNodesDistributedByValue(rel_exec_nodes))
 	{
 		Var	*dist_var = pgxc_get_dist_var(varno, rte, query->targetList);
-		rel_exec_nodes->en_dist_vars = list_make1(dist_var);
+		if (dist_var)
+			rel_exec_nodes->en_dist_vars = list_make1(dist_var);
 	}
 #ifdef ADB
 	else if (IsExecNodesDistributedByUserDefined(rel_exec_nodes))
@@ -540,7 +541,8 @@ pgxc_FQS_get_relation_nodes(RangeTblEntry *rte, Index varno, Query *query)
 	}
 #endif
 	if (rel_access == RELATION_ACCESS_INSERT &&
-			 IsRelationDistributedByValue(rel_loc_info))
+			 IsRelationDistributedByValue(rel_loc_info) &&
+			 !IsRelationDistributedByMultiHash(rel_loc_info))
 	{
 		ListCell *lc;
 		TargetEntry *tle;
@@ -581,7 +583,8 @@ pgxc_FQS_get_relation_nodes(RangeTblEntry *rte, Index varno, Query *query)
 	}
 #ifdef ADB
 	else if (rel_access == RELATION_ACCESS_INSERT &&
-			 IsRelationDistributedByUserDefined(rel_loc_info))
+			 (IsRelationDistributedByUserDefined(rel_loc_info) ||
+			  IsRelationDistributedByMultiHash(rel_loc_info)))
 	{
 		ListCell *lc1, *lc2;
 		TargetEntry *tle;
@@ -1936,6 +1939,8 @@ pgxc_merge_exec_nodes(ExecNodes *en1, ExecNodes *en2)
 				if (OidIsValid(en1->en_funcid) &&
 					en1->en_funcid == en2->en_funcid)
 					merged_en->en_funcid = en1->en_funcid;
+				if (en1->en_colocation == en2->en_colocation)
+					merged_en->en_colocation = en1->en_colocation;
 #endif
 				merged_en->en_dist_vars = list_concat(list_copy(en1->en_dist_vars),
 												list_copy(en2->en_dist_vars));
@@ -2050,6 +2055,10 @@ pgxc_check_index_shippability(RelationLocInfo *relLocInfo,
 
 			case LOCATOR_TYPE_HASH:
 			case LOCATOR_TYPE_MODULO:
+#ifdef ADB
+			case LOCATOR_TYPE_RANGE:
+			case LOCATOR_TYPE_LIST:
+#endif
 				/*
 				 * Unique indexes on Hash and Modulo tables are shippable if the
 				 * index expression contains all the distribution expressions of
@@ -2092,6 +2101,21 @@ pgxc_check_index_shippability(RelationLocInfo *relLocInfo,
 				if (indexAttrs == NIL)
 					break;
 
+#ifdef ADB
+				/* Hash on several columns needs them all in the index */
+				if (IsRelationDistributedByMultiHash(relLocInfo))
+				{
+					List *attr_diff = list_difference_int(relLocInfo->funcAttrNums,
+														  indexAttrs);
+					if (attr_diff != NIL)
+					{
+						pfree(attr_diff);
+						result = false;
+					}
+					break;
+				}
+#endif
+
 				/*
 				 * Check that distribution column is included in the list of
 				 * index columns.
@@ -2141,7 +2165,6 @@ pgxc_check_index_shippability(RelationLocInfo *relLocInfo,
 				break;
 #endif
 			/* Those types are not supported yet */
-			case LOCATOR_TYPE_RANGE:
 			case LOCATOR_TYPE_NONE:
 			case LOCATOR_TYPE_DISTRIBUTED:
 			case LOCATOR_TYPE_CUSTOM:
@@ -2205,6 +2228,8 @@ pgxc_check_fk_shippability(RelationLocInfo *parentLocInfo,
 			break;
 #ifdef ADB
 		case LOCATOR_TYPE_USER_DEFINED:
+		case LOCATOR_TYPE_RANGE:
+		case LOCATOR_TYPE_LIST:
 #endif
 		case LOCATOR_TYPE_HASH:
 		case LOCATOR_TYPE_MODULO:
@@ -2247,7 +2272,21 @@ pgxc_check_fk_shippability(RelationLocInfo *parentLocInfo,
 				break;
 			}
 #ifdef ADB
-			if (IsRelationDistributedByUserDefined(parentLocInfo))
+			/*
+			 * Range and list tables also need the same nodes in the same
+			 * order for the same values.
+			 */
+			if (IsRelationDistributedByRangeOrList(parentLocInfo) &&
+				(!equal(childLocInfo->nodeids, parentLocInfo->nodeids) ||
+				 !equal(childLocInfo->distValues, parentLocInfo->distValues)))
+			{
+				result = false;
+				break;
+			}
+
+			if (IsRelationDistributedByUserDefined(parentLocInfo) ||
+				IsRelationDistributedByMultiHash(parentLocInfo) ||
+				IsRelationDistributedByMultiHash(childLocInfo))
 			{
 				List *childRefsDiff = NIL;
 				List *parentRefsDiff = NIL;
@@ -2256,15 +2295,25 @@ pgxc_check_fk_shippability(RelationLocInfo *parentLocInfo,
 				int childAttIdx, parentAttIdx;
 
 				/* Parent and child need to have the same distribution function */
-				Assert(OidIsValid(parentLocInfo->funcid));
-				Assert(OidIsValid(childLocInfo->funcid));
-				if (parentLocInfo->funcid != childLocInfo->funcid)
+				if (IsRelationDistributedByUserDefined(parentLocInfo))
+				{
+					Assert(OidIsValid(parentLocInfo->funcid));
+					Assert(OidIsValid(childLocInfo->funcid));
+					if (parentLocInfo->funcid != childLocInfo->funcid)
+					{
+						result = false;
+						break;
+					}
+					Assert(list_length(childLocInfo->funcAttrNums) ==
+						list_length(parentLocInfo->funcAttrNums));
+				} else
+				if (list_length(childLocInfo->funcAttrNums) !=
+					list_length(parentLocInfo->funcAttrNums))
 				{
+					/* or hash the same number of columns */
 					result = false;
 					break;
 				}
-				Assert(list_length(childLocInfo->funcAttrNums) ==
-					list_length(parentLocInfo->funcAttrNums));
 
 				/* Child foreign key should contain all distribution columns. */
 				childRefsDiff = list_difference_int(childLocInfo->funcAttrNums, childRefs);
@@ -2316,7 +2365,6 @@ pgxc_check_fk_shippability(RelationLocInfo *parentLocInfo,
 			/* By being here, parent-child constraint can be shipped correctly */
 			break;
 
-		case LOCATOR_TYPE_RANGE:
 		case LOCATOR_TYPE_NONE:
 		case LOCATOR_TYPE_DISTRIBUTED:
 		case LOCATOR_TYPE_CUSTOM:
@@ -2392,6 +2440,12 @@ pgxc_get_dist_var(Index varno, RangeTblEntry *rte, List *tlist)
 	if (!rel_loc_info || !IsRelationDistributedByValue(rel_loc_info))
 		return NULL;
 
+#ifdef ADB
+	/* no single column locates the rows of a hash on several columns */
+	if (IsRelationDistributedByMultiHash(rel_loc_info))
+		return NULL;
+#endif
+
 	/* find the TLE corresponding to the distribution column it. */
 	foreach (lcell, tlist)
 	{
@@ -2536,7 +2590,17 @@ pgxc_is_join_shippable(ExecNodes *inner_en, ExecNodes *outer_en,
 		 * merged.
 		 */
 		if (inner_en->baselocatortype == outer_en->baselocatortype &&
-			IsExecNodesDistributedByValue(inner_en))
+			IsExecNodesDistributedByValue(inner_en)
+#ifdef ADB
+			/*
+			 * The bounds of range and list tables are only known to be the
+			 * same when they are in the same colocation group.
+			 */
+			&& (!IsExecNodesDistributedByRangeOrList(inner_en) ||
+				(OidIsValid(inner_en->en_colocation) &&
+				 inner_en->en_colocation == outer_en->en_colocation))
+#endif
+			)
 		{
 			Expr *equi_join_expr = pgxc_find_dist_equijoin_qual(inner_en->en_dist_vars,
 																outer_en->en_dist_vars,
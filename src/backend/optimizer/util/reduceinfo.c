@@ -22,6 +22,7 @@
 #include "parser/parse_oper.h"
 #include "pgxc/pgxc.h"
 #include "pgxc/pgxcnode.h"
+#include "utils/array.h"
 #include "utils/builtins.h"
 #include "utils/fmgroids.h"
 #include "utils/lsyscache.h"
@@ -35,32 +36,48 @@
 static Param *makeReduceParam(Oid type, int paramid, int parammod, Oid collid);
 static oidvector *makeOidVector(List *list);
 static Expr* makeReduceArrayRef(List *oid_list, Expr *modulo, bool try_const);
+static Expr* makeReduceValueParam(const Expr *param, const Const *value);
+static Const* makeReduceValueArray(const List *values);
 static Node* ReduceParam2ExprMutator(Node *node, List *params);
 static int CompareOid(const void *a, const void *b);
 
 ReduceInfo *MakeHashReduceInfo(const List *storage, const List *exclude, const Expr *param)
+{
+	AssertArg(param);
+	return MakeMultiHashReduceInfo(storage, exclude, list_make1((Expr*)param));
+}
+
+/*
+ * Hash on several expressions, the hashes of the params are combined in
+ * order by adb_hash_combine
+ */
+ReduceInfo *MakeMultiHashReduceInfo(const List *storage, const List *exclude, const List *params)
 {
 	ReduceInfo *rinfo;
 	TypeCacheEntry *typeCache;
+	const ListCell *lc;
 	Oid typoid;
-	AssertArg(storage && IsA(storage, OidList) && param);
+	AssertArg(storage && IsA(storage, OidList) && params != NIL);
 	AssertArg(exclude == NIL || IsA(exclude, OidList));
 
-	typoid = exprType((Node*)param);
-	typeCache = lookup_type_cache(typoid, TYPECACHE_HASH_PROC);
-	if(!OidIsValid(typeCache->hash_proc))
+	foreach(lc, params)
 	{
-		ereport(ERROR,
-				(errcode(ERRCODE_UNDEFINED_FUNCTION),
-				 errmsg("could not identify a hash function for type %s",
-						format_type_be(typoid))));
+		typoid = exprType(lfirst(lc));
+		typeCache = lookup_type_cache(typoid, TYPECACHE_HASH_PROC);
+		if(!OidIsValid(typeCache->hash_proc))
+		{
+			ereport(ERROR,
+					(errcode(ERRCODE_UNDEFINED_FUNCTION),
+					 errmsg("could not identify a hash function for type %s",
+							format_type_be(typoid))));
+		}
 	}
 
 	rinfo = MakeEmptyReduceInfo();
 	rinfo->storage_nodes = list_copy(storage);
 	rinfo->exclude_exec = list_copy(exclude);
-	rinfo->params = list_make1(copyObject(param));
-	rinfo->relids = pull_varnos((Node*)param);
+	rinfo->params = copyObject(params);
+	rinfo->relids = pull_varnos((Node*)rinfo->params);
 	rinfo->type = REDUCE_TYPE_HASH;
 
 	return rinfo;
@@ -157,6 +174,110 @@ ReduceInfo *MakeModuloReduceInfo(const List *storage, const List *exclude, const
 	return rinfo;
 }
 
+/*
+ * Range distribution, the node is the number of bounds not above the
+ * value, computed by width_bucket(value, bounds array).  NULL values go to
+ * the first node.
+ */
+ReduceInfo *MakeRangeReduceInfo(const List *storage, const List *exclude, const Expr *param, const List *bounds)
+{
+	ReduceInfo *rinfo;
+	Const *first;
+	AssertArg(storage != NIL && IsA(storage, OidList) && param);
+	AssertArg(exclude == NIL || IsA(exclude, OidList));
+	AssertArg(list_length(bounds) + 1 == list_length(storage));
+
+	first = linitial(bounds);
+	rinfo = MakeEmptyReduceInfo();
+	rinfo->params = list_make1(copyObject(param));
+	rinfo->expr = (Expr*) makeFuncExpr(F_WIDTH_BUCKET_ARRAY,
+									   INT4OID,
+									   list_make2(makeReduceValueParam(param, first),
+												  makeReduceValueArray(bounds)),
+									   InvalidOid,
+									   first->constcollid,
+									   COERCE_EXPLICIT_CALL);
+	rinfo->storage_nodes = list_copy(storage);
+	rinfo->exclude_exec = list_copy(exclude);
+	rinfo->relids = pull_varnos((Node*)rinfo->params);
+	rinfo->type = REDUCE_TYPE_CUSTOM;
+
+	return rinfo;
+}
+
+/*
+ * List distribution, CASE WHEN value = ANY(values of node 1) THEN 1 ... ELSE 0,
+ * the first node also gets NULL and values not listed.
+ */
+ReduceInfo *MakeListReduceInfo(const List *storage, const List *exclude, const Expr *param, const List *values)
+{
+	ReduceInfo *rinfo;
+	CaseExpr *expr;
+	Const *first;
+	Expr *arg;
+	TypeCacheEntry *typentry;
+	ListCell *lc;
+	int i;
+	AssertArg(storage != NIL && IsA(storage, OidList) && param);
+	AssertArg(exclude == NIL || IsA(exclude, OidList));
+	AssertArg(list_length(values) == list_length(storage));
+
+	first = linitial(linitial(values));
+	typentry = lookup_type_cache(first->consttype, TYPECACHE_EQ_OPR);
+	if(!OidIsValid(typentry->eq_opr))
+	{
+		ereport(ERROR,
+				(errcode(ERRCODE_UNDEFINED_FUNCTION),
+				 errmsg("could not identify an equality operator for type %s",
+						format_type_be(first->consttype))));
+	}
+
+	arg = makeReduceValueParam(param, first);
+	expr = makeNode(CaseExpr);
+	expr->casetype = INT4OID;
+	expr->casecollid = InvalidOid;
+	expr->arg = NULL;
+	expr->args = NIL;
+	expr->location = -1;
+	i = 0;
+	foreach(lc, values)
+	{
+		ScalarArrayOpExpr *saop;
+		CaseWhen *when;
+
+		/* first node is the default */
+		if(i++ == 0)
+			continue;
+
+		saop = makeNode(ScalarArrayOpExpr);
+		saop->opno = typentry->eq_opr;
+		saop->opfuncid = get_opcode(typentry->eq_opr);
+		saop->useOr = true;
+		saop->inputcollid = first->constcollid;
+		saop->args = list_make2(copyObject(arg), makeReduceValueArray(lfirst(lc)));
+		saop->location = -1;
+
+		when = makeNode(CaseWhen);
+		when->expr = (Expr*)saop;
+		when->result = (Expr*)makeConst(INT4OID, -1, InvalidOid, sizeof(int32),
+										Int32GetDatum(i-1), false, true);
+		when->location = -1;
+		expr->args = lappend(expr->args, when);
+	}
+	expr->defresult = (Expr*)makeConst(INT4OID, -1, InvalidOid, sizeof(int32),
+									   Int32GetDatum(0), false, true);
+
+	rinfo = MakeEmptyReduceInfo();
+	rinfo->params = list_make1(copyObject(param));
+	rinfo->expr = (Expr*)expr;
+	rinfo->storage_nodes = list_copy(storage);
+	rinfo->exclude_exec = list_copy(exclude);
+	rinfo->relids = pull_varnos((Node*)rinfo->params);
+	rinfo->type = REDUCE_TYPE_CUSTOM;
+
+	return rinfo;
+}
+
 ReduceInfo *MakeReplicateReduceInfo(const List *storage)
 {
 	ReduceInfo *rinfo;
@@ -218,7 +339,14 @@ ReduceInfo *MakeReduceInfoFromLocInfo(const RelationLocInfo *loc_info, const Lis
 		rinfo = MakeRoundReduceInfo(rnodes);
 	}else
 	{
-		if(loc_info->locatorType == LOCATOR_TYPE_HASH)
+		if(IsRelationDistributedByMultiHash(loc_info))
+		{
+			ListCell *lc;
+			List *params = NIL;
+			foreach(lc, loc_info->funcAttrNums)
+				params = lappend(params, makeVarByRel(lfirst_int(lc), reloid, relid));
+			rinfo = MakeMultiHashReduceInfo(rnodes, exclude, params);
+		}else if(loc_info->locatorType == LOCATOR_TYPE_HASH)
 		{
 			Var *var = makeVarByRel(loc_info->partAttrNum, reloid, relid);
 			rinfo = MakeHashReduceInfo(rnodes, exclude, (Expr*)var);
@@ -234,6 +362,14 @@ ReduceInfo *MakeReduceInfoFromLocInfo(const RelationLocInfo *loc_info, const Lis
 		{
 			Var *var = makeVarByRel(loc_info->partAttrNum, reloid, relid);
 			rinfo = MakeModuloReduceInfo(rnodes, exclude, (Expr*)var);
+		}else if(loc_info->locatorType == LOCATOR_TYPE_RANGE)
+		{
+			Var *var = makeVarByRel(loc_info->partAttrNum, reloid, relid);
+			rinfo = MakeRangeReduceInfo(rnodes, exclude, (Expr*)var, loc_info->distValues);
+		}else if(loc_info->locatorType == LOCATOR_TYPE_LIST)
+		{
+			Var *var = makeVarByRel(loc_info->partAttrNum, reloid, relid);
+			rinfo = MakeListReduceInfo(rnodes, exclude, (Expr*)var, loc_info->distValues);
 		}else
 		{
 			ereport(ERROR,
@@ -1388,12 +1524,13 @@ bool IsReduceInfoCanInnerJoin(ReduceInfo *outer_rinfo, ReduceInfo *inner_rinfo,
 	Expr *right_param;
 	RestrictInfo *ri;
 	ListCell *lc;
+	ListCell *lc_outer;
+	ListCell *lc_inner;
 
 	AssertArg(outer_rinfo && inner_rinfo);
 
-	/* for now support only one distribute cloumn */
-	if (list_length(outer_rinfo->params) != 1 ||
-		list_length(inner_rinfo->params) != 1)
+	if (outer_rinfo->params == NIL ||
+		list_length(outer_rinfo->params) != list_length(inner_rinfo->params))
 		return false;
 
 	if (IsReduceInfoCoordinator(outer_rinfo) &&
@@ -1404,33 +1541,36 @@ bool IsReduceInfoCanInnerJoin(ReduceInfo *outer_rinfo, ReduceInfo *inner_rinfo,
 		!IsReduceInfoByValue(inner_rinfo))
 		return false;
 
-	Assert(list_length(outer_rinfo->params) == 1);
-	Assert(list_length(outer_rinfo->params) == list_length(inner_rinfo->params));
-	left_param = linitial(outer_rinfo->params);
-	right_param = linitial(inner_rinfo->params);
-
-	foreach(lc, restrictlist)
+	/* every distribute column must be joined to the same one of the other side */
+	forboth(lc_outer, outer_rinfo->params, lc_inner, inner_rinfo->params)
 	{
-		ri = lfirst(lc);
+		left_param = lfirst(lc_outer);
+		right_param = lfirst(lc_inner);
 
-		/* only support X=X expression */
-		if (!is_opclause(ri->clause) ||
-			!op_is_equivalence(((OpExpr *)(ri->clause))->opno))
-			continue;
+		foreach(lc, restrictlist)
+		{
+			ri = lfirst(lc);
 
-		left_expr = (Expr*)get_leftop(ri->clause);
-		right_expr = (Expr*)get_rightop(ri->clause);
+			/* only support X=X expression */
+			if (!is_opclause(ri->clause) ||
+				!op_is_equivalence(((OpExpr *)(ri->clause))->opno))
+				continue;
 
-		if ((EqualReduceExpr(left_expr, left_param) &&
-				EqualReduceExpr(right_expr, right_param))
-			|| (EqualReduceExpr(left_expr, right_param) &&
-				EqualReduceExpr(right_expr, left_param)))
-		{
-			return true;
+			left_expr = (Expr*)get_leftop(ri->clause);
+			right_expr = (Expr*)get_rightop(ri->clause);
+
+			if ((EqualReduceExpr(left_expr, left_param) &&
+					EqualReduceExpr(right_expr, right_param))
+				|| (EqualReduceExpr(left_expr, right_param) &&
+					EqualReduceExpr(right_expr, left_param)))
+				break;
 		}
+
+		if (lc == NULL)
+			return false;
 	}
 
-	return false;
+	return true;
 }
 
 bool
@@ -1785,8 +1925,9 @@ bool CanOnceDistinctReduceInfo(List *distinct, ReduceInfo *reduce_info)
 bool CanOnceWindowAggClusterPath(WindowClause *wclause, List *tlist, Path *path)
 {
 	List *reduce_list;
+	List *exprs;
 	ListCell *lc;
-	Expr *expr;
+	bool result;
 
 	reduce_list = get_reduce_info_list(path);
 	Assert(reduce_list != NIL);
@@ -1797,16 +1938,14 @@ bool CanOnceWindowAggClusterPath(WindowClause *wclause, List *tlist, Path *path)
 		wclause->partitionClause == NIL)
 		return false;
 
+	/* a partition needs all distribute columns, like DISTINCT */
+	exprs = NIL;
 	foreach(lc, wclause->partitionClause)
-	{
-		expr = (Expr*)get_sortgroupclause_expr(lfirst(lc), tlist);
-		while(IsA(expr, RelabelType))
-			expr = ((RelabelType *) expr)->arg;
-		if(ReduceInfoListIncludeExpr(reduce_list, expr))
-			return true;
-	}
+		exprs = lappend(exprs, get_sortgroupclause_expr(lfirst(lc), tlist));
+	result = CanOnceDistinctReduceInfoList(exprs, reduce_list);
+	list_free(exprs);
 
-	return false;
+	return result;
 }
 
 bool HaveOnceWindowAggClusterPath(List *wclauses, List *tlist, Path *path)
@@ -1839,8 +1978,8 @@ Expr *CreateExprUsingReduceInfo(ReduceInfo *reduce)
 	switch(reduce->type)
 	{
 	case REDUCE_TYPE_HASH:
-		Assert(list_length(reduce->params) == 1);
-		result = makeHashExpr(linitial(reduce->params));
+		Assert(list_length(reduce->params) > 0);
+		result = makeHashExprList(reduce->params);
 		result = makeModuloExpr(result, list_length(reduce->storage_nodes));
 		Assert(exprType((Node*)result) == INT4OID);
 		result = (Expr*) makeFuncExpr(F_INT4ABS,
@@ -2005,6 +2144,84 @@ static Param *makeReduceParam(Oid type, int paramid, int parammod, Oid collid)
 	return param;
 }
 
+/*
+ * Param 1 for a range or list reduce, of the type of the distribution values
+ */
+static Expr* makeReduceValueParam(const Expr *param, const Const *value)
+{
+	Oid typid = exprType((Node*)param);
+	Expr *expr;
+
+	expr = (Expr*)makeReduceParam(typid,
+								  1,
+								  exprTypmod((Node*)param),
+								  exprCollation((Node*)param));
+	if(typid != value->consttype)
+	{
+		expr = (Expr*)coerce_to_target_type(NULL,
+											(Node*)expr,
+											typid,
+											value->consttype,
+											-1,
+											COERCION_EXPLICIT,
+											COERCE_IMPLICIT_CAST,
+											-1);
+		if(expr == NULL)
+			ereport(ERROR,
+					(errcode(ERRCODE_CANNOT_COERCE),
+					 errmsg("cannot cast type %s to %s",
+							format_type_be(typid),
+							format_type_be(value->consttype))));
+	}
+
+	return expr;
+}
+
+/*
+ * array of the distribution values, a List of Const
+ */
+static Const* makeReduceValueArray(const List *values)
+{
+	const Const *first = linitial(values);
+	const ListCell *lc;
+	ArrayType *array;
+	Datum *datums;
+	Oid arraytype;
+	int16 typlen;
+	bool typbyval;
+	char typalign;
+	int i;
+
+	arraytype = get_array_type(first->consttype);
+	if(!OidIsValid(arraytype))
+	{
+		ereport(ERROR,
+				(errcode(ERRCODE_UNDEFINED_OBJECT),
+				 errmsg("could not find array type for data type %s",
+						format_type_be(first->consttype))));
+	}
+	get_typlenbyvalalign(first->consttype, &typlen, &typbyval, &typalign);
+
+	datums = palloc(sizeof(Datum) * list_length(values));
+	i = 0;
+	foreach(lc, values)
+	{
+		const Const *c = lfirst(lc);
+		Assert(IsA(c, Const) && !c->constisnull);
+		datums[i++] = c->constvalue;
+	}
+	array = construct_array(datums, i, first->consttype, typlen, typbyval, typalign);
+	pfree(datums);
+
+	return makeConst(arraytype,
+					 -1,
+					 InvalidOid,
+					 -1,
+					 PointerGetDatum(array),
+					 false,
+					 false);
+}
+
 static oidvector *makeOidVector(List *list)
 {
 	oidvector *oids;
@@ -14,6 +14,7 @@
  */
 #include "postgres.h"
 
+#include "access/nbtree.h"
 #include "access/sysattr.h"
 #include "catalog/pg_operator.h"
 #include "catalog/pg_type.h"
@@ -28,10 +29,13 @@
 #include "optimizer/reduceinfo.h"
 #include "parser/parse_coerce.h"
 #include "pgxc/locator.h"
+#include "pgxc/noderange.h"
 #include "utils/array.h"
 #include "utils/fmgroids.h"
 #include "utils/lsyscache.h"
 #include "utils/memutils.h"
+#include "utils/snapmgr.h"
+#include "utils/typcache.h"
 
 typedef struct ModifyContext
 {
@@ -50,12 +54,18 @@ static Expr* makeInt4EQ(Expr *l, Expr *r);
 static Expr* makeInt4ArrayIn(Expr *l, Datum *values, int count);
 static Expr* makeInt4Const(int32 val);
 static Expr* makeNotNullTest(Expr *expr, bool isrow);
+static Expr* makeNullTest(Expr *expr);
+static List* makeNodeRangeConstraints(NodeRangeColumn *column, Oid node_oid, Oid reloid, Index varno);
+static Expr* makeDistValueOpClause(int strategy, Expr *var, Const *value);
+static List* makeRangeOrListConstraints(RelationLocInfo *loc_info, int nodepos, Index varno);
 static Expr* makePartitionExpr(RelationLocInfo *loc_info, Node *node);
 static List* make_new_qual_list(ModifyContext *context, Node *quals, bool need_eval_const);
 static Node* mutator_equal_expr(Node *node, ModifyContext *context);
 static void init_context_expr_if_need(ModifyContext *context);
 static Const* get_var_equal_const(List *args, Oid opno, Index relid, AttrNumber attno, Var **var);
 static Const* is_const_able_expr(Expr *expr);
+static Expr* makeMultiHashEqualExpr(RelationLocInfo *loc_info, Index varno, List *clauses, Expr *partition_expr);
+static Const* find_var_equal_const(List *clauses, Index varno, AttrNumber attno);
 
 /* return remote oid list */
 List *relation_remote_by_constraints(PlannerInfo *root, RelOptInfo *rel)
@@ -78,6 +88,10 @@ List *relation_remote_by_constraints_base(PlannerInfo *root, Node *quals, Relati
 	List		   *temp_constraints;
 	List		   *new_clauses;
 	List		   *null_test_list;
+	List		   *node_ranges;
+	uint32			node_ranges_stamp = 0;
+	bool			node_ranges_used;
+	Expr		   *multi_hash_expr;
 	ListCell	   *lc;
 	int				i;
 
@@ -108,6 +122,7 @@ List *relation_remote_by_constraints_base(PlannerInfo *root, Node *quals, Relati
 
 	context.relid = varno;
 	null_test_list = NIL;
+	multi_hash_expr = NULL;
 	if (loc_info->locatorType == LOCATOR_TYPE_USER_DEFINED)
 	{
 		if(list_length(loc_info->funcAttrNums) == 1)
@@ -123,6 +138,16 @@ List *relation_remote_by_constraints_base(PlannerInfo *root, Node *quals, Relati
 										 makeNotNullTest((Expr*)makeVarByRel(lfirst_int(lc), loc_info->relid, varno), false));
 			}
 		}
+	}else if (IsRelationDistributedByMultiHash(loc_info))
+	{
+		List *vars = NIL;
+		foreach(lc, loc_info->funcAttrNums)
+		{
+			Expr *var = (Expr*)makeVarByRel(lfirst_int(lc), loc_info->relid, varno);
+			vars = lappend(vars, var);
+			null_test_list = lappend(null_test_list, makeNotNullTest(var, false));
+		}
+		multi_hash_expr = makePartitionExpr(loc_info, (Node*)vars);
 	}else if(IsLocatorDistributedByValue(loc_info->locatorType))
 	{
 		context.varattno = loc_info->partAttrNum;
@@ -144,6 +169,26 @@ List *relation_remote_by_constraints_base(PlannerInfo *root, Node *quals, Relati
 							   makeNotNullTest((Expr*)makeVarByRel(XC_NodeIdAttributeNumber, loc_info->relid, varno), false));
 
 	new_clauses = make_new_qual_list(&context, quals, root == NULL);
+	if (multi_hash_expr)
+	{
+		Expr *expr = makeMultiHashEqualExpr(loc_info, varno, new_clauses, multi_hash_expr);
+		if (expr)
+			new_clauses = lappend(new_clauses, expr);
+		context.partition_expr = multi_hash_expr;
+	}
+
+	/* value ranges of columns on each node, see noderange.c */
+	node_ranges = NIL;
+	node_ranges_used = false;
+	foreach(lc, NodeRangeGetColumns(loc_info->relid,
+									ActiveSnapshotSet() ? GetActiveSnapshot() : NULL,
+									&node_ranges_stamp))
+	{
+		NodeRangeColumn *column = lfirst(lc);
+
+		if (get_atttype(loc_info->relid, column->attnum) == column->typid)
+			node_ranges = lappend(node_ranges, column);
+	}
 
 	i=0;
 	result = NIL;
@@ -151,6 +196,7 @@ List *relation_remote_by_constraints_base(PlannerInfo *root, Node *quals, Relati
 	{
 		Expr *expr;
 		Oid node_oid = lfirst_oid(lc);
+		bool refuted;
 		MemoryContextSwitchTo(temp_mctx);
 		MemoryContextResetAndDeleteChildren(temp_mctx);
 		temp_constraints = list_copy(safe_constraints);
@@ -174,7 +220,30 @@ List *relation_remote_by_constraints_base(PlannerInfo *root, Node *quals, Relati
 			temp_constraints = lappend(temp_constraints, expr);
 		}
 
-		if (predicate_refuted_by(temp_constraints, new_clauses) == false)
+		if (IsRelationDistributedByRangeOrList(loc_info))
+			temp_constraints = list_concat(temp_constraints,
+										   makeRangeOrListConstraints(loc_info, i, varno));
+
+		/*
+		 * The ranges are only tried if needed, a plan which relies on them
+		 * is checked again when it starts, see NodeRangeCheckPlan().
+		 */
+		refuted = predicate_refuted_by(temp_constraints, new_clauses);
+		if (!refuted && node_ranges)
+		{
+			ListCell *lc2;
+			foreach(lc2, node_ranges)
+				temp_constraints = list_concat(temp_constraints,
+											   makeNodeRangeConstraints(lfirst(lc2),
+																		node_oid,
+																		loc_info->relid,
+																		varno));
+			refuted = predicate_refuted_by(temp_constraints, new_clauses);
+			if (refuted)
+				node_ranges_used = true;
+		}
+
+		if (!refuted)
 		{
 			MemoryContextSwitchTo(old_mctx);
 			result = lappend_oid(result, node_oid);
@@ -192,6 +261,10 @@ List *relation_remote_by_constraints_base(PlannerInfo *root, Node *quals, Relati
 
 	MemoryContextSwitchTo(old_mctx);
 	MemoryContextDelete(main_mctx);
+
+	if (node_ranges_used)
+		NodeRangeNotePruned(loc_info->relid, node_ranges_stamp);
+
 	return result;
 }
 
@@ -246,6 +319,181 @@ static Expr* makeInt4Const(int32 val)
 							true);
 }
 
+static Expr* makeNullTest(Expr *expr)
+{
+	NullTest *null_test = makeNode(NullTest);
+
+	null_test->arg = expr;
+	null_test->nulltesttype = IS_NULL;
+	null_test->argisrow = false;
+	null_test->location = -1;
+
+	return (Expr*)null_test;
+}
+
+/*
+ * make the constraints the values of a column on one node satisfy,
+ * or NIL when the node did not report the column
+ */
+static List* makeNodeRangeConstraints(NodeRangeColumn *column, Oid node_oid, Oid reloid, Index varno)
+{
+	NodeRangeBound *bound = NULL;
+	TypeCacheEntry *typentry;
+	Expr *var;
+	Expr *range;
+	Oid opintype;
+	Oid ge_opno;
+	Oid le_opno;
+	int i;
+
+	for (i = 0; i < column->nbounds; i++)
+	{
+		if (column->bounds[i].nodeoid == node_oid)
+		{
+			bound = &column->bounds[i];
+			break;
+		}
+	}
+	if (bound == NULL)
+		return NIL;
+
+	var = (Expr*)makeVarByRel(column->attnum, reloid, varno);
+	if (!bound->hasvalues)
+	{
+		/* no row on the node has a value in the column */
+		if (bound->hasnulls)
+			return list_make1(makeNullTest(var));
+		return list_make2(makeNullTest(var), makeNotNullTest(var, false));
+	}
+
+	typentry = lookup_type_cache(column->typid, TYPECACHE_BTREE_OPFAMILY);
+	if (!OidIsValid(typentry->btree_opf))
+		return NIL;
+	opintype = typentry->btree_opintype;
+	ge_opno = get_opfamily_member(typentry->btree_opf, opintype, opintype,
+								  BTGreaterEqualStrategyNumber);
+	le_opno = get_opfamily_member(typentry->btree_opf, opintype, opintype,
+								  BTLessEqualStrategyNumber);
+	if (!OidIsValid(ge_opno) || !OidIsValid(le_opno))
+		return NIL;
+
+	if (opintype != column->typid)
+		var = (Expr*)makeRelabelType(var, opintype, -1, InvalidOid, COERCE_IMPLICIT_CAST);
+
+	range = make_andclause(list_make2(
+		make_opclause(ge_opno, BOOLOID, false, var,
+					  (Expr*)makeConst(opintype, -1, InvalidOid, get_typlen(opintype),
+									   bound->minval, false, true),
+					  InvalidOid, InvalidOid),
+		make_opclause(le_opno, BOOLOID, false, var,
+					  (Expr*)makeConst(opintype, -1, InvalidOid, get_typlen(opintype),
+									   bound->maxval, false, true),
+					  InvalidOid, InvalidOid)));
+	if (bound->hasnulls)
+		range = make_orclause(list_make2(range, makeNullTest(var)));
+
+	return list_make1(range);
+}
+
+/*
+ * make "var op value" using the btree operator of the given strategy
+ */
+static Expr* makeDistValueOpClause(int strategy, Expr *var, Const *value)
+{
+	TypeCacheEntry *typentry;
+	Const *c;
+	Oid opintype;
+	Oid opno;
+
+	typentry = lookup_type_cache(value->consttype, TYPECACHE_BTREE_OPFAMILY);
+	if (!OidIsValid(typentry->btree_opf))
+		return NULL;
+	opintype = typentry->btree_opintype;
+	opno = get_opfamily_member(typentry->btree_opf, opintype, opintype, strategy);
+	if (!OidIsValid(opno))
+		return NULL;
+
+	c = (Const*)copyObject(value);
+	if (opintype != value->consttype)
+	{
+		var = (Expr*)makeRelabelType(var, opintype, -1, value->constcollid, COERCE_IMPLICIT_CAST);
+		c->consttype = opintype;
+	}
+
+	return make_opclause(opno, BOOLOID, false, var, (Expr*)c,
+						 InvalidOid, value->constcollid);
+}
+
+/*
+ * make the constraints the distribution column satisfies on the node at
+ * nodepos of a table distributed by range or list, see GetRangeOrListNodePos
+ */
+static List* makeRangeOrListConstraints(RelationLocInfo *loc_info, int nodepos, Index varno)
+{
+	Expr *var = (Expr*)makeVarByRel(loc_info->partAttrNum, loc_info->relid, varno);
+	List *args = NIL;
+	Expr *expr;
+	ListCell *lc;
+	int i;
+
+	if (loc_info->locatorType == LOCATOR_TYPE_RANGE)
+	{
+		/* lower bound, col >= bound(nodepos-1) */
+		if (nodepos > 0)
+		{
+			expr = makeDistValueOpClause(BTGreaterEqualStrategyNumber, var,
+										 list_nth(loc_info->distValues, nodepos-1));
+			if (expr == NULL)
+				return NIL;
+			args = lappend(args, expr);
+		}
+
+		/* upper bound, col < bound(nodepos) */
+		if (nodepos < list_length(loc_info->distValues))
+		{
+			expr = makeDistValueOpClause(BTLessStrategyNumber, var,
+										 list_nth(loc_info->distValues, nodepos));
+			if (expr == NULL)
+				return NIL;
+			if (nodepos == 0)
+				expr = make_orclause(list_make2(expr, makeNullTest(var)));
+			args = lappend(args, expr);
+		}
+
+		return args;
+	}
+
+	Assert(loc_info->locatorType == LOCATOR_TYPE_LIST);
+
+	/* values listed for the node, or for other nodes when the default */
+	i = 0;
+	foreach(lc, loc_info->distValues)
+	{
+		ListCell *lc2;
+		bool own = (i++ == nodepos);
+
+		if (nodepos > 0 ? !own : own)
+			continue;
+		foreach(lc2, (List*)lfirst(lc))
+		{
+			expr = makeDistValueOpClause(BTEqualStrategyNumber, var, lfirst(lc2));
+			if (expr == NULL)
+				return NIL;
+			args = lappend(args, expr);
+		}
+	}
+
+	if (nodepos > 0)
+		return list_make1(list_length(args) == 1 ? linitial(args) : make_orclause(args));
+
+	/* the first node has nulls and values not listed by other nodes */
+	if (args == NIL)
+		return NIL;
+	expr = list_length(args) == 1 ? linitial(args) : make_orclause(args);
+	return list_make1(make_orclause(list_make2(makeNullTest(var),
+											   make_notclause(expr))));
+}
+
 static Expr* makeNotNullTest(Expr *expr, bool isrow)
 {
 	NullTest *null_test = makeNode(NullTest);
@@ -266,7 +514,10 @@ static Expr* makePartitionExpr(RelationLocInfo *loc_info, Node *node)
 	switch(loc_info->locatorType)
 	{
 	case LOCATOR_TYPE_HASH:
-		expr = makeHashExpr((Expr*)node);
+		if (IsA(node, List))
+			expr = makeHashExprList((List*)node);	/* multi-column hash */
+		else
+			expr = makeHashExpr((Expr*)node);
 		break;
 	case LOCATOR_TYPE_MODULO:
 		expr = (Expr*)node;
@@ -582,6 +833,86 @@ static Const* is_const_able_expr(Expr *expr)
 	return IsA(expr, Const) ? (Const*)expr:NULL;
 }
 
+/*
+ * when each column of a multi-column hash key equals a constant,
+ * return partition_expr = node index of those values
+ */
+static Expr* makeMultiHashEqualExpr(RelationLocInfo *loc_info, Index varno, List *clauses, Expr *partition_expr)
+{
+	ListCell *lc;
+	Datum *values;
+	Oid *types;
+	int nkeys;
+	int i;
+	int modulo;
+
+	nkeys = list_length(loc_info->funcAttrNums);
+	values = palloc(sizeof(Datum) * nkeys);
+	types = palloc(sizeof(Oid) * nkeys);
+	i = 0;
+	foreach(lc, loc_info->funcAttrNums)
+	{
+		Const *c = find_var_equal_const(clauses, varno, lfirst_int(lc));
+		if (c == NULL || c->constisnull)
+			return NULL;
+		values[i] = c->constvalue;
+		types[i] = c->consttype;
+		++i;
+	}
+
+	modulo = execModuloValue(Int32GetDatum(execHashValues(nkeys, values, types)),
+							 INT4OID,
+							 list_length(loc_info->nodeids));
+	return makeInt4EQ(partition_expr, makeInt4Const(modulo));
+}
+
+/* find "column = constant" in ANDed clauses, constant converted to column type */
+static Const* find_var_equal_const(List *clauses, Index varno, AttrNumber attno)
+{
+	ListCell *lc;
+	Node *clause;
+	Node *convert;
+	Const *c;
+	Var *var;
+
+	foreach(lc, clauses)
+	{
+		clause = lfirst(lc);
+		if (and_clause(clause))
+		{
+			c = find_var_equal_const(((BoolExpr*)clause)->args, varno, attno);
+			if (c)
+				return c;
+			continue;
+		}
+		if (!IsA(clause, OpExpr))
+			continue;
+
+		c = get_var_equal_const(((OpExpr*)clause)->args,
+								((OpExpr*)clause)->opno,
+								varno,
+								attno,
+								&var);
+		if (c == NULL)
+			continue;
+
+		convert = coerce_to_target_type(NULL,
+										(Node*)c,
+										exprType((Node*)c),
+										var->vartype,
+										var->vartypmod,
+										COERCION_EXPLICIT,
+										COERCE_IMPLICIT_CAST,
+										-1);
+		if (convert)
+			convert = eval_const_expressions(NULL, convert);
+		if (convert && IsA(convert, Const))
+			return (Const*)convert;
+	}
+
+	return NULL;
+}
+
 static void init_context_expr_if_need(ModifyContext *context)
 {
 	if (context->const_expr == NULL)
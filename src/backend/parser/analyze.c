@@ -62,6 +62,7 @@
 #include "pgxc/poolmgr.h"
 #include "catalog/pgxc_node.h"
 #include "pgxc/xc_maintenance_mode.h"
+#include "pgxc/noderange.h"
 #include "access/xact.h"
 #endif
 
@@ -2868,6 +2869,11 @@ transformExecDirectStmt(ParseState *pstate, ExecDirectStmt *stmt)
 				 errmsg("EXECUTE DIRECT cannot execute locally this utility query")));
 	}
 
+	/* what it writes on the datanode does not show on the coordinator */
+	if (nodetype == PGXC_NODE_DATANODE && !is_local &&
+		step->exec_direct_type != EXEC_DIRECT_SELECT)
+		NodeRangeNoteWriteAll();
+
 	/* Build Execute Node list, there is a unique node for the time being */
 	step->exec_nodes->nodeList = lappend_int(step->exec_nodes->nodeList, nodeIndex);
 	step->exec_nodes->nodeids = lappend_oid(step->exec_nodes->nodeids, nodeoid);
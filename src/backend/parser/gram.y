@@ -2441,7 +2441,7 @@ alter_table_cmd:
 					n->def = (Node *)$1;
 					$$ = (Node *)n;
 				}
-			/* ALTER TABLE <name> TO [ NODE (nodelist) | GROUP groupname ] */
+			/* ALTER TABLE <name> TO [ NODE (nodelist) | GROUP groupname ] or COLOCATE WITH table */
 			| OptSubClusterInternal
 				{
 					AlterTableCmd *n = makeNode(AlterTableCmd);
@@ -3653,6 +3653,18 @@ OptSubClusterInternal:
 					n->members = list_make1(makeString($3));
 					$$ = n;
 				}
+			| IDENT WITH any_name
+				{
+					PGXCSubCluster *n = makeNode(PGXCSubCluster);
+					if (strcmp($1, "colocate") != 0)
+						ereport(ERROR,
+								(errcode(ERRCODE_SYNTAX_ERROR),
+								 errmsg("syntax error at or near \"%s\"", $1),
+								 parser_errposition(@1)));
+					n->clustertype = SUBCLUSTER_COLOCATE;
+					n->members = $3;
+					$$ = n;
+				}
 		;
 /* ADB_END */
 
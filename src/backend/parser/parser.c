@@ -1671,14 +1671,21 @@ void transformDistributeBy(DistributeBy *dbstmt)
 		char *fname = strVal(linitial(funcname));
 		if (strcasecmp(fname, "HASH") == 0)
 		{
-			if (list_length(funcargs) != 1 ||
-				IsA(argnode, ColumnRef) == false ||
-				list_length(((ColumnRef *)argnode)->fields) != 1)
-				ereport(ERROR,
-						(errcode(ERRCODE_SYNTAX_ERROR),
-						 errmsg("Invalid distribution column specified for \"HASH\""),
-						 errhint("Valid syntax input: HASH(column)")));
+			ListCell *lc;
 
+			/* one column, or several hashed together, kept in funcargs */
+			foreach (lc, funcargs)
+			{
+				argnode = lfirst(lc);
+				if (IsA(argnode, ColumnRef) == false ||
+					list_length(((ColumnRef *)argnode)->fields) != 1)
+					ereport(ERROR,
+							(errcode(ERRCODE_SYNTAX_ERROR),
+							 errmsg("Invalid distribution column specified for \"HASH\""),
+							 errhint("Valid syntax input: HASH(column [, ...])")));
+			}
+
+			argnode = linitial(funcargs);
 			dbstmt->disttype = DISTTYPE_HASH;
 			dbstmt->colname = strVal(linitial(((ColumnRef *)argnode)->fields));
 		} else if (strcasecmp(fname, "MODULO") == 0)
@@ -1693,6 +1700,36 @@ void transformDistributeBy(DistributeBy *dbstmt)
 
 			dbstmt->disttype = DISTTYPE_MODULO;
 			dbstmt->colname = strVal(linitial(((ColumnRef *)argnode)->fields));
+		} else if (strcasecmp(fname, "RANGE") == 0)
+		{
+			/* the column, then the lower bound of every node but the first */
+			if (list_length(funcargs) < 2 ||
+				IsA(argnode, ColumnRef) == false ||
+				list_length(((ColumnRef *)argnode)->fields) != 1)
+				ereport(ERROR,
+						(errcode(ERRCODE_SYNTAX_ERROR),
+						 errmsg("Invalid distribution column specified for \"RANGE\""),
+						 errhint("Valid syntax input: RANGE(column, bound [, ...])")));
+
+			dbstmt->disttype = DISTTYPE_RANGE;
+			dbstmt->colname = strVal(linitial(((ColumnRef *)argnode)->fields));
+			dbstmt->funcname = NIL;
+			dbstmt->funcargs = list_copy_tail(funcargs, 1);
+		} else if (strcasecmp(fname, "LIST") == 0)
+		{
+			/* the column, then the value or array of values of each node */
+			if (list_length(funcargs) < 2 ||
+				IsA(argnode, ColumnRef) == false ||
+				list_length(((ColumnRef *)argnode)->fields) != 1)
+				ereport(ERROR,
+						(errcode(ERRCODE_SYNTAX_ERROR),
+						 errmsg("Invalid distribution column specified for \"LIST\""),
+						 errhint("Valid syntax input: LIST(column, values [, ...])")));
+
+			dbstmt->disttype = DISTTYPE_LIST;
+			dbstmt->colname = strVal(linitial(((ColumnRef *)argnode)->fields));
+			dbstmt->funcname = NIL;
+			dbstmt->funcargs = list_copy_tail(funcargs, 1);
 		} else
 		{
 			/*
@@ -25,6 +25,8 @@
 #include "utils/rel.h"
 #include "utils/lsyscache.h"
 
+static void RemoteCopyAppendOption(StringInfo query_buf, int options_start,
+								   const char *option);
 static void RemoteCopyQuoteStr(StringInfo query_buf, char *value);
 
 void
@@ -158,6 +160,7 @@ RemoteCopyBuildStatement(RemoteCopyState *state,
 						 List *attnums)
 {
 	int			attnum;
+	int			options_start;
 	TupleDesc	tupDesc = RelationGetDescr(rel);
 
 	/*
@@ -229,19 +232,24 @@ RemoteCopyBuildStatement(RemoteCopyState *state,
 		appendStringInfoString(&state->query_buf, " FROM STDIN");
 	else
 		appendStringInfoString(&state->query_buf, " TO STDOUT");
+	options_start = state->query_buf.len;
 
+	/*
+	 * Options go in the generic syntax, which is the only one taking the
+	 * options this cluster adds.
+	 */
 	if (options->rco_binary)
-		appendStringInfoString(&state->query_buf, " BINARY");
+		RemoteCopyAppendOption(&state->query_buf, options_start, "FORMAT binary");
 
 	if (options->rco_oids)
-		appendStringInfoString(&state->query_buf, " OIDS");
+		RemoteCopyAppendOption(&state->query_buf, options_start, "OIDS");
 
 	if (options->rco_delim)
 	{
 		if ((!options->rco_csv_mode && options->rco_delim[0] != '\t')
 			|| (options->rco_csv_mode && options->rco_delim[0] != ','))
 		{
-			appendStringInfoString(&state->query_buf, " DELIMITER AS ");
+			RemoteCopyAppendOption(&state->query_buf, options_start, "DELIMITER ");
 			RemoteCopyQuoteStr(&state->query_buf, options->rco_delim);
 		}
 	}
@@ -251,13 +259,13 @@ RemoteCopyBuildStatement(RemoteCopyState *state,
 		if ((!options->rco_csv_mode && strcmp(options->rco_null_print, "\\N"))
 			|| (options->rco_csv_mode && strcmp(options->rco_null_print, "")))
 		{
-			appendStringInfoString(&state->query_buf, " NULL AS ");
+			RemoteCopyAppendOption(&state->query_buf, options_start, "NULL ");
 			RemoteCopyQuoteStr(&state->query_buf, options->rco_null_print);
 		}
 	}
 
 	if (options->rco_csv_mode)
-		appendStringInfoString(&state->query_buf, " CSV");
+		RemoteCopyAppendOption(&state->query_buf, options_start, "FORMAT csv");
 
 	/*
 	 * It is not necessary to send the HEADER part to Datanodes.
@@ -265,13 +273,13 @@ RemoteCopyBuildStatement(RemoteCopyState *state,
 	 */
 	if (options->rco_quote && options->rco_quote[0] != '"')
 	{
-		appendStringInfoString(&state->query_buf, " QUOTE AS ");
+		RemoteCopyAppendOption(&state->query_buf, options_start, "QUOTE ");
 		RemoteCopyQuoteStr(&state->query_buf, options->rco_quote);
 	}
 
 	if (options->rco_escape && options->rco_quote && options->rco_escape[0] != options->rco_quote[0])
 	{
-		appendStringInfoString(&state->query_buf, " ESCAPE AS ");
+		RemoteCopyAppendOption(&state->query_buf, options_start, "ESCAPE ");
 		RemoteCopyQuoteStr(&state->query_buf, options->rco_escape);
 	}
 
@@ -279,7 +287,7 @@ RemoteCopyBuildStatement(RemoteCopyState *state,
 	{
 		ListCell *cell;
 		ListCell *prev = NULL;
-		appendStringInfoString(&state->query_buf, " FORCE QUOTE ");
+		RemoteCopyAppendOption(&state->query_buf, options_start, "FORCE_QUOTE (");
 		foreach (cell, options->rco_force_quote)
 		{
 			if (prev)
@@ -288,13 +296,14 @@ RemoteCopyBuildStatement(RemoteCopyState *state,
 								   quote_identifier(strVal(lfirst(cell))));
 			prev = cell;
 		}
+		appendStringInfoChar(&state->query_buf, ')');
 	}
 
 	if (options->rco_force_notnull)
 	{
 		ListCell *cell;
 		ListCell *prev = NULL;
-		appendStringInfoString(&state->query_buf, " FORCE NOT NULL ");
+		RemoteCopyAppendOption(&state->query_buf, options_start, "FORCE_NOT_NULL (");
 		foreach (cell, options->rco_force_notnull)
 		{
 			if (prev)
@@ -303,7 +312,30 @@ RemoteCopyBuildStatement(RemoteCopyState *state,
 								   quote_identifier(strVal(lfirst(cell))));
 			prev = cell;
 		}
+		appendStringInfoChar(&state->query_buf, ')');
 	}
+
+	if (options->rco_bulk_load)
+		RemoteCopyAppendOption(&state->query_buf, options_start, "BULK_LOAD");
+
+	if (state->query_buf.len > options_start)
+		appendStringInfoChar(&state->query_buf, ')');
+}
+
+/*
+ * RemoteCopyAppendOption
+ * Append "option" to the option list of the COPY query being built,
+ * which starts at "options_start", opening the list on first use.
+ */
+static void
+RemoteCopyAppendOption(StringInfo query_buf, int options_start,
+					   const char *option)
+{
+	if (query_buf->len == options_start)
+		appendStringInfoString(query_buf, " WITH (");
+	else
+		appendStringInfoString(query_buf, ", ");
+	appendStringInfoString(query_buf, option);
 }
 
 
@@ -323,6 +355,7 @@ makeRemoteCopyOptions(void)
 	res->rco_escape = NULL;
 	res->rco_force_quote = NIL;
 	res->rco_force_notnull = NIL;
+	res->rco_bulk_load = false;
 	return res;
 }
 
@@ -171,6 +171,40 @@ get_nodeid_from_modulo(int modulo, List *nodeids)
 }
 
 
+/*
+ * GetDistKeyCount - number of values locating a row of a hash or modulo
+ * table, one for each column of a multi-column hash
+ */
+static int
+GetDistKeyCount(RelationLocInfo *rel_loc_info)
+{
+	if (IsRelationDistributedByMultiHash(rel_loc_info))
+		return list_length(rel_loc_info->funcAttrNums);
+	return 1;
+}
+
+/*
+ * HasNullDistValue - whether a value locating a row of a hash or modulo
+ * table is null or not given, so that the row can not be located
+ */
+static bool
+HasNullDistValue(RelationLocInfo *rel_loc_info, int nelems, bool *dist_col_nulls)
+{
+	int		nkeys = GetDistKeyCount(rel_loc_info);
+	int		i;
+
+	if (nelems < nkeys)
+		return true;
+
+	for (i = 0; i < nkeys; i++)
+	{
+		if (dist_col_nulls[i])
+			return true;
+	}
+
+	return false;
+}
+
 /*
  * GetRelationDistribColumn
  * Return hash column name for relation or NULL if relation is not distributed.
@@ -200,7 +234,8 @@ GetRelationDistribColumnList(RelationLocInfo *locInfo)
 	if (!locInfo)
 		return NIL;
 
-	if (!IsRelationDistributedByUserDefined(locInfo))
+	if (!IsRelationDistributedByUserDefined(locInfo) &&
+		!IsRelationDistributedByMultiHash(locInfo))
 		return NIL;
 
 	foreach (lc, locInfo->funcAttrNums)
@@ -240,11 +275,13 @@ IsDistribColumn(Oid relid, AttrNumber attNum)
 	if (!locInfo)
 		return false;
 
-	if (IsRelationDistributedByValue(locInfo))
+	if (IsRelationDistributedByValue(locInfo) &&
+		!IsRelationDistributedByMultiHash(locInfo))
 	{
 		return locInfo->partAttrNum == attNum;
 	} else
-	if (IsRelationDistributedByUserDefined(locInfo))
+	if (IsRelationDistributedByUserDefined(locInfo) ||
+		IsRelationDistributedByMultiHash(locInfo))
 	{
 		if (list_member_int(locInfo->funcAttrNums, (int)attNum))
 			return true;
@@ -265,6 +302,107 @@ IsTypeDistributable(Oid col_type)
 	return OidIsValid(typeCache->hash_proc);
 }
 
+/*
+ * GetRangeOrListNodePos
+ * Return the position in the node list of the node which stores a non-null
+ * value of the distribution column of a table distributed by range or list.
+ *
+ * Node i of a range table stores the values from its lower bound, the
+ * (i-1)th of distValues, up to the next one.  The first node stores values
+ * below all bounds, and the values not listed by any node of a list table.
+ */
+int
+GetRangeOrListNodePos(RelationLocInfo *rel_loc_info, Datum value, Oid valuetype)
+{
+	Const		   *first;
+	TypeCacheEntry *typentry;
+	ListCell	   *lc;
+	int				pos;
+
+	Assert(IsRelationDistributedByRangeOrList(rel_loc_info));
+	Assert(rel_loc_info->distValues != NIL);
+
+	first = linitial(rel_loc_info->distValues);
+	if (IsA(first, List))
+		first = linitial((List *) first);
+	Assert(IsA(first, Const));
+
+	/* Coerce value if it is not of the column type, see CoerceUserDefinedFuncArgs */
+	if (OidIsValid(valuetype) && valuetype != first->consttype)
+	{
+		Oid		typinput, typioparam;
+		Oid		typoutput;
+		bool	typisvarlena;
+
+		getTypeOutputInfo(valuetype, &typoutput, &typisvarlena);
+		getTypeInputInfo(first->consttype, &typinput, &typioparam);
+		value = OidInputFunctionCall(typinput,
+									 OidOutputFunctionCall(typoutput, value),
+									 typioparam,
+									 first->consttypmod);
+	}
+
+	if (rel_loc_info->locatorType == LOCATOR_TYPE_RANGE)
+	{
+		int		lo, hi;
+
+		typentry = lookup_type_cache(first->consttype, TYPECACHE_CMP_PROC_FINFO);
+		if (!OidIsValid(typentry->cmp_proc_finfo.fn_oid))
+			ereport(ERROR,
+					(errcode(ERRCODE_UNDEFINED_FUNCTION),
+					 errmsg("could not identify a comparison function for type %s",
+							format_type_be(first->consttype))));
+
+		/* binary search for the number of bounds not above value */
+		lo = 0;
+		hi = list_length(rel_loc_info->distValues);
+		while (lo < hi)
+		{
+			int		mid = (lo + hi) / 2;
+			Const  *bound = list_nth(rel_loc_info->distValues, mid);
+			int32	cmp;
+
+			cmp = DatumGetInt32(FunctionCall2Coll(&typentry->cmp_proc_finfo,
+												  bound->constcollid,
+												  bound->constvalue,
+												  value));
+			if (cmp <= 0)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		return lo;
+	}
+
+	typentry = lookup_type_cache(first->consttype, TYPECACHE_EQ_OPR_FINFO);
+	if (!OidIsValid(typentry->eq_opr_finfo.fn_oid))
+		ereport(ERROR,
+				(errcode(ERRCODE_UNDEFINED_FUNCTION),
+				 errmsg("could not identify an equality operator for type %s",
+						format_type_be(first->consttype))));
+
+	pos = 0;
+	foreach (lc, rel_loc_info->distValues)
+	{
+		ListCell   *lc2;
+
+		foreach (lc2, (List *) lfirst(lc))
+		{
+			Const  *listed = lfirst(lc2);
+
+			if (DatumGetBool(FunctionCall2Coll(&typentry->eq_opr_finfo,
+											   listed->constcollid,
+											   listed->constvalue,
+											   value)))
+				return pos;
+		}
+		pos++;
+	}
+
+	/* not listed, the first node is the default */
+	return 0;
+}
+
 
 /*
  * GetRoundRobinNodeIdx
@@ -365,6 +503,9 @@ IsLocatorInfoEqual(RelationLocInfo *locInfo1,
 	if (!equal(locInfo1->funcAttrNums, locInfo2->funcAttrNums))
 		return false;
 
+	if (!equal(locInfo1->distValues, locInfo2->distValues))
+		return false;
+
 	/* Everything is equal */
 	return true;
 }
@@ -381,6 +522,7 @@ ExecNodes *MakeExecNodesByOids(RelationLocInfo *loc_info, List *oids, RelationAc
 	exec_nodes->baselocatortype = loc_info->locatorType;
 	exec_nodes->en_relid = loc_info->relid;
 	exec_nodes->en_funcid = loc_info->funcid;
+	exec_nodes->en_colocation = loc_info->colocation;
 	exec_nodes->nodeids = oids;
 	foreach(lc, oids)
 	{
@@ -427,6 +569,7 @@ GetRelationNodes(RelationLocInfo *rel_loc_info,
 	exec_nodes = makeNode(ExecNodes);
 	exec_nodes->baselocatortype = rel_loc_info->locatorType;
 	exec_nodes->accesstype = accessType;
+	exec_nodes->en_colocation = rel_loc_info->colocation;
 
 	switch (rel_loc_info->locatorType)
 	{
@@ -462,7 +605,7 @@ GetRelationNodes(RelationLocInfo *rel_loc_info,
 		case LOCATOR_TYPE_HASH:
 		case LOCATOR_TYPE_MODULO:
 			{
-				if(dist_col_nulls[0])
+				if(HasNullDistValue(rel_loc_info, nelems, dist_col_nulls))
 				{
 					if(accessType == RELATION_ACCESS_INSERT)
 					{
@@ -478,9 +621,9 @@ GetRelationNodes(RelationLocInfo *rel_loc_info,
 				{
 					if(rel_loc_info->locatorType == LOCATOR_TYPE_HASH)
 					{
-						int32 hashVal = execHashValue(dist_col_values[0],
-											  dist_col_types[0],
-											  InvalidOid);
+						int32 hashVal = execHashValues(GetDistKeyCount(rel_loc_info),
+													   dist_col_values,
+													   dist_col_types);
 						modulo = execModuloValue(Int32GetDatum(hashVal),
 												 INT4OID,
 												 list_length(rel_loc_info->nodeList));
@@ -575,7 +718,33 @@ GetRelationNodes(RelationLocInfo *rel_loc_info,
 			}
 			break;
 
-			/* PGXCTODO case LOCATOR_TYPE_RANGE: */
+		case LOCATOR_TYPE_RANGE:
+		case LOCATOR_TYPE_LIST:
+			{
+				if (dist_col_nulls[0])
+				{
+					if (accessType == RELATION_ACCESS_INSERT)
+					{
+						/* Insert NULL to first node*/
+						modulo = 0;
+					}else
+					{
+						exec_nodes->nodeList = list_copy(rel_loc_info->nodeList);
+						exec_nodes->nodeids = list_copy(rel_loc_info->nodeids);
+						break;
+					}
+				}else
+				{
+					modulo = GetRangeOrListNodePos(rel_loc_info,
+												   dist_col_values[0],
+												   dist_col_types[0]);
+				}
+				nodeIndex = get_nodeidx_from_modulo(modulo, rel_loc_info->nodeList);
+				exec_nodes->nodeList = list_make1_int(nodeIndex);
+				exec_nodes->nodeids = list_make1_oid(get_nodeid_from_modulo(modulo, rel_loc_info->nodeids));
+			}
+			break;
+
 			/* PGXCTODO case LOCATOR_TYPE_CUSTOM: */
 		default:
 			ereport(ERROR, (errmsg("Error: no such supported locator type: %c\n",
@@ -612,7 +781,8 @@ GetRelationNodesByQuals(Oid reloid, Index varno, Node *quals,
 	 * then check if we can reduce the Datanodes by evaluating the value by
 	 * user-defined partition function.
 	 */
-	if (IsRelationDistributedByUserDefined(rel_loc_info))
+	if (IsRelationDistributedByUserDefined(rel_loc_info) ||
+		IsRelationDistributedByMultiHash(rel_loc_info))
 		return GetRelationNodesByMultQuals(rel_loc_info,
 										   reloid,
 										   varno,
@@ -698,29 +868,41 @@ GetRelationNodesByMultQuals(RelationLocInfo *rel_loc_info,
 	ExecNodes	*nodes = NULL;
 
 	Assert(rel_loc_info);
-	Assert(IsRelationDistributedByUserDefined(rel_loc_info));
+	Assert(IsRelationDistributedByUserDefined(rel_loc_info) ||
+		   IsRelationDistributedByMultiHash(rel_loc_info));
 
-	if (!IsRelationDistributedByUserDefined(rel_loc_info))
+	if (!IsRelationDistributedByUserDefined(rel_loc_info) &&
+		!IsRelationDistributedByMultiHash(rel_loc_info))
 		return NULL;
 
 	Assert(OidIsValid(rel_loc_info->relid));
-	Assert(OidIsValid(rel_loc_info->funcid));
 	Assert(rel_loc_info->funcAttrNums);
 
 	nargs = list_length(rel_loc_info->funcAttrNums);
 	distcol_values = (Datum *)palloc0(sizeof(Datum) * nargs);
 	distcol_isnulls = (bool *)palloc0(sizeof(bool) * nargs);
 	distcol_types = (Oid *)palloc0(sizeof(Oid) * nargs);
-	(void)get_func_signature(rel_loc_info->funcid, &argtypes, &nelems);
-
-	Assert(nelems == nargs);
+	if (IsRelationDistributedByUserDefined(rel_loc_info))
+	{
+		Assert(OidIsValid(rel_loc_info->funcid));
+		(void)get_func_signature(rel_loc_info->funcid, &argtypes, &nelems);
+		Assert(nelems == nargs);
+	}
 
 	i = 0;
 	foreach (cell, rel_loc_info->funcAttrNums)
 	{
 		attnum = lfirst_int(cell);
-		disttype = argtypes[i];
-		disttypmod = -1;
+		if (argtypes)
+		{
+			disttype = argtypes[i];
+			disttypmod = -1;
+		} else
+		{
+			/* hash on several columns, values are those of the columns */
+			disttype = get_atttype(reloid, attnum);
+			disttypmod = get_atttypmod(reloid, attnum);
+		}
 		distcol_expr = pgxc_find_distcol_expr(varno, attnum, quals);
 
 		if (distcol_expr)
@@ -882,31 +1064,23 @@ GetAllCoordNodeIdx(void)
 void
 RelationBuildLocator(Relation rel)
 {
-	Relation	pcrel;
-	ScanKeyData	skey;
-	SysScanDesc	pcscan;
 	HeapTuple	htup;
 	MemoryContext	oldContext;
 	RelationLocInfo	*relationLocInfo;
 	int		j;
 	Form_pgxc_class	pgxc_class;
 
-	ScanKeyInit(&skey,
-				Anum_pgxc_class_pcrelid,
-				BTEqualStrategyNumber, F_OIDEQ,
-				ObjectIdGetDatum(RelationGetRelid(rel)));
-
-	pcrel = heap_open(PgxcClassRelationId, AccessShareLock);
-	pcscan = systable_beginscan(pcrel, PgxcClassPgxcRelIdIndexId, true,
-								NULL, 1, &skey);
-	htup = systable_getnext(pcscan);
+	/*
+	 * Go through the syscache rather than scanning pgxc_class, relcache
+	 * entries are rebuilt much more often than pgxc_class changes.
+	 */
+	htup = SearchSysCache1(PGXCCLASSRELID,
+						   ObjectIdGetDatum(RelationGetRelid(rel)));
 
 	if (!HeapTupleIsValid(htup))
 	{
 		/* Assume local relation only */
 		rel->rd_locator_info = NULL;
-		systable_endscan(pcscan);
-		heap_close(pcrel, AccessShareLock);
 		return;
 	}
 
@@ -921,6 +1095,7 @@ RelationBuildLocator(Relation rel)
 	relationLocInfo->locatorType = pgxc_class->pclocatortype;
 
 	relationLocInfo->partAttrNum = pgxc_class->pcattnum;
+	relationLocInfo->colocation = pgxc_class->pccolocation;
 	relationLocInfo->nodeList = NIL;
 	relationLocInfo->nodeids = NIL;
 
@@ -957,7 +1132,23 @@ RelationBuildLocator(Relation rel)
 
 	relationLocInfo->funcid = InvalidOid;
 	relationLocInfo->funcAttrNums = NIL;
-	if (relationLocInfo->locatorType == LOCATOR_TYPE_USER_DEFINED)
+	if (relationLocInfo->locatorType == LOCATOR_TYPE_HASH)
+	{
+		Datum attrnumsDatum;
+		bool isnull;
+		int2vector *attrnums = NULL;
+
+		/* hash on several columns */
+		attrnumsDatum = SysCacheGetAttr(PGXCCLASSRELID, htup,
+									Anum_pgxc_class_pcfuncattnums, &isnull);
+		if (!isnull)
+		{
+			attrnums = (int2vector *)DatumGetPointer(attrnumsDatum);
+			for (j = 0; j < attrnums->dim1; j++)
+				relationLocInfo->funcAttrNums = lappend_int(relationLocInfo->funcAttrNums,
+															attrnums->values[j]);
+		}
+	} else if (relationLocInfo->locatorType == LOCATOR_TYPE_USER_DEFINED)
 	{
 		Datum funcidDatum;
 		Datum attrnumsDatum;
@@ -978,8 +1169,19 @@ RelationBuildLocator(Relation rel)
 														attrnums->values[j]);
 	}
 
-	systable_endscan(pcscan);
-	heap_close(pcrel, AccessShareLock);
+	relationLocInfo->distValues = NIL;
+	if (IsLocatorDistributedByRangeOrList(relationLocInfo->locatorType))
+	{
+		Datum valuesDatum;
+		bool isnull;
+
+		valuesDatum = SysCacheGetAttr(PGXCCLASSRELID, htup,
+									  Anum_pgxc_class_pcvalues, &isnull);
+		Assert(!isnull);
+		relationLocInfo->distValues = (List *) stringToNode(TextDatumGetCString(valuesDatum));
+	}
+
+	ReleaseSysCache(htup);
 
 	MemoryContextSwitchTo(oldContext);
 }
@@ -1029,12 +1231,44 @@ CopyRelationLocInfo(RelationLocInfo *srcInfo)
 	destInfo->funcid = srcInfo->funcid;
 	if (srcInfo->funcAttrNums)
 		destInfo->funcAttrNums = list_copy(srcInfo->funcAttrNums);
+	if (srcInfo->distValues)
+		destInfo->distValues = copyObject(srcInfo->distValues);
+	destInfo->colocation = srcInfo->colocation;
 
 	/* Note: for roundrobin, we use the relcache entry */
 	return destInfo;
 }
 
 
+/*
+ * FreeDistValues
+ * Free the Consts of RelationLocInfo::distValues
+ */
+static void
+FreeDistValues(List *values)
+{
+	ListCell *lc;
+
+	foreach (lc, values)
+	{
+		Node *node = lfirst(lc);
+
+		if (IsA(node, List))
+		{
+			FreeDistValues((List *) node);
+		} else
+		{
+			Const *c = (Const *) node;
+
+			Assert(IsA(c, Const));
+			if (!c->constbyval && !c->constisnull)
+				pfree(DatumGetPointer(c->constvalue));
+			pfree(c);
+		}
+	}
+	list_free(values);
+}
+
 /*
  * FreeRelationLocInfo
  * Free RelationLocInfo struct
@@ -1047,6 +1281,7 @@ FreeRelationLocInfo(RelationLocInfo *relationLocInfo)
 		list_free(relationLocInfo->nodeList);
 		list_free(relationLocInfo->nodeids);
 		list_free(relationLocInfo->funcAttrNums);
+		FreeDistValues(relationLocInfo->distValues);
 		pfree(relationLocInfo);
 	}
 }
@@ -1216,7 +1451,7 @@ GetInvolvedNodes(RelationLocInfo *rel_loc,
 				nnodes = list_length(rel_loc->nodeids);
 				Assert(nnodes > 0);
 
-				if(dist_nulls[0])
+				if(HasNullDistValue(rel_loc, nelems, dist_nulls))
 				{
 					if(accessType == RELATION_ACCESS_INSERT)
 						modulo = 0;	/* Insert NULL to first node*/
@@ -1229,7 +1464,7 @@ GetInvolvedNodes(RelationLocInfo *rel_loc,
 				{
 					if(rel_loc->locatorType == LOCATOR_TYPE_HASH)
 					{
-						int32 hashVal = execHashValue(dist_values[0], dist_types[0], InvalidOid);
+						int32 hashVal = execHashValues(GetDistKeyCount(rel_loc), dist_values, dist_types);
 						modulo = execModuloValue(Int32GetDatum(hashVal), INT4OID, nnodes);
 					}else
 						modulo = execModuloValue(dist_values[0], dist_types[0], nnodes);
@@ -1304,7 +1539,24 @@ GetInvolvedNodes(RelationLocInfo *rel_loc,
 			}
 			break;
 
-			/* TODO case LOCATOR_TYPE_RANGE: */
+		case LOCATOR_TYPE_RANGE:
+		case LOCATOR_TYPE_LIST:
+			{
+				if (dist_nulls[0])
+				{
+					if (accessType == RELATION_ACCESS_INSERT)
+						modulo = 0;	/* Insert NULL to first node*/
+					else
+					{
+						node_list = list_copy(rel_loc->nodeids);
+						break;
+					}
+				} else
+					modulo = GetRangeOrListNodePos(rel_loc, dist_values[0], dist_types[0]);
+				node_list = list_make1_oid(list_nth_oid(rel_loc->nodeids, modulo));
+			}
+			break;
+
 			/* TODO case LOCATOR_TYPE_CUSTOM: */
 		default:
 			ereport(ERROR,
@@ -1333,7 +1585,8 @@ GetInvolvedNodesByQuals(Oid reloid, Index varno, Node *quals, RelationAccessType
 	 * then check if we can reduce the Datanodes by evaluating the value by
 	 * user-defined partition function.
 	 */
-	if (IsRelationDistributedByUserDefined(rel_loc))
+	if (IsRelationDistributedByUserDefined(rel_loc) ||
+		IsRelationDistributedByMultiHash(rel_loc))
 		return GetInvolvedNodesByMultQuals(rel_loc, varno, quals, relaccess);
 
 	/*
@@ -1409,24 +1662,36 @@ GetInvolvedNodesByMultQuals(RelationLocInfo *rel_loc, Index varno, Node *quals,
 	if (!rel_loc)
 		return NIL;
 
-	Assert(IsRelationDistributedByUserDefined(rel_loc));
+	Assert(IsRelationDistributedByUserDefined(rel_loc) ||
+		   IsRelationDistributedByMultiHash(rel_loc));
 	Assert(OidIsValid(rel_loc->relid));
-	Assert(OidIsValid(rel_loc->funcid));
 	Assert(rel_loc->funcAttrNums);
 
 	nargs = list_length(rel_loc->funcAttrNums);
 	distcol_values = (Datum *) palloc0(sizeof(Datum) * nargs);
 	distcol_isnulls = (bool *) palloc0(sizeof(bool) * nargs);
 	distcol_types = (Oid *) palloc0(sizeof(Oid) * nargs);
-	(void)get_func_signature(rel_loc->funcid, &argtypes, &nelems);
-	Assert(nelems == nargs);
+	if (IsRelationDistributedByUserDefined(rel_loc))
+	{
+		Assert(OidIsValid(rel_loc->funcid));
+		(void)get_func_signature(rel_loc->funcid, &argtypes, &nelems);
+		Assert(nelems == nargs);
+	}
 
 	i = 0;
 	foreach (cell, rel_loc->funcAttrNums)
 	{
 		attnum = lfirst_int(cell);
-		disttype = argtypes[i];
-		disttypmod = -1;
+		if (argtypes)
+		{
+			disttype = argtypes[i];
+			disttypmod = -1;
+		} else
+		{
+			/* hash on several columns, values are those of the columns */
+			disttype = get_atttype(rel_loc->relid, attnum);
+			disttypmod = get_atttypmod(rel_loc->relid, attnum);
+		}
 		distcol_expr = pgxc_find_distcol_expr(varno, attnum, quals);
 
 		if (distcol_expr)
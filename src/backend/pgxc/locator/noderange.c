@@ -0,0 +1,906 @@
+/*-------------------------------------------------------------------------
+ *
+ * noderange.c
+ *	  Coordinator-side ranges of column values stored on each datanode
+ *
+ * A table distributed by round robin, or by hash of a column the query does
+ * not restrict, has its rows on every datanode, and a query with a range
+ * qual is sent to all of them.  When the rows are loaded in order of a
+ * column (time series, sequence-generated keys) each datanode only holds a
+ * slice of its values, and BRIN minmax indexes on the datanodes already
+ * know that slice.  ANALYZE on the coordinator asks each datanode for the
+ * bounds of the columns its BRIN indexes summarize (brin_minmax_bounds())
+ * and keeps them in shared memory; the planner then adds
+ * "col >= min AND col <= max" to the constraints it refutes the quals with
+ * for each datanode (see relation_remote_by_constraints_base()), and drops
+ * the datanodes whose slice cannot match.
+ *
+ * The bounds only ever hold for the rows that existed when they were read.
+ * Once a coordinator has inserted or updated rows of a table, it records
+ * its transaction as a writer of the ranges at once, and on the other
+ * coordinators in one round trip for all the tables it wrote before the
+ * transaction commits (NodeRangePreCommit()); no other snapshot sees the
+ * rows until then.  ANALYZE stores the bounds it read only if no writer
+ * came in the meantime.  Ranges are used only for snapshots to which
+ * none of their writers is visible: the planner checks the snapshot it
+ * plans with, and since a query may run with a later snapshot, the executor
+ * checks again (NodeRangeCheckPlan()) for the tables the plan left
+ * datanodes out of.
+ *
+ * Rows written by triggers on the datanodes, or by statements sent there
+ * with EXECUTE DIRECT, do not show in the plans of the coordinator, so such
+ * statements make every table a writer of.  Sessions connected straight to
+ * a datanode bypass the cluster altogether and are not seen, which is one
+ * reason the feature is off unless node_range_pruning_tables is set.
+ *
+ * Portions Copyright (c) 2016-2017, ADB Development Group
+ *
+ * IDENTIFICATION
+ *	  src/backend/pgxc/locator/noderange.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+#include "miscadmin.h"
+
+#include "access/htup_details.h"
+#include "access/xact.h"
+#include "catalog/pg_am.h"
+#include "catalog/pg_class.h"
+#include "catalog/pg_type.h"
+#include "executor/executor.h"
+#include "intercomm/inter-comm.h"
+#include "lib/stringinfo.h"
+#include "nodes/makefuncs.h"
+#include "pgxc/execRemote.h"
+#include "pgxc/locator.h"
+#include "pgxc/nodemgr.h"
+#include "pgxc/noderange.h"
+#include "pgxc/pgxc.h"
+#include "storage/lwlock.h"
+#include "storage/proc.h"
+#include "storage/shmem.h"
+#include "utils/builtins.h"
+#include "utils/hsearch.h"
+#include "utils/inval.h"
+#include "utils/lsyscache.h"
+#include "utils/memutils.h"
+#include "utils/rel.h"
+#include "utils/snapmgr.h"
+#include "utils/syscache.h"
+#include "utils/typcache.h"
+
+/* columns of a table whose ranges are kept */
+#define NODE_RANGE_MAX_COLUMNS	8
+
+/* transactions which wrote a table since its ranges were read */
+#define NODE_RANGE_MAX_WRITERS	8
+
+int node_range_pruning_tables = 0;
+
+/*
+ * Ranges of one table, bounds holds MaxDataNodes entries per column.
+ */
+typedef struct NodeRangeEntry
+{
+	Oid			relid;			/* hash key */
+	TransactionId classxmin;	/* xmin of the pg_class row when collected */
+	uint32		stamp;			/* same as long as no writer came */
+	int			nwriters;
+	TransactionId writers[NODE_RANGE_MAX_WRITERS];
+	int			ncolumns;
+	AttrNumber	attnums[NODE_RANGE_MAX_COLUMNS];
+	Oid			typids[NODE_RANGE_MAX_COLUMNS];
+	int			nbounds[NODE_RANGE_MAX_COLUMNS];
+	NodeRangeBound bounds[FLEXIBLE_ARRAY_MEMBER];
+} NodeRangeEntry;
+
+typedef struct NodeRangeShared
+{
+	uint64		generation;		/* bumped each time a writer comes */
+	uint32		next_stamp;
+} NodeRangeShared;
+
+static NodeRangeShared *NodeRangeState = NULL;
+static HTAB *NodeRangeHash = NULL;
+
+/* tables the plan being made left datanodes out of, see planner() */
+static NodeRangePlanState plan_state = {NIL, NIL};
+
+/*
+ * Tables the current transaction wrote, which the other coordinators are
+ * told about at pre-commit, allocated in TopTransactionContext.  pending_all
+ * stands for every table.
+ */
+static List *pending_relids = NIL;
+static bool pending_all = false;
+static LocalTransactionId pending_lxid = InvalidLocalTransactionId;
+
+static Size NodeRangeEntrySize(void);
+static TransactionId NodeRangeClassXmin(Oid relid);
+static bool NodeRangeHasBrin(Relation rel);
+static bool NodeRangeTypeOK(Oid typid);
+static bool NodeRangeWritersVisible(NodeRangeEntry *entry, Snapshot snapshot);
+static bool NodeRangeAddWriter(NodeRangeEntry *entry, TransactionId xid);
+static void NodeRangeAddPending(Oid relid);
+static void NodeRangeInvalidateRemote(List *relids, TransactionId xid);
+
+static Size
+NodeRangeEntrySize(void)
+{
+	return add_size(offsetof(NodeRangeEntry, bounds),
+					mul_size(sizeof(NodeRangeBound),
+							 mul_size(NODE_RANGE_MAX_COLUMNS, MaxDataNodes)));
+}
+
+Size
+NodeRangeShmemSize(void)
+{
+	Size		size;
+
+	if (node_range_pruning_tables <= 0 || !IS_PGXC_COORDINATOR)
+		return 0;
+
+	size = MAXALIGN(sizeof(NodeRangeShared));
+	size = add_size(size, hash_estimate_size(node_range_pruning_tables,
+											 NodeRangeEntrySize()));
+
+	return size;
+}
+
+void
+NodeRangeShmemInit(void)
+{
+	HASHCTL		info;
+	bool		found;
+
+	if (node_range_pruning_tables <= 0 || !IS_PGXC_COORDINATOR)
+		return;
+
+	NodeRangeState = (NodeRangeShared *)
+		ShmemInitStruct("Node Range State", sizeof(NodeRangeShared), &found);
+	if (!found)
+	{
+		NodeRangeState->generation = 0;
+		NodeRangeState->next_stamp = 0;
+	}
+
+	MemSet(&info, 0, sizeof(info));
+	info.keysize = sizeof(Oid);
+	info.entrysize = NodeRangeEntrySize();
+	NodeRangeHash = ShmemInitHash("Node Range Hash",
+								  node_range_pruning_tables,
+								  node_range_pruning_tables,
+								  &info,
+								  HASH_ELEM | HASH_BLOBS);
+}
+
+/*
+ * Ranges are tied to the pg_class row they were collected for, so they are
+ * not used for a table which got the OID of a dropped one or was rewritten.
+ */
+static TransactionId
+NodeRangeClassXmin(Oid relid)
+{
+	HeapTuple	tuple;
+	TransactionId xmin;
+
+	tuple = SearchSysCache1(RELOID, ObjectIdGetDatum(relid));
+	if (!HeapTupleIsValid(tuple))
+		return InvalidTransactionId;
+	xmin = HeapTupleHeaderGetRawXmin(tuple->t_data);
+	ReleaseSysCache(tuple);
+
+	return xmin;
+}
+
+static bool
+NodeRangeHasBrin(Relation rel)
+{
+	List	   *indexoids;
+	ListCell   *lc;
+	bool		result = false;
+
+	if (!rel->rd_rel->relhasindex)
+		return false;
+
+	indexoids = RelationGetIndexList(rel);
+	foreach(lc, indexoids)
+	{
+		HeapTuple	tuple;
+
+		tuple = SearchSysCache1(RELOID, ObjectIdGetDatum(lfirst_oid(lc)));
+		if (!HeapTupleIsValid(tuple))
+			continue;
+		result = (((Form_pg_class) GETSTRUCT(tuple))->relam == BRIN_AM_OID);
+		ReleaseSysCache(tuple);
+		if (result)
+			break;
+	}
+	list_free(indexoids);
+
+	return result;
+}
+
+/*
+ * Whether a writer of the ranges may be visible to "snapshot", so that the
+ * rows it wrote may lie outside of them.
+ */
+static bool
+NodeRangeWritersVisible(NodeRangeEntry *entry, Snapshot snapshot)
+{
+	int			i;
+	uint32		j;
+
+	if (entry->nwriters > 0 && snapshot->takenDuringRecovery)
+		return true;
+
+	for (i = 0; i < entry->nwriters; i++)
+	{
+		TransactionId xid = entry->writers[i];
+		bool		running = false;
+
+		if (TransactionIdIsCurrentTransactionId(xid))
+			return true;
+		if (TransactionIdFollowsOrEquals(xid, snapshot->xmax))
+			continue;
+		if (TransactionIdPrecedes(xid, snapshot->xmin))
+			return true;
+		for (j = 0; j < snapshot->xcnt; j++)
+		{
+			if (TransactionIdEquals(xid, snapshot->xip[j]))
+			{
+				running = true;
+				break;
+			}
+		}
+		if (!running)
+			return true;
+	}
+
+	return false;
+}
+
+/*
+ * Record a writer, returns false if the entry has to go instead, because
+ * there is no room or no transaction.
+ */
+static bool
+NodeRangeAddWriter(NodeRangeEntry *entry, TransactionId xid)
+{
+	int			i;
+
+	if (!TransactionIdIsValid(xid))
+		return false;
+
+	for (i = 0; i < entry->nwriters; i++)
+	{
+		if (TransactionIdEquals(entry->writers[i], xid))
+			return true;
+	}
+	if (entry->nwriters >= NODE_RANGE_MAX_WRITERS)
+		return false;
+	entry->writers[entry->nwriters++] = xid;
+
+	return true;
+}
+
+/*
+ * The bounds live in shared memory as Datums, and the planner needs btree
+ * operators to compare them with the quals.
+ */
+static bool
+NodeRangeTypeOK(Oid typid)
+{
+	TypeCacheEntry *typentry;
+
+	if (!get_typbyval(typid))
+		return false;
+
+	typentry = lookup_type_cache(typid, TYPECACHE_BTREE_OPFAMILY);
+	return OidIsValid(typentry->btree_opf);
+}
+
+/*
+ * NodeRangeCollect
+ *
+ * Read the bounds of the BRIN indexed columns of a distributed table from
+ * its datanodes, called by ANALYZE on a coordinator.
+ */
+void
+NodeRangeCollect(Relation rel)
+{
+	RelationLocInfo *loc_info = RelationGetLocInfo(rel);
+	Oid			relid = RelationGetRelid(rel);
+	TupleDesc	tupdesc = RelationGetDescr(rel);
+	NodeRangeColumn columns[NODE_RANGE_MAX_COLUMNS];
+	int			ncolumns = 0;
+	uint64		generation;
+	TransactionId classxmin;
+	StringInfoData query;
+	EState	   *estate;
+	MemoryContext oldcontext;
+	RemoteQuery *step;
+	RemoteQueryState *node;
+	TupleTableSlot *slot;
+	NodeRangeEntry *entry;
+	bool		changed = false;
+	int			i;
+
+	if (NodeRangeHash == NULL || loc_info == NULL ||
+		IsRelationReplicated(loc_info) || !IsCoordMaster())
+		return;
+
+	if (!NodeRangeHasBrin(rel))
+	{
+		NodeRangeForget(relid, InvalidTransactionId);
+		return;
+	}
+
+	classxmin = NodeRangeClassXmin(relid);
+
+	/* writes from now on make what we read useless */
+	LWLockAcquire(NodeRangeLock, LW_SHARED);
+	generation = NodeRangeState->generation;
+	LWLockRelease(NodeRangeLock);
+
+	initStringInfo(&query);
+	appendStringInfo(&query,
+					 "SELECT pg_catalog.pgxc_node_str(), attnum, minvalue, maxvalue, hasnulls "
+					 "FROM pg_catalog.brin_minmax_bounds(%s::pg_catalog.regclass)",
+					 quote_literal_cstr(quote_qualified_identifier(
+						get_namespace_name(RelationGetNamespace(rel)),
+						RelationGetRelationName(rel))));
+
+	step = makeNode(RemoteQuery);
+	step->combine_type = COMBINE_TYPE_NONE;
+	step->exec_nodes = makeNode(ExecNodes);
+	step->exec_nodes->accesstype = RELATION_ACCESS_READ;
+	step->exec_nodes->baselocatortype = loc_info->locatorType;
+	step->exec_nodes->nodeList = list_copy(loc_info->nodeList);
+	step->exec_nodes->nodeids = list_copy(loc_info->nodeids);
+	step->sql_statement = query.data;
+	step->force_autocommit = true;
+	step->exec_type = EXEC_ON_DATANODES;
+	step->scan.plan.targetlist = list_make4(
+		makeTargetEntry((Expr *) makeVar(1, 1, NAMEOID, -1, InvalidOid, 0), 1, NULL, false),
+		makeTargetEntry((Expr *) makeVar(1, 2, INT2OID, -1, InvalidOid, 0), 2, NULL, false),
+		makeTargetEntry((Expr *) makeVar(1, 3, BYTEAOID, -1, InvalidOid, 0), 3, NULL, false),
+		makeTargetEntry((Expr *) makeVar(1, 4, BYTEAOID, -1, InvalidOid, 0), 4, NULL, false));
+	step->scan.plan.targetlist = lappend(step->scan.plan.targetlist,
+		makeTargetEntry((Expr *) makeVar(1, 5, BOOLOID, -1, InvalidOid, 0), 5, NULL, false));
+
+	estate = CreateExecutorState();
+	oldcontext = MemoryContextSwitchTo(estate->es_query_cxt);
+	estate->es_snapshot = GetActiveSnapshot();
+	node = ExecInitRemoteQuery(step, estate, 0);
+	MemoryContextSwitchTo(oldcontext);
+
+	for (slot = ExecRemoteQuery(node);
+		 slot != NULL && !TupIsNull(slot);
+		 slot = ExecRemoteQuery(node))
+	{
+		NodeRangeColumn *column = NULL;
+		NodeRangeBound *bound;
+		Form_pg_attribute attr;
+		AttrNumber	attnum;
+		Oid			nodeoid;
+		Datum		value;
+		bool		isnull;
+
+		value = slot_getattr(slot, 1, &isnull);
+		nodeoid = isnull ? InvalidOid : get_pgxc_nodeoid(NameStr(*DatumGetName(value)));
+		if (!OidIsValid(nodeoid))
+			continue;
+
+		attnum = DatumGetInt16(slot_getattr(slot, 2, &isnull));
+		if (attnum <= 0 || attnum > tupdesc->natts)
+			continue;
+		attr = tupdesc->attrs[attnum - 1];
+		if (attr->attisdropped || !NodeRangeTypeOK(attr->atttypid))
+			continue;
+
+		for (i = 0; i < ncolumns; i++)
+		{
+			if (columns[i].attnum == attnum)
+				column = &columns[i];
+		}
+		if (column == NULL)
+		{
+			if (ncolumns >= NODE_RANGE_MAX_COLUMNS)
+				continue;
+			column = &columns[ncolumns++];
+			column->attnum = attnum;
+			column->typid = attr->atttypid;
+			column->nbounds = 0;
+			column->bounds = palloc(sizeof(NodeRangeBound) * MaxDataNodes);
+		}
+		if (column->nbounds >= MaxDataNodes)
+			continue;
+
+		bound = &column->bounds[column->nbounds];
+		bound->nodeoid = nodeoid;
+		bound->hasnulls = DatumGetBool(slot_getattr(slot, 5, &isnull));
+		bound->hasvalues = false;
+		bound->minval = bound->maxval = (Datum) 0;
+
+		value = slot_getattr(slot, 3, &isnull);
+		if (!isnull)
+		{
+			Oid			typreceive;
+			Oid			typioparam;
+			bytea	   *bytes;
+			StringInfoData buf;
+
+			getTypeBinaryInputInfo(column->typid, &typreceive, &typioparam);
+
+			initStringInfo(&buf);
+			bytes = DatumGetByteaP(value);
+			appendBinaryStringInfo(&buf, VARDATA(bytes), VARSIZE(bytes) - VARHDRSZ);
+			bound->minval = OidReceiveFunctionCall(typreceive, &buf, typioparam, -1);
+
+			resetStringInfo(&buf);
+			bytes = DatumGetByteaP(slot_getattr(slot, 4, &isnull));
+			appendBinaryStringInfo(&buf, VARDATA(bytes), VARSIZE(bytes) - VARHDRSZ);
+			bound->maxval = OidReceiveFunctionCall(typreceive, &buf, typioparam, -1);
+
+			pfree(buf.data);
+			bound->hasvalues = true;
+		}
+		column->nbounds++;
+	}
+	ExecEndRemoteQuery(node);
+	FreeExecutorState(estate);
+	pfree(query.data);
+
+	LWLockAcquire(NodeRangeLock, LW_EXCLUSIVE);
+	if (NodeRangeState->generation != generation)
+	{
+		/* a write raced with us, keep what we had, if anything */
+	} else if (ncolumns == 0)
+	{
+		changed = (hash_search(NodeRangeHash, &relid, HASH_REMOVE, NULL) != NULL);
+	} else
+	{
+		bool		found;
+
+		entry = (NodeRangeEntry *) hash_search(NodeRangeHash, &relid,
+											   HASH_ENTER_NULL, &found);
+		if (entry)
+		{
+			/*
+			 * Plans made with what we replace stay good unless a writer came
+			 * since, see NodeRangeCheckPlan().
+			 */
+			if (!found || entry->nwriters > 0 ||
+				!TransactionIdEquals(entry->classxmin, classxmin))
+				entry->stamp = NodeRangeState->next_stamp++;
+			entry->classxmin = classxmin;
+			entry->nwriters = 0;
+			entry->ncolumns = ncolumns;
+			for (i = 0; i < ncolumns; i++)
+			{
+				entry->attnums[i] = columns[i].attnum;
+				entry->typids[i] = columns[i].typid;
+				entry->nbounds[i] = columns[i].nbounds;
+				memcpy(&entry->bounds[i * MaxDataNodes], columns[i].bounds,
+					   sizeof(NodeRangeBound) * columns[i].nbounds);
+			}
+			changed = true;
+		} else
+		{
+			elog(DEBUG1, "no room left for the node ranges of \"%s\"",
+				 RelationGetRelationName(rel));
+		}
+	}
+	LWLockRelease(NodeRangeLock);
+
+	/* replan the cached plans of the table with the new ranges */
+	if (changed)
+		CacheInvalidateRelcacheByRelid(relid);
+
+	for (i = 0; i < ncolumns; i++)
+		pfree(columns[i].bounds);
+}
+
+/*
+ * NodeRangeGetColumns
+ *
+ * Returns a list of NodeRangeColumn, copies of the ranges known for a table
+ * which hold for "snapshot", or NIL.  *stamp is set to what a plan using
+ * them passes to NodeRangeNotePruned().
+ */
+List *
+NodeRangeGetColumns(Oid relid, Snapshot snapshot, uint32 *stamp)
+{
+	NodeRangeEntry *entry;
+	TransactionId classxmin;
+	List	   *result = NIL;
+	int			i;
+
+	if (NodeRangeHash == NULL || snapshot == NULL)
+		return NIL;
+
+	classxmin = NodeRangeClassXmin(relid);
+
+	LWLockAcquire(NodeRangeLock, LW_SHARED);
+	entry = (NodeRangeEntry *) hash_search(NodeRangeHash, &relid, HASH_FIND, NULL);
+	if (entry && TransactionIdEquals(entry->classxmin, classxmin) &&
+		!NodeRangeWritersVisible(entry, snapshot))
+	{
+		*stamp = entry->stamp;
+		for (i = 0; i < entry->ncolumns; i++)
+		{
+			NodeRangeColumn *column = palloc(sizeof(NodeRangeColumn));
+
+			column->attnum = entry->attnums[i];
+			column->typid = entry->typids[i];
+			column->nbounds = entry->nbounds[i];
+			column->bounds = palloc(sizeof(NodeRangeBound) * column->nbounds);
+			memcpy(column->bounds, &entry->bounds[i * MaxDataNodes],
+				   sizeof(NodeRangeBound) * column->nbounds);
+			result = lappend(result, column);
+		}
+	}
+	LWLockRelease(NodeRangeLock);
+
+	return result;
+}
+
+/*
+ * NodeRangeForget
+ *
+ * Record "xid" as a writer of the ranges of a table on this coordinator, or
+ * of all tables if relid is InvalidOid.  Without a transaction the ranges
+ * are dropped.
+ */
+void
+NodeRangeForget(Oid relid, TransactionId xid)
+{
+	NodeRangeEntry *entry;
+	List	   *relids = NIL;
+	ListCell   *lc;
+
+	if (NodeRangeHash == NULL)
+		return;
+
+	LWLockAcquire(NodeRangeLock, LW_EXCLUSIVE);
+	if (OidIsValid(relid))
+	{
+		entry = (NodeRangeEntry *) hash_search(NodeRangeHash, &relid,
+											   HASH_FIND, NULL);
+		if (entry)
+		{
+			if (!NodeRangeAddWriter(entry, xid))
+				hash_search(NodeRangeHash, &relid, HASH_REMOVE, NULL);
+			relids = lappend_oid(relids, relid);
+		}
+	} else
+	{
+		HASH_SEQ_STATUS status;
+
+		hash_seq_init(&status, NodeRangeHash);
+		while ((entry = (NodeRangeEntry *) hash_seq_search(&status)) != NULL)
+		{
+			relids = lappend_oid(relids, entry->relid);
+			if (!NodeRangeAddWriter(entry, xid))
+				hash_search(NodeRangeHash, &entry->relid, HASH_REMOVE, NULL);
+		}
+	}
+	/* even if there was nothing, an ANALYZE may be reading them */
+	NodeRangeState->generation++;
+	LWLockRelease(NodeRangeLock);
+
+	/* replan once the writer commits */
+	foreach (lc, relids)
+		CacheInvalidateRelcacheByRelid(lfirst_oid(lc));
+	list_free(relids);
+}
+
+/*
+ * NodeRangeNoteWrite
+ *
+ * The current statement has inserted or updated rows of "relid", which are
+ * in the BRIN indexes of the datanodes by now.  Forget the ranges of the
+ * table here, and on the other coordinators before the rows become visible.
+ */
+void
+NodeRangeNoteWrite(Oid relid)
+{
+	RelationLocInfo *loc_info;
+	Relation	rel;
+	bool		brin;
+
+	if (NodeRangeHash == NULL || !IsCoordMaster())
+		return;
+
+	rel = relation_open(relid, NoLock);
+	loc_info = RelationGetLocInfo(rel);
+	brin = (loc_info != NULL && !IsRelationReplicated(loc_info) &&
+			NodeRangeHasBrin(rel));
+	relation_close(rel, NoLock);
+	if (!brin)
+		return;
+
+	NodeRangeForget(relid, GetTopTransactionId());
+
+	/* other sessions can not read our temporary tables */
+	if (get_rel_persistence(relid) != RELPERSISTENCE_TEMP)
+		NodeRangeAddPending(relid);
+}
+
+/*
+ * NodeRangeNoteWriteAll
+ *
+ * The current statement may have written rows of any table, in ways the
+ * plan of the coordinator does not show.
+ */
+void
+NodeRangeNoteWriteAll(void)
+{
+	if (NodeRangeHash == NULL || !IsCoordMaster())
+		return;
+
+	NodeRangeForget(InvalidOid, GetTopTransactionId());
+	NodeRangeAddPending(InvalidOid);
+}
+
+/*
+ * NodeRangeNoteWrites
+ *
+ * NodeRangeNoteWrite() for every table a finished plan inserted into or
+ * updated.  Triggers of the tables it wrote, including those of foreign
+ * keys, may have fired on the datanodes and written any table.
+ */
+void
+NodeRangeNoteWrites(PlannedStmt *stmt)
+{
+	ListCell   *lc;
+	List	   *done = NIL;
+
+	if (NodeRangeHash == NULL || !IsCoordMaster())
+		return;
+
+	if (stmt->commandType == CMD_SELECT && !stmt->hasModifyingCTE)
+		return;
+
+	foreach (lc, stmt->rtable)
+	{
+		RangeTblEntry *rte = (RangeTblEntry *) lfirst(lc);
+		Relation	rel;
+		bool		hastriggers;
+
+		if (rte->rtekind != RTE_RELATION ||
+			(rte->requiredPerms & (ACL_INSERT | ACL_UPDATE | ACL_DELETE)) == 0 ||
+			list_member_oid(done, rte->relid))
+			continue;
+		done = lappend_oid(done, rte->relid);
+
+		rel = relation_open(rte->relid, NoLock);
+		hastriggers = rel->rd_rel->relhastriggers;
+		relation_close(rel, NoLock);
+		if (hastriggers)
+		{
+			NodeRangeNoteWriteAll();
+			break;
+		}
+
+		if ((rte->requiredPerms & (ACL_INSERT | ACL_UPDATE)) != 0)
+			NodeRangeNoteWrite(rte->relid);
+	}
+	list_free(done);
+}
+
+/*
+ * NodeRangeBeginPlan
+ *
+ * Start collecting the tables a plan leaves datanodes out of because of
+ * their ranges, saving what an outer planner collected into "save".
+ */
+void
+NodeRangeBeginPlan(NodeRangePlanState *save)
+{
+	*save = plan_state;
+	plan_state.relids = plan_state.stamps = NIL;
+}
+
+/*
+ * NodeRangeEndPlan
+ *
+ * Hand what was collected to the finished plan, if any, and go back to
+ * the state NodeRangeBeginPlan() saved.
+ */
+void
+NodeRangeEndPlan(PlannedStmt *stmt, NodeRangePlanState *save)
+{
+	if (stmt)
+	{
+		stmt->nodeRangeRelids = plan_state.relids;
+		stmt->nodeRangeStamps = plan_state.stamps;
+	}
+	plan_state = *save;
+}
+
+/*
+ * NodeRangeNotePruned
+ *
+ * The plan being made leaves datanodes of "relid" out, which only the
+ * ranges with "stamp" allowed.
+ */
+void
+NodeRangeNotePruned(Oid relid, uint32 stamp)
+{
+	ListCell   *lc;
+	ListCell   *lc2;
+
+	forboth(lc, plan_state.relids, lc2, plan_state.stamps)
+	{
+		if (lfirst_oid(lc) == relid && (uint32) lfirst_int(lc2) == stamp)
+			return;
+	}
+	plan_state.relids = lappend_oid(plan_state.relids, relid);
+	plan_state.stamps = lappend_int(plan_state.stamps, (int) stamp);
+}
+
+/*
+ * NodeRangeCheckPlan
+ *
+ * Called when a plan starts with the snapshot it runs with, which may be
+ * later than the one it was made with.  The ranges it left datanodes out
+ * with must still hold for it.  Plans are made again once a writer
+ * commits, so this only fails if one did between planning and starting.
+ */
+void
+NodeRangeCheckPlan(PlannedStmt *stmt, Snapshot snapshot)
+{
+	ListCell   *lc;
+	ListCell   *lc2;
+
+	if (NodeRangeHash == NULL || !IsCoordMaster())
+		return;
+
+	forboth(lc, stmt->nodeRangeRelids, lc2, stmt->nodeRangeStamps)
+	{
+		Oid			relid = lfirst_oid(lc);
+		NodeRangeEntry *entry;
+		bool		valid;
+
+		LWLockAcquire(NodeRangeLock, LW_SHARED);
+		entry = (NodeRangeEntry *) hash_search(NodeRangeHash, &relid,
+											   HASH_FIND, NULL);
+		valid = (entry != NULL &&
+				 entry->stamp == (uint32) lfirst_int(lc2) &&
+				 !NodeRangeWritersVisible(entry, snapshot));
+		LWLockRelease(NodeRangeLock);
+
+		if (!valid)
+			ereport(ERROR,
+					(errcode(ERRCODE_T_R_SERIALIZATION_FAILURE),
+					 errmsg("could not serialize access due to concurrent write to table \"%s\"",
+							get_rel_name(relid)),
+					 errdetail("The datanodes of the table were chosen with value ranges which no longer hold."),
+					 errhint("The transaction might succeed if retried.")));
+	}
+}
+
+/*
+ * Remember that the other coordinators must learn the current transaction
+ * wrote "relid", or every table if it is InvalidOid.
+ */
+static void
+NodeRangeAddPending(Oid relid)
+{
+	MemoryContext oldcontext;
+
+	if (pending_lxid != MyProc->lxid)
+	{
+		/* the old list went away with its transaction */
+		pending_relids = NIL;
+		pending_all = false;
+		pending_lxid = MyProc->lxid;
+	}
+
+	if (!OidIsValid(relid))
+	{
+		pending_all = true;
+		return;
+	}
+	if (pending_all || list_member_oid(pending_relids, relid))
+		return;
+
+	oldcontext = MemoryContextSwitchTo(TopTransactionContext);
+	pending_relids = lappend_oid(pending_relids, relid);
+	MemoryContextSwitchTo(oldcontext);
+}
+
+/*
+ * NodeRangePreCommit
+ *
+ * Called by the coordinator which runs the transaction before it prepares
+ * the remote nodes.  Records the transaction as a writer of the tables it
+ * wrote on the other coordinators, with one statement for all of them.
+ */
+void
+NodeRangePreCommit(void)
+{
+	if (pending_lxid != MyProc->lxid)
+		return;
+
+	if (pending_all)
+		NodeRangeInvalidateRemote(NIL, GetTopTransactionId());
+	else if (pending_relids != NIL)
+		NodeRangeInvalidateRemote(pending_relids, GetTopTransactionId());
+
+	pending_relids = NIL;
+	pending_all = false;
+	pending_lxid = InvalidLocalTransactionId;
+}
+
+/*
+ * Relation OIDs differ between coordinators, so the other coordinators
+ * are told the qualified names, or "-" for all tables.
+ */
+static void
+NodeRangeInvalidateRemote(List *relids, TransactionId xid)
+{
+	RemoteQuery	   *step;
+	StringInfoData	sql;
+	ListCell	   *lc;
+	bool			first = true;
+
+	initStringInfo(&sql);
+	appendStringInfoString(&sql, "SELECT ");
+	if (relids == NIL)
+		appendStringInfo(&sql,
+						 "pg_catalog.adb_node_range_invalidate('-'::pg_catalog.regclass, '%u'::pg_catalog.xid)",
+						 xid);
+	foreach (lc, relids)
+	{
+		Oid			relid = lfirst_oid(lc);
+		char	   *relname = get_rel_name(relid);
+
+		/* dropped by the transaction since */
+		if (relname == NULL)
+			continue;
+
+		appendStringInfo(&sql,
+						 "%spg_catalog.adb_node_range_invalidate(%s::pg_catalog.regclass, '%u'::pg_catalog.xid)",
+						 first ? "" : ", ",
+						 quote_literal_cstr(quote_qualified_identifier(get_namespace_name(get_rel_namespace(relid)),
+																	   relname)),
+						 xid);
+		first = false;
+	}
+	if (relids != NIL && first)
+	{
+		pfree(sql.data);
+		return;
+	}
+
+	step = makeNode(RemoteQuery);
+	step->combine_type = COMBINE_TYPE_SAME;
+	step->exec_nodes = NULL;
+	step->sql_statement = sql.data;
+	step->force_autocommit = false;
+	step->exec_type = EXEC_ON_COORDS;
+	(void) ExecInterXactUtility(step, GetCurrentInterXactState());
+	pfree(sql.data);
+	pfree(step);
+}
+
+/*
+ * adb_node_range_invalidate
+ *
+ * Executed on a coordinator by NodeRangePreCommit(), records the writer
+ * at once, it has not committed yet.
+ */
+Datum
+adb_node_range_invalidate(PG_FUNCTION_ARGS)
+{
+	Oid			relid = PG_GETARG_OID(0);
+	TransactionId xid = DatumGetTransactionId(PG_GETARG_DATUM(1));
+
+	NodeRangeForget(relid, xid);
+
+	PG_RETURN_VOID();
+}
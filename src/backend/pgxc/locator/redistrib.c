@@ -163,9 +163,13 @@ pgxc_redist_build_replicate_to_distrib(RedistribState *distribState,
 	if (list_length(distribState->commands) != 0)
 		return;
 
-	/* Redistribution is done from replication to distributed (with value) */
+	/*
+	 * Redistribution is done from replication to distributed (with value),
+	 * the DELETE below hashes a single column
+	 */
 	if (!IsRelationReplicated(oldLocInfo) ||
-		!IsRelationDistributedByValue(newLocInfo))
+		!IsRelationDistributedByValue(newLocInfo) ||
+		IsRelationDistributedByMultiHash(newLocInfo))
 		return;
 
 	/* Get the list of nodes that are added to the relation */
@@ -543,7 +547,8 @@ distrib_copy_from(RedistribState *distribState, ExecNodes *exec_nodes)
 		CopyOps_BuildOneRowTo(tupdesc, slot->tts_values, slot->tts_isnull, &line_buf);
 
 		/* Build relation node list */
-		if (IsRelationDistributedByValue(copyState->rel_loc))
+		if (IsRelationDistributedByValue(copyState->rel_loc) &&
+			!IsRelationDistributedByMultiHash(copyState->rel_loc))
 		{
 			nelems = 1;
 			need_free = false;
@@ -552,12 +557,12 @@ distrib_copy_from(RedistribState *distribState, ExecNodes *exec_nodes)
 			dist_col_is_nulls = &slot->tts_isnull[attnum - 1];
 			dist_col_types = &attr[attnum - 1]->atttypid;
 		} else
-		if (IsRelationDistributedByUserDefined(copyState->rel_loc))
+		if (IsRelationDistributedByUserDefined(copyState->rel_loc) ||
+			IsRelationDistributedByMultiHash(copyState->rel_loc))
 		{
 			ListCell   *lc = NULL;
 			int			idx = 0;
 
-			Assert(OidIsValid(copyState->rel_loc->funcid));
 			Assert(copyState->rel_loc->funcAttrNums);
 			nelems = list_length(copyState->rel_loc->funcAttrNums);
 			dist_col_values = (Datum *) palloc0(sizeof(Datum) * nelems);
@@ -24,7 +24,9 @@
 #include "catalog/pgxc_node.h"
 #include "commands/defrem.h"
 #include "nodes/parsenodes.h"
+#include "port/atomics.h"
 #include "utils/builtins.h"
+#include "utils/inval.h"
 #include "utils/lsyscache.h"
 #include "utils/rel.h"
 #include "utils/syscache.h"
@@ -44,6 +46,8 @@
 #define MAX_TRIES_FOR_NID	200
 
 static Datum generate_node_id(const char *node_name);
+static void PgxcNodeInvalCallback(Datum arg, int cacheid, uint32 hashvalue);
+static void PgxcNodeRegisterInvalCallback(void);
 
 /*
  * GUC parameters.
@@ -64,6 +68,27 @@ static int	   *shmemNumDataNodes;
 NodeDefinition *coDefs;
 NodeDefinition *dnDefs;
 
+/*
+ * State of the shared node tables.
+ *
+ * "invalidations" is bumped without any lock by every backend which sees a
+ * pgxc_node change through sinval, "loaded_gen" (protected by NodeTableLock)
+ * remembers the value it had when the tables were last filled from the
+ * catalog. The tables are in sync with pgxc_node as long as both are equal,
+ * so new backends can skip the catalog scan.
+ */
+typedef struct NodeTableState
+{
+	bool				loaded;
+	uint32				loaded_gen;
+	pg_atomic_uint32	invalidations;
+} NodeTableState;
+
+static NodeTableState *shmemNodeTableState;
+
+/* Has this backend registered PgxcNodeInvalCallback? */
+static bool node_inval_registered = false;
+
 /*
  * NodeTablesInit
  *	Initializes shared memory tables of Coordinators and Datanodes.
@@ -104,6 +129,17 @@ NodeTablesShmemInit(void)
 	/* Mark it empty upon creation */
 	if (!found)
 		*shmemNumDataNodes = 0;
+
+	/* Tables are not loaded until the first PgxcNodeListAndCount */
+	shmemNodeTableState = ShmemInitStruct("Node Table State",
+										  sizeof(NodeTableState),
+										  &found);
+	if (!found)
+	{
+		shmemNodeTableState->loaded = false;
+		shmemNodeTableState->loaded_gen = 0;
+		pg_atomic_init_u32(&shmemNodeTableState->invalidations, 0);
+	}
 }
 
 
@@ -122,7 +158,7 @@ NodeTablesShmemSize(void)
 	dn_size = mul_size(sizeof(NodeDefinition), MaxDataNodes);
 	dn_size = add_size(dn_size, sizeof(int));
 
-	return add_size(co_size, dn_size);
+	return add_size(add_size(co_size, dn_size), sizeof(NodeTableState));
 }
 
 /*
@@ -312,9 +348,19 @@ PgxcNodeListAndCount(void)
 	Relation rel;
 	HeapScanDesc scan;
 	HeapTuple   tuple;
+	uint32		gen;
+
+	PgxcNodeRegisterInvalCallback();
 
 	LWLockAcquire(NodeTableLock, LW_EXCLUSIVE);
 
+	/*
+	 * Remember the invalidation counter before scanning, so a change
+	 * committed while we scan leaves the tables marked as stale.
+	 */
+	gen = pg_atomic_read_u32(&shmemNodeTableState->invalidations);
+	pg_read_barrier();
+
 	*shmemNumCoords = 0;
 	*shmemNumDataNodes = 0;
 
@@ -361,9 +407,63 @@ PgxcNodeListAndCount(void)
 	if (*shmemNumDataNodes > 1)
 		qsort(dnDefs, *shmemNumDataNodes, sizeof(NodeDefinition), cmp_nodes);
 
+	shmemNodeTableState->loaded_gen = gen;
+	shmemNodeTableState->loaded = true;
+
 	LWLockRelease(NodeTableLock);
 }
 
+/*
+ * PgxcNodeListAndCountIfInvalid
+ *
+ * Same as PgxcNodeListAndCount, but only scan the catalog if the shared
+ * tables were never loaded or pgxc_node changed since the last load.
+ * Backends starting up use this to attach to the node tables already
+ * built by their predecessors.
+ */
+void
+PgxcNodeListAndCountIfInvalid(void)
+{
+	bool		valid;
+
+	PgxcNodeRegisterInvalCallback();
+
+	LWLockAcquire(NodeTableLock, LW_SHARED);
+	valid = shmemNodeTableState->loaded &&
+			shmemNodeTableState->loaded_gen ==
+				pg_atomic_read_u32(&shmemNodeTableState->invalidations);
+	LWLockRelease(NodeTableLock);
+
+	if (!valid)
+		PgxcNodeListAndCount();
+}
+
+/*
+ * PgxcNodeInvalCallback
+ *
+ * Syscache callback for pgxc_node, mark the shared tables as stale.
+ * Note: this may be called while NodeTableLock is held by ourselves,
+ * so never take it here.
+ */
+static void
+PgxcNodeInvalCallback(Datum arg, int cacheid, uint32 hashvalue)
+{
+	if (shmemNodeTableState)
+		pg_atomic_fetch_add_u32(&shmemNodeTableState->invalidations, 1);
+}
+
+static void
+PgxcNodeRegisterInvalCallback(void)
+{
+	if (node_inval_registered)
+		return;
+
+	CacheRegisterSyscacheCallback(PGXCNODEOID,
+								  PgxcNodeInvalCallback,
+								  (Datum) 0);
+	node_inval_registered = true;
+}
+
 
 /*
  * PgxcNodeGetIds
@@ -534,6 +634,9 @@ PgxcNodeCreate(CreateNodeStmt *stmt)
 				(errcode(ERRCODE_INSUFFICIENT_PRIVILEGE),
 				 errmsg("must be superuser to create cluster nodes")));
 
+	/* make sure our own commit marks the shared node tables stale */
+	PgxcNodeRegisterInvalCallback();
+
 	/* Check that node name is node in use */
 	if (OidIsValid(get_pgxc_nodeoid(node_name)))
 		ereport(ERROR,
@@ -653,6 +756,9 @@ PgxcNodeAlter(AlterNodeStmt *stmt)
 				(errcode(ERRCODE_INSUFFICIENT_PRIVILEGE),
 				 errmsg("must be superuser to change cluster nodes")));
 
+	/* make sure our own commit marks the shared node tables stale */
+	PgxcNodeRegisterInvalCallback();
+
 	/* Look at the node tuple, and take exclusive lock on it */
 	rel = heap_open(PgxcNodeRelationId, RowExclusiveLock);
 
@@ -781,6 +887,9 @@ PgxcNodeRemove(DropNodeStmt *stmt)
 				(errcode(ERRCODE_INSUFFICIENT_PRIVILEGE),
 				 errmsg("must be superuser to remove cluster nodes")));
 
+	/* make sure our own commit marks the shared node tables stale */
+	PgxcNodeRegisterInvalCallback();
+
 	/* Check if node is defined */
 	if (!OidIsValid(noid))
 		ereport(ERROR,
@@ -45,6 +45,7 @@
 #include "pgxc/nodemgr.h"
 #include "pgxc/pgxc.h"
 #include "pgxc/poolmgr.h"
+#include "pgxc/resultcache.h"
 #include "pgxc/xc_maintenance_mode.h"
 #include "storage/ipc.h"
 #include "utils/builtins.h"
@@ -361,6 +362,10 @@ ExecInitRemoteQuery(RemoteQuery *node, EState *estate, int eflags)
 		rqstate->rqs_cmd_id = GetCurrentCommandId(false);
 	}
 
+#ifdef ADB
+	rqstate->result_cache = ResultCacheBeginScan(rqstate);
+#endif
+
 	return rqstate;
 }
 
@@ -442,6 +447,17 @@ RemoteQueryNext(ScanState *scan_node)
 	 */
 	node->rqs_processed = 0;
 
+#ifdef ADB
+	if (node->result_cache)
+	{
+		/* a cached result replaces the round trip to the datanode */
+		if (!node->query_Done && ResultCacheLookup(node->result_cache))
+			node->query_Done = true;
+		if (ResultCacheIsHit(node->result_cache))
+			return ResultCacheNext(node->result_cache, scanslot);
+	}
+#endif
+
 	if (!node->query_Done)
 	{
 		/* Fire BEFORE STATEMENT triggers just before the query execution */
@@ -482,6 +498,11 @@ RemoteQueryNext(ScanState *scan_node)
 	if (TupIsNull(scanslot))
 		pgxc_rq_fire_astriggers(node);
 
+#ifdef ADB
+	if (node->result_cache)
+		ResultCacheCollect(node->result_cache, scanslot);
+#endif
+
 	/*
 	 * If it's an FQSed DML query for which command tag is to be set,
 	 * then update estate->es_processed. For other queries, the standard
@@ -866,6 +887,11 @@ ExecRemoteQueryReScan(RemoteQueryState *node, ExprContext *exprCtxt)
 	 */
 	ExecClearTuple(node->ss.ps.ps_ResultTupleSlot);
 
+#ifdef ADB
+	if (node->result_cache)
+		ResultCacheRescan(node->result_cache);
+#endif
+
 	if (!node->tuplestorestate)
 		return;
 
@@ -167,7 +167,10 @@ InitMultinodeExecutor(bool is_force)
 		return;
 
 	/* Update node table in the shared memory */
-	PgxcNodeListAndCount();
+	if (is_force)
+		PgxcNodeListAndCount();
+	else
+		PgxcNodeListAndCountIfInvalid();
 
 	/* Get classified list of node Oids */
 	PgxcNodeGetOids(&coOids, &dnOids, (int*)&NumCoords, (int*)&NumDataNodes, true);
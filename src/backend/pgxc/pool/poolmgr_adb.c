@@ -20,8 +20,10 @@
 #include "pgxc/pgxc.h"
 #include "pgxc/poolmgr.h"
 #include "pgxc/poolutils.h"
+#include "port/atomics.h"
 #include "postmaster/postmaster.h"		/* For Unix_socket_directories */
 #include "storage/ipc.h"
+#include "storage/shmem.h"
 #include "tcop/tcopprot.h"
 #include "utils/builtins.h"
 #include "utils/guc.h"
@@ -191,6 +193,18 @@ int			PoolRemoteCmdTimeout = 0;
 
 bool		PersistentConnections = false;
 
+/*
+ * Shared pooler state. "generation" is bumped each time pooled connections
+ * are reloaded or cleaned, sessions keeping connections across transactions
+ * compare it with the value seen when they got them.
+ */
+typedef struct PoolerSharedState
+{
+	pg_atomic_uint32	generation;
+} PoolerSharedState;
+
+static PoolerSharedState *poolerShared = NULL;
+
 /* pool time out */
 extern int pool_time_out;
 extern int pool_release_to_idle_timeout;
@@ -229,6 +243,8 @@ static void agent_handle_output(PoolAgent *agent);
 static void agent_destroy(PoolAgent *agent);
 static void agent_error_hook(void *arg);
 static void agent_check_waiting_slot(PoolAgent *agent);
+static void agent_send_slot_params(PoolAgent *agent, ADBNodePoolSlot *slot,
+								   bool reset_all, bool with_session);
 static bool agent_recv_data(PoolAgent *agent);
 static bool agent_has_completion_msg(PoolAgent *agent, StringInfo msg, int *msg_type);
 static char * build_node_conn_str(Oid node, DatabasePool *dbPool);
@@ -1175,6 +1191,7 @@ PoolManagerAbortTransactions(char *dbname, char *username, int **proc_pids)
 	/* send user name */
 	pool_sendstring(&buf, username);
 
+	PoolManagerBumpGeneration();
 	pool_end_flush_msg(&(poolHandle->port), &buf);
 
 	return pool_recvpids(&(poolHandle->port), proc_pids);
@@ -1211,6 +1228,7 @@ PoolManagerCleanConnection(List *datanodelist, List *coordlist, char *dbname, ch
 	/* send user name */
 	pool_sendstring(&buf, username);
 
+	PoolManagerBumpGeneration();
 	pool_end_flush_msg(&(poolHandle->port), &buf);
 
 	/* Receive result message */
@@ -1251,10 +1269,53 @@ PoolManagerReloadConnectionInfo(void)
 {
 	Assert(poolHandle);
 	PgxcNodeListAndCount();
+	PoolManagerBumpGeneration();
 	pool_putmessage(&poolHandle->port, PM_MSG_RELOAD_CONNECT, NULL, 0);
 	pool_flush(&poolHandle->port);
 }
 
+/*
+ * PoolManagerShmemSize
+ *	Get the size of shared memory dedicated to pooler state
+ */
+Size
+PoolManagerShmemSize(void)
+{
+	return sizeof(PoolerSharedState);
+}
+
+void
+PoolManagerShmemInit(void)
+{
+	bool found;
+
+	poolerShared = ShmemInitStruct("Pooler Shared State",
+								   sizeof(PoolerSharedState),
+								   &found);
+	if (!found)
+		pg_atomic_init_u32(&poolerShared->generation, 0);
+}
+
+/*
+ * Return current generation of pooled connections, connections got
+ * under an older generation may point to a stale node definition.
+ */
+uint32
+PoolManagerGetGeneration(void)
+{
+	if (poolerShared == NULL)
+		return 0;
+
+	return pg_atomic_read_u32(&poolerShared->generation);
+}
+
+void
+PoolManagerBumpGeneration(void)
+{
+	if (poolerShared)
+		pg_atomic_fetch_add_u32(&poolerShared->generation, 1);
+}
+
 void PoolManagerReleaseConnections(bool force_close)
 {
 	Assert(poolHandle);
@@ -1613,6 +1674,68 @@ static void agent_error_hook(void *arg)
 	}
 }
 
+/*
+ * Send "reset all", session params and local params to slot as one
+ * simple query, so getting a slot ready for a backend costs one round
+ * trip to the remote node instead of up to three. Slot state is set to
+ * the last step we sent, its END state leads to the following steps.
+ */
+static void agent_send_slot_params(PoolAgent *agent, ADBNodePoolSlot *slot,
+								   bool reset_all, bool with_session)
+{
+	StringInfoData buf;
+	SlotStateType state = SLOT_STATE_QUERY_RESET_ALL;
+
+	AssertArg(agent && slot);
+	Assert(reset_all || (with_session && agent->session_params) || agent->local_params);
+
+	initStringInfo(&buf);
+	if(reset_all)
+	{
+		appendStringInfoString(&buf, "reset all");
+		state = SLOT_STATE_QUERY_RESET_ALL;
+	}
+	if(with_session && agent->session_params)
+	{
+		if(buf.len > 0)
+			appendStringInfoChar(&buf, ';');
+		appendStringInfoString(&buf, agent->session_params);
+		state = SLOT_STATE_QUERY_PARAMS_SESSION;
+	}
+	if(agent->local_params)
+	{
+		if(buf.len > 0)
+			appendStringInfoChar(&buf, ';');
+		appendStringInfoString(&buf, agent->local_params);
+		state = SLOT_STATE_QUERY_PARAMS_LOCAL;
+	}
+
+	if(!PQsendQuery(slot->conn, buf.data))
+	{
+		pfree(buf.data);
+		save_slot_error(slot);
+		return;
+	}
+	pfree(buf.data);
+
+	/* "reset all" cleared params we do not send again */
+	if(reset_all)
+	{
+		INIT_SLOT_PARAMS_MAGIC(slot, session_magic);
+		INIT_SLOT_PARAMS_MAGIC(slot, local_magic);
+	}
+	if(with_session && agent->session_params)
+		COPY_PARAMS_MAGIC(slot->session_magic, agent->session_magic);
+	if(agent->local_params)
+		COPY_PARAMS_MAGIC(slot->local_magic, agent->local_magic);
+
+	slot->slot_state = state;
+	Assert(slot->current_list != NULL_SLOT);
+	dlist_delete(&slot->dnode);
+	dlist_push_head(&slot->parent->busy_slot, &slot->dnode);
+	slot->current_list = BUSY_SLOT;
+}
+
 static void agent_check_waiting_slot(PoolAgent *agent)
 {
 	ListCell *lc;
@@ -1657,17 +1780,7 @@ static void agent_check_waiting_slot(PoolAgent *agent)
 send_session_params_:
 				if(agent->session_params != NULL)
 				{
-					if(!PQsendQuery(slot->conn, agent->session_params))
-					{
-						save_slot_error(slot);
-						break;
-					}
-					slot->slot_state = SLOT_STATE_QUERY_PARAMS_SESSION;
-					COPY_PARAMS_MAGIC(slot->session_magic, agent->session_magic);
-					Assert(slot->current_list != NULL_SLOT);
-					dlist_delete(&slot->dnode);
-					dlist_push_head(&slot->parent->busy_slot, &slot->dnode);
-					slot->current_list = BUSY_SLOT;
+					agent_send_slot_params(agent, slot, false, true);
 					break;
 				}
 				goto send_local_params_;
@@ -1677,16 +1790,7 @@ send_session_params_:
 				if(slot->last_user_pid != agent->pid)
 				{
 					slot->last_agtm_port = 0;
-					if(!PQsendQuery(slot->conn, "reset all"))
-					{
-						save_slot_error(slot);
-						break;
-					}
-					slot->slot_state = SLOT_STATE_QUERY_RESET_ALL;
-					Assert(slot->current_list != NULL_SLOT);
-					dlist_delete(&slot->dnode);
-					dlist_push_head(&slot->parent->busy_slot, &slot->dnode);
-					slot->current_list = BUSY_SLOT;
+					agent_send_slot_params(agent, slot, true, true);
 				}else if(!EQUAL_PARAMS_MAGIC(slot->session_magic, agent->session_magic))
 				{
 					goto send_session_params_;
@@ -1706,17 +1810,7 @@ send_session_params_:
 send_local_params_:
 				if(agent->local_params)
 				{
-					if(!PQsendQuery(slot->conn, agent->local_params))
-					{
-						save_slot_error(slot);
-						break;
-					}
-					slot->slot_state = SLOT_STATE_QUERY_PARAMS_LOCAL;
-					COPY_PARAMS_MAGIC(slot->local_magic, agent->session_magic);
-					Assert(slot->current_list != NULL_SLOT);
-					dlist_delete(&slot->dnode);
-					dlist_push_head(&slot->parent->busy_slot, &slot->dnode);
-					slot->current_list = BUSY_SLOT;
+					agent_send_slot_params(agent, slot, false, false);
 					break;
 				}
 				goto send_agtm_port_;
@@ -0,0 +1,793 @@
+/*-------------------------------------------------------------------------
+ *
+ * resultcache.c
+ *	  Coordinator-side cache of remote query results on replicated tables
+ *
+ * A read-only statement that only touches replicated tables is shipped to
+ * one datanode and its result is the same on every datanode.  Dashboards
+ * and lookup-table joins repeat such statements many times a second, so
+ * the coordinator backend keeps the rows it received, keyed by the shipped
+ * SQL text, the bound parameters, the current and session user, the
+ * row_security setting and the search_path, and serves the next execution
+ * of the same statement without a network round trip.
+ *
+ * The cache is private to each backend, nothing is shared between the
+ * backends of a coordinator or between coordinators.
+ *
+ * The datanode evaluates the statement with the snapshot of the
+ * coordinator, so an entry is only served to a statement whose snapshot
+ * sees the same committed transactions as the one it was read with: the
+ * same xmax and the same in-progress transactions.  Any commit in the
+ * cluster changes the snapshots the GTM hands out, whichever coordinator
+ * or datanode issued the write, so no invalidation message has to reach
+ * the other coordinators.  Relcache invalidation still drops the entries
+ * of altered or dropped tables, and tables with row level security are
+ * never cached, their policies may depend on anything.
+ *
+ * Portions Copyright (c) 2016-2017, ADB Development Group
+ *
+ * IDENTIFICATION
+ *	  src/backend/pgxc/pool/resultcache.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+#include "miscadmin.h"
+
+#include "access/hash.h"
+#include "access/htup_details.h"
+#include "access/xact.h"
+#include "catalog/namespace.h"
+#include "catalog/pg_class.h"
+#include "executor/executor.h"
+#include "lib/ilist.h"
+#include "lib/stringinfo.h"
+#include "nodes/nodeFuncs.h"
+#include "optimizer/clauses.h"
+#include "parser/parsetree.h"
+#include "pgxc/locator.h"
+#include "pgxc/pgxc.h"
+#include "pgxc/resultcache.h"
+#include "storage/proc.h"
+#include "utils/acl.h"
+#include "utils/builtins.h"
+#include "utils/hsearch.h"
+#include "utils/inval.h"
+#include "utils/memutils.h"
+#include "utils/rls.h"
+#include "utils/snapmgr.h"
+
+int remote_result_cache_size = 0;
+
+/*
+ * What decides the rows a snapshot sees, see ResultCacheSnapMatch().
+ * xids holds the xip entries then the subxip entries, each part sorted.
+ */
+typedef struct ResultCacheSnap
+{
+	TransactionId xmax;
+	uint32		xcnt;
+	int32		subxcnt;
+	bool		suboverflowed;
+	TransactionId *xids;
+} ResultCacheSnap;
+
+/*
+ * One cached result.  The key strings, the relids and the tuples are
+ * allocated in the same chunk, right after the struct.
+ */
+typedef struct ResultCacheEntry
+{
+	dlist_node	lru_node;		/* in ResultCacheLRU, most recent first */
+	dlist_node	bucket_node;	/* in ResultCacheBucket->entries */
+	uint32		hashvalue;		/* hash of the lookup key */
+	Oid			userid;
+	Oid			sessionid;
+	bool		row_security;
+	char	   *sql;
+	char	   *params;
+	int			paramlen;
+	char	   *search_path;
+	int			nrelids;
+	Oid		   *relids;			/* relations the statement reads */
+	ResultCacheSnap snap;		/* snapshot the rows were read with */
+	char	   *data;			/* MAXALIGN'ed remote MinimalTuples */
+	Size		datalen;
+	Size		size;			/* memory charged against the budget */
+} ResultCacheEntry;
+
+typedef struct ResultCacheBucket
+{
+	uint32		hashvalue;		/* hash key */
+	dlist_head	entries;		/* ResultCacheEntry with this hashvalue */
+} ResultCacheBucket;
+
+/*
+ * Invalidation generation of a relation.  A result collected while the
+ * generation of any of its relations moved may be stale and is not stored.
+ */
+typedef struct ResultCacheRel
+{
+	Oid			relid;			/* hash key */
+	uint32		generation;
+} ResultCacheRel;
+
+struct ResultCacheScan
+{
+	MemoryContext mcxt;			/* query context of the RemoteQueryState */
+
+	/* lookup key */
+	uint32		hashvalue;
+	Oid			userid;
+	Oid			sessionid;
+	bool		row_security;
+	char	   *sql;
+	char	   *params;
+	int			paramlen;
+	char	   *search_path;
+	int			nrelids;
+	Oid		   *relids;
+
+	/* invalidation state and snapshot when collecting started */
+	uint32		resetgen;
+	uint32	   *relgens;
+	ResultCacheSnap snap;
+
+	bool		looked_up;		/* ResultCacheLookup() done */
+	bool		hit;			/* rows come from the cache */
+	bool		filling;		/* rows are collected for the cache */
+	StringInfoData buf;			/* collected rows, or a copy of the entry */
+	Size		readpos;		/* next row in buf when hit */
+};
+
+typedef struct ResultCacheRelidsContext
+{
+	List	   *relids;
+	List	   *written;
+} ResultCacheRelidsContext;
+
+static MemoryContext ResultCacheContext = NULL;
+static HTAB *ResultCacheHash = NULL;
+static HTAB *ResultCacheRelHash = NULL;
+static dlist_head ResultCacheLRU = DLIST_STATIC_INIT(ResultCacheLRU);
+static Size ResultCacheUsed = 0;
+static uint32 ResultCacheResetGen = 0;
+
+/*
+ * Relations already handled by ResultCacheNoteWrite() in the current
+ * transaction, allocated in TopTransactionContext.  Writes of subtransactions
+ * stay in the list when they commit and also when they abort, which only
+ * keeps the relation out of the cache a little longer than needed.
+ */
+static List *ResultCacheWritten = NIL;
+static LocalTransactionId ResultCacheWrittenLxid = InvalidLocalTransactionId;
+
+static void ResultCacheInit(void);
+static void ResultCacheInvalCallback(Datum arg, Oid relid);
+static void ResultCacheRemove(ResultCacheEntry *entry);
+static void ResultCacheReset(void);
+static void ResultCacheEvict(Size need);
+static ResultCacheEntry *ResultCacheFind(ResultCacheScan *scan);
+static void ResultCacheStore(ResultCacheScan *scan);
+static uint32 ResultCacheRelGeneration(Oid relid);
+static bool ResultCacheRelidsWalker(Node *node, ResultCacheRelidsContext *context);
+static List *ResultCacheGetWritten(void);
+static void ResultCacheSetSnap(ResultCacheSnap *snap, Snapshot snapshot);
+static bool ResultCacheSnapMatch(ResultCacheSnap *a, ResultCacheSnap *b);
+
+#define ResultCacheBudget()		((Size) remote_result_cache_size * 1024)
+/* one result may not take more than a quarter of the cache */
+#define ResultCacheMaxResult()	(ResultCacheBudget() / 4)
+
+#define HashCombine(a, b)	((a) ^ ((b) + 0x9e3779b9 + ((a) << 6) + ((a) >> 2)))
+
+static void
+ResultCacheInit(void)
+{
+	HASHCTL		ctl;
+
+	if (ResultCacheContext)
+		return;
+
+	ResultCacheContext = AllocSetContextCreate(TopMemoryContext,
+											   "Remote result cache",
+											   ALLOCSET_DEFAULT_SIZES);
+
+	MemSet(&ctl, 0, sizeof(ctl));
+	ctl.keysize = sizeof(uint32);
+	ctl.entrysize = sizeof(ResultCacheBucket);
+	ctl.hcxt = ResultCacheContext;
+	ResultCacheHash = hash_create("Remote result cache", 256, &ctl,
+								  HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
+
+	MemSet(&ctl, 0, sizeof(ctl));
+	ctl.keysize = sizeof(Oid);
+	ctl.entrysize = sizeof(ResultCacheRel);
+	ctl.hcxt = ResultCacheContext;
+	ResultCacheRelHash = hash_create("Remote result cache relations", 64, &ctl,
+									 HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
+
+	CacheRegisterRelcacheCallback(ResultCacheInvalCallback, (Datum) 0);
+}
+
+/*
+ * Relcache invalidation callback: drop every result that read "relid",
+ * or everything on a full reset.
+ */
+static void
+ResultCacheInvalCallback(Datum arg, Oid relid)
+{
+	ResultCacheRel *rel;
+	dlist_mutable_iter iter;
+	int			i;
+
+	if (!OidIsValid(relid))
+	{
+		ResultCacheResetGen++;
+		ResultCacheReset();
+		return;
+	}
+
+	rel = (ResultCacheRel *) hash_search(ResultCacheRelHash, &relid, HASH_FIND, NULL);
+	if (rel == NULL)
+		return;				/* never read by a cacheable statement */
+	rel->generation++;
+
+	dlist_foreach_modify(iter, &ResultCacheLRU)
+	{
+		ResultCacheEntry *entry = dlist_container(ResultCacheEntry, lru_node, iter.cur);
+
+		for (i = 0; i < entry->nrelids; i++)
+		{
+			if (entry->relids[i] == relid)
+			{
+				ResultCacheRemove(entry);
+				break;
+			}
+		}
+	}
+}
+
+static void
+ResultCacheRemove(ResultCacheEntry *entry)
+{
+	ResultCacheBucket *bucket;
+
+	dlist_delete(&entry->lru_node);
+	dlist_delete(&entry->bucket_node);
+
+	bucket = (ResultCacheBucket *) hash_search(ResultCacheHash, &entry->hashvalue,
+											   HASH_FIND, NULL);
+	Assert(bucket);
+	if (dlist_is_empty(&bucket->entries))
+		hash_search(ResultCacheHash, &entry->hashvalue, HASH_REMOVE, NULL);
+
+	Assert(ResultCacheUsed >= entry->size);
+	ResultCacheUsed -= entry->size;
+	pfree(entry);
+}
+
+static void
+ResultCacheReset(void)
+{
+	while (!dlist_is_empty(&ResultCacheLRU))
+		ResultCacheRemove(dlist_container(ResultCacheEntry, lru_node,
+										  dlist_head_node(&ResultCacheLRU)));
+	Assert(ResultCacheUsed == 0);
+}
+
+/* make room for "need" bytes, least recently used first */
+static void
+ResultCacheEvict(Size need)
+{
+	while (!dlist_is_empty(&ResultCacheLRU) &&
+		   ResultCacheUsed + need > ResultCacheBudget())
+		ResultCacheRemove(dlist_container(ResultCacheEntry, lru_node,
+										  dlist_tail_node(&ResultCacheLRU)));
+}
+
+static ResultCacheEntry *
+ResultCacheFind(ResultCacheScan *scan)
+{
+	ResultCacheBucket *bucket;
+	dlist_iter	iter;
+
+	bucket = (ResultCacheBucket *) hash_search(ResultCacheHash, &scan->hashvalue,
+											   HASH_FIND, NULL);
+	if (bucket == NULL)
+		return NULL;
+
+	dlist_foreach(iter, &bucket->entries)
+	{
+		ResultCacheEntry *entry = dlist_container(ResultCacheEntry, bucket_node, iter.cur);
+
+		if (entry->userid == scan->userid &&
+			entry->sessionid == scan->sessionid &&
+			entry->row_security == scan->row_security &&
+			entry->paramlen == scan->paramlen &&
+			strcmp(entry->sql, scan->sql) == 0 &&
+			strcmp(entry->search_path, scan->search_path) == 0 &&
+			(scan->paramlen == 0 ||
+			 memcmp(entry->params, scan->params, scan->paramlen) == 0))
+			return entry;
+	}
+
+	return NULL;
+}
+
+static uint32
+ResultCacheRelGeneration(Oid relid)
+{
+	ResultCacheRel *rel;
+	bool		found;
+
+	rel = (ResultCacheRel *) hash_search(ResultCacheRelHash, &relid, HASH_ENTER, &found);
+	if (!found)
+		rel->generation = 0;
+
+	return rel->generation;
+}
+
+/*
+ * Collect the relations read by the shipped query.  Returns true when one
+ * of them makes the result uncacheable.
+ */
+static bool
+ResultCacheRelidsWalker(Node *node, ResultCacheRelidsContext *context)
+{
+	if (node == NULL)
+		return false;
+
+	if (IsA(node, RangeTblEntry))
+	{
+		RangeTblEntry  *rte = (RangeTblEntry *) node;
+		RelationLocInfo *rel_loc;
+		bool			replicated;
+
+		if (rte->rtekind != RTE_RELATION)
+			return false;
+
+		if (list_member_oid(context->written, rte->relid))
+			return true;
+
+		rel_loc = GetRelationLocInfo(rte->relid);
+		replicated = (rel_loc && IsRelationReplicated(rel_loc));
+		if (rel_loc)
+			FreeRelationLocInfo(rel_loc);
+		if (!replicated)
+			return true;
+
+		/* policies may depend on any setting of the session */
+		if (check_enable_rls(rte->relid, InvalidOid, true) == RLS_ENABLED)
+			return true;
+
+		context->relids = list_append_unique_oid(context->relids, rte->relid);
+		return false;
+	}
+
+	if (IsA(node, Query))
+		return query_tree_walker((Query *) node,
+								 ResultCacheRelidsWalker,
+								 (void *) context,
+								 QTW_EXAMINE_RTES);
+
+	return expression_tree_walker(node, ResultCacheRelidsWalker, (void *) context);
+}
+
+/*
+ * ResultCacheBeginScan
+ *
+ * Called at executor startup of a RemoteQuery, returns NULL when its
+ * result cannot be cached.
+ */
+ResultCacheScan *
+ResultCacheBeginScan(RemoteQueryState *node)
+{
+	RemoteQuery	   *rq = (RemoteQuery *) node->ss.ps.plan;
+	Query		   *query = rq->remote_query;
+	ResultCacheRelidsContext context;
+	ResultCacheScan *scan;
+	ListCell	   *lc;
+	uint32			hashvalue;
+	int				i;
+
+	if (remote_result_cache_size <= 0)
+	{
+		/* release the memory of a cache switched off by reload */
+		if (ResultCacheContext)
+			ResultCacheReset();
+		return NULL;
+	}
+
+	if (!IsCoordMaster())
+		return NULL;
+
+	if (query == NULL ||
+		query->commandType != CMD_SELECT ||
+		query->rowMarks != NIL ||
+		query->hasModifyingCTE ||
+		rq->sql_statement == NULL ||
+		rq->rq_params_internal ||
+		rq->exec_type != EXEC_ON_DATANODES ||
+		rq->exec_nodes == NULL ||
+		rq->exec_nodes->accesstype != RELATION_ACCESS_READ ||
+		!IsExecNodesReplicated(rq->exec_nodes) ||
+		node->cursor != NULL ||
+		node->update_cursor != NULL)
+		return NULL;
+
+	if (contain_mutable_functions((Node *) query))
+		return NULL;
+
+	context.relids = NIL;
+	context.written = ResultCacheGetWritten();
+	if (ResultCacheRelidsWalker((Node *) query, &context) ||
+		context.relids == NIL)
+	{
+		list_free(context.relids);
+		return NULL;
+	}
+
+	scan = (ResultCacheScan *) palloc0(sizeof(ResultCacheScan));
+	scan->mcxt = CurrentMemoryContext;
+	scan->userid = GetUserId();
+	scan->sessionid = GetSessionUserId();
+	scan->row_security = row_security;
+	scan->sql = rq->sql_statement;
+	scan->params = node->paramval_data;
+	scan->paramlen = node->paramval_data ? node->paramval_len : 0;
+	scan->search_path = pstrdup(namespace_search_path ? namespace_search_path : "");
+	scan->nrelids = list_length(context.relids);
+	scan->relids = (Oid *) palloc(sizeof(Oid) * scan->nrelids);
+	scan->relgens = (uint32 *) palloc(sizeof(uint32) * scan->nrelids);
+	i = 0;
+	foreach (lc, context.relids)
+		scan->relids[i++] = lfirst_oid(lc);
+	list_free(context.relids);
+
+	hashvalue = hash_any((const unsigned char *) scan->sql, strlen(scan->sql));
+	hashvalue = HashCombine(hashvalue, hash_uint32(scan->userid));
+	hashvalue = HashCombine(hashvalue, hash_uint32(scan->sessionid));
+	hashvalue = HashCombine(hashvalue, hash_uint32(scan->row_security));
+	hashvalue = HashCombine(hashvalue,
+							hash_any((const unsigned char *) scan->search_path,
+									 strlen(scan->search_path)));
+	if (scan->paramlen > 0)
+		hashvalue = HashCombine(hashvalue,
+								hash_any((const unsigned char *) scan->params,
+										 scan->paramlen));
+	scan->hashvalue = hashvalue;
+
+	return scan;
+}
+
+/*
+ * ResultCacheLookup
+ *
+ * Called before the query is sent to the datanode.  Returns true if the
+ * rows are served by ResultCacheNext(), otherwise starts collecting them.
+ */
+bool
+ResultCacheLookup(ResultCacheScan *scan)
+{
+	ResultCacheEntry *entry;
+	MemoryContext oldcontext;
+	int			i;
+
+	Assert(!scan->looked_up);
+	scan->looked_up = true;
+
+	if (!ActiveSnapshotSet())
+		return false;
+
+	ResultCacheInit();
+
+	/* see DDL of other sessions before trusting the cache */
+	AcceptInvalidationMessages();
+
+	oldcontext = MemoryContextSwitchTo(scan->mcxt);
+	ResultCacheSetSnap(&scan->snap, GetActiveSnapshot());
+	MemoryContextSwitchTo(oldcontext);
+
+	entry = ResultCacheFind(scan);
+	if (entry && !ResultCacheSnapMatch(&entry->snap, &scan->snap))
+	{
+		/* read with another set of committed transactions */
+		ResultCacheRemove(entry);
+		entry = NULL;
+	}
+
+	if (entry)
+	{
+		dlist_move_head(&ResultCacheLRU, &entry->lru_node);
+
+		/*
+		 * Copy the rows, the entry may be invalidated while the query
+		 * is still reading them.
+		 */
+		scan->buf.data = MemoryContextAlloc(scan->mcxt, entry->datalen + 1);
+		memcpy(scan->buf.data, entry->data, entry->datalen);
+		scan->buf.len = scan->buf.maxlen = entry->datalen;
+		scan->readpos = 0;
+		scan->hit = true;
+		return true;
+	}
+
+	scan->resetgen = ResultCacheResetGen;
+	for (i = 0; i < scan->nrelids; i++)
+		scan->relgens[i] = ResultCacheRelGeneration(scan->relids[i]);
+
+	scan->buf.data = MemoryContextAlloc(scan->mcxt, BLCKSZ);
+	scan->buf.maxlen = BLCKSZ;
+	resetStringInfo(&scan->buf);
+	scan->filling = true;
+
+	return false;
+}
+
+bool
+ResultCacheIsHit(ResultCacheScan *scan)
+{
+	return scan->hit;
+}
+
+TupleTableSlot *
+ResultCacheNext(ResultCacheScan *scan, TupleTableSlot *slot)
+{
+	MinimalTuple	tuple;
+
+	Assert(scan->hit);
+	if (scan->readpos >= scan->buf.len)
+		return ExecClearTuple(slot);
+
+	tuple = (MinimalTuple) (scan->buf.data + scan->readpos);
+	scan->readpos += MAXALIGN(tuple->t_len + sizeof(Oid));
+
+	ExecStoreMinimalTuple(tuple, slot, false);
+	slot->tts_xcnodeoid = MiniTupGetRemoteNode(tuple);
+
+	return slot;
+}
+
+/*
+ * ResultCacheCollect
+ *
+ * Remember a row received from the datanode, an empty slot ends the
+ * result and stores it.
+ */
+void
+ResultCacheCollect(ResultCacheScan *scan, TupleTableSlot *slot)
+{
+	MinimalTuple	tuple;
+	Size			len;
+
+	if (!scan->filling)
+		return;
+
+	if (TupIsNull(slot))
+	{
+		scan->filling = false;
+		ResultCacheStore(scan);
+		pfree(scan->buf.data);
+		scan->buf.data = NULL;
+		return;
+	}
+
+	tuple = ExecCopyRemoteSlotMinimalTuple(slot);
+	len = tuple->t_len + sizeof(Oid);
+	if (scan->buf.len + MAXALIGN(len) > ResultCacheMaxResult())
+	{
+		/* too large to be worth it, stop collecting */
+		scan->filling = false;
+		pfree(scan->buf.data);
+		scan->buf.data = NULL;
+	} else
+	{
+		enlargeStringInfo(&scan->buf, MAXALIGN(len));
+		memcpy(scan->buf.data + scan->buf.len, tuple, len);
+		memset(scan->buf.data + scan->buf.len + len, 0, MAXALIGN(len) - len);
+		scan->buf.len += MAXALIGN(len);
+	}
+	pfree(tuple);
+}
+
+void
+ResultCacheRescan(ResultCacheScan *scan)
+{
+	if (scan->hit)
+	{
+		scan->readpos = 0;
+	} else if (scan->filling)
+	{
+		/* the rows will be read again from the tuplestore */
+		scan->filling = false;
+		pfree(scan->buf.data);
+		scan->buf.data = NULL;
+	}
+}
+
+static void
+ResultCacheStore(ResultCacheScan *scan)
+{
+	ResultCacheEntry   *entry;
+	ResultCacheBucket  *bucket;
+	Size				sqllen,
+						pathlen,
+						xidslen,
+						size;
+	char			   *ptr;
+	bool				found;
+	int					i;
+
+	if (scan->resetgen != ResultCacheResetGen)
+		return;
+	for (i = 0; i < scan->nrelids; i++)
+	{
+		if (ResultCacheRelGeneration(scan->relids[i]) != scan->relgens[i])
+			return;
+	}
+
+	/* replace the result of another execution of the same statement */
+	entry = ResultCacheFind(scan);
+	if (entry)
+		ResultCacheRemove(entry);
+
+	sqllen = strlen(scan->sql) + 1;
+	pathlen = strlen(scan->search_path) + 1;
+	xidslen = sizeof(TransactionId) * (scan->snap.xcnt + scan->snap.subxcnt);
+	size = MAXALIGN(sizeof(ResultCacheEntry)) +
+		   MAXALIGN(sqllen) +
+		   MAXALIGN(pathlen) +
+		   MAXALIGN(scan->paramlen) +
+		   MAXALIGN(sizeof(Oid) * scan->nrelids) +
+		   MAXALIGN(xidslen) +
+		   scan->buf.len;
+	if (size > ResultCacheBudget())
+		return;
+	ResultCacheEvict(size);
+
+	ptr = MemoryContextAlloc(ResultCacheContext, size);
+	entry = (ResultCacheEntry *) ptr;
+	ptr += MAXALIGN(sizeof(ResultCacheEntry));
+
+	entry->hashvalue = scan->hashvalue;
+	entry->userid = scan->userid;
+	entry->sessionid = scan->sessionid;
+	entry->row_security = scan->row_security;
+	entry->sql = ptr;
+	memcpy(ptr, scan->sql, sqllen);
+	ptr += MAXALIGN(sqllen);
+	entry->search_path = ptr;
+	memcpy(ptr, scan->search_path, pathlen);
+	ptr += MAXALIGN(pathlen);
+	entry->params = ptr;
+	entry->paramlen = scan->paramlen;
+	if (scan->paramlen > 0)
+		memcpy(ptr, scan->params, scan->paramlen);
+	ptr += MAXALIGN(scan->paramlen);
+	entry->relids = (Oid *) ptr;
+	entry->nrelids = scan->nrelids;
+	memcpy(ptr, scan->relids, sizeof(Oid) * scan->nrelids);
+	ptr += MAXALIGN(sizeof(Oid) * scan->nrelids);
+	entry->snap = scan->snap;
+	entry->snap.xids = (TransactionId *) ptr;
+	if (xidslen > 0)
+		memcpy(ptr, scan->snap.xids, xidslen);
+	ptr += MAXALIGN(xidslen);
+	entry->data = ptr;
+	entry->datalen = scan->buf.len;
+	memcpy(ptr, scan->buf.data, scan->buf.len);
+	entry->size = size;
+
+	bucket = (ResultCacheBucket *) hash_search(ResultCacheHash, &entry->hashvalue,
+											   HASH_ENTER, &found);
+	if (!found)
+		dlist_init(&bucket->entries);
+	dlist_push_head(&bucket->entries, &entry->bucket_node);
+	dlist_push_head(&ResultCacheLRU, &entry->lru_node);
+	ResultCacheUsed += size;
+}
+
+static void
+ResultCacheSetSnap(ResultCacheSnap *snap, Snapshot snapshot)
+{
+	int			nxids = snapshot->xcnt + Max(snapshot->subxcnt, 0);
+
+	snap->xmax = snapshot->xmax;
+	snap->xcnt = snapshot->xcnt;
+	snap->subxcnt = Max(snapshot->subxcnt, 0);
+	snap->suboverflowed = snapshot->suboverflowed;
+	snap->xids = (TransactionId *) palloc(sizeof(TransactionId) * Max(nxids, 1));
+	if (snap->xcnt > 0)
+	{
+		memcpy(snap->xids, snapshot->xip, sizeof(TransactionId) * snap->xcnt);
+		qsort(snap->xids, snap->xcnt, sizeof(TransactionId), xidComparator);
+	}
+	if (snap->subxcnt > 0)
+	{
+		memcpy(snap->xids + snap->xcnt, snapshot->subxip,
+			   sizeof(TransactionId) * snap->subxcnt);
+		qsort(snap->xids + snap->xcnt, snap->subxcnt, sizeof(TransactionId),
+			  xidComparator);
+	}
+}
+
+/*
+ * Two snapshots with the same xmax and the same in-progress transactions
+ * see the same committed transactions.  Anything that ended or started
+ * between them makes them differ, which is stricter than needed but does
+ * not depend on knowing what the other transactions wrote.
+ */
+static bool
+ResultCacheSnapMatch(ResultCacheSnap *a, ResultCacheSnap *b)
+{
+	return a->xmax == b->xmax &&
+		   a->xcnt == b->xcnt &&
+		   a->subxcnt == b->subxcnt &&
+		   a->suboverflowed == b->suboverflowed &&
+		   memcmp(a->xids, b->xids,
+				  sizeof(TransactionId) * (a->xcnt + a->subxcnt)) == 0;
+}
+
+/* relations handled by ResultCacheNoteWrite() in this transaction */
+static List *
+ResultCacheGetWritten(void)
+{
+	if (ResultCacheWrittenLxid != MyProc->lxid)
+	{
+		/* the old list went away with its transaction */
+		ResultCacheWritten = NIL;
+		ResultCacheWrittenLxid = MyProc->lxid;
+	}
+
+	return ResultCacheWritten;
+}
+
+/*
+ * ResultCacheNoteWrite
+ *
+ * The current transaction modifies "relid".  Its own changes are not told
+ * apart by the snapshot, so its statements on the relation neither use nor
+ * fill the cache until the transaction ends.
+ */
+void
+ResultCacheNoteWrite(Oid relid)
+{
+	MemoryContext		oldcontext;
+
+	if (remote_result_cache_size <= 0 || !IsCoordMaster())
+		return;
+
+	if (list_member_oid(ResultCacheGetWritten(), relid))
+		return;
+
+	oldcontext = MemoryContextSwitchTo(TopTransactionContext);
+	ResultCacheWritten = lappend_oid(ResultCacheWritten, relid);
+	MemoryContextSwitchTo(oldcontext);
+}
+
+/*
+ * ResultCacheNoteWrites
+ *
+ * ResultCacheNoteWrite() for every table a plan is going to modify.
+ */
+void
+ResultCacheNoteWrites(PlannedStmt *stmt)
+{
+	ListCell   *lc;
+
+	if (remote_result_cache_size <= 0 || !IsCoordMaster())
+		return;
+
+	if (stmt->commandType == CMD_SELECT && !stmt->hasModifyingCTE)
+		return;
+
+	foreach (lc, stmt->rtable)
+	{
+		RangeTblEntry *rte = (RangeTblEntry *) lfirst(lc);
+
+		if (rte->rtekind == RTE_RELATION &&
+			(rte->requiredPerms & (ACL_INSERT | ACL_UPDATE | ACL_DELETE)) != 0)
+			ResultCacheNoteWrite(rte->relid);
+	}
+}
@@ -102,6 +102,13 @@
 #include "utils/timeout.h"
 #include "utils/timestamp.h"
 #include "utils/tqual.h"
+#ifdef ADB
+#include "catalog/pgxc_class.h"
+#include "intercomm/inter-node.h"
+#include "pgxc/pgxc.h"
+#include "pgxc/pgxcnode.h"
+#include "pgxc/poolmgr.h"
+#endif
 
 
 /*
@@ -123,6 +130,10 @@ int			autovacuum_vac_cost_limit;
 
 int			Log_autovacuum_min_duration = -1;
 
+#ifdef ADB
+bool		autovacuum_coordinator_analyze = true;
+#endif
+
 /* how long to keep pgstat data in the launcher, in milliseconds */
 #define STATS_READ_DELAY 1000
 
@@ -152,6 +163,13 @@ static int	default_multixact_freeze_table_age;
 /* Memory context for long-lived data */
 static MemoryContext AutovacMemCxt;
 
+#ifdef ADB
+/* RemoteAnalyzeInfo of the distributed tables of this database, by relid */
+static HTAB *autovac_remote_info = NULL;
+/* this worker is connected to the pooler */
+static bool autovac_remote_ready = false;
+#endif
+
 /* struct to keep track of databases in launcher */
 typedef struct avl_dbase
 {
@@ -321,6 +339,10 @@ static void av_sighup_handler(SIGNAL_ARGS);
 static void avl_sigusr2_handler(SIGNAL_ARGS);
 static void avl_sigterm_handler(SIGNAL_ARGS);
 static void autovac_refresh_stats(void);
+#ifdef ADB
+static void autovac_init_remote(void);
+static void autovac_fetch_remote_info(void);
+#endif
 
 
 
@@ -1961,6 +1983,16 @@ do_autovacuum(void)
 	/* StartTransactionCommand changed elsewhere */
 	MemoryContextSwitchTo(AutovacMemCxt);
 
+#ifdef ADB
+	if (IsCoordMaster() && autovacuum_coordinator_analyze)
+	{
+		autovac_fetch_remote_info();
+		/* an error in there ends the transaction and the stats snapshot */
+		dbentry = pgstat_fetch_stat_dbentry(MyDatabaseId);
+		MemoryContextSwitchTo(AutovacMemCxt);
+	}
+#endif
+
 	/* The database hash where pgstat keeps shared relations */
 	shared = pgstat_fetch_stat_dbentry(InvalidOid);
 
@@ -2326,6 +2358,12 @@ do_autovacuum(void)
 		{
 			/* have at it */
 			MemoryContextSwitchTo(TopTransactionContext);
+#ifdef ADB
+			/* the coordinator gets the statistics of distributed tables remotely */
+			if (IsCoordMaster() &&
+				SearchSysCacheExists1(PGXCCLASSRELID, ObjectIdGetDatum(relid)))
+				autovac_init_remote();
+#endif
 			autovacuum_do_vac_analyze(tab, bstrategy);
 
 			/*
@@ -2802,11 +2840,125 @@ relation_needs_vacanalyze(Oid relid,
 		*doanalyze = false;
 	}
 
+#ifdef ADB
+	/*
+	 * The coordinator keeps no rows of a distributed table, its statistics
+	 * are merged from what the datanodes collected by their own analyze.
+	 * Refresh that copy once the datanodes analyzed again.  While changes
+	 * past the threshold still wait for the analyze of other datanodes,
+	 * hold off for one naptime so a bulk load is merged once rather than
+	 * once per datanode.
+	 */
+	if (autovac_remote_info && AutoVacuumingActive())
+	{
+		RemoteAnalyzeInfo *remote;
+
+		remote = (RemoteAnalyzeInfo *) hash_search(autovac_remote_info, &relid,
+												   HASH_FIND, NULL);
+		if (remote)
+		{
+			TimestampTz last_analyze = 0;
+
+			if (tabentry)
+				last_analyze = Max(tabentry->analyze_timestamp,
+								   tabentry->autovac_analyze_timestamp);
+			anlthresh = (float4) anl_base_thresh +
+						anl_scale_factor * classForm->reltuples;
+
+			elog(DEBUG3, "%s: remote anl: %.0f (threshold %.0f), datanodes %s analyzed since last merge",
+				 NameStr(classForm->relname), remote->changes, anlthresh,
+				 remote->last_analyze > last_analyze ? "have" : "have not");
+
+			*doanalyze = (remote->last_analyze > last_analyze &&
+						  (remote->changes <= anlthresh ||
+						   TimestampDifferenceExceeds(remote->last_analyze,
+													  GetCurrentTimestamp(),
+													  autovacuum_naptime * 1000)));
+		}
+	}
+#endif
+
 	/* ANALYZE refuses to work with pg_statistics */
 	if (relid == StatisticRelationId)
 		*doanalyze = false;
 }
 
+#ifdef ADB
+/*
+ * autovac_init_remote
+ *		Connect this worker to the pooler, so it can reach the datanodes
+ */
+static void
+autovac_init_remote(void)
+{
+	if (autovac_remote_ready)
+		return;
+
+	InitMultinodeExecutor(false);
+	InitNodeExecutor(false);
+	PoolManagerReconnect();
+	on_proc_exit(PGXCNodeCleanAndRelease, 0);
+
+	autovac_remote_ready = true;
+}
+
+/*
+ * autovac_fetch_remote_info
+ *		Poll the datanodes for the analyze activity of distributed tables
+ *
+ * Builds autovac_remote_info in the current memory context.  Failing to
+ * reach the datanodes is reported but does not stop the worker, the local
+ * tables still get processed.
+ */
+static void
+autovac_fetch_remote_info(void)
+{
+	MemoryContext	mcxt = CurrentMemoryContext;
+	Relation		rel;
+	HeapScanDesc	scan;
+	HeapTuple		tuple;
+	List		   *relids = NIL;
+
+	autovac_remote_info = NULL;
+
+	rel = heap_open(PgxcClassRelationId, AccessShareLock);
+	scan = heap_beginscan_catalog(rel, 0, NULL);
+	while ((tuple = heap_getnext(scan, ForwardScanDirection)) != NULL)
+		relids = lappend_oid(relids, ((Form_pgxc_class) GETSTRUCT(tuple))->pcrelid);
+	heap_endscan(scan);
+	heap_close(rel, AccessShareLock);
+
+	if (relids == NIL)
+		return;
+
+	PG_TRY();
+	{
+		autovac_init_remote();
+		PushActiveSnapshot(GetTransactionSnapshot());
+		autovac_remote_info = get_remote_analyze_info(relids);
+		PopActiveSnapshot();
+	}
+	PG_CATCH();
+	{
+		HOLD_INTERRUPTS();
+		EmitErrorReport();
+
+		AbortOutOfAnyTransaction();
+		FlushErrorState();
+
+		/* restart our transaction for the following operations */
+		StartTransactionCommand();
+		RESUME_INTERRUPTS();
+
+		MemoryContextSwitchTo(mcxt);
+		autovac_remote_info = NULL;
+	}
+	PG_END_TRY();
+
+	list_free(relids);
+}
+#endif
+
 /*
  * autovacuum_do_vac_analyze
  *		Vacuum and/or analyze the specified table
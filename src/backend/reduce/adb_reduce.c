@@ -52,6 +52,13 @@ static List		   *GroupReduceList = NIL;
 #define RDC_BACKEND_HOLD	0
 #define RDC_REDUCE_HOLD		1
 
+/*
+ * Body of the data message telling a plan node switched to its adaptive
+ * reduce, any tuple body is longer than it.
+ */
+#define RDC_ADAPT_MARK		'A'
+#define RDC_ADAPT_MARK_LEN	1
+
 static void ResetSelfReduce(void);
 static void InitCommunicationChannel(void);
 static void CloseBackendPort(void);
@@ -470,9 +477,52 @@ SendSlotToRemote(RdcPort *port, List *dest_nodes, TupleTableSlot *slot)
 	port->send_num++;
 }
 
+void
+SendAdaptToRemote(RdcPort *port, List *dest_nodes)
+{
+	StringInfo		msg;
+	ListCell	   *lc;
+	int				num;
+	char			mark = RDC_ADAPT_MARK;
+	unsigned int	marklen = RDC_ADAPT_MARK_LEN;
+
+	AssertArg(port);
+	if (!dest_nodes)
+		return ;
+
+	msg = RdcMsgBuf(port);
+
+	resetStringInfo(msg);
+	rdc_beginmessage(msg, MSG_P2R_DATA);
+	rdc_sendint(msg, marklen, sizeof(marklen));
+	rdc_sendbytes(msg, &mark, marklen);
+	num = list_length(dest_nodes);
+	rdc_sendint(msg, num, sizeof(num));
+	foreach (lc, dest_nodes)
+		rdc_sendRdcPortID(msg, lfirst_oid(lc));
+	rdc_endmessage(port, msg);
+
+	if (rdc_flush(port) == EOF)
+		ereport(ERROR,
+				(errmsg("fail to send adapt message to remote"),
+				 errdetail("%s", RdcError(port))));
+
+	elog(DEBUG1,
+		 "Backend send adapt message of" PLAN_PORT_PRINT_FORMAT,
+		 RdcSelfID(port));
+
+	port->send_num++;
+}
+
+/*
+ * tuple_cxt is where the received tuple is copied to, NULL means the
+ * memory context of the slot.
+ */
 TupleTableSlot *
 GetSlotFromRemote(RdcPort *port, TupleTableSlot *slot,
+				  MemoryContext tuple_cxt,
 				  Oid *slot_oid, Oid *eof_oid,
+				  Oid *adapt_oid,
 				  List **closed_remote)
 {
 	StringInfo	msg;
@@ -515,8 +565,17 @@ GetSlotFromRemote(RdcPort *port, TupleTableSlot *slot,
 				data = rdc_getmsgbytes(msg, msg_len);
 				rdc_getmsgend(msg);
 
+				if (msg_len == RDC_ADAPT_MARK_LEN)
+				{
+					Assert(data[0] == RDC_ADAPT_MARK);
+					if (adapt_oid)
+						*adapt_oid = (Oid) rid;
+					break;
+				}
+
 				tuplen = msg_len + MINIMAL_TUPLE_DATA_OFFSET;
-				tuple = (MinimalTuple) MemoryContextAlloc(slot->tts_mcxt, tuplen);
+				tuple = (MinimalTuple) MemoryContextAlloc(tuple_cxt ? tuple_cxt : slot->tts_mcxt,
+														  tuplen);
 				tupbody = (char *) tuple + MINIMAL_TUPLE_DATA_OFFSET;
 				tuple->t_len = tuplen;
 				memcpy(tupbody, data, msg_len);
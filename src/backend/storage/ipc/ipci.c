@@ -43,15 +43,21 @@
 #include "storage/procsignal.h"
 #include "storage/sinvaladt.h"
 #include "storage/spin.h"
+#include "utils/hlc.h"
 #include "utils/snapmgr.h"
 #ifdef ADB
 #include "pgxc/nodemgr.h"
+#include "pgxc/noderange.h"
 #include "pgxc/pause.h"
 #include "pgxc/pgxc.h"
+#include "pgxc/poolmgr.h"
 #endif
 #if defined(ADBMGRD)
 #include "postmaster/adbmonitor.h"
 #endif
+#ifdef AGTM
+#include "agtm/agtm_sequence.h"
+#endif
 
 shmem_startup_hook_type shmem_startup_hook = NULL;
 
@@ -148,15 +154,21 @@ CreateSharedMemoryAndSemaphores(bool makePrivate, int port)
 		size = add_size(size, BTreeShmemSize());
 		size = add_size(size, SyncScanShmemSize());
 		size = add_size(size, AsyncShmemSize());
+		size = add_size(size, HlcShmemSize());
 #ifdef ADB
 		if (IS_PGXC_COORDINATOR)
 			size = add_size(size, ClusterLockShmemSize());
 		size = add_size(size, NodeTablesShmemSize());
+		size = add_size(size, PoolManagerShmemSize());
+		size = add_size(size, NodeRangeShmemSize());
 #endif
 
 #if defined(ADBMGRD)
 		size = add_size(size, AdbMonitorShmemSize());
 #endif /* ADBMGRD */
+#ifdef AGTM
+		size = add_size(size, AgtmSequenceShmemSize());
+#endif
 
 #ifdef EXEC_BACKEND
 		size = add_size(size, ShmemBackendArraySize());
@@ -275,14 +287,20 @@ CreateSharedMemoryAndSemaphores(bool makePrivate, int port)
 	BTreeShmemInit();
 	SyncScanShmemInit();
 	AsyncShmemInit();
+	HlcShmemInit();
 
 #ifdef ADB
 	NodeTablesShmemInit();
+	PoolManagerShmemInit();
+	NodeRangeShmemInit();
 #endif
 	
 #if defined(ADBMGRD)
 	AdbMonitorShmemInit();
 #endif /* ADBMGRD */
+#ifdef AGTM
+	AgtmSequenceShmemInit();
+#endif
 
 #ifdef EXEC_BACKEND
 
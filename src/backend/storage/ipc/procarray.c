@@ -84,6 +84,9 @@
 #include "utils/builtins.h"
 #include "utils/rel.h"
 #include "utils/snapmgr.h"
+#ifdef AGTM
+#include "agtm/agtm_msg.h"
+#endif
 #ifdef ADB
 #include "agtm/agtm.h"
 #include "pgxc/nodemgr.h"
@@ -123,6 +126,14 @@ typedef struct ProcArrayStruct
 	/* oldest catalog xmin of any replication slot */
 	TransactionId replication_slot_catalog_xmin;
 
+#ifdef ADB
+	/*
+	 * Newest cleanup horizon AGTM has handed this datanode, see
+	 * ProcArrayAdvanceNodeXmin.
+	 */
+	pg_atomic_uint32 node_xmin;
+#endif /* ADB */
+
 	/* indexes into allPgXact[], has PROCARRAY_MAXPROCS entries */
 	int			pgprocnos[FLEXIBLE_ARRAY_MEMBER];
 } ProcArrayStruct;
@@ -132,6 +143,11 @@ static ProcArrayStruct *procArray;
 static PGPROC *allProcs;
 static PGXACT *allPgXact;
 
+#ifdef ADB
+/* GUC: let datanode autovacuum use the horizon of its own node */
+bool		node_cleanup_horizon = false;
+#endif /* ADB */
+
 /*
  * Bookkeeping for tracking emulated transactions in recovery
  */
@@ -206,6 +222,12 @@ static void KnownAssignedXidsReset(void);
 static inline void ProcArrayEndTransactionInternal(PGPROC *proc,
 								PGXACT *pgxact, TransactionId latestXid);
 static void ProcArrayGroupClearXid(PGPROC *proc, TransactionId latestXid);
+#ifdef ADB
+static TransactionId GetNodeGlobalXmin(TransactionId xmin, TransactionId xmax);
+static void CheckSnapshotNodeXmin(Snapshot snapshot, TransactionId xmin,
+					  TransactionId xmax, int xcnt, int subxcnt,
+					  bool advance_xmin);
+#endif /* ADB */
 
 /*
  * Report shared-memory space needed by CreateSharedProcArray.
@@ -279,6 +301,9 @@ CreateSharedProcArray(void)
 		procArray->headKnownAssignedXids = 0;
 		SpinLockInit(&procArray->known_assigned_xids_lck);
 		procArray->lastOverflowedXid = InvalidTransactionId;
+#ifdef ADB
+		pg_atomic_init_u32(&procArray->node_xmin, InvalidTransactionId);
+#endif /* ADB */
 	}
 
 	allProcs = ProcGlobal->allProcs;
@@ -486,6 +511,9 @@ ProcArrayEndTransaction(PGPROC *proc, TransactionId latestXid)
 		pgxact->vacuumFlags &= ~PROC_VACUUM_STATE_MASK;
 		pgxact->delayChkpt = false;		/* be sure this is cleared in abort */
 		proc->recoveryConflictPending = false;
+#ifdef AGTM
+		proc->xactNodes = 0;
+#endif
 
 		Assert(pgxact->nxids == 0);
 		Assert(pgxact->overflowed == false);
@@ -508,6 +536,9 @@ ProcArrayEndTransactionInternal(PGPROC *proc, PGXACT *pgxact,
 	pgxact->vacuumFlags &= ~PROC_VACUUM_STATE_MASK;
 	pgxact->delayChkpt = false; /* be sure this is cleared in abort */
 	proc->recoveryConflictPending = false;
+#ifdef AGTM
+	proc->xactNodes = 0;
+#endif
 
 	/* Clear the subtransaction-XID cache too while holding the lock */
 	pgxact->nxids = 0;
@@ -665,6 +696,9 @@ ProcArrayClearTransaction(PGPROC *proc)
 	proc->lxid = InvalidLocalTransactionId;
 	pgxact->xmin = InvalidTransactionId;
 	proc->recoveryConflictPending = false;
+#ifdef AGTM
+	proc->xactNodes = 0;
+#endif
 
 	/* redundant, but just in case */
 	pgxact->vacuumFlags &= ~PROC_VACUUM_STATE_MASK;
@@ -1544,6 +1578,73 @@ GetOldestXmin(Relation rel, bool ignoreVacuum)
 	return result;
 }
 
+#ifdef AGTM
+/*
+ * GetOldestXminForNode -- cleanup horizon of some datanodes
+ *
+ * Like GetOldestXmin(NULL, true), but only transactions whose coordinator
+ * reported they involve any of "nodes" count; one that reported nothing
+ * yet counts for all nodes.  Our own entry is skipped too: it belongs to
+ * the requesting datanode, which adds its local transactions itself, and
+ * vacuum_defer_cleanup_age is applied there.
+ */
+TransactionId
+GetOldestXminForNode(uint64 nodes)
+{
+	ProcArrayStruct *arrayP = procArray;
+	TransactionId result;
+	int			index;
+
+	volatile TransactionId replication_slot_xmin = InvalidTransactionId;
+	volatile TransactionId replication_slot_catalog_xmin = InvalidTransactionId;
+
+	LWLockAcquire(ProcArrayLock, LW_SHARED);
+
+	result = ShmemVariableCache->latestCompletedXid;
+	Assert(TransactionIdIsNormal(result));
+	TransactionIdAdvance(result);
+
+	for (index = 0; index < arrayP->numProcs; index++)
+	{
+		int			pgprocno = arrayP->pgprocnos[index];
+		volatile PGPROC *proc = &allProcs[pgprocno];
+		volatile PGXACT *pgxact = &allPgXact[pgprocno];
+		TransactionId xid;
+
+		if (proc == MyProc ||
+			(proc->xactNodes != 0 && (proc->xactNodes & nodes) == 0))
+			continue;
+
+		if (pgxact->vacuumFlags & (PROC_IN_LOGICAL_DECODING | PROC_IN_VACUUM))
+			continue;
+
+		xid = pgxact->xid;
+		if (TransactionIdIsNormal(xid) &&
+			TransactionIdPrecedes(xid, result))
+			result = xid;
+
+		xid = pgxact->xmin;
+		if (TransactionIdIsNormal(xid) &&
+			TransactionIdPrecedes(xid, result))
+			result = xid;
+	}
+
+	replication_slot_xmin = procArray->replication_slot_xmin;
+	replication_slot_catalog_xmin = procArray->replication_slot_catalog_xmin;
+
+	LWLockRelease(ProcArrayLock);
+
+	if (TransactionIdIsValid(replication_slot_xmin) &&
+		NormalTransactionIdPrecedes(replication_slot_xmin, result))
+		result = replication_slot_xmin;
+	if (TransactionIdIsValid(replication_slot_catalog_xmin) &&
+		NormalTransactionIdPrecedes(replication_slot_catalog_xmin, result))
+		result = replication_slot_catalog_xmin;
+
+	return result;
+}
+#endif /* AGTM */
+
 /*
  * GetMaxSnapshotXidCount -- get max size for snapshot XID array
  *
@@ -1617,6 +1718,8 @@ GetSnapshotData(Snapshot snapshot)
 #ifdef ADB
 	bool		is_under_agtm;
 	bool		hint;
+	bool		node_xmin_used = false;
+	bool		xmin_set = false;
 #endif /* ADB */
 
 	Assert(snapshot != NULL);
@@ -1715,7 +1818,9 @@ GetSnapshotData(Snapshot snapshot)
 	{
 		if(TransactionIdPrecedes(xmax, snapshot->xmax))
 			xmax = snapshot->xmax;
-		globalxmin = xmin = snapshot->xmin;
+		xmin = snapshot->xmin;
+		globalxmin = GetNodeGlobalXmin(xmin, xmax);
+		node_xmin_used = TransactionIdPrecedes(xmin, globalxmin);
 	}else
 #endif /* ADB */
 	globalxmin = xmin = xmax;
@@ -1775,6 +1880,11 @@ GetSnapshotData(Snapshot snapshot)
 			 */
 			if (NormalTransactionIdPrecedes(xid, xmin))
 				xmin = xid;
+#ifdef ADB
+			/* xmin starts below globalxmin, so local xids must go here too */
+			if (node_xmin_used && NormalTransactionIdPrecedes(xid, globalxmin))
+				globalxmin = xid;
+#endif /* ADB */
 			if (pgxact == MyPgXact)
 				continue;
 
@@ -1919,15 +2029,32 @@ GetSnapshotData(Snapshot snapshot)
 	replication_slot_catalog_xmin = procArray->replication_slot_catalog_xmin;
 
 	if (!TransactionIdIsValid(MyPgXact->xmin))
+#ifdef ADB
+	{
 		MyPgXact->xmin = TransactionXmin = xmin;
+		xmin_set = true;
+	}
+#else
+		MyPgXact->xmin = TransactionXmin = xmin;
+#endif /* ADB */
 
 	LWLockRelease(ProcArrayLock);
 
+#ifdef ADB
+	if (is_under_agtm && IS_PGXC_DATANODE)
+		CheckSnapshotNodeXmin(snapshot, xmin, xmax, count, subcount,
+							  xmin_set && !suboverflowed);
+#endif /* ADB */
+
 	/*
 	 * Update globalxmin to include actual process xids.  This is a slightly
 	 * different way of computing it than GetOldestXmin uses, but should give
 	 * the same result.
 	 */
+#ifdef ADB
+	/* unless the node horizon applies, see CheckSnapshotNodeXmin */
+	if (!node_xmin_used)
+#endif /* ADB */
 	if (TransactionIdPrecedes(xmin, globalxmin))
 		globalxmin = xmin;
 
@@ -4329,4 +4456,113 @@ void EnlargeSnapshotXip(Snapshot snapshot, uint32 need_size)
 	snapshot->xip = p;
 	snapshot->max_xcnt = new_size;
 }
+
+/*
+ * ProcArrayAdvanceNodeXmin
+ *
+ * Publish a cleanup horizon AGTM computed for this datanode.  It leaves out
+ * transactions which never involved this node, so a long transaction
+ * elsewhere in the cluster does not hold back vacuum and pruning here.
+ * Local transactions are still added by GetSnapshotData, and snapshots
+ * arriving afterwards are checked by CheckSnapshotNodeXmin.
+ */
+void
+ProcArrayAdvanceNodeXmin(TransactionId xmin)
+{
+	uint32		old_xmin;
+
+	if (!TransactionIdIsNormal(xmin))
+		return;
+
+	old_xmin = pg_atomic_read_u32(&procArray->node_xmin);
+	while (!TransactionIdIsNormal(old_xmin) ||
+		   TransactionIdPrecedes(old_xmin, xmin))
+	{
+		if (pg_atomic_compare_exchange_u32(&procArray->node_xmin,
+										   &old_xmin, xmin))
+			break;
+	}
+}
+
+/*
+ * GetNodeGlobalXmin
+ *
+ * Where the cleanup horizon of a snapshot from AGTM starts: its xmin, or
+ * the newer horizon of this datanode if that still lies within the
+ * snapshot and node_cleanup_horizon is on.
+ */
+static TransactionId
+GetNodeGlobalXmin(TransactionId xmin, TransactionId xmax)
+{
+	TransactionId	node_xmin;
+
+	if (!IS_PGXC_DATANODE || !node_cleanup_horizon)
+		return xmin;
+
+	node_xmin = pg_atomic_read_u32(&procArray->node_xmin);
+	if (TransactionIdIsNormal(node_xmin) &&
+		TransactionIdPrecedes(xmin, node_xmin) &&
+		TransactionIdPrecedesOrEquals(node_xmin, xmax))
+		return node_xmin;
+
+	return xmin;
+}
+
+/*
+ * CheckSnapshotNodeXmin
+ *
+ * Rows below the datanode horizon may be gone already, so a snapshot older
+ * than it is only usable here if it would not have seen them anyway: it
+ * must not predate the horizon, and no xid it treats as running below the
+ * horizon may have committed on this node.  A transaction can pass that
+ * check and start writing here later, which is why our xmin is advertised
+ * before the horizon is read: anyone cleaning up afterwards respects it.
+ *
+ * A snapshot that passed has no use for anything below the horizon, so an
+ * xmin advertised just for it may move up there ("advance_xmin").
+ *
+ * There is no horizon, and so no error, unless node_cleanup_horizon had
+ * autovacuum ask for one; after turning it off the check keeps going
+ * until the cluster-wide horizon catches up, since rows may be gone.
+ */
+static void
+CheckSnapshotNodeXmin(Snapshot snapshot, TransactionId xmin,
+					  TransactionId xmax, int xcnt, int subxcnt,
+					  bool advance_xmin)
+{
+	TransactionId	node_xmin;
+	TransactionId	next_xid;
+	TransactionId	xid;
+	int				i;
+
+	pg_memory_barrier();
+	node_xmin = pg_atomic_read_u32(&procArray->node_xmin);
+	if (!TransactionIdIsNormal(node_xmin) ||
+		!TransactionIdPrecedes(xmin, node_xmin))
+		return;
+
+	if (TransactionIdPrecedes(xmax, node_xmin))
+		goto too_old_;
+
+	next_xid = ReadNewTransactionId();
+	for (i = 0; i < xcnt + subxcnt; i++)
+	{
+		xid = i < xcnt ? snapshot->xip[i] : snapshot->subxip[i - xcnt];
+		if (TransactionIdPrecedes(xid, node_xmin) &&
+			TransactionIdPrecedes(xid, next_xid) &&
+			TransactionIdDidCommit(xid))
+			goto too_old_;
+	}
+
+	if (advance_xmin)
+		MyPgXact->xmin = node_xmin;
+	return;
+
+too_old_:
+	ereport(ERROR,
+			(errcode(ERRCODE_SNAPSHOT_TOO_OLD),
+			 errmsg("snapshot too old"),
+			 errdetail("Datanode \"%s\" may have removed rows older than transaction %u.",
+					   PGXCNodeName, node_xmin)));
+}
 #endif /* ADB */
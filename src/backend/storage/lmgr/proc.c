@@ -58,6 +58,9 @@
 #ifdef ADB
 #include "pgxc/poolmgr.h"
 #endif
+#ifdef AGTM
+#include "agtm/agtm_msg.h"
+#endif
 
 
 /* GUC variables */
@@ -403,6 +406,9 @@ InitProcess(void)
 	MyProc->isBackgroundWorker = IsBackgroundWorker;
 #ifdef ADB
 	MyProc->isPooler = IsPGXCPoolerProcess();
+#endif
+#ifdef AGTM
+	MyProc->xactNodes = 0;
 #endif
 	MyPgXact->delayChkpt = false;
 	MyPgXact->vacuumFlags = 0;
@@ -578,6 +584,9 @@ InitAuxiliaryProcess(void)
 	MyProc->roleId = InvalidOid;
 #ifdef ADB
 	MyProc->isPooler = IsPGXCPoolerProcess();
+#endif
+#ifdef AGTM
+	MyProc->xactNodes = 0;
 #endif
 	MyProc->isBackgroundWorker = IsBackgroundWorker;
 	MyPgXact->delayChkpt = false;
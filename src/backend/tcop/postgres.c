@@ -3513,6 +3513,22 @@ ProcessInterrupts(void)
 
 	}
 
+#ifdef ADB
+	if (AgtmIdleReleasePending)
+	{
+		/*
+		 * The session stayed idle, let its AGTM backend exit.  The next
+		 * transaction connects again and hands the new listen port to the
+		 * datanode connections it gets from the pooler.  On a datanode the
+		 * connection to the coordinator's AGTM backend is closed, so that
+		 * sessions idle in the pool do not hold it.
+		 */
+		AgtmIdleReleasePending = false;
+		if (DoingCommandRead && !IsTransactionOrTransactionBlock())
+			agtm_Close();
+	}
+#endif
+
 	if (ParallelMessagePending)
 		HandleParallelMessages();
 }
@@ -4139,6 +4155,9 @@ PostgresMain(int argc, char *argv[],
 	sigjmp_buf	local_sigjmp_buf;
 	volatile bool send_ready_for_query = true;
 	bool		disable_idle_in_transaction_timeout = false;
+#ifdef ADB
+	bool		disable_agtm_idle_release_timeout = false;
+#endif
 
 #ifdef ADB
 	PoolHandle		*pool_handle;
@@ -4586,8 +4605,13 @@ PostgresMain(int argc, char *argv[],
 			 */
 			ResetNodeExecutor();
 
-			/* Make sure the old PGconn will dump the trash data */
-			PQNReleaseAllConnect();
+			/*
+			 * Make sure the old PGconn will dump the trash data. Sessions
+			 * with persistent connections keep clean ones, so the next
+			 * transaction attaches them again without asking the pooler.
+			 */
+			if (!PersistentConnections || !PQNCanKeepAllConnect())
+				PQNReleaseAllConnect();
 		}
 
 		if(need_reload_pooler)
@@ -4666,6 +4690,25 @@ PostgresMain(int argc, char *argv[],
 
 				set_ps_display("idle", false);
 				pgstat_report_activity(STATE_IDLE, NULL);
+
+#ifdef ADB
+				/*
+				 * Start the timer to release the AGTM backend.  Sessions
+				 * keeping their datanode connections would leave those
+				 * connected to the old AGTM backend, so they keep it too.
+				 * A datanode session only closes its connection to the
+				 * backend of its coordinator, and connects again to the
+				 * port it is given for the next transaction.
+				 */
+				if (agtm_idle_release_timeout > 0 &&
+					((IsCoordMaster() && !PersistentConnections) ||
+					 IS_PGXC_DATANODE))
+				{
+					disable_agtm_idle_release_timeout = true;
+					enable_timeout_after(AGTM_IDLE_RELEASE_TIMEOUT,
+										 agtm_idle_release_timeout);
+				}
+#endif
 			}
 
 			ReadyForQuery(whereToSendOutput);
@@ -4732,6 +4775,13 @@ PostgresMain(int argc, char *argv[],
 			disable_timeout(IDLE_IN_TRANSACTION_SESSION_TIMEOUT, false);
 			disable_idle_in_transaction_timeout = false;
 		}
+#ifdef ADB
+		if (disable_agtm_idle_release_timeout)
+		{
+			disable_timeout(AGTM_IDLE_RELEASE_TIMEOUT, false);
+			disable_agtm_idle_release_timeout = false;
+		}
+#endif
 
 		/*
 		 * (6) check for any other interesting events that happened while we
@@ -0,0 +1,186 @@
+/*-------------------------------------------------------------------------
+ *
+ * hllfuncs.c
+ *	  approx_count_distinct() aggregate, based on HyperLogLog
+ *
+ * The transition state is a hyperLogLogState fed with the hash of every
+ * non-null input, computed with the hash support function of the input
+ * type.  Since the registers of two states can be merged with a plain
+ * maximum, the aggregate has combine, serial and deserial functions, so
+ * each datanode can build its own estimator and only the registers have
+ * to be sent to the node that produces the final result.
+ *
+ * Portions Copyright (c) 2014-2017, ADB Development Group
+ *
+ * IDENTIFICATION
+ *	  src/backend/utils/adt/hllfuncs.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include <math.h>
+
+#include "fmgr.h"
+#include "lib/hyperloglog.h"
+#include "libpq/pqformat.h"
+#include "utils/builtins.h"
+#include "utils/lsyscache.h"
+#include "utils/typcache.h"
+
+/*
+ * Register width of the estimator, 2^14 registers gives a standard error
+ * of about 0.8% for 16kB of state.
+ */
+#define APPROX_COUNT_BWIDTH		14
+
+static hyperLogLogState *make_approx_count_state(MemoryContext aggcontext,
+						uint8 bwidth);
+
+static hyperLogLogState *
+make_approx_count_state(MemoryContext aggcontext, uint8 bwidth)
+{
+	MemoryContext oldcontext = MemoryContextSwitchTo(aggcontext);
+	hyperLogLogState *state = palloc(sizeof(hyperLogLogState));
+
+	initHyperLogLog(state, bwidth);
+	MemoryContextSwitchTo(oldcontext);
+
+	return state;
+}
+
+Datum
+approx_count_distinct_trans(PG_FUNCTION_ARGS)
+{
+	MemoryContext aggcontext;
+	hyperLogLogState *state;
+	FmgrInfo   *hash_proc;
+
+	if (!AggCheckCallContext(fcinfo, &aggcontext))
+		elog(ERROR, "aggregate function called in non-aggregate context");
+
+	state = PG_ARGISNULL(0) ? NULL : (hyperLogLogState *) PG_GETARG_POINTER(0);
+	if (state == NULL)
+		state = make_approx_count_state(aggcontext, APPROX_COUNT_BWIDTH);
+
+	if (PG_ARGISNULL(1))
+		PG_RETURN_POINTER(state);
+
+	/* look up the hash function of the input type once per query */
+	hash_proc = (FmgrInfo *) fcinfo->flinfo->fn_extra;
+	if (hash_proc == NULL)
+	{
+		Oid			argtype = get_fn_expr_argtype(fcinfo->flinfo, 1);
+		TypeCacheEntry *typentry;
+
+		typentry = lookup_type_cache(argtype, TYPECACHE_HASH_PROC_FINFO);
+		if (!OidIsValid(typentry->hash_proc_finfo.fn_oid))
+			ereport(ERROR,
+					(errcode(ERRCODE_UNDEFINED_FUNCTION),
+					 errmsg("could not identify a hash function for type %s",
+							format_type_be(argtype))));
+
+		hash_proc = MemoryContextAlloc(fcinfo->flinfo->fn_mcxt, sizeof(FmgrInfo));
+		fmgr_info_copy(hash_proc, &typentry->hash_proc_finfo,
+					   fcinfo->flinfo->fn_mcxt);
+		fcinfo->flinfo->fn_extra = hash_proc;
+	}
+
+	addHyperLogLog(state,
+				   DatumGetUInt32(FunctionCall1Coll(hash_proc,
+													PG_GET_COLLATION(),
+													PG_GETARG_DATUM(1))));
+
+	PG_RETURN_POINTER(state);
+}
+
+Datum
+approx_count_distinct_final(PG_FUNCTION_ARGS)
+{
+	hyperLogLogState *state;
+
+	/* no non-null input */
+	if (PG_ARGISNULL(0))
+		PG_RETURN_INT64(0);
+
+	state = (hyperLogLogState *) PG_GETARG_POINTER(0);
+	PG_RETURN_INT64((int64) rint(estimateHyperLogLog(state)));
+}
+
+Datum
+approx_count_distinct_combine(PG_FUNCTION_ARGS)
+{
+	MemoryContext aggcontext;
+	hyperLogLogState *state1;
+	hyperLogLogState *state2;
+
+	if (!AggCheckCallContext(fcinfo, &aggcontext))
+		elog(ERROR, "aggregate function called in non-aggregate context");
+
+	state1 = PG_ARGISNULL(0) ? NULL : (hyperLogLogState *) PG_GETARG_POINTER(0);
+	state2 = PG_ARGISNULL(1) ? NULL : (hyperLogLogState *) PG_GETARG_POINTER(1);
+
+	if (state2 == NULL)
+		PG_RETURN_POINTER(state1);
+
+	/* manually copy all fields from state2 to state1 */
+	if (state1 == NULL)
+	{
+		state1 = make_approx_count_state(aggcontext, state2->registerWidth);
+		memcpy(state1->hashesArr, state2->hashesArr, state2->arrSize);
+		PG_RETURN_POINTER(state1);
+	}
+
+	mergeHyperLogLog(state1, state2);
+
+	PG_RETURN_POINTER(state1);
+}
+
+Datum
+approx_count_distinct_serialize(PG_FUNCTION_ARGS)
+{
+	hyperLogLogState *state;
+	StringInfoData buf;
+
+	if (!AggCheckCallContext(fcinfo, NULL))
+		elog(ERROR, "aggregate function called in non-aggregate context");
+
+	state = (hyperLogLogState *) PG_GETARG_POINTER(0);
+
+	pq_begintypsend(&buf);
+	pq_sendbyte(&buf, state->registerWidth);
+	pq_sendbytes(&buf, (char *) state->hashesArr, state->nRegisters);
+
+	PG_RETURN_BYTEA_P(pq_endtypsend(&buf));
+}
+
+Datum
+approx_count_distinct_deserialize(PG_FUNCTION_ARGS)
+{
+	bytea	   *sstate;
+	hyperLogLogState *result;
+	StringInfoData buf;
+
+	if (!AggCheckCallContext(fcinfo, NULL))
+		elog(ERROR, "aggregate function called in non-aggregate context");
+
+	sstate = PG_GETARG_BYTEA_P(0);
+
+	/*
+	 * Copy the bytea into a StringInfo so that we can "receive" it using the
+	 * standard recv-function infrastructure.
+	 */
+	initStringInfo(&buf);
+	appendBinaryStringInfo(&buf, VARDATA(sstate), VARSIZE(sstate) - VARHDRSZ);
+
+	result = palloc(sizeof(hyperLogLogState));
+	initHyperLogLog(result, (uint8) pq_getmsgbyte(&buf));
+	memcpy(result->hashesArr,
+		   pq_getmsgbytes(&buf, result->nRegisters),
+		   result->nRegisters);
+
+	pq_getmsgend(&buf);
+	pfree(buf.data);
+
+	PG_RETURN_POINTER(result);
+}
@@ -6559,7 +6559,24 @@ get_utility_query_def(Query *query, deparse_context *context)
 					break;
 
 				case DISTTYPE_HASH:
-					appendStringInfo(buf, " DISTRIBUTE BY HASH(%s)", stmt->distributeby->colname);
+					if (list_length(stmt->distributeby->funcargs) > 1)
+					{
+						ListCell   *lc;
+						const char *sep = "";
+
+						appendStringInfo(buf, " DISTRIBUTE BY HASH(");
+						foreach(lc, stmt->distributeby->funcargs)
+						{
+							ColumnRef  *cref = (ColumnRef *) lfirst(lc);
+
+							appendStringInfo(buf, "%s%s", sep,
+											 strVal(linitial(cref->fields)));
+							sep = ", ";
+						}
+						appendStringInfoChar(buf, ')');
+					}
+					else
+						appendStringInfo(buf, " DISTRIBUTE BY HASH(%s)", stmt->distributeby->colname);
 					break;
 
 				case DISTTYPE_ROUNDROBIN:
@@ -6610,6 +6627,11 @@ get_utility_query_def(Query *query, deparse_context *context)
 					}
 					break;
 
+				case SUBCLUSTER_COLOCATE:
+					appendStringInfo(buf, " COLOCATE WITH %s",
+									 NameListToQuotedString(stmt->subcluster->members));
+					break;
+
 				case SUBCLUSTER_NONE:
 				default:
 					/* Nothing to do */
@@ -8905,6 +8927,17 @@ get_rule_expr(Node *node, deparse_context *context,
 				foreach(l, (List *) node)
 				{
 					appendStringInfoString(buf, sep);
+#ifdef ADB
+					/* the values of one node of a list distribution */
+					if (IsA(lfirst(l), List))
+					{
+						appendStringInfoString(buf, "ARRAY[");
+						get_rule_expr((Node *) lfirst(l), context, showimplicit);
+						appendStringInfoChar(buf, ']');
+						sep = ", ";
+						continue;
+					}
+#endif
 					get_rule_expr((Node *) lfirst(l), context, showimplicit);
 					sep = ", ";
 				}
@@ -31,6 +31,9 @@ volatile bool QueryCancelPending = false;
 volatile bool ProcDiePending = false;
 volatile bool ClientConnectionLost = false;
 volatile bool IdleInTransactionSessionTimeoutPending = false;
+#ifdef ADB
+volatile bool AgtmIdleReleasePending = false;
+#endif
 volatile uint32 InterruptHoldoffCount = 0;
 volatile uint32 QueryCancelHoldoffCount = 0;
 volatile uint32 CritSectionCount = 0;
@@ -111,6 +114,9 @@ bool		enableFsync = true;
 bool		allowSystemTableMods = false;
 int			work_mem = 1024;
 int			maintenance_work_mem = 16384;
+#ifdef ADB
+int			max_parallel_maintenance_workers = 2;
+#endif
 int			replacement_sort_tuples = 150000;
 
 /*
@@ -74,6 +74,9 @@ static void ShutdownPostgres(int code, Datum arg);
 static void StatementTimeoutHandler(void);
 static void LockTimeoutHandler(void);
 static void IdleInTransactionSessionTimeoutHandler(void);
+#ifdef ADB
+static void AgtmIdleReleaseTimeoutHandler(void);
+#endif
 static bool ThereIsAtLeastOneRole(void);
 static void process_startup_options(Port *port, bool am_superuser);
 static void process_settings(Oid databaseid, Oid roleid);
@@ -615,6 +618,10 @@ InitPostgres(const char *in_dbname, Oid dboid, const char *username,
 		RegisterTimeout(LOCK_TIMEOUT, LockTimeoutHandler);
 		RegisterTimeout(IDLE_IN_TRANSACTION_SESSION_TIMEOUT,
 						IdleInTransactionSessionTimeoutHandler);
+#ifdef ADB
+		RegisterTimeout(AGTM_IDLE_RELEASE_TIMEOUT,
+						AgtmIdleReleaseTimeoutHandler);
+#endif
 	}
 
 	/*
@@ -1210,6 +1217,16 @@ IdleInTransactionSessionTimeoutHandler(void)
 	SetLatch(MyLatch);
 }
 
+#ifdef ADB
+static void
+AgtmIdleReleaseTimeoutHandler(void)
+{
+	AgtmIdleReleasePending = true;
+	InterruptPending = true;
+	SetLatch(MyLatch);
+}
+#endif
+
 /*
  * Returns true if at least one role is defined in this database cluster.
  */
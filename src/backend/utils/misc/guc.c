@@ -77,6 +77,7 @@
 #include "utils/builtins.h"
 #include "utils/bytea.h"
 #include "utils/guc_tables.h"
+#include "utils/hlc.h"
 #include "utils/memutils.h"
 #include "utils/pg_locale.h"
 #include "utils/plancache.h"
@@ -88,17 +89,22 @@
 #include "utils/xml.h"
 
 #ifdef ADB
+#include "agtm/agtm_client.h"
 #include "commands/tablecmds.h"
 #include "nodes/nodes.h"
+#include "libpq/libpq-node.h"
 #include "optimizer/pgxcship.h"
 #include "pgxc/execRemote.h"
 #include "pgxc/locator.h"
 #include "pgxc/nodemgr.h"
+#include "pgxc/noderange.h"
 #include "pgxc/pgxc.h"
 #include "pgxc/pgxcnode.h"
 #include "pgxc/poolmgr.h"
+#include "pgxc/resultcache.h"
 #include "pgxc/xc_maintenance_mode.h"
 #include "optimizer/pgxcplan.h"
+#include "storage/procarray.h"
 #endif
 #if defined(ADBMGRD)
 #include "postmaster/adbmonitor.h"
@@ -469,6 +475,7 @@ bool		Debug_print_parse = false;
 #ifdef ADB
 bool		Debug_print_grammar = false;
 bool		enable_cluster_plan = false;
+int			cluster_plan_cache_size = 2048;
 #endif
 bool		Debug_print_rewritten = false;
 bool		Debug_pretty_print = true;
@@ -535,6 +542,8 @@ bool		ADB_DEBUG;
 #endif
 #ifdef AGTM
 extern int agtm_listen_port;
+extern int agtm_hot_sequences;
+extern int agtm_sequence_reserve;
 #endif /* AGTM */
 
 /*
@@ -1365,6 +1374,27 @@ static struct config_bool ConfigureNamesBool[] =
 		true,
 		NULL, NULL, NULL
 	},
+#ifdef ADB
+	{
+		{"autovacuum_coordinator_analyze", PGC_SIGHUP, AUTOVACUUM,
+			gettext_noop("Refreshes coordinator statistics of distributed tables after datanodes analyze them."),
+			NULL
+		},
+		&autovacuum_coordinator_analyze,
+		true,
+		NULL, NULL, NULL
+	},
+	{
+		{"node_cleanup_horizon", PGC_SIGHUP, AUTOVACUUM,
+			gettext_noop("Lets datanode autovacuum ignore transactions that never involved the datanode."),
+			gettext_noop("Queries whose snapshot predates rows removed that way fail "
+						 "with a \"snapshot too old\" error.")
+		},
+		&node_cleanup_horizon,
+		false,
+		NULL, NULL, NULL
+	},
+#endif
 
 #if defined(ADBMGRD)
 	{
@@ -1862,6 +1892,15 @@ static struct config_bool ConfigureNamesBool[] =
 		true,
 		NULL, NULL, NULL
 	},
+	{
+		{"enable_semijoin_reduction", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Enables the planner's reducing of distinct semi join keys only."),
+			NULL
+		},
+		&enable_semijoin_reduction,
+		true,
+		NULL, NULL, NULL
+	},
 #if 0
 	{
 		{"gtm_backup_barrier", PGC_SUSET, QUERY_TUNING_METHOD,
@@ -1893,8 +1932,9 @@ static struct config_bool ConfigureNamesBool[] =
 	},
 	{
 		{"persistent_datanode_connections", PGC_BACKEND, DEVELOPER_OPTIONS,
-			gettext_noop("Session never releases acquired connections."),
-			NULL,
+			gettext_noop("Session keeps its acquired connections between transactions."),
+			gettext_noop("They are given back when the pooler is reloaded or cleaned, "
+						 "and closed after DISCARD ALL or RESET ALL."),
 			GUC_NOT_IN_SAMPLE
 		},
 		&PersistentConnections,
@@ -3025,8 +3065,77 @@ static struct config_int ConfigureNamesInt[] =
 		-1, -1, INT_MAX,
 		NULL, NULL, NULL
 	},
+	{
+		{"remote_result_cache_size", PGC_SUSET, RESOURCES_MEM,
+			gettext_noop("Sets the memory each coordinator backend uses to cache results of read-only queries on replicated tables."),
+			gettext_noop("0 disables the cache. The cache is private to the backend, "
+						 "a result is only reused while no transaction of the cluster ended."),
+			GUC_UNIT_KB
+		},
+		&remote_result_cache_size,
+		0, 0, MAX_KILOBYTES,
+		NULL, NULL, NULL
+	},
+	{
+		{"cluster_plan_cache_size", PGC_USERSET, RESOURCES_MEM,
+			gettext_noop("Sets the memory each datanode backend uses to keep large cluster plans."),
+			gettext_noop("Cluster plans of at least 8kB are sent by digest and kept in this "
+						 "memory, so that executing one again does not send it again. "
+						 "0 always sends the whole plan."),
+			GUC_UNIT_KB
+		},
+		&cluster_plan_cache_size,
+		2048, 0, MAX_KILOBYTES,
+		NULL, NULL, NULL
+	},
+	{
+		{"node_range_pruning_tables", PGC_POSTMASTER, QUERY_TUNING_OTHER,
+			gettext_noop("Sets the number of distributed tables whose per-datanode value ranges a coordinator keeps."),
+			gettext_noop("0 disables pruning datanodes by the ranges of BRIN indexed columns. "
+						 "Writes of sessions connected straight to a datanode are not seen.")
+		},
+		&node_range_pruning_tables,
+		0, 0, INT_MAX / 2,
+		NULL, NULL, NULL
+	},
+	{
+		{"agtm_idle_release_timeout", PGC_USERSET, CLIENT_CONN_STATEMENT,
+			gettext_noop("Sets the time an idle session keeps its AGTM connection."),
+			gettext_noop("A coordinator or datanode session idle out of a transaction "
+						 "for this long closes its AGTM connection, so that AGTM does "
+						 "not keep a process for it. 0 keeps the connection for the "
+						 "life of the session."),
+			GUC_UNIT_MS
+		},
+		&agtm_idle_release_timeout,
+		0, 0, INT_MAX,
+		NULL, NULL, NULL
+	},
+	{
+		{"adaptive_join_rows", PGC_USERSET, QUERY_TUNING_OTHER,
+			gettext_noop("Sets the number of rows a node broadcasts for the inner side of a join "
+						 "before switching to reduce them by hash."),
+			gettext_noop("Applies to left and anti hash joins whose inner side is broadcast. "
+						 "0 disables switching.")
+		},
+		&adaptive_join_rows,
+		0, 0, INT_MAX,
+		NULL, NULL, NULL
+	},
 #endif
 
+	{
+		{"hlc_max_offset", PGC_SIGHUP, CLIENT_CONN_OTHER,
+			gettext_noop("Sets the largest lead over the local clock of a timestamp received from another node."),
+			gettext_noop("A timestamp further ahead is logged and moves the hybrid logical clock "
+						 "only this far ahead. 0 accepts any timestamp."),
+			GUC_UNIT_MS
+		},
+		&hlc_max_offset,
+		500, 0, INT_MAX / 1000,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"max_parallel_workers_per_gather", PGC_USERSET, RESOURCES_ASYNCHRONOUS,
 			gettext_noop("Sets the maximum number of parallel processes per executor node."),
@@ -3037,6 +3146,19 @@ static struct config_int ConfigureNamesInt[] =
 		NULL, NULL, NULL
 	},
 
+#ifdef ADB
+	{
+		{"max_parallel_maintenance_workers", PGC_USERSET, RESOURCES_ASYNCHRONOUS,
+			gettext_noop("Sets the maximum number of parallel processes per btree index build."),
+			gettext_noop("Each process sorts in its share of maintenance_work_mem, "
+						 "of at least 16MB.")
+		},
+		&max_parallel_maintenance_workers,
+		2, 0, 1024,
+		NULL, NULL, NULL
+	},
+#endif
+
 	{
 		{"autovacuum_work_mem", PGC_SIGHUP, RESOURCES_MEM,
 			gettext_noop("Sets the maximum memory to be used by each autovacuum worker process."),
@@ -3287,6 +3409,25 @@ static struct config_int ConfigureNamesInt[] =
 		0, 0, 65535,
 		NULL, NULL, NULL
 	},
+	{
+		{"agtm_hot_sequences", PGC_POSTMASTER, RESOURCES_MEM,
+			gettext_noop("Sets the number of sequences whose nextval results are kept in shared memory."),
+			gettext_noop("0 makes every nextval read and update the sequence relation.")
+		},
+		&agtm_hot_sequences,
+		1024, 0, INT_MAX / 2,
+		NULL, NULL, NULL
+	},
+	{
+		{"agtm_sequence_reserve", PGC_SIGHUP, RESOURCES_MEM,
+			gettext_noop("Sets the number of nextval results reserved in memory at once."),
+			gettext_noop("Each reservation writes a WAL record. Results reserved "
+						 "but not handed out are lost on a restart.")
+		},
+		&agtm_sequence_reserve,
+		100, 1, INT_MAX,
+		NULL, NULL, NULL
+	},
 #endif /* AGTM */
 
 	/* End-of-list marker */
@@ -7940,6 +8081,7 @@ ExecSetVariableStmt(VariableSetStmt *stmt, bool isTopLevel)
 #ifdef ADB
 			if (!IsCoordMaster())
 				ResetTempTableNamespace();
+			PQNRequestCloseAllConnect();
 #endif
 			break;
 	}
@@ -0,0 +1,566 @@
+/*-------------------------------------------------------------------------
+ *
+ * generation.c
+ *	  Generational allocator definitions.
+ *
+ * Generation is a custom MemoryContext implementation designed for cases of
+ * chunks with similar lifespan, freed roughly in the order they were
+ * allocated, such as the tuples streamed through a reduce or a gather:
+ * each tuple lives until the next one is stored in the same slot.
+ *
+ * Chunks are carved one after another from blocks of a fixed size and are
+ * never reused individually.  A block only counts its chunks and the ones
+ * freed; once all of them are freed the block is given back to malloc, or
+ * rewound if it is the block chunks are currently allocated from.  Unlike
+ * an AllocSet there are no freelists, so memory of freed chunks cannot end
+ * up in a freelist of the wrong size, and chunks too large for a block get
+ * a block of their own which is released as soon as the chunk is freed.
+ *
+ * Portions Copyright (c) 2016-2017, ADB Development Group
+ *
+ * IDENTIFICATION
+ *	  src/backend/utils/mmgr/generation.c
+ *
+ *	About CLOBBER_FREED_MEMORY and MEMORY_CONTEXT_CHECKING, see aset.c.
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "postgres.h"
+
+#include "lib/ilist.h"
+#include "utils/memdebug.h"
+#include "utils/memutils.h"
+
+/*
+ * A chunk is preceded by a pointer to its block, followed by the standard
+ * chunk header pfree() and repalloc() look for just before the data.
+ */
+#define Generation_BLOCKHDRSZ	MAXALIGN(sizeof(GenerationBlockData))
+#define Generation_BLOCKPTRSZ	MAXALIGN(sizeof(GenerationBlock))
+#define Generation_CHUNKHDRSZ	(Generation_BLOCKPTRSZ + STANDARDCHUNKHEADERSIZE)
+
+typedef struct GenerationBlockData *GenerationBlock;
+
+typedef struct GenerationContext
+{
+	MemoryContextData header;	/* Standard memory-context fields */
+
+	/* Generational context parameters */
+	Size		blockSize;		/* standard block size */
+
+	GenerationBlock block;		/* current (most recently allocated) block */
+	dlist_head	blocks;			/* list of blocks */
+} GenerationContext;
+
+typedef GenerationContext *Generation;
+
+typedef struct GenerationBlockData
+{
+	dlist_node	node;			/* doubly-linked list of blocks */
+	int			nchunks;		/* number of chunks in the block */
+	int			nfree;			/* number of free chunks */
+	char	   *freeptr;		/* start of free space in this block */
+	char	   *endptr;			/* end of space in this block */
+} GenerationBlockData;
+
+#define GenerationPointerGetHeader(ptr) \
+	((StandardChunkHeader *) (((char *) (ptr)) - STANDARDCHUNKHEADERSIZE))
+#define GenerationPointerGetBlock(ptr) \
+	(*(GenerationBlock *) (((char *) (ptr)) - Generation_CHUNKHDRSZ))
+#define GenerationBlockFirstChunk(block) \
+	(((char *) (block)) + Generation_BLOCKHDRSZ)
+
+#define GenerationIsValid(set) PointerIsValid(set)
+
+/*
+ * These functions implement the MemoryContext API for Generation contexts.
+ */
+static void *GenerationAlloc(MemoryContext context, Size size);
+static void GenerationFree(MemoryContext context, void *pointer);
+static void *GenerationRealloc(MemoryContext context, void *pointer, Size size);
+static void GenerationInit(MemoryContext context);
+static void GenerationReset(MemoryContext context);
+static void GenerationDelete(MemoryContext context);
+static Size GenerationGetChunkSpace(MemoryContext context, void *pointer);
+static bool GenerationIsEmpty(MemoryContext context);
+static void GenerationStats(MemoryContext context, int level, bool print,
+				MemoryContextCounters *totals);
+
+#ifdef MEMORY_CONTEXT_CHECKING
+static void GenerationCheck(MemoryContext context);
+#endif
+
+/*
+ * This is the virtual function table for Generation contexts.
+ */
+static MemoryContextMethods GenerationMethods = {
+	GenerationAlloc,
+	GenerationFree,
+	GenerationRealloc,
+	GenerationInit,
+	GenerationReset,
+	GenerationDelete,
+	GenerationGetChunkSpace,
+	GenerationIsEmpty,
+	GenerationStats
+#ifdef MEMORY_CONTEXT_CHECKING
+	,GenerationCheck
+#endif
+};
+
+#ifdef CLOBBER_FREED_MEMORY
+
+/* Wipe freed memory for debugging purposes */
+static void
+wipe_mem(void *ptr, size_t size)
+{
+	VALGRIND_MAKE_MEM_UNDEFINED(ptr, size);
+	memset(ptr, 0x7F, size);
+	VALGRIND_MAKE_MEM_NOACCESS(ptr, size);
+}
+#endif
+
+#ifdef MEMORY_CONTEXT_CHECKING
+static void
+set_sentinel(void *base, Size offset)
+{
+	char	   *ptr = (char *) base + offset;
+
+	VALGRIND_MAKE_MEM_UNDEFINED(ptr, 1);
+	*ptr = 0x7E;
+	VALGRIND_MAKE_MEM_NOACCESS(ptr, 1);
+}
+
+static bool
+sentinel_ok(const void *base, Size offset)
+{
+	const char *ptr = (const char *) base + offset;
+	bool		ret;
+
+	VALGRIND_MAKE_MEM_DEFINED(ptr, 1);
+	ret = *ptr == 0x7E;
+	VALGRIND_MAKE_MEM_NOACCESS(ptr, 1);
+
+	return ret;
+}
+#endif
+
+/*
+ * GenerationContextCreate
+ *		Create a new Generation context.
+ *
+ * parent: parent context, or NULL if top-level context
+ * name: name of context (for debugging --- string will be copied)
+ * blockSize: size of the blocks chunks are carved from
+ */
+MemoryContext
+GenerationContextCreate(MemoryContext parent,
+						const char *name,
+						Size blockSize)
+{
+	Generation	set;
+
+	/* blocks must hold at least a few chunks of a reasonable size */
+	if (blockSize != MAXALIGN(blockSize) ||
+		blockSize < 1024 ||
+		!AllocHugeSizeIsValid(blockSize))
+		elog(ERROR, "invalid blockSize for memory context: %zu",
+			 blockSize);
+
+	set = (Generation) MemoryContextCreate(T_GenerationContext,
+										   sizeof(GenerationContext),
+										   &GenerationMethods,
+										   parent,
+										   name);
+
+	set->blockSize = blockSize;
+	set->block = NULL;
+	dlist_init(&set->blocks);
+
+	return (MemoryContext) set;
+}
+
+/*
+ * GenerationInit
+ *		Context-type-specific initialization routine.
+ */
+static void
+GenerationInit(MemoryContext context)
+{
+	/*
+	 * Since MemoryContextCreate already zeroed the context node, we don't
+	 * have to do anything here: it's already OK.
+	 */
+}
+
+/*
+ * GenerationReset
+ *		Frees all memory which is allocated in the given set.
+ */
+static void
+GenerationReset(MemoryContext context)
+{
+	Generation	set = (Generation) context;
+	dlist_mutable_iter miter;
+
+	AssertArg(GenerationIsValid(set));
+
+#ifdef MEMORY_CONTEXT_CHECKING
+	/* Check for corruption and leaks before freeing */
+	GenerationCheck(context);
+#endif
+
+	dlist_foreach_modify(miter, &set->blocks)
+	{
+		GenerationBlock block = dlist_container(GenerationBlockData, node, miter.cur);
+
+		dlist_delete(miter.cur);
+
+#ifdef CLOBBER_FREED_MEMORY
+		wipe_mem(block, block->endptr - ((char *) block));
+#endif
+		free(block);
+	}
+
+	set->block = NULL;
+}
+
+/*
+ * GenerationDelete
+ *		Frees all memory which is allocated in the given set, in preparation
+ *		for deletion of the set.  We simply call GenerationReset() which does
+ *		all the dirty work.
+ */
+static void
+GenerationDelete(MemoryContext context)
+{
+	GenerationReset(context);
+}
+
+/*
+ * GenerationAlloc
+ *		Returns pointer to allocated memory of given size or NULL if
+ *		request could not be completed; memory is added to the set.
+ *
+ * No request may exceed:
+ *		MAXALIGN_DOWN(SIZE_MAX) - Generation_BLOCKHDRSZ - Generation_CHUNKHDRSZ
+ * All callers use a much-lower limit.
+ */
+static void *
+GenerationAlloc(MemoryContext context, Size size)
+{
+	Generation	set = (Generation) context;
+	GenerationBlock block;
+	StandardChunkHeader *header;
+	char	   *chunk;
+	Size		chunk_size = MAXALIGN(size);
+	Size		required_size = chunk_size + Generation_CHUNKHDRSZ;
+
+	AssertArg(GenerationIsValid(set));
+
+	/* a chunk larger than a block gets a block of its own */
+	if (required_size > set->blockSize - Generation_BLOCKHDRSZ)
+	{
+		Size		blksize = required_size + Generation_BLOCKHDRSZ;
+
+		block = (GenerationBlock) malloc(blksize);
+		if (block == NULL)
+			return NULL;
+
+		chunk = GenerationBlockFirstChunk(block);
+		block->nchunks = 1;
+		block->nfree = 0;
+		block->freeptr = block->endptr = ((char *) block) + blksize;
+
+		/* put it after the current block, which keeps taking chunks */
+		dlist_push_tail(&set->blocks, &block->node);
+	}
+	else
+	{
+		block = set->block;
+		if (block == NULL ||
+			(block->endptr - block->freeptr) < required_size)
+		{
+			block = (GenerationBlock) malloc(set->blockSize);
+			if (block == NULL)
+				return NULL;
+
+			block->nchunks = 0;
+			block->nfree = 0;
+			block->freeptr = GenerationBlockFirstChunk(block);
+			block->endptr = ((char *) block) + set->blockSize;
+
+			/* Mark unallocated space NOACCESS. */
+			VALGRIND_MAKE_MEM_NOACCESS(block->freeptr,
+									   block->endptr - block->freeptr);
+
+			dlist_push_head(&set->blocks, &block->node);
+			set->block = block;
+		}
+
+		chunk = block->freeptr;
+		block->freeptr += required_size;
+		block->nchunks++;
+		Assert(block->freeptr <= block->endptr);
+
+		VALGRIND_MAKE_MEM_UNDEFINED(chunk, required_size);
+	}
+
+	*(GenerationBlock *) chunk = block;
+	header = (StandardChunkHeader *) (chunk + Generation_BLOCKPTRSZ);
+	header->context = context;
+	header->size = chunk_size;
+#ifdef MEMORY_CONTEXT_CHECKING
+	header->requested_size = size;
+	/* set mark to catch clobber of "unused" space */
+	if (size < chunk_size)
+		set_sentinel(((char *) header) + STANDARDCHUNKHEADERSIZE, size);
+#endif
+
+	return ((char *) header) + STANDARDCHUNKHEADERSIZE;
+}
+
+/*
+ * GenerationFree
+ *		Update number of chunks freed in the block; give the block back once
+ *		all its chunks are freed.
+ */
+static void
+GenerationFree(MemoryContext context, void *pointer)
+{
+	Generation	set = (Generation) context;
+	GenerationBlock block = GenerationPointerGetBlock(pointer);
+	StandardChunkHeader *header PG_USED_FOR_ASSERTS_ONLY = GenerationPointerGetHeader(pointer);
+
+	Assert(header->context == context);
+
+#ifdef MEMORY_CONTEXT_CHECKING
+	/* Test for someone scribbling on unused space in chunk */
+	if (header->requested_size < header->size)
+		if (!sentinel_ok(pointer, header->requested_size))
+			elog(WARNING, "detected write past chunk end in %s %p",
+				 set->header.name, header);
+#endif
+
+#ifdef CLOBBER_FREED_MEMORY
+	wipe_mem(pointer, header->size);
+#endif
+
+	block->nfree++;
+	Assert(block->nfree <= block->nchunks);
+
+	/* other chunks of the block are still used */
+	if (block->nfree < block->nchunks)
+		return;
+
+	/* chunks are still carved from the current block, start it over */
+	if (block == set->block)
+	{
+		block->nchunks = 0;
+		block->nfree = 0;
+		block->freeptr = GenerationBlockFirstChunk(block);
+		VALGRIND_MAKE_MEM_NOACCESS(block->freeptr,
+								   block->endptr - block->freeptr);
+		return;
+	}
+
+	dlist_delete(&block->node);
+#ifdef CLOBBER_FREED_MEMORY
+	wipe_mem(block, block->endptr - ((char *) block));
+#endif
+	free(block);
+}
+
+/*
+ * GenerationRealloc
+ *		When handling repalloc, we simply allocate a new chunk, copy the data
+ *		and discard the old one.  The only exception is when the new size
+ *		fits into the old chunk, in which case we just update the requested
+ *		size.
+ */
+static void *
+GenerationRealloc(MemoryContext context, void *pointer, Size size)
+{
+	StandardChunkHeader *header = GenerationPointerGetHeader(pointer);
+	Size		oldsize = header->size;
+	void	   *newPointer;
+
+	if (oldsize >= size)
+	{
+#ifdef MEMORY_CONTEXT_CHECKING
+		header->requested_size = size;
+
+		/* set mark to catch clobber of "unused" space */
+		if (size < oldsize)
+			set_sentinel(pointer, size);
+#endif
+		return pointer;
+	}
+
+	newPointer = GenerationAlloc(context, size);
+
+	/* leave immediately if request was not completed */
+	if (newPointer == NULL)
+		return NULL;
+
+	memcpy(newPointer, pointer, oldsize);
+
+	/* free old chunk */
+	GenerationFree(context, pointer);
+
+	return newPointer;
+}
+
+/*
+ * GenerationGetChunkSpace
+ *		Given a currently-allocated chunk, determine the total space
+ *		it occupies (including all memory-allocation overhead).
+ */
+static Size
+GenerationGetChunkSpace(MemoryContext context, void *pointer)
+{
+	StandardChunkHeader *header = GenerationPointerGetHeader(pointer);
+
+	return header->size + Generation_CHUNKHDRSZ;
+}
+
+/*
+ * GenerationIsEmpty
+ *		Is a Generation empty of any allocated space?
+ */
+static bool
+GenerationIsEmpty(MemoryContext context)
+{
+	Generation	set = (Generation) context;
+	dlist_iter	iter;
+
+	dlist_foreach(iter, &set->blocks)
+	{
+		GenerationBlock block = dlist_container(GenerationBlockData, node, iter.cur);
+
+		if (block->nchunks > block->nfree)
+			return false;
+	}
+
+	return true;
+}
+
+/*
+ * GenerationStats
+ *		Compute stats about memory consumption of a Generation.
+ *
+ * level: recursion level (0 at top level); used for print indentation.
+ * print: true to print stats to stderr.
+ * totals: if not NULL, add stats about this Generation into *totals.
+ *
+ * Freed chunks are only reclaimed with their whole block, so the count of
+ * free chunks also includes chunks of blocks still in use.
+ */
+static void
+GenerationStats(MemoryContext context, int level, bool print,
+				MemoryContextCounters *totals)
+{
+	Generation	set = (Generation) context;
+	Size		nblocks = 0;
+	Size		freechunks = 0;
+	Size		totalspace = 0;
+	Size		freespace = 0;
+	dlist_iter	iter;
+
+	dlist_foreach(iter, &set->blocks)
+	{
+		GenerationBlock block = dlist_container(GenerationBlockData, node, iter.cur);
+
+		nblocks++;
+		freechunks += block->nfree;
+		totalspace += block->endptr - ((char *) block);
+		freespace += block->endptr - block->freeptr;
+	}
+
+	if (print)
+	{
+		int			i;
+
+		for (i = 0; i < level; i++)
+			fprintf(stderr, "  ");
+		fprintf(stderr,
+			"%s: %zu total in %zd blocks; %zu free (%zd chunks); %zu used\n",
+				set->header.name, totalspace, nblocks, freespace, freechunks,
+				totalspace - freespace);
+	}
+
+	if (totals)
+	{
+		totals->nblocks += nblocks;
+		totals->freechunks += freechunks;
+		totals->totalspace += totalspace;
+		totals->freespace += freespace;
+	}
+}
+
+
+#ifdef MEMORY_CONTEXT_CHECKING
+
+/*
+ * GenerationCheck
+ *		Walk through chunks and check consistency of memory.
+ *
+ * NOTE: report errors as WARNING, *not* ERROR or FATAL.  Otherwise you'll
+ * find yourself in an infinite loop when trouble occurs, because this
+ * routine will be entered again when elog cleanup tries to release memory!
+ */
+static void
+GenerationCheck(MemoryContext context)
+{
+	Generation	set = (Generation) context;
+	const char *name = set->header.name;
+	dlist_iter	iter;
+
+	dlist_foreach(iter, &set->blocks)
+	{
+		GenerationBlock block = dlist_container(GenerationBlockData, node, iter.cur);
+		int			nchunks;
+		char	   *ptr;
+
+		if (block->nchunks < 0 ||
+			block->nfree < 0 ||
+			block->nfree > block->nchunks)
+			elog(WARNING, "problem in Generation %s: block %p has %d chunks, %d free",
+				 name, block, block->nchunks, block->nfree);
+
+		/* freed chunks keep their header, walk them all */
+		nchunks = 0;
+		ptr = GenerationBlockFirstChunk(block);
+		while (ptr < block->freeptr)
+		{
+			StandardChunkHeader *header;
+
+			header = (StandardChunkHeader *) (ptr + Generation_BLOCKPTRSZ);
+
+			/* allow access to private part of chunk header */
+			VALGRIND_MAKE_MEM_DEFINED(ptr, Generation_CHUNKHDRSZ);
+
+			if (*(GenerationBlock *) ptr != block)
+				elog(WARNING, "problem in Generation %s: bogus block link in block %p, chunk %p",
+					 name, block, ptr);
+			if (header->context != context)
+				elog(WARNING, "problem in Generation %s: bogus context link in block %p, chunk %p",
+					 name, block, ptr);
+			if (header->requested_size > header->size)
+				elog(WARNING, "problem in Generation %s: req size > alloc size for chunk %p in block %p",
+					 name, ptr, block);
+
+			nchunks++;
+			ptr += header->size + Generation_CHUNKHDRSZ;
+
+			VALGRIND_MAKE_MEM_NOACCESS(header, STANDARDCHUNKHEADERSIZE);
+		}
+
+		if (nchunks != block->nchunks)
+			elog(WARNING, "problem in Generation %s: number of chunks %d in block %p does not match header %d",
+				 name, nchunks, block, block->nchunks);
+	}
+}
+
+#endif   /* MEMORY_CONTEXT_CHECKING */
@@ -0,0 +1,139 @@
+/*-------------------------------------------------------------------------
+ *
+ * hlc.c
+ *	  Hybrid logical clock of a node
+ *
+ * Transaction timestamps of a cluster follow one timeline: the master
+ * coordinator takes the start timestamp of a transaction from AGTM along
+ * with its first snapshot and hands it to the datanodes it involves.  The
+ * clocks of the nodes drift, so a timestamp read from the local clock can
+ * be earlier than one another node already handed out for a transaction
+ * that happened before.
+ *
+ * Each node keeps a hybrid logical clock in shared memory instead.  It
+ * reads as the physical clock, except that it never goes backward and
+ * never falls behind a timestamp the node received from another node:
+ * HlcObserve() is called with the timestamps which already travel with
+ * the messages between the coordinators, the datanodes and AGTM, and
+ * HlcNow() returns a value later than every timestamp observed or returned
+ * before.  When the physical clock is not ahead, the clock counts in
+ * microseconds, the unit of TimestampTz, so the logical part lives in the
+ * low digits of the timestamp and no wider type is needed on the wire.
+ *
+ * A timestamp so read is ordered after everything that causally preceded
+ * it anywhere in the cluster, without asking AGTM.
+ *
+ * A timestamp further ahead of the physical clock than hlc_max_offset comes
+ * from a node whose clock is badly off, and following it would carry that
+ * error to every node.  It is logged, and the clock only moves up to the
+ * largest lead allowed; the transaction which brought it goes on, as
+ * failing it would stop the cluster until the clocks are fixed.
+ *
+ * The clock is read at the start of every transaction, so it is a single
+ * 64-bit atomic rather than a spinlock-protected field.  Readers only
+ * retry when another backend moved the clock in between.
+ *
+ * Portions Copyright (c) 2016-2017, ADB Development Group
+ *
+ * IDENTIFICATION
+ *	  src/backend/utils/time/hlc.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "port/atomics.h"
+#include "storage/shmem.h"
+#include "utils/hlc.h"
+#include "utils/timestamp.h"
+
+/* GUC variable, milliseconds */
+int			hlc_max_offset = 500;
+
+typedef struct HlcState
+{
+	pg_atomic_uint64 last;		/* latest timestamp returned or observed */
+} HlcState;
+
+static HlcState *hlcState = NULL;
+
+Size
+HlcShmemSize(void)
+{
+	return sizeof(HlcState);
+}
+
+void
+HlcShmemInit(void)
+{
+	bool		found;
+
+	hlcState = ShmemInitStruct("Hybrid Logical Clock",
+							   HlcShmemSize(),
+							   &found);
+	if (!found)
+		pg_atomic_init_u64(&hlcState->last, 0);
+}
+
+/*
+ * HlcNow
+ *		Read the clock, returning a timestamp later than all timestamps
+ *		returned or observed before
+ */
+TimestampTz
+HlcNow(void)
+{
+	TimestampTz	physical = GetCurrentTimestamp();
+	uint64		last = pg_atomic_read_u64(&hlcState->last);
+	TimestampTz	result;
+
+	do
+	{
+		if (physical > (TimestampTz) last)
+			result = physical;
+		else
+			result = (TimestampTz) last + 1;
+	} while (!pg_atomic_compare_exchange_u64(&hlcState->last, &last,
+											 (uint64) result));
+
+	return result;
+}
+
+/*
+ * HlcObserve
+ *		Move the clock past a timestamp received from another node
+ */
+void
+HlcObserve(TimestampTz timestamp)
+{
+	uint64		last = pg_atomic_read_u64(&hlcState->last);
+
+	if (timestamp <= (TimestampTz) last)
+		return;
+
+	if (hlc_max_offset > 0)
+	{
+		TimestampTz	physical = GetCurrentTimestamp();
+		TimestampTz	limit = physical + (TimestampTz) hlc_max_offset * 1000;
+
+		if (timestamp > limit)
+		{
+			ereport(LOG,
+					(errmsg("received timestamp %s is ahead of the local clock by more than hlc_max_offset",
+							timestamptz_to_str(timestamp)),
+					 errdetail("The local clock reads %s.",
+							   timestamptz_to_str(physical)),
+					 errhint("Synchronize the clocks of the nodes, or raise hlc_max_offset.")));
+			timestamp = limit;
+			if (timestamp <= (TimestampTz) last)
+				return;
+		}
+	}
+
+	while (timestamp > (TimestampTz) last)
+	{
+		if (pg_atomic_compare_exchange_u64(&hlcState->last, &last,
+										   (uint64) timestamp))
+			break;
+	}
+}
@@ -5279,6 +5279,8 @@ getTables(Archive *fout, int *numTables)
 	int 		i_pgxclocatortype;
 	int 		i_pgxcattnum;
 	int 		i_pgxc_node_names;
+	int			i_pgxcattnums;
+	int			i_pgxcvalues;
 #endif
 	int			i_reltablespace;
 	int			i_reloptions;
@@ -5361,7 +5363,9 @@ getTables(Archive *fout, int *numTables)
 #ifdef ADB
 						  "(SELECT pclocatortype from pgxc_class v where v.pcrelid = c.oid) AS pgxclocatortype,"
 						  "(SELECT pcattnum from pgxc_class v where v.pcrelid = c.oid) AS pgxcattnum,"
-						  "(SELECT '\"' || string_agg(node_name,'\",\"') || '\"' AS pgxc_node_names from pgxc_node n where n.oid in (select unnest(nodeoids) from pgxc_class v where v.pcrelid=c.oid) ) , "
+						  "(SELECT '\"' || string_agg(n.node_name,'\",\"' ORDER BY u.ord) || '\"' AS pgxc_node_names from pgxc_class v, unnest(v.nodeoids) WITH ORDINALITY AS u(nodeoid, ord), pgxc_node n where v.pcrelid=c.oid and n.oid = u.nodeoid) , "
+						  "(SELECT array_to_string(pcfuncattnums, ' ') from pgxc_class v where v.pcrelid = c.oid and v.pclocatortype = 'H') AS pgxcattnums,"
+						  "(SELECT pg_get_expr(pcvalues, pcrelid) from pgxc_class v where v.pcrelid = c.oid) AS pgxcvalues,"
 #endif
 						  "array_remove(array_remove(c.reloptions,'check_option=local'),'check_option=cascaded') AS reloptions, "
 						  "CASE WHEN 'check_option=local' = ANY (c.reloptions) THEN 'LOCAL'::text "
@@ -5983,6 +5987,8 @@ getTables(Archive *fout, int *numTables)
 	i_pgxclocatortype = PQfnumber(res, "pgxclocatortype");
 	i_pgxcattnum = PQfnumber(res, "pgxcattnum");
 	i_pgxc_node_names = PQfnumber(res, "pgxc_node_names");
+	i_pgxcattnums = PQfnumber(res, "pgxcattnums");
+	i_pgxcvalues = PQfnumber(res, "pgxcvalues");
 #endif
 
 	i_reltablespace = PQfnumber(res, "reltablespace");
@@ -6067,6 +6073,16 @@ getTables(Archive *fout, int *numTables)
 			tblinfo[i].pgxcattnum = atoi(PQgetvalue(res, i, i_pgxcattnum));
 		}
 		tblinfo[i].pgxc_node_names = pg_strdup(PQgetvalue(res, i, i_pgxc_node_names));
+		/* Columns of a hash on several columns, older servers have none */
+		if (i_pgxcattnums < 0 || PQgetisnull(res, i, i_pgxcattnums))
+			tblinfo[i].pgxcattnums = NULL;
+		else
+			tblinfo[i].pgxcattnums = pg_strdup(PQgetvalue(res, i, i_pgxcattnums));
+		/* Range bounds or list values, older servers have none */
+		if (i_pgxcvalues < 0 || PQgetisnull(res, i, i_pgxcvalues))
+			tblinfo[i].pgxcvalues = NULL;
+		else
+			tblinfo[i].pgxcvalues = pg_strdup(PQgetvalue(res, i, i_pgxcvalues));
 #endif
 
 
@@ -15676,6 +15692,28 @@ dumpTableSchema(Archive *fout, TableInfo *tbinfo)
 				appendPQExpBuffer(q, "\nDISTRIBUTE BY REPLICATION");
 			}
 			/* H: DISTRIBUTE BY HASH  */
+			else if (tbinfo->pgxclocatortype == 'H' &&
+					 tbinfo->pgxcattnums != NULL)
+			{
+				/* hash on several columns, in the order they are hashed */
+				char	   *attnum = tbinfo->pgxcattnums;
+				char	   *endptr;
+				const char *sep = "";
+
+				appendPQExpBuffer(q, "\nDISTRIBUTE BY HASH (");
+				for (;;)
+				{
+					int hashkey = (int) strtol(attnum, &endptr, 10);
+
+					if (endptr == attnum)
+						break;
+					appendPQExpBuffer(q, "%s%s", sep,
+						fmtId(tbinfo->attnames[hashkey - 1]));
+					sep = ", ";
+					attnum = endptr;
+				}
+				appendPQExpBufferChar(q, ')');
+			}
 			else if (tbinfo->pgxclocatortype == 'H')
 			{
 				int hashkey = tbinfo->pgxcattnum;
@@ -15688,8 +15726,22 @@ dumpTableSchema(Archive *fout, TableInfo *tbinfo)
 				appendPQExpBuffer(q, "\nDISTRIBUTE BY MODULO (%s)",
 				fmtId(tbinfo->attnames[hashkey - 1]));
 			}
+			/* G: DISTRIBUTE BY RANGE, L: DISTRIBUTE BY LIST */
+			else if ((tbinfo->pgxclocatortype == 'G' ||
+					  tbinfo->pgxclocatortype == 'L') &&
+					 tbinfo->pgxcvalues != NULL)
+			{
+				int distkey = tbinfo->pgxcattnum;
+				appendPQExpBuffer(q, "\nDISTRIBUTE BY %s (%s, %s)",
+					tbinfo->pgxclocatortype == 'G' ? "RANGE" : "LIST",
+					fmtId(tbinfo->attnames[distkey - 1]),
+					tbinfo->pgxcvalues);
+			}
 		}
-		if (include_nodes &&
+		/* Range and list tables map their values to nodes in this order */
+		if ((include_nodes ||
+			 tbinfo->pgxclocatortype == 'G' ||
+			 tbinfo->pgxclocatortype == 'L') &&
 			tbinfo->pgxc_node_names != NULL &&
 			tbinfo->pgxc_node_names[0] != '\0')
 		{
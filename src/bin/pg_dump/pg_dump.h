@@ -293,6 +293,8 @@ typedef struct _tableInfo
 		char		pgxclocatortype;	/* Type of PGXC table locator */
 		int 		pgxcattnum; 	/* Number of the attribute the table is partitioned with */
 		char		*pgxc_node_names;	/* List of node names where this table is distributed */
+		char		*pgxcattnums;	/* Columns of a hash on several columns */
+		char		*pgxcvalues;	/* Range bounds or list values of the nodes */
 #endif
 
 	/*
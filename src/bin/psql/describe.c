@@ -30,6 +30,8 @@
 #define LOCATOR_TYPE_RROBIN 'N'
 #define LOCATOR_TYPE_MODULO 'M'
 #define LOCATOR_TYPE_USER_DEFINED 'U'
+#define LOCATOR_TYPE_RANGE 'G'
+#define LOCATOR_TYPE_LIST 'L'
 #endif
 
 
@@ -2658,10 +2660,20 @@ describeOneTableDetails(const char *schemaname,
 						"		  WHEN '%c' THEN \n"
 						"		   'REPLICATION' \n"
 						"		  WHEN '%c' THEN \n"
-						"		   'HASH' || '(' || a.attname || ')' \n"
+						"		   'HASH' || '(' || \n"
+						"		   COALESCE((SELECT string_agg(fa.attname, ', ' ORDER BY k.n) \n"
+						"					   FROM pg_catalog.pg_attribute fa, \n"
+						"							unnest(c.pcfuncattnums) WITH ORDINALITY k(attnum, n) \n"
+						"					  WHERE fa.attrelid = c.pcrelid \n"
+						"						AND fa.attnum = k.attnum), \n"
+						"					a.attname) || ')' \n"
 						"		  WHEN '%c' THEN \n"
 						"		   'MODULO' || '(' || a.attname || ')' \n"
 						"		  WHEN '%c' THEN \n"
+						"		   'RANGE' || '(' || a.attname || ')' \n"
+						"		  WHEN '%c' THEN \n"
+						"		   'LIST' || '(' || a.attname || ')' \n"
+						"		  WHEN '%c' THEN \n"
 						"		   (SELECT proname FROM pg_catalog.pg_proc WHERE oid = pcfuncid) || '(' || \n"
 						"		   array_to_string(ARRAY \n"
 						"						   (SELECT attname \n"
@@ -2684,7 +2696,10 @@ describeOneTableDetails(const char *schemaname,
 						"											 FROM pg_catalog.pgxc_class \n"
 						"											WHERE pcrelid = '%s')), \n"
 						"						   ', ') \n"
-						"		END AS loc_nodes \n"
+						"		END AS loc_nodes, \n"
+						"		CASE WHEN c.pccolocation <> 0 THEN \n"
+						"		   c.pccolocation::pg_catalog.regclass::pg_catalog.text \n"
+						"		END AS colocation \n"
 						"  FROM pg_catalog.pg_attribute a \n"
 						" RIGHT JOIN  \n"
 						"		pg_catalog.pgxc_class c \n"
@@ -2696,6 +2711,8 @@ describeOneTableDetails(const char *schemaname,
 					, LOCATOR_TYPE_REPLICATED
 					, LOCATOR_TYPE_HASH
 					, LOCATOR_TYPE_MODULO
+					, LOCATOR_TYPE_RANGE
+					, LOCATOR_TYPE_LIST
 					, LOCATOR_TYPE_USER_DEFINED
 					, oid
 					, oid
@@ -2723,6 +2740,14 @@ describeOneTableDetails(const char *schemaname,
 									PQgetvalue(result, 0, 1));
 				printTableAddFooter(&cont, buf.data);
 
+				/* Print colocation group, named after its first table */
+				if (!PQgetisnull(result, 0, 2))
+				{
+					printfPQExpBuffer(&buf, _("Colocation Group: %s"),
+									  PQgetvalue(result, 0, 2));
+					printTableAddFooter(&cont, buf.data);
+				}
+
 				PQclear(result);
 			}
 		}
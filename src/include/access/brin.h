@@ -20,6 +20,9 @@
  */
 extern Datum brinhandler(PG_FUNCTION_ARGS);
 extern Datum brin_summarize_new_values(PG_FUNCTION_ARGS);
+#ifdef ADB
+extern Datum brin_minmax_bounds(PG_FUNCTION_ARGS);
+#endif
 
 /*
  * Storage type for BRIN's reloptions
@@ -371,6 +371,7 @@ extern void hash_desc(StringInfo buf, XLogReaderState *record);
 extern const char *hash_identify(uint8 info);
 
 #ifdef ADB
+extern Datum adb_hash_combine(PG_FUNCTION_ARGS);
 extern Datum compute_hash(Oid type, Datum value, char locator);
 extern char *get_compute_hash_function(Oid type, char locator);
 #endif
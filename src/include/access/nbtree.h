@@ -768,6 +768,12 @@ extern void _bt_spooldestroy(BTSpool *btspool);
 extern void _bt_spool(BTSpool *btspool, ItemPointer self,
 		  Datum *values, bool *isnull);
 extern void _bt_leafbuild(BTSpool *btspool, BTSpool *spool2);
+#ifdef ADB
+extern int	_bt_parallel_workers(Relation heap, Relation index,
+					 struct IndexInfo *indexInfo);
+extern IndexBuildResult *_bt_parallel_build(Relation heap, Relation index,
+				   struct IndexInfo *indexInfo, int nworkers);
+#endif
 
 /*
  * prototypes for functions in nbtxlog.c
@@ -37,6 +37,9 @@ typedef struct ParallelHeapScanDescData
 	slock_t		phs_mutex;		/* mutual exclusion for block number fields */
 	BlockNumber phs_startblock; /* starting block number */
 	BlockNumber phs_cblock;		/* current block number */
+#ifdef ADB
+	bool		phs_snapshot_any;	/* SnapshotAny, not serialized */
+#endif
 	char		phs_snapshot_data[FLEXIBLE_ARRAY_MEMBER];
 }	ParallelHeapScanDescData;
 
@@ -61,6 +64,14 @@ typedef struct HeapScanDescData
 	/* rs_numblocks is usually InvalidBlockNumber, meaning "scan whole rel" */
 	BufferAccessStrategy rs_strategy;	/* access strategy for reads */
 	bool		rs_syncscan;	/* report location to syncscan logic? */
+#ifdef ADB
+	/* read-ahead of a forward scan, see heapprefetch */
+	int			rs_prefetch_maximum;	/* max of rs_prefetch_target */
+	int			rs_prefetch_target;		/* current prefetch distance */
+	int			rs_prefetch_pages;		/* # pages prefetched past current */
+	BlockNumber rs_prefetch_next;	/* next block to prefetch */
+	BlockNumber rs_prefetch_left;	/* # blocks of the scan not prefetched */
+#endif
 
 	/* scan current state */
 	bool		rs_inited;		/* false = scan not init'd yet */
@@ -46,6 +46,15 @@ extern TransactionId agtm_GetGlobalTransactionId(bool isSubXact);
  */
 extern Snapshot agtm_GetGlobalSnapShot(Snapshot snapshot);
 
+/*
+ * nodes involved in the current transaction, see agtm_AddXactNodes
+ */
+extern uint64 agtm_NodeBit(const char *node_name);
+extern void agtm_AddXactNodes(uint64 nodes);
+extern void agtm_ResetXactNodes(void);
+extern Datum adb_xact_nodes(PG_FUNCTION_ARGS);
+extern Datum adb_node_bit(PG_FUNCTION_ARGS);
+
 /*
  * get transaction status from AGTM by transaction ID.
  */
@@ -11,6 +11,9 @@ typedef struct AGTM_Conn
 	struct pg_result	*pg_res;
 } AGTM_Conn;
 
+/* GUC, milliseconds an idle coordinator session keeps its AGTM backend */
+extern int agtm_idle_release_timeout;
+
 #define AGTM_RESULT_COMM_ERROR (-2) /* Communication error */
 #define AGTM_RESULT_ERROR      (-1)
 #define AGTM_RESULT_OK         (0)
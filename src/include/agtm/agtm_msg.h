@@ -38,9 +38,10 @@ typedef enum AGTM_MessageType
 	AGTM_MSG_SEQUENCE_GET_LAST,	/* Get the last sequence value of sequence */
 	AGTM_MSG_SEQUENCE_SET_VAL,	/* Set values for sequence */
 	AGTM_MSG_SEQUENCE_RESET_CACHE, /* Reset agtm cache */
-	AGTM_MSG_GET_STATUS			/* Get status of a given transaction */
+	AGTM_MSG_GET_STATUS,		/* Get status of a given transaction */
+	AGTM_MSG_SET_XACT_NODES		/* Set nodes involved in current transaction */
 } AGTM_MessageType;
-#define AGTM_MSG_TYPE_COUNT (AGTM_MSG_GET_STATUS+1)
+#define AGTM_MSG_TYPE_COUNT (AGTM_MSG_SET_XACT_NODES+1)
 
 /*
  * Symbols in the following enum are usd in result_name_tab defined in agtm_utils.c.
@@ -66,10 +67,17 @@ typedef enum AGTM_ResultType
 	AGTM_SEQUENCE_GET_LAST_RESULT,
 	AGTM_SEQUENCE_SET_VAL_RESULT,
 	AGTM_MSG_SEQUENCE_RESET_CACHE_RESULT,
+	AGTM_SET_XACT_NODES_RESULT,
 	AGTM_COMPLETE_RESULT			/* for no message result */
 } AGTM_ResultType;
 #define AGTM_RESULT_TYPE_COUNT (AGTM_COMPLETE_RESULT+1)
 
+/*
+ * Nodes involved in a transaction are sent to AGTM as a 64-bit mask, each
+ * node name hashed to one bit.  Collisions only make AGTM more conservative.
+ */
+#define AGTM_ALL_NODES		PG_UINT64_MAX
+
 typedef enum AgtmNodeTag
 {
 	T_AgtmInvalid = 0,
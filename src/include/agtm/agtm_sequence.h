@@ -18,6 +18,10 @@
 
 #include "lib/stringinfo.h"
 
+/* GUC variables */
+extern int	agtm_hot_sequences;
+extern int	agtm_sequence_reserve;
+
 StringInfo ProcessNextSeqCommand(StringInfo message, StringInfo output);
 
 /*
@@ -38,4 +42,8 @@ StringInfo ProcessSetSeqCommand(StringInfo message, StringInfo output);
 
 StringInfo ProcessDiscardCommand(StringInfo message, StringInfo output);
 
+extern Size AgtmSequenceShmemSize(void);
+extern void AgtmSequenceShmemInit(void);
+extern void AgtmSequenceForget(Oid relid);
+
 #endif
\ No newline at end of file
@@ -151,7 +151,8 @@ extern void GetRelationDistributionItems(Oid relid,
 				AttrNumber *attnum,
 				Oid *funcid,
 				int *numatts,
-				int16 **attnums);
+				int16 **attnums,
+				List **values);
 
 extern void AddPgxcRelationDependFunction(Oid relid,
 				DistributeBy *distributeby,
@@ -164,6 +165,7 @@ extern Oid *GetRelationDistributionNodes(PGXCSubCluster *subcluster, int *numnod
 extern Oid *BuildRelationDistributionNodes(List *nodes, int *numnodes);
 
 extern Oid *SortRelationDistributionNodes(Oid *nodeoids, int numnodes);
+extern Oid GetColocationRelid(PGXCSubCluster *subcluster);
 #endif
 
 #endif   /* HEAP_H */
@@ -110,6 +110,14 @@ extern double IndexBuildHeapRangeScan(Relation heapRelation,
 						BlockNumber end_blockno,
 						IndexBuildCallback callback,
 						void *callback_state);
+#ifdef ADB
+extern double IndexBuildHeapScanParallel(Relation heapRelation,
+						   Relation indexRelation,
+						   IndexInfo *indexInfo,
+						   HeapScanDesc scan,
+						   IndexBuildCallback callback,
+						   void *callback_state);
+#endif
 
 extern void validate_index(Oid heapId, Oid indexId, Snapshot snapshot);
 
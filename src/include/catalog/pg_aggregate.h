@@ -213,6 +213,9 @@ DATA(insert ( 3370	n 0 rowid_smaller	-				rowid_larger		-	-	-				-				-				f f 3
 /* count */
 DATA(insert ( 2147	n 0 int8inc_any		-				int8pl	-	-	int8inc_any		int8dec_any		-				f f 0		20		0	20		0	"0" "0" ));
 DATA(insert ( 2803	n 0 int8inc			-				int8pl	-	-	int8inc			int8dec			-				f f 0		20		0	20		0	"0" "0" ));
+#ifdef ADB
+DATA(insert ( 4118	n 0 approx_count_distinct_trans	approx_count_distinct_final	approx_count_distinct_combine	approx_count_distinct_serialize	approx_count_distinct_deserialize	-	-	-	f f 0	2281	16384	0		0	_null_ _null_ ));
+#endif
 
 /* var_pop */
 DATA(insert ( 2718	n 0 int8_accum		numeric_var_pop			numeric_combine			numeric_serialize		numeric_deserialize			int8_accum		int8_accum_inv	numeric_var_pop			f f 0	2281	128 2281	128 _null_ _null_ ));
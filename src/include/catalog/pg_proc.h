@@ -5169,6 +5169,28 @@ DESCR("is given GXID committed or aborted?");
 DATA(insert OID = 3363 ( pgxc_lock_for_backup	PGNSP PGUID 12 1 0 0 0 f f f f t f v s 0 0 16 "" _null_ _null_ _null_ _null_ _null_ pgxc_lock_for_backup _null_ _null_ _null_ ));
 DESCR("lock the cluster for taking backup");
 DATA(insert OID = 9018 ( adb_node_oid		PGNSP PGUID 12 1 0 0 0 f f f f t f s s 0 0 26 "" _null_ _null_ _null_ _null_ _null_ adb_node_oid _null_ _null_ _null_ ));
+DATA(insert OID = 4110 ( brin_minmax_bounds	PGNSP PGUID 12 1 10 0 0 f f f f t t v s 1 0 2249 "2205" "{2205,21,17,17,16}" "{i,o,o,o,o}" "{rel,attnum,minvalue,maxvalue,hasnulls}" _null_ _null_ brin_minmax_bounds _null_ _null_ _null_ ));
+DESCR("bounds of the values of the columns of a table summarized by BRIN minmax indexes");
+DATA(insert OID = 4111 ( adb_node_range_invalidate	PGNSP PGUID 12 1 0 0 0 f f f f t f v s 2 0 2278 "2205 28" _null_ _null_ _null_ _null_ _null_ adb_node_range_invalidate _null_ _null_ _null_ ));
+DESCR("record a writer of the datanode value ranges of a table");
+DATA(insert OID = 4112 ( adb_hash_combine	PGNSP PGUID 12 1 0 0 0 f f f f t f i s 2 0 23 "23 23" _null_ _null_ _null_ _null_ _null_ adb_hash_combine _null_ _null_ _null_ ));
+DESCR("combine the hashes of the columns of a multi-column distribution key");
+DATA(insert OID = 4113 ( approx_count_distinct_trans	PGNSP PGUID 12 1 0 0 0 f f f f f f i s 2 0 2281 "2281 2283" _null_ _null_ _null_ _null_ _null_ approx_count_distinct_trans _null_ _null_ _null_ ));
+DESCR("aggregate transition function");
+DATA(insert OID = 4114 ( approx_count_distinct_final	PGNSP PGUID 12 1 0 0 0 f f f f f f i s 1 0 20 "2281" _null_ _null_ _null_ _null_ _null_ approx_count_distinct_final _null_ _null_ _null_ ));
+DESCR("aggregate final function");
+DATA(insert OID = 4115 ( approx_count_distinct_combine	PGNSP PGUID 12 1 0 0 0 f f f f f f i s 2 0 2281 "2281 2281" _null_ _null_ _null_ _null_ _null_ approx_count_distinct_combine _null_ _null_ _null_ ));
+DESCR("aggregate combine function");
+DATA(insert OID = 4116 ( approx_count_distinct_serialize	PGNSP PGUID 12 1 0 0 0 f f f f t f i s 1 0 17 "2281" _null_ _null_ _null_ _null_ _null_ approx_count_distinct_serialize _null_ _null_ _null_ ));
+DESCR("aggregate serial function");
+DATA(insert OID = 4117 ( approx_count_distinct_deserialize	PGNSP PGUID 12 1 0 0 0 f f f f t f i s 2 0 2281 "17 2281" _null_ _null_ _null_ _null_ _null_ approx_count_distinct_deserialize _null_ _null_ _null_ ));
+DESCR("aggregate deserial function");
+DATA(insert OID = 4118 ( approx_count_distinct	PGNSP PGUID 12 1 0 0 0 t f f f f f i s 1 0 20 "2283" _null_ _null_ _null_ _null_ _null_ aggregate_dummy _null_ _null_ _null_ ));
+DESCR("approximate number of distinct input values, using HyperLogLog");
+DATA(insert OID = 4119 ( adb_xact_nodes	PGNSP PGUID 12 1 0 0 0 f f f f t f v r 0 0 20 "" _null_ _null_ _null_ _null_ _null_ adb_xact_nodes _null_ _null_ _null_ ));
+DESCR("mask of the nodes of the current transaction sent to AGTM");
+DATA(insert OID = 4120 ( adb_node_bit	PGNSP PGUID 12 1 0 0 0 f f f f t f i s 1 0 20 "19" _null_ _null_ _null_ _null_ _null_ adb_node_bit _null_ _null_ _null_ ));
+DESCR("bit of a node in the masks sent to AGTM");
 #endif
 
 #if defined(ADB) || defined(AGTM)
@@ -25,16 +25,18 @@ CATALOG(pgxc_class,9001) BKI_WITHOUT_OIDS
 	int16		pchashalgorithm;	/* Hashing algorithm */
 	int16		pchashbuckets;		/* Number of buckets */
 	Oid			pcfuncid;			/* User-defined distribution function oid */
+	Oid			pccolocation;		/* Colocation group, or InvalidOid */
 
 	oidvector	nodeoids;			/* List of nodes used by table */
 #ifdef CATALOG_VARLEN
 	int2vector	pcfuncattnums;		/* List of column number of distribution */
+	pg_node_tree pcvalues;			/* Range bounds or list values of nodes */
 #endif
 } FormData_pgxc_class;
 
 typedef FormData_pgxc_class *Form_pgxc_class;
 
-#define Natts_pgxc_class					8
+#define Natts_pgxc_class					10
 
 #define Anum_pgxc_class_pcrelid				1
 #define Anum_pgxc_class_pclocatortype		2
@@ -42,8 +44,10 @@ typedef FormData_pgxc_class *Form_pgxc_class;
 #define Anum_pgxc_class_pchashalgorithm		4
 #define Anum_pgxc_class_pchashbuckets		5
 #define Anum_pgxc_class_pcfuncid			6
-#define Anum_pgxc_class_nodes				7
-#define Anum_pgxc_class_pcfuncattnums		8
+#define Anum_pgxc_class_pccolocation		7
+#define Anum_pgxc_class_nodes				8
+#define Anum_pgxc_class_pcfuncattnums		9
+#define Anum_pgxc_class_pcvalues			10
 
 typedef enum PgxcClassAlterType
 {
@@ -61,7 +65,8 @@ extern void PgxcClassCreate(Oid pcrelid,
 							Oid *nodes,
 							Oid pcfuncid,
 							int numatts,
-							int16 *pcfuncattnums);
+							int16 *pcfuncattnums,
+							List *pcvalues);
 extern void PgxcClassAlter(Oid pcrelid,
 						   char pclocatortype,
 						   int pcattnum,
@@ -72,7 +77,9 @@ extern void PgxcClassAlter(Oid pcrelid,
 						   PgxcClassAlterType type,
 						   Oid pcfuncid,
 						   int numatts,
-						   int16 *pcfuncattnums);
+						   int16 *pcfuncattnums,
+						   List *pcvalues);
+extern void PgxcClassColocate(Oid pcrelid, Oid refrelid);
 extern void RemovePgxcClass(Oid pcrelid);
 
 extern void CreatePgxcClassFuncDepend(char locatortype, Oid relid, Oid funcid);
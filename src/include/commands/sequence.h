@@ -88,6 +88,10 @@ extern char *GetGlobalSeqName(Relation seqrel, const char *new_seqname, const ch
 extern void GetSequenceInfoByName(Relation seqrel, char ** dbname, char ** schemaName);
 extern void register_sequence_cb(Relation  rel, AGTM_SequenceKeyType key, AGTM_SequenceDropType type);
 #endif
+#ifdef AGTM
+extern bool AgtmSequenceReserve(Oid relid, int64 count,
+					int64 *first, int64 *step, int64 *nresults);
+#endif
 
 extern ObjectAddress DefineSequence(CreateSeqStmt *stmt);
 extern ObjectAddress AlterSequence(AlterSeqStmt *stmt);
@@ -21,6 +21,10 @@
 #include "storage/buf.h"
 #include "storage/lock.h"
 #include "utils/relcache.h"
+#ifdef ADB
+#include "datatype/timestamp.h"
+#include "utils/hsearch.h"
+#endif
 
 
 /*----------
@@ -189,9 +193,21 @@ extern void vac_update_datfrozenxid(void);
 extern void vacuum_delay_point(void);
 
 #ifdef ADB
+/*
+ * Analyze activity of a distributed table on the datanodes, see
+ * get_remote_analyze_info()
+ */
+typedef struct RemoteAnalyzeInfo
+{
+	Oid			relid;			/* hash key */
+	float8		changes;		/* rows modified since the datanodes analyzed */
+	TimestampTz	last_analyze;	/* latest ANALYZE on any datanode, 0 if none */
+} RemoteAnalyzeInfo;
+
 extern void vacuum_rel_coordinator(Relation onerel, bool is_outer);
 extern TargetEntry *make_relation_tle(Oid reloid, const char *relname,
 						const char *column, AttrNumber attnum);
+extern HTAB *get_remote_analyze_info(List *relids);
 #endif
 
 /* in commands/vacuumlazy.c */
@@ -12,6 +12,7 @@
 #define CLUSTER_MSG_PROCESSED		'P'
 #define CLUSTER_MSG_RDC_PORT		'p'
 #define CLUSTER_MSG_COMMAND_ID		'M'
+#define CLUSTER_MSG_PLAN_STATUS		'c'
 
 struct pg_conn;
 
@@ -21,6 +22,7 @@ typedef struct ClusterRecvState
 	TupleTableSlot *convert_slot;
 	struct TupleTypeConvert *convert;
 	PlanState *ps;
+	MemoryContext tuple_cxt;	/* received tuples, NULL for slot's context */
 	bool convert_slot_is_single;
 	bool slot_need_copy_datum;
 }ClusterRecvState;
@@ -44,6 +46,8 @@ extern TupleDesc restore_slot_head_message_str(StringInfo buf);
 extern void serialize_slot_message(StringInfo buf, TupleTableSlot *slot, char msg_type);
 extern MinimalTuple fetch_slot_message(TupleTableSlot *slot, bool *need_free_tup);
 extern TupleTableSlot* restore_slot_message(const char *msg, int len, TupleTableSlot *slot);
+extern TupleTableSlot* restore_slot_message_ex(const char *msg, int len, TupleTableSlot *slot,
+											   MemoryContext tuple_cxt);
 extern void serialize_processed_message(StringInfo buf, uint64 processed);
 extern void serialize_command_id(StringInfo buf, CommandId cid);
 
@@ -11,6 +11,7 @@ extern void ExecClusterReduceMarkPos(ClusterReduceState *node);
 extern void ExecClusterReduceRestrPos(ClusterReduceState *node);
 extern void ExecConnectReduce(PlanState *node);
 extern void ExecReScanClusterReduce(ClusterReduceState *node);
+extern void ExecClusterReduceFollow(ClusterReduceState *node, ClusterReduceState *leader);
 extern void TopDownDriveClusterReduce(PlanState *node);
 
 #endif /* NODE_CLUSTER_REDUCE_H */
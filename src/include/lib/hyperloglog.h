@@ -62,6 +62,10 @@ typedef struct hyperLogLogState
 extern void initHyperLogLog(hyperLogLogState *cState, uint8 bwidth);
 extern void initHyperLogLogError(hyperLogLogState *cState, double error);
 extern void addHyperLogLog(hyperLogLogState *cState, uint32 hash);
+#ifdef ADB
+extern void mergeHyperLogLog(hyperLogLogState *cState,
+				 const hyperLogLogState *oState);
+#endif
 extern double estimateHyperLogLog(hyperLogLogState *cState);
 extern void freeHyperLogLog(hyperLogLogState *cState);
 
@@ -28,6 +28,8 @@ extern bool PQNListExecFinish(List *conn_list, GetPGconnHook get_pgconn_hook, PQ
 extern bool PQNEFHNormal(void *context, struct pg_conn *conn, PQNHookFuncType type, ...);
 extern void PQNExecFinish_trouble(struct pg_conn *conn);
 extern void PQNReleaseAllConnect(void);
+extern bool PQNCanKeepAllConnect(void);
+extern void PQNRequestCloseAllConnect(void);
 extern void PQNReportResultError(struct pg_result *result, struct pg_conn *conn, int elevel, bool free_result);
 extern const char *PQNConnectName(struct pg_conn *conn);
 extern Oid PQNConnectOid(struct pg_conn *conn);
@@ -81,6 +81,9 @@ extern PGDLLIMPORT volatile bool InterruptPending;
 extern PGDLLIMPORT volatile bool QueryCancelPending;
 extern PGDLLIMPORT volatile bool ProcDiePending;
 extern PGDLLIMPORT volatile bool IdleInTransactionSessionTimeoutPending;
+#ifdef ADB
+extern PGDLLIMPORT volatile bool AgtmIdleReleasePending;
+#endif
 
 extern volatile bool ClientConnectionLost;
 
@@ -239,6 +242,9 @@ extern bool enableFsync;
 extern bool allowSystemTableMods;
 extern PGDLLIMPORT int work_mem;
 extern PGDLLIMPORT int maintenance_work_mem;
+#ifdef ADB
+extern PGDLLIMPORT int max_parallel_maintenance_workers;
+#endif
 extern PGDLLIMPORT int replacement_sort_tuples;
 
 extern int	VacuumCostPageHit;
@@ -293,6 +293,9 @@ BEGIN_ENUM(NodeTag)
 	ENUM_VALUE(T_PlannerParamItem)
 	ENUM_VALUE(T_MemoryContext)
 	ENUM_VALUE(T_AllocSetContext)
+#ifdef ADB
+	ENUM_VALUE(T_GenerationContext)
+#endif
 	ENUM_VALUE(T_Value)
 	ENUM_VALUE(T_Integer)
 	ENUM_VALUE(T_Float)
@@ -684,6 +687,8 @@ BEGIN_ENUM(DistributionType)
 	ENUM_VALUE(DISTTYPE_ROUNDROBIN)
 	ENUM_VALUE(DISTTYPE_MODULO)
 	ENUM_VALUE(DISTTYPE_USER_DEFINED)
+	ENUM_VALUE(DISTTYPE_RANGE)
+	ENUM_VALUE(DISTTYPE_LIST)
 END_ENUM(DistributionType)
 #endif /* NO_ENUM_DistributionType */
 #endif
@@ -694,6 +699,7 @@ BEGIN_ENUM(PGXCSubClusterType)
 	ENUM_VALUE(SUBCLUSTER_NONE)
 	ENUM_VALUE(SUBCLUSTER_NODE)
 	ENUM_VALUE(SUBCLUSTER_GROUP)
+	ENUM_VALUE(SUBCLUSTER_COLOCATE)
 END_ENUM(PGXCSubClusterType)
 #endif /* NO_ENUM_PGXCSubClusterType */
 #endif
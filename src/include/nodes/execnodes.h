@@ -2188,6 +2188,12 @@ typedef struct ClusterReduceState
 	ReduceEntry	   *rdc_entrys;		/* array of length nrdcs */
 	struct TupleTypeConvert *convert;
 	TupleTableSlot *convert_slot;
+	MemoryContext	tuple_cxt;		/* tuples received from remote */
+
+	/* used for adaptive reduce as below */
+	ExprState	   *adaptiveState;	/* switch to it from reduceState */
+	int64			adaptive_seen;	/* rows of underlying plan reduced */
+	bool			adaptive_switched;
 
 	int				eflags;			/* capability flags to pass to tuplestore */
 	Tuplestorestate*tuplestorestate;
@@ -88,8 +88,10 @@ extern GroupingSet *makeGroupingSet(GroupingSetKind kind, List *content, int loc
 
 #ifdef ADB
 extern Expr *makeHashExpr(Expr *expr);
+extern Expr *makeHashExprList(List *exprs);
 extern Expr *makeModuloExpr(Expr *expr, int right);
 extern int32 execHashValue(Datum datum, Oid typid, Oid collid);
+extern int32 execHashValues(int nelems, const Datum *datums, const Oid *typids);
 extern int32 execModuloValue(Datum datum, Oid typid, int right);
 #endif /* ADB */
 
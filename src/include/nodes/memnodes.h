@@ -94,8 +94,15 @@ typedef struct MemoryContextData
  *
  * Add new context types to the set accepted by this macro.
  */
+#ifdef ADB
+#define MemoryContextIsValid(context) \
+	((context) != NULL && \
+	 (IsA((context), AllocSetContext) || \
+	  IsA((context), GenerationContext)))
+#else
 #define MemoryContextIsValid(context) \
 	((context) != NULL && \
 	 (IsA((context), AllocSetContext)))
+#endif
 
 #endif   /* MEMNODES_H */
@@ -327,6 +327,9 @@ typedef enum NodeTag
 	 */
 	T_MemoryContext = 600,
 	T_AllocSetContext,
+#ifdef ADB
+	T_GenerationContext,
+#endif
 
 	/*
 	 * TAGS FOR VALUE NODES (value.h)
@@ -692,6 +695,7 @@ extern Oid load_oid_type(struct StringInfoData *buf);
 extern Oid load_namespace(struct StringInfoData *buf);
 extern Oid load_namespace_extend(struct StringInfoData *buf, bool missok);
 extern Oid load_oid_class(struct StringInfoData *buf);
+extern Oid load_oid_class_extend(struct StringInfoData *buf, bool missok);
 extern char * load_node_string(struct StringInfoData *buf, bool need_dup);
 extern struct Bitmapset* load_Bitmapset(struct StringInfoData *buf);
 extern void save_oid_operator(struct StringInfoData *buf, Oid op);
@@ -632,6 +632,7 @@ BEGIN_NODE(ExecNodes)
 	NODE_NODE(List,en_dist_vars)
 	NODE_NODE(List,nodeList)
 	NODE_NODE(List,nodeids)
+	NODE_SCALAR(Oid,en_colocation)
 END_NODE(ExecNodes)
 #endif /* NO_NODE_ExecNodes */
 
@@ -747,6 +748,9 @@ BEGIN_NODE(ClusterReduce)
 	NODE_NODE(Expr,special_reduce)
 	NODE_NODE(List,reduce_oids)
 	NODE_SCALAR(Oid,special_node)
+	NODE_NODE(Expr,adaptive_reduce)
+	NODE_SCALAR(int,adaptive_rows)
+	NODE_SCALAR(bool,adaptive_follow)
 	NODE_SCALAR(int,numCols)
 	NODE_SCALAR_POINT(AttrNumber,sortColIdx,NODE_ARG_->numCols)
 	NODE_SCALAR_POINT(Oid,sortOperators,NODE_ARG_->numCols)
@@ -1726,6 +1730,9 @@ BEGIN_NODE(WindowAggPath)
 	NODE_NODE(Path,subpath)
 	NODE_NODE(WindowClause,winclause)
 	NODE_NODE(List,winpathkeys)
+#ifdef ADB
+	NODE_NODE(List,qual)
+#endif
 END_NODE(WindowAggPath)
 #endif /* NO_NODE_WindowAggPath */
 
@@ -2057,6 +2064,10 @@ BEGIN_NODE(PlannedStmt)
 	NODE_NODE(List,relationOids)
 	NODE_NODE(List,invalItems)
 	NODE_SCALAR(int,nParamExec)
+#ifdef ADB
+	NODE_NODE(List,nodeRangeRelids)
+	NODE_NODE(List,nodeRangeStamps)
+#endif
 END_NODE(PlannedStmt)
 #endif /* NO_NODE_PlannedStmt */
 
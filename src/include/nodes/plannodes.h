@@ -74,6 +74,12 @@ typedef struct PlannedStmt
 	List	   *invalItems;		/* other dependencies, as PlanInvalItems */
 
 	int			nParamExec;		/* number of PARAM_EXEC Params used */
+
+#ifdef ADB
+	/* tables datanodes were left out of by their value ranges, see noderange.c */
+	List	   *nodeRangeRelids;	/* OIDs of the tables */
+	List	   *nodeRangeStamps;	/* integer list, stamps of their ranges */
+#endif /* ADB */
 } PlannedStmt;
 
 /* macro for fetching the Plan associated with a SubPlan node */
@@ -913,6 +919,16 @@ typedef struct ClusterReduce
 	List	   *reduce_oids;
 	Oid			special_node;
 
+	/*
+	 * The inner side of a join may broadcast its rows and switch to
+	 * adaptive_reduce after sending adaptive_rows of them.  The outer side
+	 * of that join then has adaptive_follow set: it keeps its rows local and
+	 * only uses reduce when the inner side switched on any node.
+	 */
+	Expr	   *adaptive_reduce;
+	int			adaptive_rows;
+	bool		adaptive_follow;
+
 	/* remaining fields are just like the sort-key info in struct Sort */
 	int			numCols;		/* number of sort-key columns */
 	AttrNumber *sortColIdx;		/* their indexes in the target list */
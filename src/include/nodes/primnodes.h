@@ -1460,7 +1460,9 @@ typedef enum DistributionType
 	DISTTYPE_HASH,				/* Hash partitioned */
 	DISTTYPE_ROUNDROBIN,		/* Round Robin */
 	DISTTYPE_MODULO,			/* Modulo partitioned */
-	DISTTYPE_USER_DEFINED		/* User-defined function partitioned */
+	DISTTYPE_USER_DEFINED,		/* User-defined function partitioned */
+	DISTTYPE_RANGE,				/* Range partitioned */
+	DISTTYPE_LIST				/* List partitioned */
 } DistributionType;
 
 /*----------
@@ -1474,7 +1476,8 @@ typedef struct DistributeBy
 	DistributionType disttype;	/* Distribution type */
 	char	   	*colname;		/* Distribution column name */
 	List		*funcname;		/* User-defined distribute function name */
-	List		*funcargs;		/* User-defined distribute function arguments */
+	List		*funcargs;		/* User-defined distribute function arguments,
+								 * or range bounds or list values */
 } DistributeBy;
 
 /*----------
@@ -1486,7 +1489,8 @@ typedef enum PGXCSubClusterType
 {
 	SUBCLUSTER_NONE,
 	SUBCLUSTER_NODE,
-	SUBCLUSTER_GROUP
+	SUBCLUSTER_GROUP,
+	SUBCLUSTER_COLOCATE				/* nodes of another table */
 } PGXCSubClusterType;
 
 /*----------
@@ -1498,7 +1502,8 @@ typedef struct PGXCSubCluster
 {
 	NodeTag				type;
 	PGXCSubClusterType	clustertype;	/* Subcluster type */
-	List				*members;		/* List of nodes or groups */
+	List				*members;		/* List of nodes or groups, or the
+										 * qualified name of a table */
 } PGXCSubCluster;
 #endif /* ADB */
 
@@ -315,6 +315,9 @@ typedef struct PlannerInfo
 	 * FOR UPDATE/SHARE in the remote query
 	 */
 	List	   *xc_rowMarks;		/* list of PlanRowMarks of type ROW_MARK_EXCLUSIVE & ROW_MARK_SHARE */
+
+	/* set while planning a subquery scan, see set_subquery_pathlist */
+	struct WindowTopK *subquery_topk;
 #endif
 
 	/* These fields are used only when hasRecursion is true: */
@@ -1489,8 +1492,24 @@ typedef struct WindowAggPath
 	Path	   *subpath;		/* path representing input source */
 	WindowClause *winclause;	/* WindowClause we'll be using */
 	List	   *winpathkeys;	/* PathKeys for PARTITION keys + ORDER keys */
+#ifdef ADB
+	List	   *qual;			/* top-k pre-filter, see create_cluster_window_path */
+#endif /* ADB */
 } WindowAggPath;
 
+#ifdef ADB
+/*
+ * WindowTopK
+ *		The upper query keeps only rows whose ranking window function of
+ *		a subquery is at most count.
+ */
+typedef struct WindowTopK
+{
+	WindowFunc *wfunc;			/* row_number(), rank() or dense_rank() */
+	int64		count;
+} WindowTopK;
+#endif /* ADB */
+
 /*
  * SetOpPath represents a set-operation, that is INTERSECT or EXCEPT
  */
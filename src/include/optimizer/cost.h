@@ -90,6 +90,8 @@ extern bool enable_remotegroup;
 extern bool enable_remotesort;
 extern bool enable_remotelimit;
 extern bool enable_hashscan;
+extern bool enable_semijoin_reduction;
+extern int	adaptive_join_rows;
 #endif
 
 extern double clamp_row_est(double nrows);
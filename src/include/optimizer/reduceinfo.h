@@ -40,10 +40,13 @@ struct RelationLocInfo;
 typedef int(*ReducePathCallback_function)(PlannerInfo *root, Path *path, void *context);
 
 extern ReduceInfo *MakeHashReduceInfo(const List *storage, const List *exclude, const Expr *param);
+extern ReduceInfo *MakeMultiHashReduceInfo(const List *storage, const List *exclude, const List *params);
 extern ReduceInfo *MakeCustomReduceInfoByRel(const List *storage, const List *exclude,
 						const List *attnums, Oid funcid, Oid reloid, Index rel_index);
 extern ReduceInfo *MakeCustomReduceInfo(const List *storage, const List *exclude, List *params, Oid funcid, Oid reloid);
 extern ReduceInfo *MakeModuloReduceInfo(const List *storage, const List *exclude, const Expr *param);
+extern ReduceInfo *MakeRangeReduceInfo(const List *storage, const List *exclude, const Expr *param, const List *bounds);
+extern ReduceInfo *MakeListReduceInfo(const List *storage, const List *exclude, const Expr *param, const List *values);
 extern ReduceInfo *MakeReplicateReduceInfo(const List *storage);
 extern ReduceInfo *MakeFinalReplicateReduceInfo(void);
 extern ReduceInfo *MakeRoundReduceInfo(const List *storage);
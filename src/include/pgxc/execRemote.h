@@ -109,6 +109,9 @@ typedef struct RemoteQueryState
 	Tuplestorestate *tuplestorestate;
 	CommandId	rqs_cmd_id;			/* Cmd id to use in some special cases */
 	uint32		rqs_processed;			/* Number of rows processed (only for DMLs) */
+#ifdef ADB
+	struct ResultCacheScan *result_cache;	/* see resultcache.c, NULL if not cacheable */
+#endif
 }	RemoteQueryState;
 
 typedef void (*xact_callback) (bool isCommit, void *args);
@@ -25,6 +25,7 @@
 										 * scheme, e.g. result of JOIN of
 										 * replicated and distributed table */
 #define LOCATOR_TYPE_USER_DEFINED	'U'
+#define LOCATOR_TYPE_LIST			'L'
 
 /* Maximum number of preferred Datanodes that can be defined in cluster */
 #define MAX_PREFERRED_NODES 64
@@ -38,11 +39,16 @@
 												 (x) == LOCATOR_TYPE_RROBIN || \
 												 (x) == LOCATOR_TYPE_MODULO || \
 												 (x) == LOCATOR_TYPE_DISTRIBUTED || \
-												 (x) == LOCATOR_TYPE_USER_DEFINED)
+												 (x) == LOCATOR_TYPE_USER_DEFINED || \
+												 (x) == LOCATOR_TYPE_RANGE || \
+												 (x) == LOCATOR_TYPE_LIST)
 #define IsLocatorDistributedByValue(x)			((x) == LOCATOR_TYPE_HASH || \
 												 (x) == LOCATOR_TYPE_MODULO || \
-												 (x) == LOCATOR_TYPE_RANGE)
+												 (x) == LOCATOR_TYPE_RANGE || \
+												 (x) == LOCATOR_TYPE_LIST)
 #define IsLocatorDistributedByUserDefined(x)	((x) == LOCATOR_TYPE_USER_DEFINED)
+#define IsLocatorDistributedByRangeOrList(x)	((x) == LOCATOR_TYPE_RANGE || \
+												 (x) == LOCATOR_TYPE_LIST)
 
 #include "nodes/primnodes.h"
 #include "utils/relcache.h"
@@ -67,13 +73,21 @@ typedef struct RelationLocInfo
 	List	   *nodeids;				/* Node ids where data is located */
 	ListCell   *roundRobinNode;			/* the next node to use */
 	Oid			funcid;					/* Oid of user-defined distribution function */
-	List	   *funcAttrNums;			/* Attributes indices used for user-defined function  */
+	List	   *funcAttrNums;			/* Attributes indices used for user-defined function,
+										 * or hashed together for hash on several columns */
+	List	   *distValues;				/* Const lower bounds of every node but
+										 * the first for range, List of Const
+										 * values of each node for list */
+	Oid			colocation;				/* Colocation group, see pgxc_class */
 } RelationLocInfo;
 
 #define IsRelationReplicated(rel_loc)				IsLocatorReplicated((rel_loc)->locatorType)
 #define IsRelationColumnDistributed(rel_loc)		IsLocatorColumnDistributed((rel_loc)->locatorType)
 #define IsRelationDistributedByValue(rel_loc)		IsLocatorDistributedByValue((rel_loc)->locatorType)
 #define IsRelationDistributedByUserDefined(rel_loc)	IsLocatorDistributedByUserDefined((rel_loc)->locatorType)
+#define IsRelationDistributedByRangeOrList(rel_loc)	IsLocatorDistributedByRangeOrList((rel_loc)->locatorType)
+#define IsRelationDistributedByMultiHash(rel_loc)	((rel_loc)->locatorType == LOCATOR_TYPE_HASH && \
+													 (rel_loc)->funcAttrNums != NIL)
 
 /*
  * Nodes to execute on
@@ -101,12 +115,14 @@ typedef struct ExecNodes
 	List		   *en_dist_vars;		/* See above for details */
 	List		   *nodeList;			/* Node list indexes */
 	List		   *nodeids;			/* Node ids list */
+	Oid				en_colocation;		/* Colocation group of the relation */
 } ExecNodes;
 
 #define IsExecNodesReplicated(en)				IsLocatorReplicated((en)->baselocatortype)
 #define IsExecNodesColumnDistributed(en) 		IsLocatorColumnDistributed((en)->baselocatortype)
 #define IsExecNodesDistributedByValue(en)		IsLocatorDistributedByValue((en)->baselocatortype)
 #define IsExecNodesDistributedByUserDefined(en)	IsLocatorDistributedByUserDefined((en)->baselocatortype)
+#define IsExecNodesDistributedByRangeOrList(en)	IsLocatorDistributedByRangeOrList((en)->baselocatortype)
 
 /* Extern variables related to locations */
 extern Oid primary_data_node;
@@ -131,6 +147,9 @@ extern int GetRoundRobinNodeIdx(Oid relid);
 extern Oid GetRoundRobinNodeId(Oid relid);
 extern bool IsTypeDistributable(Oid colType);
 extern bool IsDistribColumn(Oid relid, AttrNumber attNum);
+extern int GetRangeOrListNodePos(RelationLocInfo *rel_loc_info,
+								 Datum value,
+								 Oid valuetype);
 
 extern ExecNodes *GetRelationNodes(RelationLocInfo *rel_loc_info,
 								   int nelems,
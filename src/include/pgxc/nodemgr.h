@@ -43,6 +43,7 @@ extern void NodeTablesShmemInit(void);
 extern Size NodeTablesShmemSize(void);
 
 extern void PgxcNodeListAndCount(void);
+extern void PgxcNodeListAndCountIfInvalid(void);
 extern void PgxcNodeGetOids(Oid **coOids, Oid **dnOids,
 							int *num_coords, int *num_dns,
 							bool update_preferred);
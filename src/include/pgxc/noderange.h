@@ -0,0 +1,65 @@
+/*-------------------------------------------------------------------------
+ *
+ * noderange.h
+ *	  Coordinator-side ranges of column values stored on each datanode
+ *
+ * Portions Copyright (c) 2016-2017, ADB Development Group
+ *
+ * IDENTIFICATION
+ *	  src/include/pgxc/noderange.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef NODERANGE_H
+#define NODERANGE_H
+
+#include "nodes/plannodes.h"
+#include "utils/relcache.h"
+#include "utils/snapshot.h"
+
+/* GUC, number of tables whose ranges are kept, zero disables */
+extern int node_range_pruning_tables;
+
+/* values of a column on one datanode */
+typedef struct NodeRangeBound
+{
+	Oid			nodeoid;
+	bool		hasvalues;		/* false if all rows are null */
+	bool		hasnulls;
+	Datum		minval;
+	Datum		maxval;
+} NodeRangeBound;
+
+typedef struct NodeRangeColumn
+{
+	AttrNumber	attnum;
+	Oid			typid;			/* pass-by-value type of the column */
+	int			nbounds;
+	NodeRangeBound *bounds;		/* one per datanode which reported */
+} NodeRangeColumn;
+
+/* tables a plan leaves datanodes out of, see NodeRangeBeginPlan */
+typedef struct NodeRangePlanState
+{
+	List	   *relids;
+	List	   *stamps;
+} NodeRangePlanState;
+
+extern Size NodeRangeShmemSize(void);
+extern void NodeRangeShmemInit(void);
+
+extern void NodeRangeCollect(Relation rel);
+extern List *NodeRangeGetColumns(Oid relid, Snapshot snapshot, uint32 *stamp);
+extern void NodeRangeForget(Oid relid, TransactionId xid);
+
+extern void NodeRangeNoteWrite(Oid relid);
+extern void NodeRangeNoteWriteAll(void);
+extern void NodeRangeNoteWrites(PlannedStmt *stmt);
+extern void NodeRangePreCommit(void);
+
+extern void NodeRangeBeginPlan(NodeRangePlanState *save);
+extern void NodeRangeEndPlan(PlannedStmt *stmt, NodeRangePlanState *save);
+extern void NodeRangeNotePruned(Oid relid, uint32 stamp);
+extern void NodeRangeCheckPlan(PlannedStmt *stmt, Snapshot snapshot);
+
+#endif /* NODERANGE_H */
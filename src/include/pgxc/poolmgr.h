@@ -133,6 +133,12 @@ extern bool PoolManagerCheckConnectionInfo(void);
 /* Reload connection data in pooler and drop all the existing connections of pooler */
 extern void PoolManagerReloadConnectionInfo(void);
 
+/* Shared generation of pooled connections, bumped at reload and clean */
+extern Size PoolManagerShmemSize(void);
+extern void PoolManagerShmemInit(void);
+extern uint32 PoolManagerGetGeneration(void);
+extern void PoolManagerBumpGeneration(void);
+
 /* Send Abort signal to transactions being run */
 extern int	PoolManagerAbortTransactions(char *dbname, char *username, int **proc_pids);
 
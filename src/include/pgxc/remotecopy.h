@@ -80,6 +80,7 @@ typedef struct RemoteCopyOptions {
 	char	   *rco_escape;			/* CSV escape char (must be 1 byte) */
 	List	   *rco_force_quote;	/* list of column names */
 	List	   *rco_force_notnull;	/* list of column names */
+	bool		rco_bulk_load;		/* build indexes after loading? */
 } RemoteCopyOptions;
 
 extern void RemoteCopyBuildExtra(RemoteCopyState *rcstate, TupleDesc tupdesc);
@@ -0,0 +1,34 @@
+/*-------------------------------------------------------------------------
+ *
+ * resultcache.h
+ *	  Coordinator-side cache of remote query results on replicated tables
+ *
+ * Portions Copyright (c) 2016-2017, ADB Development Group
+ *
+ * IDENTIFICATION
+ *	  src/include/pgxc/resultcache.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef RESULTCACHE_H
+#define RESULTCACHE_H
+
+#include "nodes/plannodes.h"
+#include "pgxc/execRemote.h"
+
+/* GUC, in kB, zero disables the cache */
+extern int remote_result_cache_size;
+
+typedef struct ResultCacheScan ResultCacheScan;
+
+extern ResultCacheScan *ResultCacheBeginScan(RemoteQueryState *node);
+extern bool ResultCacheLookup(ResultCacheScan *scan);
+extern bool ResultCacheIsHit(ResultCacheScan *scan);
+extern TupleTableSlot *ResultCacheNext(ResultCacheScan *scan, TupleTableSlot *slot);
+extern void ResultCacheCollect(ResultCacheScan *scan, TupleTableSlot *slot);
+extern void ResultCacheRescan(ResultCacheScan *scan);
+
+extern void ResultCacheNoteWrite(Oid relid);
+extern void ResultCacheNoteWrites(PlannedStmt *stmt);
+
+#endif /* RESULTCACHE_H */
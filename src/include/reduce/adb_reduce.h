@@ -40,8 +40,12 @@ extern void SendEofToRemote(RdcPort *port, List *dest_nodes);
 
 extern void SendSlotToRemote(RdcPort *port, List *dest_nodes, TupleTableSlot *slot);
 
+extern void SendAdaptToRemote(RdcPort *port, List *dest_nodes);
+
 extern TupleTableSlot* GetSlotFromRemote(RdcPort *port, TupleTableSlot *slot,
+										 MemoryContext tuple_cxt,
 										 Oid *slot_oid, Oid *eof_oid,
+										 Oid *adapt_oid,
 										 List **closed_remote);
 
 extern Size EstimateReduceInfoSpace(void);
@@ -115,6 +115,15 @@ struct PGPROC
 	/* Postgres-XC flags */
 	bool		isPooler;		/* true if process is Postgres-XC pooler */
 #endif
+#ifdef AGTM
+	/*
+	 * Mask of the nodes the current global transaction involves, the union
+	 * of what the coordinator and the datanodes reported; 0 when nothing
+	 * was reported, which counts as all nodes.  Only the owning backend
+	 * sets it, readers hold ProcArrayLock.
+	 */
+	uint64		xactNodes;
+#endif
 
 	/* Info about LWLock the process is currently waiting for, if any. */
 	bool		lwWaiting;		/* true if waiting for an LW lock */
@@ -48,7 +48,10 @@ extern int	GetMaxSnapshotSubxidCount(void);
 
 extern Snapshot GetSnapshotData(Snapshot snapshot);
 #ifdef ADB
+extern bool node_cleanup_horizon;
+
 extern void EnlargeSnapshotXip(Snapshot snapshot, uint32 need_size);
+extern void ProcArrayAdvanceNodeXmin(TransactionId xmin);
 #endif /* ADB */
 
 extern bool ProcArrayInstallImportedXmin(TransactionId xmin,
@@ -60,6 +63,9 @@ extern RunningTransactions GetRunningTransactionData(void);
 extern bool TransactionIdIsInProgress(TransactionId xid);
 extern bool TransactionIdIsActive(TransactionId xid);
 extern TransactionId GetOldestXmin(Relation rel, bool ignoreVacuum);
+#ifdef AGTM
+extern TransactionId GetOldestXminForNode(uint64 nodes);
+#endif
 extern TransactionId GetOldestActiveTransactionId(void);
 extern TransactionId GetOldestSafeDecodingTransactionId(void);
 
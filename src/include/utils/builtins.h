@@ -1095,6 +1095,13 @@ extern Datum rowid_gt(PG_FUNCTION_ARGS);
 extern Datum rowid_ge(PG_FUNCTION_ARGS);
 extern Datum rowid_larger(PG_FUNCTION_ARGS);
 extern Datum rowid_smaller(PG_FUNCTION_ARGS);
+
+/* hllfuncs.c */
+extern Datum approx_count_distinct_trans(PG_FUNCTION_ARGS);
+extern Datum approx_count_distinct_final(PG_FUNCTION_ARGS);
+extern Datum approx_count_distinct_combine(PG_FUNCTION_ARGS);
+extern Datum approx_count_distinct_serialize(PG_FUNCTION_ARGS);
+extern Datum approx_count_distinct_deserialize(PG_FUNCTION_ARGS);
 #endif
 
 /* inet_cidr_ntop.c */
@@ -1491,6 +1498,9 @@ extern Datum pg_cursor(PG_FUNCTION_ARGS);
 extern Datum pgxc_pool_check(PG_FUNCTION_ARGS);
 extern Datum pgxc_pool_reload(PG_FUNCTION_ARGS);
 
+/* backend/pgxc/locator/noderange.c */
+extern Datum adb_node_range_invalidate(PG_FUNCTION_ARGS);
+
 extern Datum pgxc_is_committed(PG_FUNCTION_ARGS);
 
 /* src/backend/catalog/heap.c */
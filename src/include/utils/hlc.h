@@ -0,0 +1,27 @@
+/*-------------------------------------------------------------------------
+ *
+ * hlc.h
+ *	  Hybrid logical clock of a node
+ *
+ * Portions Copyright (c) 2016-2017, ADB Development Group
+ *
+ * IDENTIFICATION
+ *	  src/include/utils/hlc.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef HLC_H
+#define HLC_H
+
+#include "datatype/timestamp.h"
+
+/* GUC variable */
+extern int	hlc_max_offset;
+
+extern Size HlcShmemSize(void);
+extern void HlcShmemInit(void);
+
+extern TimestampTz HlcNow(void);
+extern void HlcObserve(TimestampTz timestamp);
+
+#endif /* HLC_H */
@@ -135,6 +135,13 @@ extern MemoryContext AllocSetContextCreate(MemoryContext parent,
 					  Size initBlockSize,
 					  Size maxBlockSize);
 
+#ifdef ADB
+/* generation.c */
+extern MemoryContext GenerationContextCreate(MemoryContext parent,
+						const char *name,
+						Size blockSize);
+#endif
+
 /*
  * Recommended default alloc parameters, suitable for "ordinary" contexts
  * that might hold quite a lot of data.
@@ -0,0 +1,52 @@
+--
+-- A broadcast inner side of a left or anti join switches to a hash
+-- reduce after adaptive_join_rows rows
+--
+set enable_cluster_plan = on;
+set enable_nestloop = off;
+set enable_mergejoin = off;
+create function xc_adj_adaptive(query text) returns bool language plpgsql as $$
+declare
+	line text;
+begin
+	for line in execute 'explain (verbose on, costs off) ' || query loop
+		if line like '%Adaptive Rows%' then
+			return true;
+		end if;
+	end loop;
+	return false;
+end $$;
+select create_table_nodes('xc_adj_o(a int, b int)', '{1, 2}'::int[], 'hash(a)', NULL);
+select create_table_nodes('xc_adj_i(k int, v int)', '{1, 2}'::int[], 'hash(v)', NULL);
+alter table xc_adj_i set (autovacuum_enabled = false);
+insert into xc_adj_o select i, i % 1000 from generate_series(1, 10000) i;
+insert into xc_adj_i select i, i from generate_series(1, 10) i;
+analyze xc_adj_o;
+-- the planner sees a small inner side and broadcasts it
+analyze xc_adj_i;
+insert into xc_adj_i select i % 2000 + 500, i from generate_series(11, 5000) i;
+-- off by default
+select xc_adj_adaptive('select count(*) from xc_adj_o o left join xc_adj_i i on o.b = i.k');
+select count(*), count(i.k) from xc_adj_o o left join xc_adj_i i on o.b = i.k;
+select count(*) from xc_adj_o o where not exists (select 1 from xc_adj_i i where i.k = o.b);
+-- switches early, rows broadcast before the switch and rows hashed after
+set adaptive_join_rows = 100;
+select xc_adj_adaptive('select count(*) from xc_adj_o o left join xc_adj_i i on o.b = i.k');
+select xc_adj_adaptive('select count(*) from xc_adj_o o where not exists (select 1 from xc_adj_i i where i.k = o.b)');
+select count(*), count(i.k) from xc_adj_o o left join xc_adj_i i on o.b = i.k;
+select count(*), count(i.k), sum(o.a), sum(i.v) from xc_adj_o o left join xc_adj_i i on o.b = i.k where o.b < 10;
+select count(*) from xc_adj_o o where not exists (select 1 from xc_adj_i i where i.k = o.b);
+-- never reaches the threshold, stays a broadcast
+set adaptive_join_rows = 1000000;
+select count(*), count(i.k) from xc_adj_o o left join xc_adj_i i on o.b = i.k;
+select count(*) from xc_adj_o o where not exists (select 1 from xc_adj_i i where i.k = o.b);
+-- inner joins are not adaptive
+set adaptive_join_rows = 100;
+select xc_adj_adaptive('select count(*) from xc_adj_o o join xc_adj_i i on o.b = i.k');
+drop table xc_adj_o;
+drop table xc_adj_i;
+drop function xc_adj_adaptive(text);
+reset adaptive_join_rows;
+reset enable_mergejoin;
+reset enable_nestloop;
+reset enable_cluster_plan;
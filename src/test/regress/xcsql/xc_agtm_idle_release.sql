@@ -0,0 +1,26 @@
+--
+-- Sessions idle longer than agtm_idle_release_timeout close their AGTM
+-- connection, the next transaction opens another one
+--
+set agtm_idle_release_timeout = 100;
+create table xc_agtm_idle (a int, b int) distribute by hash(a);
+create sequence xc_agtm_idle_seq;
+insert into xc_agtm_idle select nextval('xc_agtm_idle_seq'), i from generate_series(1, 10) i;
+\! sleep 1
+-- coordinator and datanode sessions were idle, and released the connection
+insert into xc_agtm_idle select nextval('xc_agtm_idle_seq'), i from generate_series(11, 20) i;
+select count(*), min(a), max(a), count(distinct a) from xc_agtm_idle;
+-- a session idle in a transaction keeps it
+begin;
+insert into xc_agtm_idle values (nextval('xc_agtm_idle_seq'), 0);
+\! sleep 1
+select currval('xc_agtm_idle_seq');
+commit;
+select count(*), max(a) from xc_agtm_idle;
+\! sleep 1
+update xc_agtm_idle set b = b + 1;
+select sum(b) from xc_agtm_idle;
+select nextval('xc_agtm_idle_seq');
+drop table xc_agtm_idle;
+drop sequence xc_agtm_idle_seq;
+reset agtm_idle_release_timeout;
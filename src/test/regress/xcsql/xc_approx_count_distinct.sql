@@ -0,0 +1,67 @@
+--
+-- approx_count_distinct() merges the estimators of the datanodes, and
+-- DISTINCT aggregates remove duplicated input on each node
+--
+set enable_cluster_plan = on;
+create function xc_acd_partial(query text) returns bool language plpgsql as $$
+declare
+	line text;
+begin
+	for line in execute 'explain (costs off) ' || query loop
+		if line like '%Partial %Aggregate%' then
+			return true;
+		end if;
+	end loop;
+	return false;
+end $$;
+create function xc_acd_unique_reduce(query text) returns bool language plpgsql as $$
+declare
+	line text;
+	depth int := 0;
+begin
+	for line in execute 'explain (costs off) ' || query loop
+		if depth > 0 and strpos(line, '->') > 0 and strpos(line, '->') <= depth then
+			depth := 0;
+		end if;
+		if depth = 0 and (line like '%Cluster Reduce%' or line like '%Cluster Gather%') then
+			depth := greatest(strpos(line, '->'), 1);
+		elsif depth > 0 and line like '%->  Unique%' then
+			return true;
+		end if;
+	end loop;
+	return false;
+end $$;
+select create_table_nodes('xc_acd(a int, b int, c int)', '{1, 2}'::int[], 'hash(a)', NULL);
+-- every value of b and c is found on both nodes
+insert into xc_acd select i, i % 1000, i % 100 from generate_series(1, 100000) i;
+analyze xc_acd;
+-- partial estimators of the nodes are combined
+select xc_acd_partial('select approx_count_distinct(b) from xc_acd');
+select xc_acd_partial('select c % 10, approx_count_distinct(a) from xc_acd group by 1');
+select abs(approx_count_distinct(b) - 1000) <= 30 from xc_acd;
+select abs(approx_count_distinct(b::text) - 1000) <= 30 from xc_acd;
+select abs(approx_count_distinct(a) - 100000) <= 3000 from xc_acd;
+select bool_and(abs(n - 10000) <= 300) from
+  (select c % 10, approx_count_distinct(a) n from xc_acd group by 1) s;
+select count(*), bool_and(abs(n - 10) <= 1) from
+  (select c, approx_count_distinct(b) n from xc_acd group by 1) s;
+-- NULLs are ignored, no input gives 0
+select approx_count_distinct(x) from (values (1), (null), (2), (null), (1)) v(x);
+select approx_count_distinct(x) from (values (null::int), (null)) v(x);
+select approx_count_distinct(nullif(a, a)) from xc_acd;
+select approx_count_distinct(a) from xc_acd where a < 0;
+select c, approx_count_distinct(nullif(a, a)) from xc_acd where c < 3 group by c order by c;
+-- the input type needs a hash function
+select approx_count_distinct(p) from (values (point '(1,2)')) v(p);
+-- DISTINCT aggregates mixed with max and FILTER remove duplicates on each node
+select xc_acd_unique_reduce('select c % 10, count(distinct c), max(c), count(distinct c) filter (where c < 50) from xc_acd group by 1');
+select c % 10, count(distinct c), max(c), count(distinct c) filter (where c < 50) from xc_acd group by 1 order by 1;
+select xc_acd_unique_reduce('select count(distinct c), max(b) from xc_acd');
+select count(distinct c), max(b) from xc_acd;
+-- count(*) counts duplicates, all rows are reduced
+select xc_acd_unique_reduce('select c % 10, count(distinct c), count(*) from xc_acd group by 1');
+select c % 10, count(distinct c), count(*) from xc_acd group by 1 order by 1;
+drop table xc_acd;
+drop function xc_acd_partial(text);
+drop function xc_acd_unique_reduce(text);
+reset enable_cluster_plan;
@@ -0,0 +1,37 @@
+--
+-- Btree index builds with parallel workers on the datanodes
+--
+set max_parallel_maintenance_workers = 4;
+set maintenance_work_mem = '128MB';
+-- parallel_workers asks for workers whatever the table size
+create table xc_btpar (a int, b text) with (parallel_workers = 4) distribute by replication;
+insert into xc_btpar select i, 'row ' || i from generate_series(1, 100000) i;
+create index xc_btpar_a on xc_btpar (a);
+create index xc_btpar_b on xc_btpar (b desc);
+create index xc_btpar_expr on xc_btpar (lower(b), a);
+set enable_seqscan = off;
+set enable_bitmapscan = off;
+select count(*), sum(a) from xc_btpar where a between 1000 and 1999;
+select a from xc_btpar where a > 99995 order by a;
+select b from xc_btpar where b > 'row 99997' order by b desc;
+select a from xc_btpar where lower(b) = 'row 5';
+reset enable_seqscan;
+reset enable_bitmapscan;
+-- the two copies of the key are far apart, usually in two participants
+insert into xc_btpar values (1, 'again');
+create unique index xc_btpar_u on xc_btpar (a);
+-- dead duplicates and NULLs are fine
+delete from xc_btpar where b = 'again';
+insert into xc_btpar values (NULL, 'null 1'), (NULL, 'null 2');
+create unique index xc_btpar_u on xc_btpar (a);
+insert into xc_btpar values (2, 'again');
+reindex index xc_btpar_u;
+select count(*), count(a) from xc_btpar;
+-- with too little memory the build is serial, with the same result
+set maintenance_work_mem = '1MB';
+drop index xc_btpar_u;
+create unique index xc_btpar_u on xc_btpar (a);
+select count(*) from xc_btpar where a < 100;
+drop table xc_btpar;
+reset maintenance_work_mem;
+reset max_parallel_maintenance_workers;
@@ -0,0 +1,40 @@
+--
+-- Large cluster plans are sent by digest once a datanode backend holds them
+--
+set enable_cluster_plan = on;
+-- room for about two of the plans below
+set cluster_plan_cache_size = '64kB';
+select create_table_nodes('xc_cplan(a int, b int)', '{1, 2}'::int[], 'hash(a)', NULL);
+insert into xc_cplan select i, i from generate_series(1, 4000) i;
+-- the join reduces rows between the datanodes, the IN list makes the plan large
+create function xc_cplan_count(lo int) returns bigint language plpgsql as $$
+declare
+	result bigint;
+begin
+	execute 'select count(*) from xc_cplan t1 join xc_cplan t2 on t1.a = t2.b where t1.a in ('
+		|| (select string_agg(i::text, ', ') from generate_series(lo, lo + 999) i) || ')'
+		into result;
+	return result;
+end $$;
+-- sent in full
+select xc_cplan_count(1);
+-- sent by digest, the datanode backends hold it
+select xc_cplan_count(1);
+select xc_cplan_count(1);
+-- other plans push it out of the datanode backends, not of what the
+-- coordinator remembers
+select xc_cplan_count(1001);
+select xc_cplan_count(2001);
+select xc_cplan_count(3001);
+-- sent by digest, the datanode backends ask for the plan
+select xc_cplan_count(1);
+-- and hold it again
+select xc_cplan_count(1);
+-- 0 always sends the whole plan
+set cluster_plan_cache_size = 0;
+select xc_cplan_count(1);
+select xc_cplan_count(2001);
+drop function xc_cplan_count(int);
+drop table xc_cplan;
+reset cluster_plan_cache_size;
+reset enable_cluster_plan;
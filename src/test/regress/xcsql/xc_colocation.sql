@@ -0,0 +1,85 @@
+--
+-- Colocation groups: membership, dependency on the anchor and joins
+--
+set enable_cluster_plan = off;
+-- is the whole query shipped to the datanodes?
+create function xc_coloc_shipped(query text) returns bool language plpgsql as $$
+declare
+	line text;
+begin
+	for line in execute 'explain (costs off) ' || query loop
+		if line like '%__REMOTE_FQS_QUERY__%' then
+			return true;
+		end if;
+	end loop;
+	return false;
+end $$;
+-- error message of a command, without the node names it may contain
+create function xc_coloc_error(cmd text) returns text language plpgsql as $$
+begin
+	execute cmd;
+	return NULL;
+exception when others then
+	return sqlerrm;
+end $$;
+
+-- hash tables
+select create_table_nodes('xc_coloc_h1(a int, b int)', '{1, 2}'::int[], 'hash(a)', NULL);
+create table xc_coloc_h2 (a int, c text) distribute by hash(a) colocate with xc_coloc_h1;
+-- members depend on the table naming the group
+drop table xc_coloc_h1;
+create table xc_coloc_h3 (a int, d int) distribute by hash(a) colocate with xc_coloc_h2;
+select pcrelid::regclass, pccolocation::regclass from pgxc_class
+	where pcrelid in ('xc_coloc_h1'::regclass, 'xc_coloc_h2'::regclass, 'xc_coloc_h3'::regclass)
+	order by pcrelid::regclass::text;
+create table xc_coloc_bad (a text) distribute by hash(a) colocate with xc_coloc_h1;
+create table xc_coloc_bad (a int) distribute by modulo(a) colocate with xc_coloc_h1;
+select count(*) from pg_depend
+	where classid = 'pg_class'::regclass and refclassid = 'pg_class'::regclass
+	and refobjid = 'xc_coloc_h1'::regclass and deptype = 'n';
+-- the same nodes in the same order keeps the member in the group
+select xc_coloc_error('alter table xc_coloc_h3 to node (' || get_xc_node_name(1) || ', ' || get_xc_node_name(2) || ')');
+select pccolocation::regclass from pgxc_class where pcrelid = 'xc_coloc_h3'::regclass;
+-- another distribution leaves it, the others stay
+alter table xc_coloc_h3 distribute by modulo(a);
+select pcrelid::regclass, pccolocation::regclass from pgxc_class
+	where pcrelid in ('xc_coloc_h1'::regclass, 'xc_coloc_h2'::regclass, 'xc_coloc_h3'::regclass)
+	order by pcrelid::regclass::text;
+select count(*) from pg_depend
+	where classid = 'pg_class'::regclass and objid = 'xc_coloc_h3'::regclass
+	and refobjid = 'xc_coloc_h1'::regclass;
+-- and joins it again
+alter table xc_coloc_h3 distribute by hash(a);
+alter table xc_coloc_h3 colocate with xc_coloc_h1;
+select pccolocation::regclass from pgxc_class where pcrelid = 'xc_coloc_h3'::regclass;
+drop table xc_coloc_h3;
+drop table xc_coloc_h2;
+drop table xc_coloc_h1;
+
+-- range tables on the same nodes, joined on the key
+select create_table_nodes('xc_coloc_r1(a int, b int)', '{1, 2}'::int[], 'range(a, 100)', NULL);
+create table xc_coloc_r2 (a int, c int) distribute by range(a, 100) colocate with xc_coloc_r1;
+select create_table_nodes('xc_coloc_r3(a int, c int)', '{1, 2}'::int[], 'range(a, 100)', NULL);
+insert into xc_coloc_r1 select i, i from generate_series(1, 200) i;
+insert into xc_coloc_r2 select i, i * 2 from generate_series(1, 200) i;
+insert into xc_coloc_r3 select i, i * 3 from generate_series(1, 200) i;
+-- only the group tells that the bounds are the same
+select xc_coloc_shipped('select * from xc_coloc_r1 join xc_coloc_r2 using (a)');
+select xc_coloc_shipped('select * from xc_coloc_r1 join xc_coloc_r3 using (a)');
+select count(*), sum(c) from xc_coloc_r1 join xc_coloc_r2 using (a);
+select count(*), sum(c) from xc_coloc_r1 join xc_coloc_r3 using (a);
+-- ALTER TABLE COLOCATE WITH is allowed on the same nodes and bounds
+alter table xc_coloc_r3 colocate with xc_coloc_r1;
+select pccolocation::regclass from pgxc_class where pcrelid = 'xc_coloc_r3'::regclass;
+select xc_coloc_shipped('select * from xc_coloc_r1 join xc_coloc_r3 using (a)');
+select count(*) from xc_coloc_r3;
+-- but not with other bounds
+select create_table_nodes('xc_coloc_r4(a int)', '{1, 2}'::int[], 'range(a, 50)', NULL);
+select xc_coloc_error('alter table xc_coloc_r4 colocate with xc_coloc_r1');
+drop table xc_coloc_r4;
+drop table xc_coloc_r3;
+drop table xc_coloc_r2;
+drop table xc_coloc_r1;
+drop function xc_coloc_error(text);
+drop function xc_coloc_shipped(text);
+reset enable_cluster_plan;
@@ -215,3 +215,63 @@ drop table if exists tbl_rr_n2;
 drop table if exists tbl_h_n12;
 drop table if exists tbl_h_n2;
 
+-- BULK_LOAD builds the indexes once all rows are in
+create table xc_copy_bulk (a int primary key, b text) distribute by hash (a);
+insert into xc_copy_bulk values (10, 'ten');
+-- only into a table created or truncated in the transaction
+copy xc_copy_bulk from stdin (bulk_load);
+1	one
+\.
+copy xc_copy_bulk to stdout (bulk_load);
+begin;
+truncate xc_copy_bulk;
+copy xc_copy_bulk from stdin (bulk_load);
+1	one
+2	two
+3	three
+\.
+commit;
+select * from xc_copy_bulk order by a;
+set enable_seqscan = off;
+select b from xc_copy_bulk where a = 2;
+reset enable_seqscan;
+-- duplicates are found when the unique index is built
+begin;
+truncate xc_copy_bulk;
+copy xc_copy_bulk from stdin (bulk_load);
+1	one
+2	two
+2	again
+\.
+rollback;
+select * from xc_copy_bulk order by a;
+-- a BEFORE ROW trigger keeps the indexes maintained row by row
+create function xc_copy_bulk_trig() returns trigger language plpgsql as $$
+begin
+	new.b := upper(new.b);
+	return new;
+end
+$$;
+begin;
+create table xc_copy_bulk_trig (a int primary key, b text) distribute by replication;
+create trigger xc_copy_bulk_trig before insert on xc_copy_bulk_trig
+	for each row execute procedure xc_copy_bulk_trig();
+copy xc_copy_bulk_trig from stdin (bulk_load);
+1	one
+2	two
+2	again
+\.
+rollback;
+begin;
+create table xc_copy_bulk_trig (a int primary key, b text) distribute by replication;
+create trigger xc_copy_bulk_trig before insert on xc_copy_bulk_trig
+	for each row execute procedure xc_copy_bulk_trig();
+copy xc_copy_bulk_trig from stdin (bulk_load);
+1	one
+2	two
+\.
+commit;
+select * from xc_copy_bulk_trig order by a;
+drop table xc_copy_bulk;
+drop table xc_copy_bulk_trig;
+drop function xc_copy_bulk_trig();
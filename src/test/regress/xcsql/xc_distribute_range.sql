@@ -0,0 +1,74 @@
+--
+-- Range and list distribution: routing, node pruning and ALTER TABLE
+--
+set enable_cluster_plan = off;
+create function xc_drange_pruned(query text) returns bool language plpgsql as $$
+declare
+	line text;
+begin
+	for line in execute 'explain (costs off, num_nodes on, nodes off) ' || query loop
+		if line like '%node count=1)%' then
+			return true;
+		end if;
+	end loop;
+	return false;
+end $$;
+-- error message of a command, without the node names it may contain
+create function xc_drange_error(cmd text) returns text language plpgsql as $$
+begin
+	execute cmd;
+	return NULL;
+exception when others then
+	return sqlerrm;
+end $$;
+
+-- values below 100 on the first node, the rest on the second
+select create_table_nodes('xc_drange(a int, b text)', '{1, 2}'::int[], 'range(a, 100)', NULL);
+select pg_get_expr(pcvalues, pcrelid) from pgxc_class where pcrelid = 'xc_drange'::regclass;
+insert into xc_drange values (1, 'one'), (99, 'ninety-nine'), (100, 'hundred'), (500, 'five hundred'), (NULL, 'null');
+select get_xc_node_name_gen(xc_node_id), * from xc_drange order by a;
+select xc_drange_pruned('select * from xc_drange where a = 5');
+select * from xc_drange where a = 5;
+select xc_drange_pruned('select * from xc_drange where a between 100 and 1000');
+select * from xc_drange where a between 100 and 1000 order by a;
+select xc_drange_pruned('select * from xc_drange where a in (1, 99)');
+select * from xc_drange where a in (1, 99) order by a;
+select xc_drange_pruned('select * from xc_drange where a in (1, 100)');
+select * from xc_drange where a in (1, 100) order by a;
+select xc_drange_pruned('select * from xc_drange where a < 200');
+select count(*) from xc_drange where a < 200;
+
+-- each node has its own values, the others go to the first node
+select create_table_nodes('xc_dlist(a int, b text)', '{1, 2}'::int[], 'list(b, array[''a'', ''b''], ''c'')', NULL);
+select pg_get_expr(pcvalues, pcrelid) from pgxc_class where pcrelid = 'xc_dlist'::regclass;
+insert into xc_dlist values (1, 'a'), (2, 'b'), (3, 'c'), (4, 'z'), (5, NULL);
+select get_xc_node_name_gen(xc_node_id), * from xc_dlist order by a;
+select xc_drange_pruned('select * from xc_dlist where b = ''c''');
+select * from xc_dlist where b = 'c';
+select xc_drange_pruned('select * from xc_dlist where b in (''a'', ''b'')');
+select * from xc_dlist where b in ('a', 'b') order by a;
+select xc_drange_pruned('select * from xc_dlist where b in (''a'', ''c'')');
+select * from xc_dlist where b in ('a', 'c') order by a;
+
+-- bad definitions
+create table xc_drange_bad (a int) distribute by range(a, 100, 50);
+create table xc_drange_bad (a int) distribute by list(a, 1, array[2, 1]);
+select xc_drange_error('create table xc_drange_bad (a int) distribute by range(a, 10, 20) to node ('
+	|| get_xc_node_name(1) || ', ' || get_xc_node_name(2) || ')');
+
+-- rows would have to move by value, or nodes would lose their values
+alter table xc_dlist distribute by range(a, 3);
+alter table xc_drange distribute by list(a, 1, 2);
+select xc_drange_error('alter table xc_drange add node (' || get_xc_node_name(1) || ')');
+select xc_drange_error('alter table xc_drange delete node (' || get_xc_node_name(2) || ')');
+select xc_drange_error('alter table xc_dlist to node (' || get_xc_node_name(1) || ')');
+-- other distributions are fine
+alter table xc_drange distribute by hash(a);
+select pclocatortype, pcvalues is null from pgxc_class where pcrelid = 'xc_drange'::regclass;
+select count(*) from xc_drange;
+
+drop table xc_drange;
+drop table xc_dlist;
+drop function xc_drange_error(text);
+drop function xc_drange_pruned(text);
+reset enable_cluster_plan;
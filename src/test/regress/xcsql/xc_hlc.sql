@@ -0,0 +1,32 @@
+--
+-- Transaction timestamps follow the hybrid logical clock of the nodes
+--
+
+-- now() never goes backward from one transaction to the next
+create table xc_hlc_now (n int, t timestamptz) distribute by replication;
+insert into xc_hlc_now values (1, now());
+insert into xc_hlc_now values (2, now());
+insert into xc_hlc_now values (3, now());
+insert into xc_hlc_now values (4, now());
+insert into xc_hlc_now values (5, now());
+select count(*) from xc_hlc_now a, xc_hlc_now b where a.n < b.n and a.t >= b.t;
+-- a datanode runs the transaction with the timestamp it observed from the
+-- coordinator, and its clock moves past it
+create function xc_hlc_node_now(nodenum int) returns timestamptz language plpgsql as $$
+declare
+	t timestamptz;
+begin
+	execute 'execute direct on (' || get_xc_node_name(nodenum) || ') ''select now()''' into t;
+	return t;
+end
+$$;
+begin;
+select xc_hlc_node_now(1) = now() as dn1, xc_hlc_node_now(2) = now() as dn2;
+insert into xc_hlc_now values (6, now());
+commit;
+begin;
+select xc_hlc_node_now(1) > max(t) as dn1, xc_hlc_node_now(2) > max(t) as dn2 from xc_hlc_now;
+commit;
+select count(*) from xc_hlc_now a, xc_hlc_now b where a.n < b.n and a.t >= b.t;
+drop function xc_hlc_node_now(int);
+drop table xc_hlc_now;
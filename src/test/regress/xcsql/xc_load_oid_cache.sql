@@ -0,0 +1,32 @@
+--
+-- Datanode backends map the names of objects in a cluster plan to OIDs
+-- once, the mapping follows renames of their schemas
+--
+set enable_cluster_plan = on;
+create schema xc_loc_a;
+create schema xc_loc_b;
+create function xc_loc_a.f(int) returns int language plpgsql immutable as $$
+begin
+	return $1;
+end $$;
+create function xc_loc_b.f(int) returns int language plpgsql immutable as $$
+begin
+	return $1 * 100;
+end $$;
+select create_table_nodes('xc_loc(a int, b int)', '{1, 2}'::int[], 'hash(a)', NULL);
+insert into xc_loc select i, i from generate_series(1, 10) i;
+-- the join reduces rows between the datanodes
+select sum(xc_loc_a.f(t1.b)) from xc_loc t1 join xc_loc t2 on t1.b = t2.a;
+select sum(xc_loc_a.f(t1.b)) from xc_loc t1 join xc_loc t2 on t1.b = t2.a;
+-- swap the schemas, only pg_namespace changes
+alter schema xc_loc_a rename to xc_loc_tmp;
+alter schema xc_loc_b rename to xc_loc_a;
+alter schema xc_loc_tmp rename to xc_loc_b;
+select sum(xc_loc_a.f(t1.b)) from xc_loc t1 join xc_loc t2 on t1.b = t2.a;
+select sum(xc_loc_b.f(t1.b)) from xc_loc t1 join xc_loc t2 on t1.b = t2.a;
+drop table xc_loc;
+drop function xc_loc_a.f(int);
+drop function xc_loc_b.f(int);
+drop schema xc_loc_a;
+drop schema xc_loc_b;
+reset enable_cluster_plan;
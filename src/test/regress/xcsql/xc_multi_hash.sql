@@ -0,0 +1,67 @@
+--
+-- Hash distribution on several columns
+--
+create function xc_mhash_pruned(query text) returns bool language plpgsql as $$
+declare
+	line text;
+begin
+	for line in execute 'explain (costs off, num_nodes on, nodes off) ' || query loop
+		if line like '%node count=1)%' then
+			return true;
+		end if;
+	end loop;
+	return false;
+end $$;
+create function xc_mhash_reduced(query text) returns bool language plpgsql as $$
+declare
+	line text;
+begin
+	for line in execute 'explain (costs off) ' || query loop
+		if line like '%Cluster Reduce%' then
+			return true;
+		end if;
+	end loop;
+	return false;
+end $$;
+select create_table_nodes('xc_mhash1(a int, b text, c int)', '{1, 2}'::int[], 'hash(a, b)', NULL);
+select pg_get_expr(pcvalues, pcrelid) is null, pcattnum, pcfuncattnums
+	from pgxc_class where pcrelid = 'xc_mhash1'::regclass;
+insert into xc_mhash1 select i % 10, 'v' || (i % 7), i from generate_series(1, 1000) i;
+-- every key lives on one node, and the keys are spread over the nodes
+select count(*) from (select a, b from xc_mhash1 group by a, b having count(distinct xc_node_id) > 1) s;
+select count(distinct xc_node_id) from xc_mhash1;
+-- a null in any key column sends the row to the first node
+insert into xc_mhash1 values (1, NULL, -1), (NULL, 'v1', -2), (NULL, NULL, -3);
+select get_xc_node_name_gen(xc_node_id), a, b, c from xc_mhash1 where c < 0 order by c;
+
+-- only every key column compared to a constant picks one node
+set enable_cluster_plan = off;
+select xc_mhash_pruned('select * from xc_mhash1 where a = 3 and b = ''v3''');
+select count(*) from xc_mhash1 where a = 3 and b = 'v3';
+select xc_mhash_pruned('select * from xc_mhash1 where a = 3');
+select count(*) from xc_mhash1 where a = 3;
+select xc_mhash_pruned('select * from xc_mhash1 where b = ''v3''');
+select count(*) from xc_mhash1 where b = 'v3';
+update xc_mhash1 set c = c + 1 where a = 3 and b = 'v3';
+select sum(c) from xc_mhash1 where a = 3 and b = 'v3';
+-- the key cannot be updated
+update xc_mhash1 set b = 'x' where a = 3;
+
+-- joins on every key column do not move rows
+set enable_cluster_plan = on;
+select create_table_nodes('xc_mhash2(a int, b text, d int)', '{1, 2}'::int[], 'hash(a, b)', NULL);
+insert into xc_mhash2 select i % 10, 'v' || (i % 7), i from generate_series(1, 70) i;
+select xc_mhash_reduced('select * from xc_mhash1 t1 join xc_mhash2 t2 on t1.a = t2.a and t1.b = t2.b');
+select count(*) from xc_mhash1 t1 join xc_mhash2 t2 on t1.a = t2.a and t1.b = t2.b;
+-- joins on part of the key, or on other columns, move rows
+select xc_mhash_reduced('select * from xc_mhash1 t1 join xc_mhash2 t2 on t1.a = t2.a');
+select count(*) from xc_mhash1 t1 join xc_mhash2 t2 on t1.a = t2.a;
+select xc_mhash_reduced('select * from xc_mhash1 t1 join xc_mhash2 t2 on t1.a = t2.d and t1.b = t2.b');
+select count(*) from xc_mhash1 t1 join xc_mhash2 t2 on t1.a = t2.d and t1.b = t2.b;
+reset enable_cluster_plan;
+select count(*) from xc_mhash1 t1 join xc_mhash2 t2 on t1.a = t2.a and t1.b = t2.b;
+
+drop table xc_mhash2;
+drop table xc_mhash1;
+drop function xc_mhash_reduced(text);
+drop function xc_mhash_pruned(text);
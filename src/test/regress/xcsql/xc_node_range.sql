@@ -0,0 +1,65 @@
+--
+-- Datanodes left out of queries by the value ranges of their BRIN indexes,
+-- needs node_range_pruning_tables set for the cluster
+--
+set enable_cluster_plan = off;
+create function xc_nrange_pruned(query text) returns bool language plpgsql as $$
+declare
+	line text;
+begin
+	for line in execute 'explain (costs off, num_nodes on, nodes off) ' || query loop
+		if line like '%node count=1)%' then
+			return true;
+		end if;
+	end loop;
+	return false;
+end $$;
+create table xc_nrange_tab (a int, b int) distribute by modulo(b);
+create index xc_nrange_idx on xc_nrange_tab using brin(a);
+-- a < 500 on the first datanode, the rest on the second, not summarized yet
+insert into xc_nrange_tab select i, (i >= 500)::int from generate_series(1, 999) i;
+analyze xc_nrange_tab;
+select xc_nrange_pruned('select count(*) from xc_nrange_tab where a < 100');
+select count(*) from xc_nrange_tab where a < 100;
+
+-- our own writes are not in the ranges
+begin;
+insert into xc_nrange_tab values (2000, 0);
+select xc_nrange_pruned('select count(*) from xc_nrange_tab where a > 1500');
+select count(*) from xc_nrange_tab where a > 1500;
+commit;
+
+-- neither are committed ones, until the next analyze
+select xc_nrange_pruned('select count(*) from xc_nrange_tab where a > 1500');
+select count(*) from xc_nrange_tab where a > 1500;
+analyze xc_nrange_tab;
+select xc_nrange_pruned('select count(*) from xc_nrange_tab where a > 1500');
+select count(*) from xc_nrange_tab where a > 1500;
+
+-- cached plans are made again once a writer commits
+prepare xc_nrange_q as select count(*) from xc_nrange_tab where a > 4000;
+execute xc_nrange_q;
+insert into xc_nrange_tab values (5000, 0);
+execute xc_nrange_q;
+deallocate xc_nrange_q;
+analyze xc_nrange_tab;
+
+-- a trigger may write any table on the datanodes
+create table xc_nrange_src (a int) distribute by replication;
+create function xc_nrange_trig() returns trigger language plpgsql as $$
+begin
+	insert into xc_nrange_tab values (new.a, 1);
+	return new;
+end $$;
+create trigger xc_nrange_trig after insert on xc_nrange_src
+	for each row execute procedure xc_nrange_trig();
+select xc_nrange_pruned('select count(*) from xc_nrange_tab where a > 6000');
+insert into xc_nrange_src values (7000);
+select xc_nrange_pruned('select count(*) from xc_nrange_tab where a > 6000');
+select count(*) from xc_nrange_tab where a > 6000;
+
+drop table xc_nrange_src;
+drop function xc_nrange_trig();
+drop table xc_nrange_tab;
+drop function xc_nrange_pruned(text);
+reset enable_cluster_plan;
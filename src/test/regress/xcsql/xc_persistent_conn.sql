@@ -0,0 +1,35 @@
+--
+-- Sessions with persistent_datanode_connections keep their datanode
+-- connections between transactions
+--
+\c dbname=regression options=-cpersistent_datanode_connections=on
+show persistent_datanode_connections;
+create function xc_persist_node_pid(nodenum int) returns int language plpgsql as $$
+declare
+	pid int;
+begin
+	execute 'execute direct on (' || get_xc_node_name(nodenum) || ') ''select pg_backend_pid()''' into pid;
+	return pid;
+end
+$$;
+create table xc_persist_pid (step int, pid int) distribute by replication;
+-- the same datanode session serves the following transactions
+insert into xc_persist_pid values (1, xc_persist_node_pid(1));
+insert into xc_persist_pid values (2, xc_persist_node_pid(1));
+begin;
+insert into xc_persist_pid values (3, xc_persist_node_pid(1));
+commit;
+select count(distinct pid) from xc_persist_pid where step <= 3;
+-- DISCARD ALL closes it, then the new one is kept again
+discard all;
+insert into xc_persist_pid values (4, xc_persist_node_pid(1));
+insert into xc_persist_pid values (5, xc_persist_node_pid(1));
+select a.pid = b.pid as kept from xc_persist_pid a, xc_persist_pid b where a.step = 4 and b.step = 5;
+select count(*) from xc_persist_pid a, xc_persist_pid b where a.step = 3 and b.step = 4 and a.pid = b.pid;
+-- so does RESET ALL
+reset all;
+insert into xc_persist_pid values (6, xc_persist_node_pid(1));
+select count(*) from xc_persist_pid a, xc_persist_pid b where a.step = 5 and b.step = 6 and a.pid = b.pid;
+show persistent_datanode_connections;
+drop table xc_persist_pid;
+drop function xc_persist_node_pid(int);
@@ -0,0 +1,106 @@
+--
+-- Results of read-only queries on replicated tables cached by the
+-- coordinator backend, see remote_result_cache_size
+--
+set remote_result_cache_size = 1024;
+create table xc_rcache_tab (a int, b text) distribute by replication;
+insert into xc_rcache_tab values (1, 'one'), (2, 'two');
+select a, b from xc_rcache_tab order by a;
+select a, b from xc_rcache_tab order by a;
+
+-- a committed write changes the snapshot, the cached rows are not used
+insert into xc_rcache_tab values (3, 'three');
+select a, b from xc_rcache_tab order by a;
+
+-- writes of the own transaction
+begin;
+select a, b from xc_rcache_tab order by a;
+delete from xc_rcache_tab where a = 1;
+select a, b from xc_rcache_tab order by a;
+rollback;
+select a, b from xc_rcache_tab order by a;
+
+-- repeatable read uses the same snapshot for every statement
+begin isolation level repeatable read;
+select a, b from xc_rcache_tab order by a;
+select a, b from xc_rcache_tab order by a;
+commit;
+
+-- EXPLAIN ANALYZE tells whether the rows came from the cache
+create function xc_rcache_status(query text) returns text language plpgsql as $$
+declare
+	line text;
+begin
+	for line in execute 'explain (analyze, costs off, timing off) ' || query
+	loop
+		if line like '%Result Cache:%' then
+			return btrim(split_part(line, ':', 2));
+		end if;
+	end loop;
+	return 'not cached';
+end
+$$;
+create role xc_rcache_reader;
+grant select on xc_rcache_tab to xc_rcache_reader;
+select xc_rcache_status('select a, b from xc_rcache_tab where a < 3');
+select xc_rcache_status('select a, b from xc_rcache_tab where a < 3');
+insert into xc_rcache_tab values (4, 'four');
+select xc_rcache_status('select a, b from xc_rcache_tab where a < 3');
+select xc_rcache_status('select a, b from xc_rcache_tab where a < 3');
+-- the search_path and the role are part of the key
+set search_path = pg_catalog, public;
+select xc_rcache_status('select a, b from xc_rcache_tab where a < 3');
+select xc_rcache_status('select a, b from xc_rcache_tab where a < 3');
+reset search_path;
+select xc_rcache_status('select a, b from xc_rcache_tab where a < 3');
+set role xc_rcache_reader;
+select xc_rcache_status('select a, b from xc_rcache_tab where a < 3');
+select xc_rcache_status('select a, b from xc_rcache_tab where a < 3');
+reset role;
+select xc_rcache_status('select a, b from xc_rcache_tab where a < 3');
+-- writes of the own transaction keep the table out of the cache until
+-- it ends, also in and after subtransactions
+begin;
+select xc_rcache_status('select a, b from xc_rcache_tab where a < 3');
+delete from xc_rcache_tab where a = 2;
+select xc_rcache_status('select a, b from xc_rcache_tab where a < 3');
+savepoint s1;
+select xc_rcache_status('select a, b from xc_rcache_tab where a < 3');
+select a, b from xc_rcache_tab where a < 3;
+release savepoint s1;
+savepoint s2;
+delete from xc_rcache_tab where a = 1;
+release savepoint s2;
+select xc_rcache_status('select a, b from xc_rcache_tab where a < 3');
+select a, b from xc_rcache_tab where a < 3;
+rollback;
+select a, b from xc_rcache_tab where a < 3;
+
+-- parameters are part of the key
+prepare xc_rcache_q(int) as select b from xc_rcache_tab where a = $1;
+execute xc_rcache_q(1);
+execute xc_rcache_q(2);
+execute xc_rcache_q(1);
+deallocate xc_rcache_q;
+
+-- tables with row level security are not cached, the role and
+-- row_security decide what they return
+create role xc_rcache_user;
+grant select on xc_rcache_tab to xc_rcache_user;
+create policy xc_rcache_pol on xc_rcache_tab using (a < 3);
+alter table xc_rcache_tab enable row level security;
+select count(*) from xc_rcache_tab;
+set role xc_rcache_user;
+select count(*) from xc_rcache_tab;
+select count(*) from xc_rcache_tab;
+set row_security = off;
+select count(*) from xc_rcache_tab;
+reset row_security;
+reset role;
+select count(*) from xc_rcache_tab;
+
+drop table xc_rcache_tab;
+drop role xc_rcache_user;
+drop role xc_rcache_reader;
+drop function xc_rcache_status(text);
+reset remote_result_cache_size;
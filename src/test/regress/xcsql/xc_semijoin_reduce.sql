@@ -0,0 +1,62 @@
+--
+-- The inner side of a distributed semi join is unique-ified on every
+-- node before it is reduced
+--
+set enable_cluster_plan = on;
+set enable_nestloop = off;
+create function xc_sj_unique_reduce(query text) returns bool language plpgsql as $$
+declare
+	line text;
+	depth int := 0;
+begin
+	for line in execute 'explain (costs off) ' || query loop
+		if depth > 0 and strpos(line, '->') > 0 and strpos(line, '->') <= depth then
+			depth := 0;
+		end if;
+		if depth = 0 and line like '%Cluster Reduce%' then
+			depth := greatest(strpos(line, '->'), 1);
+		elsif depth > 0 and (line like '%->  HashAggregate%' or line like '%->  Unique%') then
+			return true;
+		end if;
+	end loop;
+	return false;
+end $$;
+select create_table_nodes('xc_sj_o(a int, b int)', '{1, 2}'::int[], 'hash(a)', NULL);
+select create_table_nodes('xc_sj_i(k int, v int)', '{1, 2}'::int[], 'hash(v)', NULL);
+insert into xc_sj_o select i, i % 1000 from generate_series(1, 10000) i;
+-- every join key is found many times and on both nodes
+insert into xc_sj_i select i % 50, i from generate_series(1, 100000) i;
+analyze xc_sj_o;
+analyze xc_sj_i;
+set enable_semijoin_reduction = on;
+select xc_sj_unique_reduce('select count(*) from xc_sj_o where b in (select k from xc_sj_i)');
+select count(*), sum(a) from xc_sj_o where b in (select k from xc_sj_i);
+select count(*), sum(a) from xc_sj_o o where exists (select 1 from xc_sj_i i where i.k = o.b and i.v % 2 = 0);
+select count(*) from xc_sj_o o where not exists (select 1 from xc_sj_i i where i.k = o.b);
+-- sorted unique paths
+set enable_hashagg = off;
+select count(*), sum(a) from xc_sj_o where b in (select k from xc_sj_i);
+select count(*), sum(a) from xc_sj_o o where exists (select 1 from xc_sj_i i where i.k = o.b and i.v % 2 = 0);
+reset enable_hashagg;
+-- the unique inner strategy joins the reduced keys as an inner join, keys
+-- coming from both nodes must not be counted twice
+set enable_hashjoin = off;
+select count(*), sum(a) from xc_sj_o where b in (select k from xc_sj_i);
+select count(*), sum(a) from xc_sj_o o where exists (select 1 from xc_sj_i i where i.k = o.b and i.v % 2 = 0);
+set enable_hashjoin = on;
+set enable_mergejoin = off;
+select count(*), sum(a) from xc_sj_o where b in (select k from xc_sj_i);
+select count(*), sum(a) from xc_sj_o o where exists (select 1 from xc_sj_i i where i.k = o.b and i.v % 2 = 0);
+reset enable_mergejoin;
+-- same results without the reduction
+set enable_semijoin_reduction = off;
+select xc_sj_unique_reduce('select count(*) from xc_sj_o where b in (select k from xc_sj_i)');
+select count(*), sum(a) from xc_sj_o where b in (select k from xc_sj_i);
+select count(*), sum(a) from xc_sj_o o where exists (select 1 from xc_sj_i i where i.k = o.b and i.v % 2 = 0);
+select count(*) from xc_sj_o o where not exists (select 1 from xc_sj_i i where i.k = o.b);
+drop table xc_sj_o;
+drop table xc_sj_i;
+drop function xc_sj_unique_reduce(text);
+reset enable_semijoin_reduction;
+reset enable_nestloop;
+reset enable_cluster_plan;
@@ -92,3 +92,38 @@ SELECT setval('xc_sequence_neg_set', -99); -- ok
 SELECT nextval('xc_sequence_neg_set'); -- ok
 SELECT currval('xc_sequence_neg_set'); -- ok
 DROP SEQUENCE xc_sequence_neg_set;
+
+-- In-memory sequence engine of AGTM
+-- Reserved runs are handed out without gaps within a session
+CREATE SEQUENCE xc_sequence_hot START 10 INCREMENT BY 3 CACHE 5;
+SELECT nextval('xc_sequence_hot') FROM generate_series(1, 12);
+SELECT currval('xc_sequence_hot'), lastval();
+CREATE SEQUENCE xc_sequence_other;
+SELECT nextval('xc_sequence_other');
+SELECT currval('xc_sequence_hot'), lastval();
+-- setval with is_called true drops the reserved run
+SELECT setval('xc_sequence_hot', 100);
+SELECT currval('xc_sequence_hot'), lastval();
+SELECT nextval('xc_sequence_hot') FROM generate_series(1, 4);
+-- setval with is_called false hands out the value set, currval is kept
+SELECT setval('xc_sequence_hot', 200, false);
+SELECT currval('xc_sequence_hot'), lastval();
+SELECT nextval('xc_sequence_hot');
+SELECT currval('xc_sequence_hot'), lastval();
+-- ALTER ... RESTART drops the reserved run, currval is kept
+ALTER SEQUENCE xc_sequence_hot RESTART WITH 50;
+SELECT currval('xc_sequence_hot'), lastval();
+SELECT nextval('xc_sequence_hot') FROM generate_series(1, 2);
+SELECT currval('xc_sequence_hot'), lastval();
+ALTER SEQUENCE xc_sequence_hot RESTART;
+SELECT nextval('xc_sequence_hot');
+SELECT currval('xc_sequence_hot'), lastval();
+-- DROP then CREATE under the same name starts over
+DROP SEQUENCE xc_sequence_hot;
+SELECT lastval(); -- fail
+CREATE SEQUENCE xc_sequence_hot START 7;
+SELECT currval('xc_sequence_hot'); -- fail
+SELECT nextval('xc_sequence_hot') FROM generate_series(1, 2);
+SELECT currval('xc_sequence_hot'), lastval();
+DROP SEQUENCE xc_sequence_hot;
+DROP SEQUENCE xc_sequence_other;
@@ -0,0 +1,25 @@
+--
+-- Nodes of a transaction reported to AGTM, which holds back the cleanup
+-- horizon of just those nodes, see node_cleanup_horizon
+--
+show node_cleanup_horizon;
+create table xc_xnodes_tab (a int) distribute by hash(a);
+insert into xc_xnodes_tab select generate_series(1, 100);
+
+-- a read-only transaction reports the nodes it read with the next snapshot
+begin;
+select adb_xact_nodes();
+select count(*) from xc_xnodes_tab;
+select adb_xact_nodes() = (select bit_or(adb_node_bit(node_name)) from pgxc_node where node_type = 'D') as all_datanodes;
+commit;
+
+-- a write reports its nodes with the GXID request
+begin;
+insert into xc_xnodes_tab values (101);
+select adb_xact_nodes() <> 0 and (adb_xact_nodes() & ~(select bit_or(adb_node_bit(node_name)) from pgxc_node where node_type = 'D')) = 0 as datanodes_only;
+commit;
+
+-- the mask starts over with every transaction
+select adb_xact_nodes();
+
+drop table xc_xnodes_tab;